@@ -0,0 +1,313 @@
+/*
+* Copyright  2018 Denis Zyamaev (code4un@yandex.ru) All rights reserved.
+* Authors: Denis Zyamaev (code4un@yandex.ru)
+* All rights reserved.
+* API: C++ 11
+* License: see LICENSE.txt
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+* 1. Redistributions of source code must retain the above copyright notice,
+* this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must display the names 'Denis Zyamaev' and
+* in the credits of the application, if such credits exist.
+* The authors of this work must be notified via email (code4un@yandex.ru) in
+* this case of redistribution.
+* 3. Neither the name of copyright holders nor the names of its contributors
+* may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS
+* IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+* PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// HEADER
+#include "BenchCorpus.hpp"
+
+namespace c0de4un
+{
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Getters
+	// ===========================================================
+
+	/*
+	 * Returns name of corpus kind, used in report.
+	 *
+	 * @param pKind - corpus kind.
+	*/
+	const char * BenchCorpus::getName( const BenchCorpusKind pKind ) noexcept
+	{
+
+		switch ( pKind )
+		{
+
+		case BenchCorpusKind::TEXT_LOG:
+			return( "text_log" );
+
+		case BenchCorpusKind::JSON:
+			return( "json" );
+
+		case BenchCorpusKind::BINARY_TABLE:
+			return( "binary_table" );
+
+		case BenchCorpusKind::RANDOM:
+			return( "random" );
+
+		case BenchCorpusKind::COMPRESSED:
+			return( "compressed" );
+
+		}
+
+		// Return Default
+		return( "unknown" );
+
+	}
+
+	// ===========================================================
+	// Methods
+	// ===========================================================
+
+	/*
+	 * Returns random value in range [0, pRange).
+	 *
+	 * @param pRandom - generator.
+	 * @param pRange - number of values, must be greater than 0.
+	*/
+	std::uint64_t BenchCorpus::getRandom( std::mt19937_64 & pRandom, const std::uint64_t pRange ) noexcept
+	{ return( pRandom( ) % pRange ); }
+
+	/*
+	 * Append text.
+	 *
+	 * @param pData - output.
+	 * @param pText - text to append.
+	 * @throws - can throw exception (bad_alloc).
+	*/
+	void BenchCorpus::append( std::vector<unsigned char> & pData, const std::string & pText )
+	{ pData.insert( pData.end( ), pText.begin( ), pText.end( ) ); }
+
+	/*
+	 * Generate text log lines.
+	 *
+	 * @param pData - output, filled up to it's size.
+	 * @param pRandom - generator.
+	 * @throws - can throw exception (bad_alloc).
+	*/
+	void BenchCorpus::generateLog( std::vector<unsigned char> & pData, std::mt19937_64 & pRandom )
+	{
+
+		// Field values
+		static const char *const levels[] = { "INFO", "INFO", "INFO", "DEBUG", "WARN", "ERROR" };
+		static const char *const methods[] = { "GET", "GET", "POST", "PUT", "DELETE" };
+		static const char *const paths[] = { "/api/v1/users", "/api/v1/orders", "/api/v1/items", "/static/app.js", "/health", "/api/v2/search" };
+		static const int statuses[] = { 200, 200, 200, 201, 204, 304, 400, 404, 500 };
+
+		// Size
+		const std::size_t dataSize( pData.size( ) );
+		pData.clear( );
+
+		// Line
+		char line[256];
+
+		// Time, milliseconds
+		std::uint64_t timeMs( 1500000000000ULL );
+
+		// Generate
+		while ( pData.size( ) < dataSize )
+		{
+
+			// Time goes forward
+			timeMs += getRandom( pRandom, 50 );
+
+			// Format
+			const int lineSize( std::snprintf( line, sizeof( line ), "%llu.%03u %s [worker-%u] %s %s?id=%llu status=%d latency=%ums bytes=%u\n",
+				static_cast<unsigned long long>( timeMs / 1000 ), static_cast<unsigned int>( timeMs % 1000 ),
+				levels[getRandom( pRandom, 6 )], static_cast<unsigned int>( getRandom( pRandom, 16 ) ),
+				methods[getRandom( pRandom, 5 )], paths[getRandom( pRandom, 6 )],
+				static_cast<unsigned long long>( getRandom( pRandom, 100000 ) ), statuses[getRandom( pRandom, 9 )],
+				static_cast<unsigned int>( getRandom( pRandom, 2000 ) ), static_cast<unsigned int>( getRandom( pRandom, 65536 ) ) ) );
+
+			// Add
+			pData.insert( pData.end( ), line, line + lineSize );
+
+		}
+
+		// Cut
+		pData.resize( dataSize );
+
+	}
+
+	/*
+	 * Generate JSON records.
+	 *
+	 * @param pData - output, filled up to it's size.
+	 * @param pRandom - generator.
+	 * @throws - can throw exception (bad_alloc).
+	*/
+	void BenchCorpus::generateJSON( std::vector<unsigned char> & pData, std::mt19937_64 & pRandom )
+	{
+
+		// Field values
+		static const char *const names[] = { "alice", "bob", "carol", "dave", "erin", "frank", "grace", "heidi" };
+		static const char *const tags[] = { "\"new\"", "\"vip\"", "\"trial\"", "\"blocked\"", "\"beta\"" };
+
+		// Size
+		const std::size_t dataSize( pData.size( ) );
+		pData.clear( );
+
+		// Record
+		char record[512];
+
+		// Record ID
+		std::uint64_t recordID( 0 );
+
+		// Generate
+		append( pData, "[\n" );
+		while ( pData.size( ) < dataSize )
+		{
+
+			// Format
+			const int recordSize( std::snprintf( record, sizeof( record ), "  {\"id\": %llu, \"name\": \"%s_%u\", \"age\": %u, \"balance\": %u.%02u, \"active\": %s, \"tags\": [%s, %s], \"address\": {\"zip\": \"%05u\", \"street\": \"%u %s street\"}},\n",
+				static_cast<unsigned long long>( recordID++ ), names[getRandom( pRandom, 8 )], static_cast<unsigned int>( getRandom( pRandom, 1000 ) ),
+				static_cast<unsigned int>( 18 + getRandom( pRandom, 70 ) ), static_cast<unsigned int>( getRandom( pRandom, 100000 ) ), static_cast<unsigned int>( getRandom( pRandom, 100 ) ),
+				getRandom( pRandom, 4 ) != 0 ? "true" : "false", tags[getRandom( pRandom, 5 )], tags[getRandom( pRandom, 5 )],
+				static_cast<unsigned int>( getRandom( pRandom, 100000 ) ), static_cast<unsigned int>( 1 + getRandom( pRandom, 999 ) ), names[getRandom( pRandom, 8 )] ) );
+
+			// Add
+			pData.insert( pData.end( ), record, record + recordSize );
+
+		}
+
+		// Cut
+		pData.resize( dataSize );
+
+	}
+
+	/*
+	 * Generate binary table rows.
+	 *
+	 * @param pData - output, filled up to it's size.
+	 * @param pRandom - generator.
+	*/
+	void BenchCorpus::generateTable( std::vector<unsigned char> & pData, std::mt19937_64 & pRandom ) noexcept
+	{
+
+		// Row: id (4), timestamp (8), category (2), flags (2), price (4), quantity (4), little-endian
+		unsigned char row[24];
+
+		// Row values
+		std::uint64_t rowID( 0 );
+		std::uint64_t timestamp( 1500000000 );
+
+		// Generate
+		for ( std::size_t offset = 0; offset < pData.size( ); offset += sizeof( row ) )
+		{
+
+			// Values
+			timestamp += getRandom( pRandom, 4 );
+			const std::uint64_t values[6] = { rowID++, timestamp, getRandom( pRandom, 32 ), getRandom( pRandom, 4 ), 100 + getRandom( pRandom, 10000 ), getRandom( pRandom, 1000 ) };
+			const std::size_t sizes[6] = { 4, 8, 2, 2, 4, 4 };
+
+			// Write row
+			std::size_t rowOffset( 0 );
+			for ( std::size_t i = 0; i < 6; i++ )
+			{
+				for ( std::size_t j = 0; j < sizes[i]; j++ )
+					row[rowOffset++] = static_cast<unsigned char>( ( values[i] >> ( j * 8 ) ) & 0xFF );
+			}
+
+			// Copy
+			std::memcpy( pData.data( ) + offset, row, std::min( sizeof( row ), pData.size( ) - offset ) );
+
+		}
+
+	}
+
+	/*
+	 * Generate corpus.
+	 *
+	 * @thread_safety - thread-safe.
+	 * @param pKind - corpus kind.
+	 * @param pSize - size of data, in bytes.
+	 * @param pSeed - generator seed.
+	 * @return - generated data.
+	 * @throws - can throw exception.
+	*/
+	std::vector<unsigned char> BenchCorpus::generate( const BenchCorpusKind pKind, const std::size_t pSize, const std::uint64_t pSeed )
+	{
+
+		// Generator
+		std::mt19937_64 random( pSeed + static_cast<std::uint64_t>( pKind ) );
+
+		// Data
+		std::vector<unsigned char> data( pSize );
+
+		switch ( pKind )
+		{
+
+		case BenchCorpusKind::TEXT_LOG:
+			generateLog( data, random );
+			break;
+
+		case BenchCorpusKind::JSON:
+			generateJSON( data, random );
+			break;
+
+		case BenchCorpusKind::BINARY_TABLE:
+			generateTable( data, random );
+			break;
+
+		case BenchCorpusKind::RANDOM:
+			for ( std::size_t i = 0; i < pSize; i += 8 )
+			{
+				const std::uint64_t value( random( ) );
+				for ( std::size_t j = i; j < std::min<std::size_t>( i + 8, pSize ); j++ )
+					data[j] = static_cast<unsigned char>( ( value >> ( ( j - i ) * 8 ) ) & 0xFF );
+			}
+			break;
+
+		case BenchCorpusKind::COMPRESSED:
+		{
+
+			// Log text, larger than deflate ratio, so deflated data fills the size
+			std::vector<unsigned char> textData( pSize * 8 + 65536 );
+			generateLog( textData, random );
+
+			// Deflate
+			uLongf packedSize( static_cast<uLongf>( data.size( ) ) );
+			const int zRet( compress2( data.data( ), &packedSize, textData.data( ), static_cast<uLong>( textData.size( ) ), Z_BEST_COMPRESSION ) );
+
+			// Buffer too small is expected, output is cut
+			if ( zRet != Z_OK && zRet != Z_BUF_ERROR )
+				throw std::runtime_error( "BenchCorpus::generate - failed to deflate corpus" );
+
+			if ( zRet == Z_OK )
+				data.resize( static_cast<std::size_t>( packedSize ) );
+
+			break;
+
+		}
+
+		}
+
+		// Return
+		return( data );
+
+	}
+
+	// -------------------------------------------------------- \\
+
+}
\ No newline at end of file
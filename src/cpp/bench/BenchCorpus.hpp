@@ -0,0 +1,194 @@
+/*
+* Copyright  2018 Denis Zyamaev (code4un@yandex.ru) All rights reserved.
+* Authors: Denis Zyamaev (code4un@yandex.ru)
+* All rights reserved.
+* API: C++ 11
+* License: see LICENSE.txt
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+* 1. Redistributions of source code must retain the above copyright notice,
+* this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must display the names 'Denis Zyamaev' and
+* in the credits of the application, if such credits exist.
+* The authors of this work must be notified via email (code4un@yandex.ru) in
+* this case of redistribution.
+* 3. Neither the name of copyright holders nor the names of its contributors
+* may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS
+* IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+* PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+// Include 'pch_cxx'
+#include "../pch_cxx.hpp"
+
+// Include C++ random
+#include <random> // std::mt19937_64
+
+namespace c0de4un
+{
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Types
+	// ===========================================================
+
+	/* Kind of generated benchmark data */
+	enum class BenchCorpusKind : std::uint8_t
+	{
+
+		/* Text log lines, timestamps & repeated fields */
+		TEXT_LOG = 0,
+
+		/* JSON records */
+		JSON = 1,
+
+		/* Binary table of fixed-size rows */
+		BINARY_TABLE = 2,
+
+		/* Random bytes, incompressible */
+		RANDOM = 3,
+
+		/* Already deflated text, almost incompressible */
+		COMPRESSED = 4
+
+	};
+
+	/*
+	  * BenchCorpus - deterministic generator of benchmark data.
+	  *
+	  * The same kind, size & seed always produce the same bytes, on every
+	  * platform (only raw std::mt19937_64 output is used, no distributions),
+	  * so results are comparable between releases.
+	  *
+	  * @language C++ 17
+	  *
+	  * @authors Z. Denis (c0de4un@yandex.ru)
+	  * @version 1.0
+	 */
+	class BenchCorpus final
+	{
+
+	private:
+
+		// -------------------------------------------------------- \\
+
+		// ===========================================================
+		// Methods
+		// ===========================================================
+
+		/*
+		 * Returns random value in range [0, pRange).
+		 *
+		 * @param pRandom - generator.
+		 * @param pRange - number of values, must be greater than 0.
+		*/
+		static std::uint64_t getRandom( std::mt19937_64 & pRandom, const std::uint64_t pRange ) noexcept;
+
+		/*
+		 * Append text.
+		 *
+		 * @param pData - output.
+		 * @param pText - text to append.
+		 * @throws - can throw exception (bad_alloc).
+		*/
+		static void append( std::vector<unsigned char> & pData, const std::string & pText );
+
+		/*
+		 * Generate text log lines.
+		 *
+		 * @param pData - output, filled up to it's size.
+		 * @param pRandom - generator.
+		 * @throws - can throw exception (bad_alloc).
+		*/
+		static void generateLog( std::vector<unsigned char> & pData, std::mt19937_64 & pRandom );
+
+		/*
+		 * Generate JSON records.
+		 *
+		 * @param pData - output, filled up to it's size.
+		 * @param pRandom - generator.
+		 * @throws - can throw exception (bad_alloc).
+		*/
+		static void generateJSON( std::vector<unsigned char> & pData, std::mt19937_64 & pRandom );
+
+		/*
+		 * Generate binary table rows.
+		 *
+		 * @param pData - output, filled up to it's size.
+		 * @param pRandom - generator.
+		*/
+		static void generateTable( std::vector<unsigned char> & pData, std::mt19937_64 & pRandom ) noexcept;
+
+		// -------------------------------------------------------- \\
+
+	public:
+
+		// -------------------------------------------------------- \\
+
+		// ===========================================================
+		// Constants
+		// ===========================================================
+
+		/* Number of corpus kinds */
+		static constexpr std::size_t KINDS_COUNT = 5;
+
+		/* Default seed */
+		static constexpr std::uint64_t DEFAULT_SEED = 20181210;
+
+		// ===========================================================
+		// Constructor & destructor
+		// ===========================================================
+
+		/* @deleted BenchCorpus constructor, only static methods */
+		BenchCorpus( ) = delete;
+
+		// ===========================================================
+		// Getters
+		// ===========================================================
+
+		/*
+		 * Returns name of corpus kind, used in report.
+		 *
+		 * @param pKind - corpus kind.
+		*/
+		static const char * getName( const BenchCorpusKind pKind ) noexcept;
+
+		// ===========================================================
+		// Methods
+		// ===========================================================
+
+		/*
+		 * Generate corpus.
+		 *
+		 * @thread_safety - thread-safe.
+		 * @param pKind - corpus kind.
+		 * @param pSize - size of data, in bytes.
+		 * @param pSeed - generator seed.
+		 * @return - generated data.
+		 * @throws - can throw exception.
+		*/
+		static std::vector<unsigned char> generate( const BenchCorpusKind pKind, const std::size_t pSize, const std::uint64_t pSeed = DEFAULT_SEED );
+
+		// -------------------------------------------------------- \\
+
+	};
+
+	// -------------------------------------------------------- \\
+
+}
\ No newline at end of file
@@ -0,0 +1,431 @@
+/*
+* Copyright  2018 Denis Zyamaev (code4un@yandex.ru) All rights reserved.
+* Authors: Denis Zyamaev (code4un@yandex.ru)
+* All rights reserved.
+* API: C++ 11
+* License: see LICENSE.txt
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+* 1. Redistributions of source code must retain the above copyright notice,
+* this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must display the names 'Denis Zyamaev' and
+* in the credits of the application, if such credits exist.
+* The authors of this work must be notified via email (code4un@yandex.ru) in
+* this case of redistribution.
+* 3. Neither the name of copyright holders nor the names of its contributors
+* may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS
+* IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+* PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// HEADER
+#include "bench_main.hpp"
+
+/*
+ * Returns CPU time of the process (all threads, user & kernel), in seconds.
+*/
+static double getCPUTime( )
+{
+
+#if defined( _WIN32 )
+
+	// Times, in 100 ns units
+	FILETIME creationTime, exitTime, kernelTime, userTime;
+
+	if ( GetProcessTimes( GetCurrentProcess( ), &creationTime, &exitTime, &kernelTime, &userTime ) == 0 )
+		return( 0.0 );
+
+	const ULONGLONG kernelTicks( ( static_cast<ULONGLONG>( kernelTime.dwHighDateTime ) << 32 ) | kernelTime.dwLowDateTime );
+	const ULONGLONG userTicks( ( static_cast<ULONGLONG>( userTime.dwHighDateTime ) << 32 ) | userTime.dwLowDateTime );
+
+	// Return
+	return( static_cast<double>( kernelTicks + userTicks ) / 10000000.0 );
+
+#else
+
+	// Usage
+	struct rusage usage;
+
+	if ( getrusage( RUSAGE_SELF, &usage ) != 0 )
+		return( 0.0 );
+
+	// Return
+	return( static_cast<double>( usage.ru_utime.tv_sec + usage.ru_stime.tv_sec ) + static_cast<double>( usage.ru_utime.tv_usec + usage.ru_stime.tv_usec ) / 1000000.0 );
+
+#endif
+
+}
+
+/*
+ * Resets peak resident set size to current one, so getPeakRSS returns
+ * peak of the next run. Linux only, elsewhere peak of the process is kept.
+*/
+static void resetPeakRSS( )
+{
+
+#if defined( __linux__ )
+
+	// "5" resets VmHWM, failure keeps peak of the process
+	std::ofstream clearRefs( "/proc/self/clear_refs" );
+	clearRefs << "5";
+
+#endif
+
+}
+
+/*
+ * Returns peak resident set size since resetPeakRSS (Linux) or of the
+ * process, in bytes.
+*/
+static std::uint64_t getPeakRSS( )
+{
+
+#if defined( __linux__ )
+
+	// VmHWM, KB
+	std::ifstream statusFile( "/proc/self/status" );
+	std::string statusLine;
+
+	while ( std::getline( statusFile, statusLine ) )
+	{
+
+		if ( statusLine.compare( 0, 6, "VmHWM:" ) == 0 )
+			return( std::strtoull( statusLine.c_str( ) + 6, nullptr, 10 ) * 1024 );
+
+	}
+
+#endif
+
+#if defined( _WIN32 )
+
+	// Counters
+	PROCESS_MEMORY_COUNTERS memoryCounters;
+
+	if ( GetProcessMemoryInfo( GetCurrentProcess( ), &memoryCounters, sizeof( memoryCounters ) ) == 0 )
+		return( 0 );
+
+	// Return
+	return( static_cast<std::uint64_t>( memoryCounters.PeakWorkingSetSize ) );
+
+#else
+
+	// Usage
+	struct rusage usage;
+
+	if ( getrusage( RUSAGE_SELF, &usage ) != 0 )
+		return( 0 );
+
+#if defined( __APPLE__ )
+	// Bytes on Mac OS
+	return( static_cast<std::uint64_t>( usage.ru_maxrss ) );
+#else
+	// KB on Linux
+	return( static_cast<std::uint64_t>( usage.ru_maxrss ) * 1024 );
+#endif
+
+#endif
+
+}
+
+/*
+ * Returns size of file & rewinds it.
+ *
+ * @param pFile - file.
+*/
+static std::uint64_t rewindFile( std::FILE *const pFile )
+{
+
+	// Flush & size
+	std::fflush( pFile );
+	std::fseek( pFile, 0, SEEK_END );
+	const long fileSize( std::ftell( pFile ) );
+
+	// Rewind
+	std::rewind( pFile );
+
+	// Return
+	return( fileSize < 0 ? 0 : static_cast<std::uint64_t>( fileSize ) );
+
+}
+
+/*
+ * Run compression or decompression & measure it.
+ *
+ * @param pRun - runs engine, returns Z_OK if complete.
+ * @param pResult - receives time, CPU time & peak RSS.
+ * @return - true, if engine succeeded.
+*/
+static bool measure( const std::function<int( )> & pRun, BenchResult & pResult )
+{
+
+	// Start, peak of previous runs is dropped
+	resetPeakRSS( );
+	const double cpuStart( getCPUTime( ) );
+	const auto wallStart( std::chrono::steady_clock::now( ) );
+
+	// Run
+	const int zRet( pRun( ) );
+
+	// Stop
+	pResult.wallSeconds = std::chrono::duration<double>( std::chrono::steady_clock::now( ) - wallStart ).count( );
+	pResult.cpuSeconds = getCPUTime( ) - cpuStart;
+	pResult.peakRSS = getPeakRSS( );
+
+	// Return
+	return( zRet == Z_OK );
+
+}
+
+/*
+ * Print result as JSON-object.
+ *
+ * @param pReport - output.
+ * @param pCorpus - corpus name.
+ * @param pEngine - engine name.
+ * @param pOperation - "deflate" or "inflate".
+ * @param pLevel - Compression-Level.
+ * @param pBufferSize - buffer size, 0 if engine uses own defaults.
+ * @param pResult - measured result.
+ * @param pFirst - true, if this is the first result.
+*/
+static void printResult( std::ostream & pReport, const char *const pCorpus, const char *const pEngine, const char *const pOperation, const int pLevel, const std::uint32_t pBufferSize, const BenchResult & pResult, const bool pFirst )
+{
+
+	// Throughput of uncompressed data
+	const double mbPerSecond( pResult.wallSeconds > 0.0 ? static_cast<double>( pResult.inputBytes ) / BENCH_BYTES_PER_MB / pResult.wallSeconds : 0.0 );
+
+	// Compressed to uncompressed size
+	const double compressionRatio( pResult.inputBytes > 0 ? static_cast<double>( pResult.outputBytes ) / static_cast<double>( pResult.inputBytes ) : 0.0 );
+
+	// Print
+	pReport << ( pFirst ? "" : ",\n" ) << "    { \"corpus\": \"" << pCorpus << "\", \"engine\": \"" << pEngine << "\", \"operation\": \"" << pOperation
+		<< "\", \"level\": " << pLevel << ", \"buffer_size\": " << pBufferSize
+		<< ", \"input_bytes\": " << pResult.inputBytes << ", \"output_bytes\": " << pResult.outputBytes << ", \"ratio\": " << compressionRatio
+		<< ", \"wall_seconds\": " << pResult.wallSeconds << ", \"cpu_seconds\": " << pResult.cpuSeconds << ", \"mb_per_second\": " << mbPerSecond
+		<< ", \"peak_rss_bytes\": " << pResult.peakRSS << ", \"verified\": " << ( pResult.verified ? "true" : "false" ) << " }";
+
+}
+
+/*
+ * Returns benchmarked engines. New engines are added here.
+*/
+static std::vector<BenchEngine> getEngines( )
+{
+
+	// Engines
+	std::vector<BenchEngine> engines;
+
+	// ZStream, stdio
+	engines.push_back( { "zstream", true,
+		[]( std::FILE *const srcFile, std::FILE *const dstFile, const int compressionLevel, const std::uint32_t bufferSize ) { return( c0de4un::ZStream::deflateFILE( srcFile, dstFile, bufferSize, compressionLevel, c0de4un::IOBackend::STDIO ) ); },
+		[]( std::FILE *const srcFile, std::FILE *const dstFile, const std::uint32_t bufferSize ) { return( c0de4un::ZStream::inflateFILE( srcFile, dstFile, bufferSize, c0de4un::IOBackend::STDIO ) ); } } );
+
+	// ZStream, memory-mapped input
+	engines.push_back( { "zstream_mmap", true,
+		[]( std::FILE *const srcFile, std::FILE *const dstFile, const int compressionLevel, const std::uint32_t bufferSize ) { return( c0de4un::ZStream::deflateFILE( srcFile, dstFile, bufferSize, compressionLevel, c0de4un::IOBackend::MEMORY_MAPPED ) ); },
+		[]( std::FILE *const srcFile, std::FILE *const dstFile, const std::uint32_t bufferSize ) { return( c0de4un::ZStream::inflateFILE( srcFile, dstFile, bufferSize, c0de4un::IOBackend::MEMORY_MAPPED ) ); } } );
+
+	// ZStream, io_uring (stdio, if not supported)
+	engines.push_back( { "zstream_uring", true,
+		[]( std::FILE *const srcFile, std::FILE *const dstFile, const int compressionLevel, const std::uint32_t bufferSize ) { return( c0de4un::ZStream::deflateFILE( srcFile, dstFile, bufferSize, compressionLevel, c0de4un::IOBackend::IO_URING ) ); },
+		[]( std::FILE *const srcFile, std::FILE *const dstFile, const std::uint32_t bufferSize ) { return( c0de4un::ZStream::inflateFILE( srcFile, dstFile, bufferSize, c0de4un::IOBackend::IO_URING ) ); } } );
+
+	// ZStream, pages are dropped behind the cursor
+	engines.push_back( { "zstream_polite", true,
+		[]( std::FILE *const srcFile, std::FILE *const dstFile, const int compressionLevel, const std::uint32_t bufferSize ) { return( c0de4un::ZStream::deflateFILE( srcFile, dstFile, bufferSize, compressionLevel, c0de4un::IOBackend::CACHE_POLITE ) ); },
+		[]( std::FILE *const srcFile, std::FILE *const dstFile, const std::uint32_t bufferSize ) { return( c0de4un::ZStream::inflateFILE( srcFile, dstFile, bufferSize, c0de4un::IOBackend::CACHE_POLITE ) ); } } );
+
+	// ZPipeline, read/compress/write on separate threads
+	engines.push_back( { "pipeline", true,
+		[]( std::FILE *const srcFile, std::FILE *const dstFile, const int compressionLevel, const std::uint32_t bufferSize ) { return( c0de4un::ZPipeline::deflateFILE( srcFile, dstFile, compressionLevel, bufferSize ) ); },
+		[]( std::FILE *const srcFile, std::FILE *const dstFile, const std::uint32_t bufferSize ) { return( c0de4un::ZPipeline::inflateFILE( srcFile, dstFile, bufferSize ) ); } } );
+
+	// ZParallelDeflate, block-parallel single stream
+	engines.push_back( { "parallel", false,
+		[]( std::FILE *const srcFile, std::FILE *const dstFile, const int compressionLevel, const std::uint32_t ) { return( c0de4un::ZParallelDeflate::deflateFILE( srcFile, dstFile, compressionLevel ) ); },
+		[]( std::FILE *const srcFile, std::FILE *const dstFile, const std::uint32_t ) { return( c0de4un::ZPipeline::inflateFILE( srcFile, dstFile ) ); } } );
+
+	// ZParallelDeflate, seekable frames, inflated on multiple threads
+	engines.push_back( { "seekable", false,
+		[]( std::FILE *const srcFile, std::FILE *const dstFile, const int compressionLevel, const std::uint32_t ) { return( c0de4un::ZParallelDeflate::deflateSeekableFILE( srcFile, dstFile, compressionLevel ) ); },
+		[]( std::FILE *const srcFile, std::FILE *const dstFile, const std::uint32_t ) { return( c0de4un::ZParallelInflate::inflateFILE( srcFile, dstFile ) ); } } );
+
+	// ZBgzf, 64 KB members compressed on multiple threads
+	engines.push_back( { "bgzf", false,
+		[]( std::FILE *const srcFile, std::FILE *const dstFile, const int compressionLevel, const std::uint32_t ) { return( c0de4un::ZBgzf::deflateFILE( srcFile, dstFile, compressionLevel ) ); },
+		[]( std::FILE *const srcFile, std::FILE *const dstFile, const std::uint32_t ) { c0de4un::FileOutputSink outputSink( dstFile ); return( c0de4un::ZBgzf::inflateFILE( srcFile, outputSink ) ); } } );
+
+	// Return
+	return( engines );
+
+}
+
+/*
+ * Compress & decompress corpus with engine, print both results.
+ *
+ * @param pReport - output.
+ * @param pCorpusName - corpus name.
+ * @param pCorpus - uncompressed data.
+ * @param pEngine - engine.
+ * @param pLevel - Compression-Level.
+ * @param pBufferSize - buffer size, 0 if engine uses own defaults.
+ * @param pFirst - true, if no results printed yet. Set to false.
+ * @throws - can throw exception.
+*/
+static void runEngine( std::ostream & pReport, const char *const pCorpusName, const std::vector<unsigned char> & pCorpus, const BenchEngine & pEngine, const int pLevel, const std::uint32_t pBufferSize, bool & pFirst )
+{
+
+	// Files, removed on close
+	std::unique_ptr<std::FILE, int(*)( std::FILE* )> srcFile( std::tmpfile( ), &std::fclose );
+	std::unique_ptr<std::FILE, int(*)( std::FILE* )> packedFile( std::tmpfile( ), &std::fclose );
+	std::unique_ptr<std::FILE, int(*)( std::FILE* )> unpackedFile( std::tmpfile( ), &std::fclose );
+
+	if ( srcFile == nullptr || packedFile == nullptr || unpackedFile == nullptr )
+		throw std::runtime_error( "failed to create temporary files" );
+
+	// Write corpus
+	if ( std::fwrite( pCorpus.data( ), sizeof( unsigned char ), pCorpus.size( ), srcFile.get( ) ) != pCorpus.size( ) )
+		throw std::runtime_error( "failed to write temporary file" );
+
+	rewindFile( srcFile.get( ) );
+
+	// Results
+	BenchResult deflateResult = BenchResult( );
+	BenchResult inflateResult = BenchResult( );
+
+	// Compress
+	deflateResult.verified = measure( [&]( ) { return( pEngine.deflateFILE( srcFile.get( ), packedFile.get( ), pLevel, pBufferSize ) ); }, deflateResult );
+	deflateResult.inputBytes = pCorpus.size( );
+	deflateResult.outputBytes = rewindFile( packedFile.get( ) );
+
+	// Decompress
+	inflateResult.verified = deflateResult.verified && measure( [&]( ) { return( pEngine.inflateFILE( packedFile.get( ), unpackedFile.get( ), pBufferSize ) ); }, inflateResult );
+	inflateResult.inputBytes = pCorpus.size( );
+	inflateResult.outputBytes = deflateResult.outputBytes;
+
+	// Verify round-trip
+	if ( inflateResult.verified )
+	{
+
+		std::vector<unsigned char> unpackedData( static_cast<std::size_t>( rewindFile( unpackedFile.get( ) ) ) );
+		inflateResult.verified = unpackedData.size( ) == pCorpus.size( )
+			&& std::fread( unpackedData.data( ), sizeof( unsigned char ), unpackedData.size( ), unpackedFile.get( ) ) == unpackedData.size( )
+			&& unpackedData == pCorpus;
+
+	}
+
+	// Print
+	printResult( pReport, pCorpusName, pEngine.name, "deflate", pLevel, pBufferSize, deflateResult, pFirst );
+	printResult( pReport, pCorpusName, pEngine.name, "inflate", pLevel, pBufferSize, inflateResult, false );
+	pFirst = false;
+
+}
+
+/*
+ * MAIN. Runs all engines over generated corpus, sweeping Compression-Level
+ * & buffer size, & prints JSON-report.
+ *
+ * @param argC - number of arguments.
+ * @param argV - arguments, where #0 is app name, #1 is corpus size in MB (optional),
+ * #2 is report file (optional, stdout by default).
+*/
+int main( int argC, char * argV[] )
+{
+
+	// Size of each corpus
+	const std::size_t corpusSize( ( argC > 1 ? static_cast<std::size_t>( std::strtoull( argV[1], nullptr, 10 ) ) : BENCH_DEFAULT_CORPUS_MB ) * 1048576 );
+
+	// Report file, engines print errors to stdout
+	std::ofstream reportFile;
+	if ( argC > 2 )
+	{
+
+		reportFile.open( argV[2], std::ios::out | std::ios::trunc );
+
+		if ( !reportFile.is_open( ) )
+		{
+			std::cerr << "failed to open report-file #" << argV[2] << std::endl;
+			return( 1 );
+		}
+
+	}
+
+	// Report
+	std::ostream & benchReport( argC > 2 ? static_cast<std::ostream&>( reportFile ) : std::cout );
+
+	// true, if no results printed yet
+	bool firstResult( true );
+
+	// Guarded-Block
+	try
+	{
+
+		// Engines
+		const std::vector<BenchEngine> engines( getEngines( ) );
+
+		// Header
+		benchReport << "{\n  \"benchmark\": \"gzip_util_bench\",\n  \"zlib_version\": \"" << zlibVersion( ) << "\",\n  \"corpus_size\": " << corpusSize
+			<< ",\n  \"seed\": " << c0de4un::BenchCorpus::DEFAULT_SEED << ",\n  \"hardware_threads\": " << std::thread::hardware_concurrency( ) << ",\n  \"results\": [\n";
+
+		// Corpus kinds
+		for ( std::size_t kindIndex = 0; kindIndex < c0de4un::BenchCorpus::KINDS_COUNT; kindIndex++ )
+		{
+
+			// Corpus
+			const c0de4un::BenchCorpusKind corpusKind( static_cast<c0de4un::BenchCorpusKind>( kindIndex ) );
+			const std::vector<unsigned char> corpusData( c0de4un::BenchCorpus::generate( corpusKind, corpusSize ) );
+
+			// Sweep
+			for ( const BenchEngine & engine : engines )
+			{
+
+				for ( const int compressionLevel : BENCH_LEVELS )
+				{
+
+					if ( !engine.usesBuffer )
+					{
+						runEngine( benchReport, c0de4un::BenchCorpus::getName( corpusKind ), corpusData, engine, compressionLevel, 0, firstResult );
+						continue;
+					}
+
+					for ( const std::uint32_t bufferSize : BENCH_BUFFER_SIZES )
+						runEngine( benchReport, c0de4un::BenchCorpus::getName( corpusKind ), corpusData, engine, compressionLevel, bufferSize, firstResult );
+
+				}
+
+			}
+
+		}
+
+		// Footer
+		benchReport << "\n  ]\n}" << std::endl;
+
+	}
+	catch ( const std::exception & pException )
+	{
+
+		// Print ERROR-message
+		std::cerr << "benchmark failed, error: " << pException.what( ) << std::endl;
+
+		// Return ERROR
+		return( 1 );
+
+	}
+
+	// Return OK
+	return( 0 );
+
+}
\ No newline at end of file
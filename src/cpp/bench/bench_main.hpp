@@ -0,0 +1,126 @@
+/*
+* Copyright  2018 Denis Zyamaev (code4un@yandex.ru) All rights reserved.
+* Authors: Denis Zyamaev (code4un@yandex.ru)
+* All rights reserved.
+* API: C++ 11
+* License: see LICENSE.txt
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+* 1. Redistributions of source code must retain the above copyright notice,
+* this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must display the names 'Denis Zyamaev' and
+* in the credits of the application, if such credits exist.
+* The authors of this work must be notified via email (code4un@yandex.ru) in
+* this case of redistribution.
+* 3. Neither the name of copyright holders nor the names of its contributors
+* may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS
+* IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+* PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+// Include 'precompiled-headers'
+#include "../pch_cxx.hpp"
+
+// Include C++ chrono
+#include <chrono> // std::chrono::steady_clock
+
+// Include C++ file streams
+#include <fstream> // std::ofstream
+
+// Include ZStream
+#include "../zip/ZStream.hpp"
+
+// Include ZParallelDeflate
+#include "../zip/ZParallelDeflate.hpp"
+
+// Include ZPipeline
+#include "../zip/ZPipeline.hpp"
+
+// Include ZParallelInflate
+#include "../zip/ZParallelInflate.hpp"
+
+// Include ZBgzf
+#include "../zip/ZBgzf.hpp"
+
+// Include FileOutputSink
+#include "../io/FileOutputSink.hpp"
+
+// Include BenchCorpus
+#include "BenchCorpus.hpp"
+
+// Process CPU time & peak RSS
+#if defined( _WIN32 )
+#  include <windows.h>
+#  include <psapi.h>
+#else
+#  include <sys/resource.h>
+#endif
+
+/* Default size of each corpus, in MB */
+static constexpr std::size_t BENCH_DEFAULT_CORPUS_MB = 16;
+
+/* Compression-Levels to sweep */
+static constexpr int BENCH_LEVELS[] = { 1, 6, 9 };
+
+/* Buffer sizes to sweep, used by engines with configurable buffer */
+static constexpr std::uint32_t BENCH_BUFFER_SIZES[] = { 16384, 65536, 262144 };
+
+/* Bytes in MB, for throughput */
+static constexpr double BENCH_BYTES_PER_MB = 1000000.0;
+
+/* Benchmarked compression engine */
+struct BenchEngine final
+{
+
+	/* Name, used in report */
+	const char * name;
+
+	/* true, if engine uses buffer size, otherwise it runs once per level with own defaults */
+	bool usesBuffer;
+
+	/* Compress: source, destination, level, buffer size. Returns Z_OK if complete. */
+	std::function<int( std::FILE *const, std::FILE *const, const int, const std::uint32_t )> deflateFILE;
+
+	/* Decompress: source, destination, buffer size. Returns Z_OK if complete. */
+	std::function<int( std::FILE *const, std::FILE *const, const std::uint32_t )> inflateFILE;
+
+};
+
+/* Result of one measured run */
+struct BenchResult final
+{
+
+	/* Uncompressed bytes */
+	std::uint64_t inputBytes;
+
+	/* Compressed bytes */
+	std::uint64_t outputBytes;
+
+	/* Wall time, seconds */
+	double wallSeconds;
+
+	/* CPU time of all threads, seconds */
+	double cpuSeconds;
+
+	/* Peak resident set size of run (of process, if not Linux), bytes */
+	std::uint64_t peakRSS;
+
+	/* true, if run succeeded & output matched */
+	bool verified;
+
+};
\ No newline at end of file
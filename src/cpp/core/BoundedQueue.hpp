@@ -0,0 +1,221 @@
+/*
+* Copyright  2018 Denis Zyamaev (code4un@yandex.ru) All rights reserved.
+* Authors: Denis Zyamaev (code4un@yandex.ru)
+* All rights reserved.
+* API: C++ 11
+* License: see LICENSE.txt
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+* 1. Redistributions of source code must retain the above copyright notice,
+* this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must display the names 'Denis Zyamaev' and
+* in the credits of the application, if such credits exist.
+* The authors of this work must be notified via email (code4un@yandex.ru) in
+* this case of redistribution.
+* 3. Neither the name of copyright holders nor the names of its contributors
+* may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS
+* IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+* PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+// Include 'pch_cxx'
+#include "../pch_cxx.hpp"
+
+namespace c0de4un
+{
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Types
+	// ===========================================================
+
+	/*
+	  * BoundedQueue - fixed-capacity ring-buffer, blocking producers
+	  * when full and consumers when empty.
+	  *
+	  * @language C++ 17
+	  *
+	  * @authors Z. Denis (c0de4un@yandex.ru)
+	  * @version 1.0
+	 */
+	template <typename T>
+	class BoundedQueue final
+	{
+
+	private:
+
+		// -------------------------------------------------------- \\
+
+		// ===========================================================
+		// Fields
+		// ===========================================================
+
+		/* Ring-buffer storage */
+		std::vector<T> mItems;
+
+		/* Index of the first item */
+		std::size_t mHead;
+
+		/* Number of items */
+		std::size_t mSize;
+
+		/* Closed-flag */
+		bool mClosed;
+
+		/* Items mutex */
+		std::mutex mMutex;
+
+		/* Signaled when item removed or queue closed */
+		std::condition_variable mNotFull;
+
+		/* Signaled when item added or queue closed */
+		std::condition_variable mNotEmpty;
+
+		// -------------------------------------------------------- \\
+
+	public:
+
+		// -------------------------------------------------------- \\
+
+		// ===========================================================
+		// Constructor & destructor
+		// ===========================================================
+
+		/*
+		 * BoundedQueue constructor.
+		 *
+		 * @param capacity - max number of items, at least 1.
+		 * @throws - can throw exception (bad_alloc).
+		*/
+		explicit BoundedQueue( const std::size_t capacity )
+			: mItems( std::max<std::size_t>( capacity, 1 ) ),
+			mHead( 0 ),
+			mSize( 0 ),
+			mClosed( false ),
+			mMutex( ),
+			mNotFull( ),
+			mNotEmpty( )
+		{
+		}
+
+		/* @deleted BoundedQueue copy-constructor */
+		BoundedQueue( const BoundedQueue & ) = delete;
+
+		/* @deleted BoundedQueue copy-assignment */
+		BoundedQueue & operator=( const BoundedQueue & ) = delete;
+
+		// ===========================================================
+		// Methods
+		// ===========================================================
+
+		/*
+		 * Adds item, waits while queue is full.
+		 *
+		 * @thread_safety - thread-safe.
+		 * @param pItem - item to add.
+		 * @return - false if queue is closed, item is not added.
+		*/
+		bool push( T pItem )
+		{
+
+			// Lock
+			std::unique_lock<std::mutex> itemsLock( mMutex );
+
+			// Wait for free slot
+			mNotFull.wait( itemsLock, [this]( ) { return( mClosed || mSize < mItems.size( ) ); } );
+
+			// Cancel, if closed
+			if ( mClosed )
+				return( false );
+
+			// Add
+			mItems[( mHead + mSize ) % mItems.size( )] = std::move( pItem );
+			mSize++;
+
+			// Unlock & wake-up consumer
+			itemsLock.unlock( );
+			mNotEmpty.notify_one( );
+
+			// Return OK
+			return( true );
+
+		}
+
+		/*
+		 * Removes first item, waits while queue is empty.
+		 *
+		 * @thread_safety - thread-safe.
+		 * @param pItem - receives item.
+		 * @return - false if queue is closed & empty.
+		*/
+		bool pop( T & pItem )
+		{
+
+			// Lock
+			std::unique_lock<std::mutex> itemsLock( mMutex );
+
+			// Wait for item
+			mNotEmpty.wait( itemsLock, [this]( ) { return( mClosed || mSize > 0 ); } );
+
+			// Cancel, if closed & empty
+			if ( mSize == 0 )
+				return( false );
+
+			// Remove
+			pItem = std::move( mItems[mHead] );
+			mHead = ( mHead + 1 ) % mItems.size( );
+			mSize--;
+
+			// Unlock & wake-up producer
+			itemsLock.unlock( );
+			mNotFull.notify_one( );
+
+			// Return OK
+			return( true );
+
+		}
+
+		/*
+		 * Closes queue. Blocked & further push calls fail,
+		 * pop calls return remaining items, then fail.
+		 *
+		 * @thread_safety - thread-safe.
+		*/
+		void close( )
+		{
+
+			// Set closed-flag
+			{
+				std::lock_guard<std::mutex> itemsLock( mMutex );
+				mClosed = true;
+			}
+
+			// Wake-up all
+			mNotFull.notify_all( );
+			mNotEmpty.notify_all( );
+
+		}
+
+		// -------------------------------------------------------- \\
+
+	};
+
+	// -------------------------------------------------------- \\
+
+}
\ No newline at end of file
@@ -0,0 +1,294 @@
+/*
+* Copyright  2018 Denis Zyamaev (code4un@yandex.ru) All rights reserved.
+* Authors: Denis Zyamaev (code4un@yandex.ru)
+* All rights reserved.
+* API: C++ 11
+* License: see LICENSE.txt
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+* 1. Redistributions of source code must retain the above copyright notice,
+* this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must display the names 'Denis Zyamaev' and
+* in the credits of the application, if such credits exist.
+* The authors of this work must be notified via email (code4un@yandex.ru) in
+* this case of redistribution.
+* 3. Neither the name of copyright holders nor the names of its contributors
+* may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS
+* IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+* PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// HEADER
+#include "MemoryBudget.hpp"
+
+namespace c0de4un
+{
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Lease
+	// ===========================================================
+
+	/*
+	 * Lease constructor, waits for memory.
+	 *
+	 * @param pBudget - budget, null for no limit.
+	 * @param pSize - number of bytes.
+	*/
+	MemoryBudget::Lease::Lease( MemoryBudget *const pBudget, const std::uint64_t pSize )
+		: mBudget( pBudget ),
+		mSize( pBudget != nullptr && pSize > 0 ? pBudget->acquire( pSize ) : 0 )
+	{
+	}
+
+	/* Lease destructor, releases memory */
+	MemoryBudget::Lease::~Lease( )
+	{
+
+		if ( mBudget != nullptr && mSize > 0 )
+			mBudget->release( mSize );
+
+	}
+
+	// ===========================================================
+	// Constructor & destructor
+	// ===========================================================
+
+	/*
+	 * MemoryBudget constructor.
+	 *
+	 * @param pLimit - limit, in bytes.
+	*/
+	MemoryBudget::MemoryBudget( const std::uint64_t pLimit ) noexcept
+		: mLimit( std::max<std::uint64_t>( pLimit, 1 ) ),
+		mUsed( 0 ),
+		mPeak( 0 ),
+		mMutex( ),
+		mReleased( )
+	{
+	}
+
+	// ===========================================================
+	// Getters
+	// ===========================================================
+
+	/* Returns limit, in bytes */
+	std::uint64_t MemoryBudget::getLimit( ) const noexcept
+	{ return( mLimit ); }
+
+	/* Returns number of bytes, that are not acquired */
+	std::uint64_t MemoryBudget::getAvailable( ) const noexcept
+	{
+
+		std::lock_guard<std::mutex> budgetLock( mMutex );
+
+		return( mLimit - mUsed );
+
+	}
+
+	/* Returns max number of acquired bytes */
+	std::uint64_t MemoryBudget::getPeak( ) const noexcept
+	{
+
+		std::lock_guard<std::mutex> budgetLock( mMutex );
+
+		return( mPeak );
+
+	}
+
+	// ===========================================================
+	// Methods
+	// ===========================================================
+
+	/*
+	 * Returns memory of deflate z_stream.
+	 *
+	 * @param windowBits - window-bits, without wrapper offset.
+	 * @param memLevel - mem-level.
+	*/
+	std::uint64_t MemoryBudget::getDeflateSize( const int windowBits, const int memLevel ) noexcept
+	{
+
+		// zlib: window & previous-links (4 << windowBits), hash-head & pending-buffer (1 << (memLevel + 9))
+		return( ( static_cast<std::uint64_t>( 1 ) << ( windowBits + 2 ) ) + ( static_cast<std::uint64_t>( 1 ) << ( memLevel + 9 ) ) + STATE_SIZE );
+
+	}
+
+	/*
+	 * Returns memory of inflate z_stream.
+	 *
+	 * @param windowBits - window-bits, without wrapper offset.
+	*/
+	std::uint64_t MemoryBudget::getInflateSize( const int windowBits ) noexcept
+	{ return( ( static_cast<std::uint64_t>( 1 ) << windowBits ) + STATE_SIZE ); }
+
+	/*
+	 * Returns memory of stream with plan settings: z_stream & buffers.
+	 *
+	 * @param pPlan - settings.
+	 * @param forInflate - true for inflate, deflate otherwise.
+	*/
+	std::uint64_t MemoryBudget::getStreamSize( const Plan & pPlan, const bool forInflate ) noexcept
+	{ return( ( forInflate ? getInflateSize( pPlan.windowBits ) : getDeflateSize( pPlan.windowBits, pPlan.memLevel ) ) + static_cast<std::uint64_t>( pPlan.bufferSize ) * 2 ); }
+
+	/*
+	 * Parse size: number with optional K, M or G suffix ("512M").
+	 *
+	 * @param pText - size.
+	 * @return - size in bytes, 0 if not a size.
+	*/
+	std::uint64_t MemoryBudget::parseSize( const char *const pText ) noexcept
+	{
+
+		// Check
+		if ( pText == nullptr || *pText < '0' || *pText > '9' )
+			return( 0 );
+
+		// Number
+		char * suffix( nullptr );
+		const unsigned long long number( std::strtoull( pText, &suffix, 10 ) );
+
+		// Suffix, optionally followed by 'B'
+		std::uint32_t shift( 0 );
+		switch ( *suffix )
+		{
+
+		case 'k': case 'K':
+			shift = 10;
+			suffix++;
+			break;
+
+		case 'm': case 'M':
+			shift = 20;
+			suffix++;
+			break;
+
+		case 'g': case 'G':
+			shift = 30;
+			suffix++;
+			break;
+
+		}
+
+		if ( *suffix == 'b' || *suffix == 'B' )
+			suffix++;
+
+		// Trailing characters or overflow
+		if ( *suffix != '\0' || number > ( UINT64_MAX >> shift ) )
+			return( 0 );
+
+		// Return
+		return( static_cast<std::uint64_t>( number ) << shift );
+
+	}
+
+	/*
+	 * Returns settings of streams, that fit into available memory.
+	 * Inflate window is not reduced, it's set by compressed data.
+	 *
+	 * @thread_safety - thread-safe.
+	 * @param threadsCount - requested number of streams, 0 for hardware-threads.
+	 * @param bufferSize - requested size of stream buffer.
+	 * @param forInflate - true for inflate, deflate otherwise.
+	*/
+	MemoryBudget::Plan MemoryBudget::plan( const std::uint32_t threadsCount, const std::uint32_t bufferSize, const bool forInflate ) const noexcept
+	{
+
+		// Requested settings
+		Plan streamsPlan{ threadsCount > 0 ? threadsCount : std::max<std::uint32_t>( std::thread::hardware_concurrency( ), 1 ), std::max( bufferSize, MIN_BUFFER_SIZE ), MAX_WBITS, DEFAULT_MEM_LEVEL };
+
+		// Available memory
+		const std::uint64_t availableSize( getAvailable( ) );
+
+		auto fits = [&]( ) { return( getStreamSize( streamsPlan, forInflate ) * streamsPlan.threadsCount <= availableSize ); };
+
+		// Smaller buffers, more reads
+		while ( !fits( ) && streamsPlan.bufferSize > MIN_BUFFER_SIZE )
+			streamsPlan.bufferSize = std::max( streamsPlan.bufferSize / 2, MIN_BUFFER_SIZE );
+
+		// Smaller hash-table, slightly worse ratio
+		while ( !fits( ) && !forInflate && streamsPlan.memLevel > REDUCED_MEM_LEVEL )
+			streamsPlan.memLevel--;
+
+		// Less streams
+		if ( !fits( ) )
+			streamsPlan.threadsCount = static_cast<std::uint32_t>( std::max<std::uint64_t>( availableSize / getStreamSize( streamsPlan, forInflate ), 1 ) );
+
+		// Smaller window & hash-table for the only stream
+		while ( !fits( ) && !forInflate && ( streamsPlan.windowBits > MIN_WINDOW_BITS || streamsPlan.memLevel > MIN_MEM_LEVEL ) )
+		{
+			streamsPlan.windowBits = std::max( streamsPlan.windowBits - 1, MIN_WINDOW_BITS );
+			streamsPlan.memLevel = std::max( streamsPlan.memLevel - 1, MIN_MEM_LEVEL );
+		}
+
+		// Return
+		return( streamsPlan );
+
+	}
+
+	/*
+	 * Acquire memory, wait while it's not available.
+	 * Size larger than the limit waits for all memory.
+	 *
+	 * @thread_safety - thread-safe.
+	 * @param pSize - number of bytes.
+	 * @return - acquired size, pass it to release.
+	*/
+	std::uint64_t MemoryBudget::acquire( const std::uint64_t pSize )
+	{
+
+		// Size, that can be acquired
+		const std::uint64_t acquireSize( std::min( pSize, mLimit ) );
+
+		// Lock
+		std::unique_lock<std::mutex> budgetLock( mMutex );
+
+		// Wait
+		mReleased.wait( budgetLock, [&]( ) { return( mUsed + acquireSize <= mLimit ); } );
+
+		// Acquire
+		mUsed += acquireSize;
+		mPeak = std::max( mPeak, mUsed );
+
+		// Return
+		return( acquireSize );
+
+	}
+
+	/*
+	 * Release acquired memory.
+	 *
+	 * @thread_safety - thread-safe.
+	 * @param pSize - size, returned by acquire.
+	*/
+	void MemoryBudget::release( const std::uint64_t pSize ) noexcept
+	{
+
+		// Release
+		{
+			std::lock_guard<std::mutex> budgetLock( mMutex );
+			mUsed -= std::min( pSize, mUsed );
+		}
+
+		// Wake waiting jobs
+		mReleased.notify_all( );
+
+	}
+
+	// -------------------------------------------------------- \\
+
+}
\ No newline at end of file
@@ -0,0 +1,297 @@
+/*
+* Copyright  2018 Denis Zyamaev (code4un@yandex.ru) All rights reserved.
+* Authors: Denis Zyamaev (code4un@yandex.ru)
+* All rights reserved.
+* API: C++ 11
+* License: see LICENSE.txt
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+* 1. Redistributions of source code must retain the above copyright notice,
+* this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must display the names 'Denis Zyamaev' and
+* in the credits of the application, if such credits exist.
+* The authors of this work must be notified via email (code4un@yandex.ru) in
+* this case of redistribution.
+* 3. Neither the name of copyright holders nor the names of its contributors
+* may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS
+* IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+* PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+// Include 'pch_cxx'
+#include "../pch_cxx.hpp"
+
+namespace c0de4un
+{
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Types
+	// ===========================================================
+
+	/*
+	  * MemoryBudget - limit of memory, shared by concurrent jobs.
+	  *
+	  * Before start, engine asks for a plan: number of streams, size of
+	  * their buffers & deflate memory (window-bits, mem-level), that fit
+	  * into available memory. Buffers shrink first, then hash-table, then
+	  * number of streams, window shrinks only for a single stream.
+	  *
+	  * Jobs acquire their memory before allocating it & wait, while
+	  * budget is exhausted. Job larger than the limit runs alone.
+	  *
+	  * @language C++ 17
+	  *
+	  * @authors Z. Denis (c0de4un@yandex.ru)
+	  * @version 1.0
+	 */
+	class MemoryBudget final
+	{
+
+	public:
+
+		// -------------------------------------------------------- \\
+
+		// ===========================================================
+		// Types
+		// ===========================================================
+
+		/* Settings of concurrent streams */
+		struct Plan final
+		{
+
+			/* Number of streams */
+			std::uint32_t threadsCount;
+
+			/* Size of each input & output buffer */
+			std::uint32_t bufferSize;
+
+			/* deflateInit2 window-bits, without wrapper offset */
+			int windowBits;
+
+			/* deflateInit2 mem-level */
+			int memLevel;
+
+		};
+
+		/*
+		  * Lease - acquired memory, released by destructor.
+		 */
+		class Lease final
+		{
+
+		private:
+
+			// -------------------------------------------------------- \\
+
+			// ===========================================================
+			// Fields
+			// ===========================================================
+
+			/* Budget, can be null */
+			MemoryBudget * mBudget;
+
+			/* Acquired size */
+			std::uint64_t mSize;
+
+			// -------------------------------------------------------- \\
+
+		public:
+
+			// -------------------------------------------------------- \\
+
+			// ===========================================================
+			// Constructor & destructor
+			// ===========================================================
+
+			/*
+			 * Lease constructor, waits for memory.
+			 *
+			 * @param pBudget - budget, null for no limit.
+			 * @param pSize - number of bytes.
+			*/
+			explicit Lease( MemoryBudget *const pBudget, const std::uint64_t pSize );
+
+			/* Lease destructor, releases memory */
+			~Lease( );
+
+			/* @deleted Lease copy-constructor */
+			Lease( const Lease & ) = delete;
+
+			/* @deleted Lease copy-assignment */
+			Lease & operator=( const Lease & ) = delete;
+
+			// -------------------------------------------------------- \\
+
+		};
+
+		// ===========================================================
+		// Constants
+		// ===========================================================
+
+		/* Min size of stream buffer */
+		static constexpr std::uint32_t MIN_BUFFER_SIZE = 16384;
+
+		/* deflateInit default mem-level */
+		static constexpr int DEFAULT_MEM_LEVEL = 8;
+
+		/* Mem-level, to which hash-table shrinks before streams count is reduced */
+		static constexpr int REDUCED_MEM_LEVEL = 6;
+
+		/* Min deflate mem-level */
+		static constexpr int MIN_MEM_LEVEL = 2;
+
+		/* Min deflate window-bits, zlib raises 8 to 9 */
+		static constexpr int MIN_WINDOW_BITS = 9;
+
+		/* Size of deflate or inflate state, besides window & hash-table */
+		static constexpr std::uint64_t STATE_SIZE = 8192;
+
+		// -------------------------------------------------------- \\
+
+	private:
+
+		// -------------------------------------------------------- \\
+
+		// ===========================================================
+		// Fields
+		// ===========================================================
+
+		/* Limit, in bytes */
+		const std::uint64_t mLimit;
+
+		/* Acquired bytes */
+		std::uint64_t mUsed;
+
+		/* Max of acquired bytes */
+		std::uint64_t mPeak;
+
+		/* Budget mutex */
+		mutable std::mutex mMutex;
+
+		/* Signaled when memory released */
+		std::condition_variable mReleased;
+
+		// -------------------------------------------------------- \\
+
+	public:
+
+		// -------------------------------------------------------- \\
+
+		// ===========================================================
+		// Constructor & destructor
+		// ===========================================================
+
+		/*
+		 * MemoryBudget constructor.
+		 *
+		 * @param pLimit - limit, in bytes.
+		*/
+		explicit MemoryBudget( const std::uint64_t pLimit ) noexcept;
+
+		/* @deleted MemoryBudget copy-constructor */
+		MemoryBudget( const MemoryBudget & ) = delete;
+
+		/* @deleted MemoryBudget copy-assignment */
+		MemoryBudget & operator=( const MemoryBudget & ) = delete;
+
+		// ===========================================================
+		// Getters
+		// ===========================================================
+
+		/* Returns limit, in bytes */
+		std::uint64_t getLimit( ) const noexcept;
+
+		/* Returns number of bytes, that are not acquired */
+		std::uint64_t getAvailable( ) const noexcept;
+
+		/* Returns max number of acquired bytes */
+		std::uint64_t getPeak( ) const noexcept;
+
+		// ===========================================================
+		// Methods
+		// ===========================================================
+
+		/*
+		 * Returns memory of deflate z_stream.
+		 *
+		 * @param windowBits - window-bits, without wrapper offset.
+		 * @param memLevel - mem-level.
+		*/
+		static std::uint64_t getDeflateSize( const int windowBits, const int memLevel ) noexcept;
+
+		/*
+		 * Returns memory of inflate z_stream.
+		 *
+		 * @param windowBits - window-bits, without wrapper offset.
+		*/
+		static std::uint64_t getInflateSize( const int windowBits ) noexcept;
+
+		/*
+		 * Returns memory of stream with plan settings: z_stream & buffers.
+		 *
+		 * @param pPlan - settings.
+		 * @param forInflate - true for inflate, deflate otherwise.
+		*/
+		static std::uint64_t getStreamSize( const Plan & pPlan, const bool forInflate ) noexcept;
+
+		/*
+		 * Parse size: number with optional K, M or G suffix ("512M").
+		 *
+		 * @param pText - size.
+		 * @return - size in bytes, 0 if not a size.
+		*/
+		static std::uint64_t parseSize( const char *const pText ) noexcept;
+
+		/*
+		 * Returns settings of streams, that fit into available memory.
+		 * Inflate window is not reduced, it's set by compressed data.
+		 *
+		 * @thread_safety - thread-safe.
+		 * @param threadsCount - requested number of streams, 0 for hardware-threads.
+		 * @param bufferSize - requested size of stream buffer.
+		 * @param forInflate - true for inflate, deflate otherwise.
+		*/
+		Plan plan( const std::uint32_t threadsCount, const std::uint32_t bufferSize, const bool forInflate ) const noexcept;
+
+		/*
+		 * Acquire memory, wait while it's not available.
+		 * Size larger than the limit waits for all memory.
+		 *
+		 * @thread_safety - thread-safe.
+		 * @param pSize - number of bytes.
+		 * @return - acquired size, pass it to release.
+		*/
+		std::uint64_t acquire( const std::uint64_t pSize );
+
+		/*
+		 * Release acquired memory.
+		 *
+		 * @thread_safety - thread-safe.
+		 * @param pSize - size, returned by acquire.
+		*/
+		void release( const std::uint64_t pSize ) noexcept;
+
+		// -------------------------------------------------------- \\
+
+	};
+
+	// -------------------------------------------------------- \\
+
+}
\ No newline at end of file
@@ -0,0 +1,166 @@
+/*
+* Copyright  2018 Denis Zyamaev (code4un@yandex.ru) All rights reserved.
+* Authors: Denis Zyamaev (code4un@yandex.ru)
+* All rights reserved.
+* API: C++ 11
+* License: see LICENSE.txt
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+* 1. Redistributions of source code must retain the above copyright notice,
+* this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must display the names 'Denis Zyamaev' and
+* in the credits of the application, if such credits exist.
+* The authors of this work must be notified via email (code4un@yandex.ru) in
+* this case of redistribution.
+* 3. Neither the name of copyright holders nor the names of its contributors
+* may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS
+* IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+* PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// HEADER
+#include "ThreadPool.hpp"
+
+namespace c0de4un
+{
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Constructor & destructor
+	// ===========================================================
+
+	/*
+	 * ThreadPool constructor.
+	 *
+	 * @param threadsCount - number of worker-threads. If 0,
+	 * std::thread::hardware_concurrency is used.
+	 * @throws - can throw exception (system_error).
+	*/
+	ThreadPool::ThreadPool( const std::uint32_t threadsCount )
+		: mThreads( ),
+		mTasks( ),
+		mTasksMutex( ),
+		mTasksCondition( ),
+		mStopped( false )
+	{
+
+		// Number of threads to start
+		const std::uint32_t threadsToStart( threadsCount > 0 ? threadsCount : getHardwareThreadsCount( ) );
+
+		// Reserve
+		mThreads.reserve( threadsToStart );
+
+		// Start worker-threads
+		for ( std::uint32_t i = 0; i < threadsToStart; i++ )
+			mThreads.emplace_back( &ThreadPool::workerLoop, this );
+
+	}
+
+	/* ThreadPool destructor. Completes pending tasks & joins worker-threads. */
+	ThreadPool::~ThreadPool( )
+	{
+
+		// Stop
+		{
+			std::lock_guard<std::mutex> tasksLock( mTasksMutex );
+			mStopped = true;
+		}
+
+		// Wake-up all workers
+		mTasksCondition.notify_all( );
+
+		// Join worker-threads
+		for ( std::thread & workerThread : mThreads )
+		{
+
+			if ( workerThread.joinable( ) )
+				workerThread.join( );
+
+		}
+
+	}
+
+	// ===========================================================
+	// Getters
+	// ===========================================================
+
+	/*
+	 * Returns number of worker-threads.
+	 *
+	 * @thread_safety - thread-safe.
+	*/
+	std::uint32_t ThreadPool::getThreadsCount( ) const noexcept
+	{ return( static_cast<std::uint32_t>( mThreads.size( ) ) ); }
+
+	/*
+	 * Returns number of hardware-threads, at least 1.
+	 *
+	 * @thread_safety - thread-safe.
+	*/
+	std::uint32_t ThreadPool::getHardwareThreadsCount( ) noexcept
+	{
+
+		// Get hardware-threads, 0 if not computable
+		const std::uint32_t hardwareThreads( std::thread::hardware_concurrency( ) );
+
+		// Return
+		return( hardwareThreads > 0 ? hardwareThreads : 1 );
+
+	}
+
+	// ===========================================================
+	// Methods
+	// ===========================================================
+
+	/*
+	 * Worker-thread loop. Executes tasks until pool is stopped
+	 * and tasks queue is empty.
+	*/
+	void ThreadPool::workerLoop( )
+	{
+
+		// Task to execute
+		std::function<void( )> task;
+
+		// Run
+		while ( true )
+		{
+
+			// Wait for task
+			{
+				std::unique_lock<std::mutex> tasksLock( mTasksMutex );
+				mTasksCondition.wait( tasksLock, [this]( ) { return( mStopped || !mTasks.empty( ) ); } );
+
+				// Stop, when no tasks left
+				if ( mTasks.empty( ) )
+					return;
+
+				// Take task
+				task = std::move( mTasks.front( ) );
+				mTasks.pop_front( );
+			}
+
+			// Execute task. Exceptions are stored in the task future.
+			task( );
+
+		}
+
+	}
+
+	// -------------------------------------------------------- \\
+
+}
\ No newline at end of file
@@ -0,0 +1,184 @@
+/*
+* Copyright  2018 Denis Zyamaev (code4un@yandex.ru) All rights reserved.
+* Authors: Denis Zyamaev (code4un@yandex.ru)
+* All rights reserved.
+* API: C++ 11
+* License: see LICENSE.txt
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+* 1. Redistributions of source code must retain the above copyright notice,
+* this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must display the names 'Denis Zyamaev' and
+* in the credits of the application, if such credits exist.
+* The authors of this work must be notified via email (code4un@yandex.ru) in
+* this case of redistribution.
+* 3. Neither the name of copyright holders nor the names of its contributors
+* may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS
+* IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+* PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+// Include 'pch_cxx'
+#include "../pch_cxx.hpp"
+
+namespace c0de4un
+{
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Types
+	// ===========================================================
+
+	/*
+	  * ThreadPool - fixed-size pool of worker-threads, executing
+	  * submitted tasks in FIFO order.
+	  *
+	  * @language C++ 17
+	  *
+	  * @authors Z. Denis (c0de4un@yandex.ru)
+	  * @version 1.0
+	 */
+	class ThreadPool final
+	{
+
+	private:
+
+		// -------------------------------------------------------- \\
+
+		// ===========================================================
+		// Fields
+		// ===========================================================
+
+		/* Worker-threads */
+		std::vector<std::thread> mThreads;
+
+		/* Pending tasks */
+		std::deque<std::function<void( )>> mTasks;
+
+		/* Tasks mutex */
+		std::mutex mTasksMutex;
+
+		/* Signaled when task added or pool stopped */
+		std::condition_variable mTasksCondition;
+
+		/* Stop-flag, guarded by mTasksMutex */
+		bool mStopped;
+
+		// ===========================================================
+		// Methods
+		// ===========================================================
+
+		/*
+		 * Worker-thread loop. Executes tasks until pool is stopped
+		 * and tasks queue is empty.
+		*/
+		void workerLoop( );
+
+		// -------------------------------------------------------- \\
+
+	public:
+
+		// -------------------------------------------------------- \\
+
+		// ===========================================================
+		// Constructor & destructor
+		// ===========================================================
+
+		/*
+		 * ThreadPool constructor.
+		 *
+		 * @param threadsCount - number of worker-threads. If 0,
+		 * std::thread::hardware_concurrency is used.
+		 * @throws - can throw exception (system_error).
+		*/
+		explicit ThreadPool( const std::uint32_t threadsCount = 0 );
+
+		/* ThreadPool destructor. Completes pending tasks & joins worker-threads. */
+		~ThreadPool( );
+
+		/* @deleted ThreadPool copy-constructor */
+		ThreadPool( const ThreadPool & ) = delete;
+
+		/* @deleted ThreadPool copy-assignment */
+		ThreadPool & operator=( const ThreadPool & ) = delete;
+
+		// ===========================================================
+		// Getters
+		// ===========================================================
+
+		/*
+		 * Returns number of worker-threads.
+		 *
+		 * @thread_safety - thread-safe.
+		*/
+		std::uint32_t getThreadsCount( ) const noexcept;
+
+		/*
+		 * Returns number of hardware-threads, at least 1.
+		 *
+		 * @thread_safety - thread-safe.
+		*/
+		static std::uint32_t getHardwareThreadsCount( ) noexcept;
+
+		// ===========================================================
+		// Methods
+		// ===========================================================
+
+		/*
+		 * Adds task to the queue.
+		 *
+		 * @thread_safety - thread-safe.
+		 * @param pTask - callable without arguments.
+		 * @return - future, to get task result or exception.
+		 * @throws - can throw exception (bad_alloc).
+		*/
+		template <typename F>
+		std::future<std::invoke_result_t<F>> submit( F && pTask )
+		{
+
+			// Result type
+			using result_t = std::invoke_result_t<F>;
+
+			// Wrap task, std::function requires copyable target
+			auto packagedTask( std::make_shared<std::packaged_task<result_t( )>>( std::forward<F>( pTask ) ) );
+
+			// Get future before task can be executed
+			std::future<result_t> taskFuture( packagedTask->get_future( ) );
+
+			// Add task
+			{
+				std::lock_guard<std::mutex> tasksLock( mTasksMutex );
+				mTasks.emplace_back( [packagedTask]( ) { ( *packagedTask )( ); } );
+			}
+
+			// Wake-up worker
+			mTasksCondition.notify_one( );
+
+			// Return future
+			return( taskFuture );
+
+		}
+
+		// -------------------------------------------------------- \\
+
+	};
+
+	// -------------------------------------------------------- \\
+
+}
\ No newline at end of file
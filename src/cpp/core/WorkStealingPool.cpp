@@ -0,0 +1,300 @@
+/*
+* Copyright  2018 Denis Zyamaev (code4un@yandex.ru) All rights reserved.
+* Authors: Denis Zyamaev (code4un@yandex.ru)
+* All rights reserved.
+* API: C++ 11
+* License: see LICENSE.txt
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+* 1. Redistributions of source code must retain the above copyright notice,
+* this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must display the names 'Denis Zyamaev' and
+* in the credits of the application, if such credits exist.
+* The authors of this work must be notified via email (code4un@yandex.ru) in
+* this case of redistribution.
+* 3. Neither the name of copyright holders nor the names of its contributors
+* may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS
+* IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+* PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// HEADER
+#include "WorkStealingPool.hpp"
+
+namespace c0de4un
+{
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Fields
+	// ===========================================================
+
+	/* Pool of the calling thread, if it is a worker-thread */
+	thread_local const WorkStealingPool * WorkStealingPool::mCurrentPool( nullptr );
+
+	/* Worker-index of the calling thread */
+	thread_local std::uint32_t WorkStealingPool::mCurrentWorker( WorkStealingPool::NO_WORKER );
+
+	// ===========================================================
+	// Constructor & destructor
+	// ===========================================================
+
+	/*
+	 * WorkStealingPool constructor.
+	 *
+	 * @param threadsCount - number of worker-threads. If 0,
+	 * std::thread::hardware_concurrency is used.
+	 * @throws - can throw exception (system_error).
+	*/
+	WorkStealingPool::WorkStealingPool( const std::uint32_t threadsCount )
+		: mThreads( ),
+		mWorkerQueues( ),
+		mSharedQueue( ),
+		mPendingCount( 0 ),
+		mWakeMutex( ),
+		mWakeCondition( ),
+		mStopped( false )
+	{
+
+		// Number of threads to start
+		const std::uint32_t hardwareThreads( std::thread::hardware_concurrency( ) );
+		const std::uint32_t threadsToStart( threadsCount > 0 ? threadsCount : ( hardwareThreads > 0 ? hardwareThreads : 1 ) );
+
+		// Queues, created before threads start
+		mWorkerQueues.reserve( threadsToStart );
+		for ( std::uint32_t i = 0; i < threadsToStart; i++ )
+			mWorkerQueues.emplace_back( std::make_unique<TaskQueue>( ) );
+
+		// Start worker-threads
+		mThreads.reserve( threadsToStart );
+		for ( std::uint32_t i = 0; i < threadsToStart; i++ )
+			mThreads.emplace_back( &WorkStealingPool::workerLoop, this, i );
+
+	}
+
+	/* WorkStealingPool destructor. Completes pending tasks & joins worker-threads. */
+	WorkStealingPool::~WorkStealingPool( )
+	{
+
+		// Stop
+		{
+			std::lock_guard<std::mutex> wakeLock( mWakeMutex );
+			mStopped = true;
+		}
+
+		// Wake-up all workers
+		mWakeCondition.notify_all( );
+
+		// Join worker-threads
+		for ( std::thread & workerThread : mThreads )
+		{
+
+			if ( workerThread.joinable( ) )
+				workerThread.join( );
+
+		}
+
+	}
+
+	// ===========================================================
+	// Getters
+	// ===========================================================
+
+	/*
+	 * Returns number of worker-threads.
+	 *
+	 * @thread_safety - thread-safe.
+	*/
+	std::uint32_t WorkStealingPool::getThreadsCount( ) const noexcept
+	{ return( static_cast<std::uint32_t>( mThreads.size( ) ) ); }
+
+	/*
+	 * Returns index of the calling worker-thread, NO_WORKER if called not by this pool's worker.
+	 *
+	 * @thread_safety - thread-safe.
+	*/
+	std::uint32_t WorkStealingPool::getWorkerIndex( ) const noexcept
+	{ return( mCurrentPool == this ? mCurrentWorker : NO_WORKER ); }
+
+	// ===========================================================
+	// Methods
+	// ===========================================================
+
+	/*
+	 * Worker-thread loop. Executes tasks until pool is stopped
+	 * and all queues are empty.
+	 *
+	 * @param workerIndex - index of worker.
+	*/
+	void WorkStealingPool::workerLoop( const std::uint32_t workerIndex )
+	{
+
+		// Bind thread to worker
+		mCurrentPool = this;
+		mCurrentWorker = workerIndex;
+
+		// Task to execute
+		std::function<void( )> task;
+
+		// Run
+		while ( true )
+		{
+
+			// Execute task. Exceptions are stored in the task future.
+			if ( take( task, true ) )
+			{
+				task( );
+				task = nullptr;
+				continue;
+			}
+
+			// Wait for task
+			std::unique_lock<std::mutex> wakeLock( mWakeMutex );
+			mWakeCondition.wait( wakeLock, [this]( ) { return( mStopped || mPendingCount.load( ) > 0 ); } );
+
+			// Stop, when no tasks left
+			if ( mStopped && mPendingCount.load( ) == 0 )
+				return;
+
+		}
+
+	}
+
+	/*
+	 * Add task to the queue of calling worker, or to the shared queue.
+	 *
+	 * @thread_safety - thread-safe.
+	 * @param pTask - task.
+	 * @throws - can throw exception (bad_alloc).
+	*/
+	void WorkStealingPool::push( std::function<void( )> && pTask )
+	{
+
+		// Queue of calling worker, shared otherwise
+		const std::uint32_t workerIndex( getWorkerIndex( ) );
+		TaskQueue & taskQueue( workerIndex != NO_WORKER ? *mWorkerQueues[workerIndex] : mSharedQueue );
+
+		// Add task
+		{
+			std::lock_guard<std::mutex> tasksLock( taskQueue.mutex );
+			taskQueue.tasks.emplace_back( std::move( pTask ) );
+		}
+
+		mPendingCount++;
+
+		// Wake-up worker
+		{
+			std::lock_guard<std::mutex> wakeLock( mWakeMutex );
+		}
+
+		mWakeCondition.notify_one( );
+
+	}
+
+	/*
+	 * Take task: from own queue, shared queue, or other worker's queue.
+	 *
+	 * @thread_safety - thread-safe.
+	 * @param pTask - receives task.
+	 * @param useShared - false to take sub-tasks only.
+	 * @return - false, if no tasks.
+	*/
+	bool WorkStealingPool::take( std::function<void( )> & pTask, const bool useShared )
+	{
+
+		// Nothing to take
+		if ( mPendingCount.load( ) == 0 )
+			return( false );
+
+		const std::uint32_t workerIndex( getWorkerIndex( ) );
+		const std::uint32_t workersCount( static_cast<std::uint32_t>( mWorkerQueues.size( ) ) );
+
+		// Take task from queue
+		auto takeFrom = [&]( TaskQueue & pQueue, const bool pNewest )
+		{
+
+			std::lock_guard<std::mutex> tasksLock( pQueue.mutex );
+
+			if ( pQueue.tasks.empty( ) )
+				return( false );
+
+			// Newest sub-task of own queue, oldest of others
+			if ( pNewest )
+			{
+				pTask = std::move( pQueue.tasks.back( ) );
+				pQueue.tasks.pop_back( );
+			}
+			else
+			{
+				pTask = std::move( pQueue.tasks.front( ) );
+				pQueue.tasks.pop_front( );
+			}
+
+			mPendingCount--;
+
+			return( true );
+
+		};
+
+		// Own queue
+		if ( workerIndex != NO_WORKER && takeFrom( *mWorkerQueues[workerIndex], true ) )
+			return( true );
+
+		// Shared queue
+		if ( useShared && takeFrom( mSharedQueue, false ) )
+			return( true );
+
+		// Steal from other workers, starting from the next one
+		for ( std::uint32_t i = 1; i <= workersCount; i++ )
+		{
+
+			const std::uint32_t victimIndex( workerIndex != NO_WORKER ? ( workerIndex + i ) % workersCount : i - 1 );
+
+			if ( victimIndex != workerIndex && takeFrom( *mWorkerQueues[victimIndex], false ) )
+				return( true );
+
+		}
+
+		// No tasks
+		return( false );
+
+	}
+
+	/*
+	 * Execute one pending sub-task on the calling thread.
+	 *
+	 * @thread_safety - thread-safe.
+	 * @return - false, if no sub-tasks.
+	*/
+	bool WorkStealingPool::runPendingTask( )
+	{
+
+		std::function<void( )> task;
+
+		// Sub-tasks only, so waiting task doesn't start other long tasks
+		if ( !take( task, false ) )
+			return( false );
+
+		task( );
+
+		return( true );
+
+	}
+
+	// -------------------------------------------------------- \\
+
+}
\ No newline at end of file
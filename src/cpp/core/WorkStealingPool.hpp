@@ -0,0 +1,291 @@
+/*
+* Copyright  2018 Denis Zyamaev (code4un@yandex.ru) All rights reserved.
+* Authors: Denis Zyamaev (code4un@yandex.ru)
+* All rights reserved.
+* API: C++ 11
+* License: see LICENSE.txt
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+* 1. Redistributions of source code must retain the above copyright notice,
+* this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must display the names 'Denis Zyamaev' and
+* in the credits of the application, if such credits exist.
+* The authors of this work must be notified via email (code4un@yandex.ru) in
+* this case of redistribution.
+* 3. Neither the name of copyright holders nor the names of its contributors
+* may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS
+* IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+* PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+// Include 'pch_cxx'
+#include "../pch_cxx.hpp"
+
+// Include C++ atomic
+#include <atomic> // std::atomic
+
+// Include C++ chrono
+#include <chrono> // std::chrono::milliseconds
+
+namespace c0de4un
+{
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Types
+	// ===========================================================
+
+	/*
+	  * WorkStealingPool - fixed-size pool of worker-threads with
+	  * per-worker task queues.
+	  *
+	  * Tasks submitted from outside go to the shared queue & are executed
+	  * in FIFO order. Tasks submitted by a worker (sub-tasks) go to the
+	  * worker's own queue. Worker takes tasks from its own queue, then
+	  * from the shared queue, then steals from the other workers, so
+	  * sub-tasks of a long task are spread over idle workers.
+	  *
+	  * A task can wait for its sub-tasks with get, which executes pending
+	  * sub-tasks while waiting, so waiting tasks don't block workers.
+	  *
+	  * @language C++ 17
+	  *
+	  * @authors Z. Denis (c0de4un@yandex.ru)
+	  * @version 1.0
+	 */
+	class WorkStealingPool final
+	{
+
+	private:
+
+		// -------------------------------------------------------- \\
+
+		// ===========================================================
+		// Types
+		// ===========================================================
+
+		/* Tasks queue */
+		struct TaskQueue final
+		{
+
+			/* Pending tasks */
+			std::deque<std::function<void( )>> tasks;
+
+			/* Tasks mutex */
+			std::mutex mutex;
+
+		};
+
+		// ===========================================================
+		// Constants
+		// ===========================================================
+
+		/* Wait interval of get, when no tasks to execute */
+		static constexpr std::chrono::milliseconds WAIT_INTERVAL = std::chrono::milliseconds( 1 );
+
+		// ===========================================================
+		// Fields
+		// ===========================================================
+
+		/* Worker-threads */
+		std::vector<std::thread> mThreads;
+
+		/* Queue of each worker */
+		std::vector<std::unique_ptr<TaskQueue>> mWorkerQueues;
+
+		/* Shared queue, for tasks submitted from outside */
+		TaskQueue mSharedQueue;
+
+		/* Number of tasks in all queues */
+		std::atomic<std::size_t> mPendingCount;
+
+		/* Wake-up mutex */
+		std::mutex mWakeMutex;
+
+		/* Signaled when task added or pool stopped */
+		std::condition_variable mWakeCondition;
+
+		/* Stop-flag, guarded by mWakeMutex */
+		bool mStopped;
+
+		/* Pool of the calling thread, if it is a worker-thread */
+		static thread_local const WorkStealingPool * mCurrentPool;
+
+		/* Worker-index of the calling thread */
+		static thread_local std::uint32_t mCurrentWorker;
+
+		// ===========================================================
+		// Methods
+		// ===========================================================
+
+		/*
+		 * Worker-thread loop. Executes tasks until pool is stopped
+		 * and all queues are empty.
+		 *
+		 * @param workerIndex - index of worker.
+		*/
+		void workerLoop( const std::uint32_t workerIndex );
+
+		/*
+		 * Add task to the queue of calling worker, or to the shared queue.
+		 *
+		 * @thread_safety - thread-safe.
+		 * @param pTask - task.
+		 * @throws - can throw exception (bad_alloc).
+		*/
+		void push( std::function<void( )> && pTask );
+
+		/*
+		 * Take task: from own queue, shared queue, or other worker's queue.
+		 *
+		 * @thread_safety - thread-safe.
+		 * @param pTask - receives task.
+		 * @param useShared - false to take sub-tasks only.
+		 * @return - false, if no tasks.
+		*/
+		bool take( std::function<void( )> & pTask, const bool useShared );
+
+		// -------------------------------------------------------- \\
+
+	public:
+
+		// -------------------------------------------------------- \\
+
+		// ===========================================================
+		// Constants
+		// ===========================================================
+
+		/* Worker-index of thread, that is not a worker */
+		static constexpr std::uint32_t NO_WORKER = UINT32_MAX;
+
+		// ===========================================================
+		// Constructor & destructor
+		// ===========================================================
+
+		/*
+		 * WorkStealingPool constructor.
+		 *
+		 * @param threadsCount - number of worker-threads. If 0,
+		 * std::thread::hardware_concurrency is used.
+		 * @throws - can throw exception (system_error).
+		*/
+		explicit WorkStealingPool( const std::uint32_t threadsCount = 0 );
+
+		/* WorkStealingPool destructor. Completes pending tasks & joins worker-threads. */
+		~WorkStealingPool( );
+
+		/* @deleted WorkStealingPool copy-constructor */
+		WorkStealingPool( const WorkStealingPool & ) = delete;
+
+		/* @deleted WorkStealingPool copy-assignment */
+		WorkStealingPool & operator=( const WorkStealingPool & ) = delete;
+
+		// ===========================================================
+		// Getters
+		// ===========================================================
+
+		/*
+		 * Returns number of worker-threads.
+		 *
+		 * @thread_safety - thread-safe.
+		*/
+		std::uint32_t getThreadsCount( ) const noexcept;
+
+		/*
+		 * Returns index of the calling worker-thread, NO_WORKER if called not by this pool's worker.
+		 *
+		 * @thread_safety - thread-safe.
+		*/
+		std::uint32_t getWorkerIndex( ) const noexcept;
+
+		// ===========================================================
+		// Methods
+		// ===========================================================
+
+		/*
+		 * Adds task. Called by worker, adds to the worker's queue, to the shared queue otherwise.
+		 *
+		 * @thread_safety - thread-safe.
+		 * @param pTask - callable without arguments.
+		 * @return - future, to get task result or exception.
+		 * @throws - can throw exception (bad_alloc).
+		*/
+		template <typename F>
+		std::future<std::invoke_result_t<F>> submit( F && pTask )
+		{
+
+			// Result type
+			using result_t = std::invoke_result_t<F>;
+
+			// Wrap task, std::function requires copyable target
+			auto packagedTask( std::make_shared<std::packaged_task<result_t( )>>( std::forward<F>( pTask ) ) );
+
+			// Get future before task can be executed
+			std::future<result_t> taskFuture( packagedTask->get_future( ) );
+
+			// Add task
+			push( [packagedTask]( ) { ( *packagedTask )( ); } );
+
+			// Return future
+			return( taskFuture );
+
+		}
+
+		/*
+		 * Execute one pending sub-task on the calling thread.
+		 *
+		 * @thread_safety - thread-safe.
+		 * @return - false, if no sub-tasks.
+		*/
+		bool runPendingTask( );
+
+		/*
+		 * Wait for task result, executing pending sub-tasks meanwhile.
+		 * Must be used by tasks, waiting for sub-tasks.
+		 *
+		 * @thread_safety - thread-safe.
+		 * @param pFuture - future, returned by submit.
+		 * @return - task result.
+		 * @throws - rethrows task exception.
+		*/
+		template <typename T>
+		T get( std::future<T> & pFuture )
+		{
+
+			// Help, while task is not complete
+			while ( pFuture.wait_for( std::chrono::seconds( 0 ) ) != std::future_status::ready )
+			{
+
+				if ( !runPendingTask( ) )
+					pFuture.wait_for( WAIT_INTERVAL );
+
+			}
+
+			// Return result
+			return( pFuture.get( ) );
+
+		}
+
+		// -------------------------------------------------------- \\
+
+	};
+
+	// -------------------------------------------------------- \\
+
+}
\ No newline at end of file
@@ -0,0 +1,114 @@
+/*
+* Copyright  2018 Denis Zyamaev (code4un@yandex.ru) All rights reserved.
+* Authors: Denis Zyamaev (code4un@yandex.ru)
+* All rights reserved.
+* API: C++ 11
+* License: see LICENSE.txt
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+* 1. Redistributions of source code must retain the above copyright notice,
+* this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must display the names 'Denis Zyamaev' and
+* in the credits of the application, if such credits exist.
+* The authors of this work must be notified via email (code4un@yandex.ru) in
+* this case of redistribution.
+* 3. Neither the name of copyright holders nor the names of its contributors
+* may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS
+* IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+* PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// HEADER
+#include "FileInputSource.hpp"
+
+namespace c0de4un
+{
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Constructor & destructor
+	// ===========================================================
+
+	/*
+	 * FileInputSource constructor.
+	 *
+	 * @param pFile - file to read.
+	 * @param bufferSize - size of read-buffer.
+	 * @throws - can throw exception (bad_alloc).
+	*/
+	FileInputSource::FileInputSource( std::FILE *const pFile, const std::uint32_t bufferSize )
+		: mFile( pFile ),
+		mOwnBuffer( bufferSize ),
+		mBuffer( &mOwnBuffer )
+	{
+	}
+
+	/*
+	 * FileInputSource constructor with external buffer.
+	 * Size of buffer is the read size, setReadSize resizes it.
+	 *
+	 * @param pFile - file to read.
+	 * @param pBuffer - read-buffer, must outlive this source.
+	*/
+	FileInputSource::FileInputSource( std::FILE *const pFile, std::vector<unsigned char> & pBuffer ) noexcept
+		: mFile( pFile ),
+		mOwnBuffer( ),
+		mBuffer( &pBuffer )
+	{
+	}
+
+	// ===========================================================
+	// Methods
+	// ===========================================================
+
+	/*
+	 * Reads next piece of file into buffer.
+	 *
+	 * @thread_safety - not thread-safe.
+	 * @param pData - receives pointer to buffer.
+	 * @return - number of bytes, 0 at end of file.
+	 * @throws - can throw exception.
+	*/
+	std::size_t FileInputSource::read( const unsigned char *& pData )
+	{
+
+		// Read
+		const std::size_t readCount( fread( mBuffer->data( ), sizeof( unsigned char ), mBuffer->size( ), mFile ) );
+
+		// Check io errors
+		if ( ferror( mFile ) )
+			throw std::runtime_error( "FileInputSource::read - io error, can't read input file !" );
+
+		// Return
+		pData = mBuffer->data( );
+		return( readCount );
+
+	}
+
+	/*
+	 * Resize read-buffer.
+	 *
+	 * @thread_safety - not thread-safe.
+	 * @param readSize - bytes per read.
+	 * @throws - can throw exception (bad_alloc).
+	*/
+	void FileInputSource::setReadSize( const std::uint32_t readSize )
+	{ mBuffer->resize( std::max<std::uint32_t>( readSize, 1 ) ); }
+
+	// -------------------------------------------------------- \\
+
+}
\ No newline at end of file
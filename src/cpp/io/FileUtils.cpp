@@ -0,0 +1,189 @@
+/*
+* Copyright  2018 Denis Zyamaev (code4un@yandex.ru) All rights reserved.
+* Authors: Denis Zyamaev (code4un@yandex.ru)
+* All rights reserved.
+* API: C++ 11
+* License: see LICENSE.txt
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+* 1. Redistributions of source code must retain the above copyright notice,
+* this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must display the names 'Denis Zyamaev' and
+* in the credits of the application, if such credits exist.
+* The authors of this work must be notified via email (code4un@yandex.ru) in
+* this case of redistribution.
+* 3. Neither the name of copyright holders nor the names of its contributors
+* may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS
+* IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+* PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// HEADER
+#include "FileUtils.hpp"
+
+// Include POSIX file API
+#if !defined( _WIN32 )
+#  include <fcntl.h>
+#  include <sys/stat.h>
+#endif
+
+namespace c0de4un
+{
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Methods
+	// ===========================================================
+
+	/*
+	 * Set position of the file.
+	 *
+	 * @thread_safety - not thread-safe.
+	 * @param pFile - file, must be seekable.
+	 * @param pOffset - offset from the beginning of the file.
+	 * @throws - can throw exception, if file can't be positioned.
+	*/
+	void FileUtils::seek( std::FILE *const pFile, const std::uint64_t pOffset )
+	{
+
+#if defined( _WIN32 )
+		const int seekResult( _fseeki64( pFile, static_cast<__int64>( pOffset ), SEEK_SET ) );
+#else
+		const int seekResult( fseeko( pFile, static_cast<off_t>( pOffset ), SEEK_SET ) );
+#endif
+
+		// Check
+		if ( seekResult != 0 )
+			throw std::runtime_error( "FileUtils::seek - failed to set file position, file is not seekable" );
+
+	}
+
+	/*
+	 * Returns position of the file.
+	 *
+	 * @thread_safety - not thread-safe.
+	 * @param pFile - file, must be seekable.
+	 * @throws - can throw exception, if file position unknown.
+	*/
+	std::uint64_t FileUtils::tell( std::FILE *const pFile )
+	{
+
+#if defined( _WIN32 )
+		const __int64 position( _ftelli64( pFile ) );
+#else
+		const off_t position( ftello( pFile ) );
+#endif
+
+		// Check
+		if ( position < 0 )
+			throw std::runtime_error( "FileUtils::tell - failed to get file position, file is not seekable" );
+
+		// Return
+		return( static_cast<std::uint64_t>( position ) );
+
+	}
+
+	/*
+	 * Returns size of the file. Position is not changed.
+	 *
+	 * @thread_safety - not thread-safe.
+	 * @param pFile - file, must be seekable.
+	 * @throws - can throw exception, if file can't be positioned.
+	*/
+	std::uint64_t FileUtils::getSize( std::FILE *const pFile )
+	{
+
+		// Current position
+		const std::uint64_t position( tell( pFile ) );
+
+		// Seek to end
+#if defined( _WIN32 )
+		const int seekResult( _fseeki64( pFile, 0, SEEK_END ) );
+#else
+		const int seekResult( fseeko( pFile, 0, SEEK_END ) );
+#endif
+
+		// Check
+		if ( seekResult != 0 )
+			throw std::runtime_error( "FileUtils::getSize - failed to set file position, file is not seekable" );
+
+		// Size
+		const std::uint64_t fileSize( tell( pFile ) );
+
+		// Restore position
+		seek( pFile, position );
+
+		// Return
+		return( fileSize );
+
+	}
+
+	/*
+	 * Enlarge pipe buffer. Unprivileged process is limited by
+	 * /proc/sys/fs/pipe-max-size, the largest allowed size is set.
+	 *
+	 * @thread_safety - thread-safe.
+	 * @param pFile - file, any end of pipe.
+	 * @param pSize - requested size of pipe buffer.
+	 * @return - size of pipe buffer, 0 if file is not a pipe or size is unknown.
+	*/
+	std::uint32_t FileUtils::growPipe( std::FILE *const pFile, const std::uint32_t pSize ) noexcept
+	{
+
+#if defined( _WIN32 ) || !defined( F_SETPIPE_SZ )
+
+		// Not supported
+		static_cast<void>( pFile );
+		static_cast<void>( pSize );
+		return( 0 );
+
+#else
+
+		// Get file descriptor
+		const int fileDescriptor( fileno( pFile ) );
+
+		// Check file type
+		struct stat fileStat;
+		if ( fileDescriptor < 0 || fstat( fileDescriptor, &fileStat ) != 0 || !S_ISFIFO( fileStat.st_mode ) )
+			return( 0 );
+
+		// Current size, never shrink
+		const int currentSize( fcntl( fileDescriptor, F_GETPIPE_SZ ) );
+		if ( currentSize < 0 )
+			return( 0 );
+
+		// Request size, halve while over the limit
+		for ( std::uint32_t requestSize = pSize; requestSize > static_cast<std::uint32_t>( currentSize ); requestSize /= 2 )
+		{
+
+			const int pipeSize( fcntl( fileDescriptor, F_SETPIPE_SZ, static_cast<int>( requestSize ) ) );
+
+			if ( pipeSize > 0 )
+				return( static_cast<std::uint32_t>( pipeSize ) );
+
+		}
+
+		// Return
+		return( static_cast<std::uint32_t>( currentSize ) );
+
+#endif
+
+	}
+
+	// -------------------------------------------------------- \\
+
+}
\ No newline at end of file
@@ -0,0 +1,119 @@
+/*
+* Copyright  2018 Denis Zyamaev (code4un@yandex.ru) All rights reserved.
+* Authors: Denis Zyamaev (code4un@yandex.ru)
+* All rights reserved.
+* API: C++ 11
+* License: see LICENSE.txt
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+* 1. Redistributions of source code must retain the above copyright notice,
+* this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must display the names 'Denis Zyamaev' and
+* in the credits of the application, if such credits exist.
+* The authors of this work must be notified via email (code4un@yandex.ru) in
+* this case of redistribution.
+* 3. Neither the name of copyright holders nor the names of its contributors
+* may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS
+* IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+* PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+// Include 'pch_cxx'
+#include "../pch_cxx.hpp"
+
+namespace c0de4un
+{
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Types
+	// ===========================================================
+
+	/*
+	  * FileUtils - 64-bit file positioning for stdio FILE.
+	  *
+	  * @language C++ 17
+	  *
+	  * @authors Z. Denis (c0de4un@yandex.ru)
+	  * @version 1.0
+	 */
+	class FileUtils final
+	{
+
+	public:
+
+		// -------------------------------------------------------- \\
+
+		// ===========================================================
+		// Constructor & destructor
+		// ===========================================================
+
+		/* @deleted FileUtils constructor, only static methods */
+		FileUtils( ) = delete;
+
+		// ===========================================================
+		// Methods
+		// ===========================================================
+
+		/*
+		 * Set position of the file.
+		 *
+		 * @thread_safety - not thread-safe.
+		 * @param pFile - file, must be seekable.
+		 * @param pOffset - offset from the beginning of the file.
+		 * @throws - can throw exception, if file can't be positioned.
+		*/
+		static void seek( std::FILE *const pFile, const std::uint64_t pOffset );
+
+		/*
+		 * Returns position of the file.
+		 *
+		 * @thread_safety - not thread-safe.
+		 * @param pFile - file, must be seekable.
+		 * @throws - can throw exception, if file position unknown.
+		*/
+		static std::uint64_t tell( std::FILE *const pFile );
+
+		/*
+		 * Returns size of the file. Position is not changed.
+		 *
+		 * @thread_safety - not thread-safe.
+		 * @param pFile - file, must be seekable.
+		 * @throws - can throw exception, if file can't be positioned.
+		*/
+		static std::uint64_t getSize( std::FILE *const pFile );
+
+		/*
+		 * Enlarge pipe buffer. Unprivileged process is limited by
+		 * /proc/sys/fs/pipe-max-size, the largest allowed size is set.
+		 *
+		 * @thread_safety - thread-safe.
+		 * @param pFile - file, any end of pipe.
+		 * @param pSize - requested size of pipe buffer.
+		 * @return - size of pipe buffer, 0 if file is not a pipe or size is unknown.
+		*/
+		static std::uint32_t growPipe( std::FILE *const pFile, const std::uint32_t pSize ) noexcept;
+
+		// -------------------------------------------------------- \\
+
+	};
+
+	// -------------------------------------------------------- \\
+
+}
\ No newline at end of file
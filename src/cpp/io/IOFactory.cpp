@@ -0,0 +1,210 @@
+/*
+* Copyright  2018 Denis Zyamaev (code4un@yandex.ru) All rights reserved.
+* Authors: Denis Zyamaev (code4un@yandex.ru)
+* All rights reserved.
+* API: C++ 11
+* License: see LICENSE.txt
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+* 1. Redistributions of source code must retain the above copyright notice,
+* this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must display the names 'Denis Zyamaev' and
+* in the credits of the application, if such credits exist.
+* The authors of this work must be notified via email (code4un@yandex.ru) in
+* this case of redistribution.
+* 3. Neither the name of copyright holders nor the names of its contributors
+* may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS
+* IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+* PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// HEADER
+#include "IOFactory.hpp"
+
+// Include FileInputSource
+#include "FileInputSource.hpp"
+
+// Include MappedInputSource
+#include "MappedInputSource.hpp"
+
+// Include UringInputSource
+#include "UringInputSource.hpp"
+
+// Include FileOutputSink
+#include "FileOutputSink.hpp"
+
+// Include UringOutputSink
+#include "UringOutputSink.hpp"
+
+// Include PreallocOutputSink
+#include "PreallocOutputSink.hpp"
+
+// Include SparseOutputSink
+#include "SparseOutputSink.hpp"
+
+// Include PoliteInputSource
+#include "PoliteInputSource.hpp"
+
+// Include PoliteOutputSink
+#include "PoliteOutputSink.hpp"
+
+// Include PipeOutputSink
+#include "PipeOutputSink.hpp"
+
+// Include FileUtils
+#include "FileUtils.hpp"
+
+namespace c0de4un
+{
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Methods
+	// ===========================================================
+
+	/*
+	 * Creates input-source for the given file.
+	 *
+	 * @thread_safety - thread-safe.
+	 * @param pFile - file to read.
+	 * @param bufferSize - read-buffer size for stdio.
+	 * @param ioBackend - preferred backend.
+	 * @return - input-source.
+	 * @throws - can throw exception (bad_alloc).
+	*/
+	std::unique_ptr<InputSource> IOFactory::openSource( std::FILE *const pFile, const std::uint32_t bufferSize, const IOBackend ioBackend )
+	{
+
+		// Guarded-Block
+		try
+		{
+
+			// Handle backend
+			switch ( ioBackend )
+			{
+
+			case IOBackend::MEMORY_MAPPED:
+			case IOBackend::DIRECT_IO:
+			case IOBackend::SPARSE:
+				return( std::make_unique<MappedInputSource>( pFile ) );
+
+			case IOBackend::IO_URING:
+				return( std::make_unique<UringInputSource>( pFile ) );
+
+			case IOBackend::CACHE_POLITE:
+				return( std::make_unique<PoliteInputSource>( pFile, bufferSize ) );
+
+			case IOBackend::PIPE:
+				// Larger pipe, writer blocks less often
+				static_cast<void>( FileUtils::growPipe( pFile, PipeOutputSink::DEFAULT_PIPE_SIZE ) );
+				break;
+
+			default:
+				break;
+
+			}
+
+		}
+		catch ( const std::runtime_error & )
+		{
+			// Not a regular file (pipe, device) or backend not supported, use stdio
+		}
+
+		// Read with fread
+		return( std::make_unique<FileInputSource>( pFile, bufferSize ) );
+
+	}
+
+	/*
+	 * Creates output-sink for the given file. Regular file with known
+	 * expected size (or direct io) is preallocated & written with pwrite.
+	 *
+	 * @thread_safety - thread-safe.
+	 * @param pFile - file to write.
+	 * @param ioBackend - preferred backend.
+	 * @param expectedSize - expected size of output, 0 if unknown.
+	 * @return - output-sink.
+	 * @throws - can throw exception (bad_alloc).
+	*/
+	std::unique_ptr<OutputSink> IOFactory::openSink( std::FILE *const pFile, const IOBackend ioBackend, const std::uint64_t expectedSize )
+	{
+
+		// Guarded-Block
+		try
+		{
+
+			// Asynchronous writes
+			if ( ioBackend == IOBackend::IO_URING )
+				return( std::make_unique<UringOutputSink>( pFile ) );
+
+			// Zero blocks become holes
+			if ( ioBackend == IOBackend::SPARSE )
+				return( std::make_unique<SparseOutputSink>( pFile ) );
+
+			// Written pages are dropped, output is not preallocated
+			if ( ioBackend == IOBackend::CACHE_POLITE )
+				return( std::make_unique<PoliteOutputSink>( pFile ) );
+
+			// Pages are spliced into pipe
+			if ( ioBackend == IOBackend::PIPE )
+				return( std::make_unique<PipeOutputSink>( pFile ) );
+
+			// Preallocated, large aligned writes
+			if ( ioBackend == IOBackend::DIRECT_IO || expectedSize > 0 )
+				return( std::make_unique<PreallocOutputSink>( pFile, expectedSize, ioBackend == IOBackend::DIRECT_IO ) );
+
+		}
+		catch ( const std::runtime_error & )
+		{
+			// Not a regular file (pipe, device) or backend not supported, use stdio
+		}
+
+		// Write with fwrite
+		return( std::make_unique<FileOutputSink>( pFile ) );
+
+	}
+
+	/*
+	 * Creates page-cache cursor for file, that is read or written with stdio.
+	 *
+	 * @thread_safety - thread-safe.
+	 * @param pFile - file.
+	 * @param forWrite - true if file is written, read otherwise.
+	 * @return - cursor, nullptr if not a regular file or not supported.
+	 * @throws - can throw exception (bad_alloc).
+	*/
+	std::unique_ptr<PageCacheCursor> IOFactory::openCursor( std::FILE *const pFile, const bool forWrite )
+	{
+
+		// Guarded-Block
+		try
+		{
+			return( std::make_unique<PageCacheCursor>( pFile, forWrite ) );
+		}
+		catch ( const std::runtime_error & )
+		{
+			// Not a regular file (pipe, device) or not supported
+		}
+
+		// No cursor
+		return( nullptr );
+
+	}
+
+	// -------------------------------------------------------- \\
+
+}
\ No newline at end of file
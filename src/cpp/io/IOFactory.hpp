@@ -0,0 +1,128 @@
+/*
+* Copyright  2018 Denis Zyamaev (code4un@yandex.ru) All rights reserved.
+* Authors: Denis Zyamaev (code4un@yandex.ru)
+* All rights reserved.
+* API: C++ 11
+* License: see LICENSE.txt
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+* 1. Redistributions of source code must retain the above copyright notice,
+* this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must display the names 'Denis Zyamaev' and
+* in the credits of the application, if such credits exist.
+* The authors of this work must be notified via email (code4un@yandex.ru) in
+* this case of redistribution.
+* 3. Neither the name of copyright holders nor the names of its contributors
+* may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS
+* IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+* PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+// Include IOBackend
+#include "IOBackend.hpp"
+
+// Include InputSource
+#include "InputSource.hpp"
+
+// Include OutputSink
+#include "OutputSink.hpp"
+
+// Include PageCacheCursor
+#include "PageCacheCursor.hpp"
+
+namespace c0de4un
+{
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Types
+	// ===========================================================
+
+	/*
+	  * IOFactory - creates input-sources & output-sinks for files.
+	  *
+	  * If requested backend can't be used for the file (pipe, kernel
+	  * without io_uring), stdio is used instead.
+	  *
+	  * @language C++ 17
+	  *
+	  * @authors Z. Denis (c0de4un@yandex.ru)
+	  * @version 1.0
+	 */
+	class IOFactory final
+	{
+
+	public:
+
+		// -------------------------------------------------------- \\
+
+		// ===========================================================
+		// Constructor & destructor
+		// ===========================================================
+
+		/* @deleted IOFactory constructor, only static methods */
+		IOFactory( ) = delete;
+
+		// ===========================================================
+		// Methods
+		// ===========================================================
+
+		/*
+		 * Creates input-source for the given file.
+		 *
+		 * @thread_safety - thread-safe.
+		 * @param pFile - file to read.
+		 * @param bufferSize - read-buffer size for stdio.
+		 * @param ioBackend - preferred backend.
+		 * @return - input-source.
+		 * @throws - can throw exception (bad_alloc).
+		*/
+		static std::unique_ptr<InputSource> openSource( std::FILE *const pFile, const std::uint32_t bufferSize, const IOBackend ioBackend );
+
+		/*
+		 * Creates output-sink for the given file. Regular file with known
+		 * expected size (or direct io) is preallocated & written with pwrite.
+		 *
+		 * @thread_safety - thread-safe.
+		 * @param pFile - file to write.
+		 * @param ioBackend - preferred backend.
+		 * @param expectedSize - expected size of output, 0 if unknown.
+		 * @return - output-sink.
+		 * @throws - can throw exception (bad_alloc).
+		*/
+		static std::unique_ptr<OutputSink> openSink( std::FILE *const pFile, const IOBackend ioBackend, const std::uint64_t expectedSize = 0 );
+
+		/*
+		 * Creates page-cache cursor for file, that is read or written with stdio.
+		 *
+		 * @thread_safety - thread-safe.
+		 * @param pFile - file.
+		 * @param forWrite - true if file is written, read otherwise.
+		 * @return - cursor, nullptr if not a regular file or not supported.
+		 * @throws - can throw exception (bad_alloc).
+		*/
+		static std::unique_ptr<PageCacheCursor> openCursor( std::FILE *const pFile, const bool forWrite );
+
+		// -------------------------------------------------------- \\
+
+	};
+
+	// -------------------------------------------------------- \\
+
+}
\ No newline at end of file
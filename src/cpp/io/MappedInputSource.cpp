@@ -0,0 +1,240 @@
+/*
+* Copyright  2018 Denis Zyamaev (code4un@yandex.ru) All rights reserved.
+* Authors: Denis Zyamaev (code4un@yandex.ru)
+* All rights reserved.
+* API: C++ 11
+* License: see LICENSE.txt
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+* 1. Redistributions of source code must retain the above copyright notice,
+* this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must display the names 'Denis Zyamaev' and
+* in the credits of the application, if such credits exist.
+* The authors of this work must be notified via email (code4un@yandex.ru) in
+* this case of redistribution.
+* 3. Neither the name of copyright holders nor the names of its contributors
+* may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS
+* IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+* PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// HEADER
+#include "MappedInputSource.hpp"
+
+// Include platform memory-mapping API
+#if defined( _WIN32 )
+#  ifndef NOMINMAX
+#    define NOMINMAX
+#  endif
+#  include <windows.h>
+#  include <io.h>
+#else
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+namespace c0de4un
+{
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Constructor & destructor
+	// ===========================================================
+
+	/*
+	 * MappedInputSource constructor. Data is read from the current
+	 * position of the file.
+	 *
+	 * @param pFile - file to read, must be regular file.
+	 * @param windowSize - size of mapped window.
+	 * @throws - can throw exception, if file can't be mapped.
+	*/
+	MappedInputSource::MappedInputSource( std::FILE *const pFile, const std::size_t windowSize )
+		: mHandle( -1 ),
+		mFileSize( 0 ),
+		mOffset( 0 ),
+		mGranularity( 0 ),
+		mWindowSize( 0 ),
+		mView( nullptr ),
+		mViewSize( 0 )
+	{
+
+#if defined( _WIN32 )
+
+		// Get mapping granularity
+		SYSTEM_INFO systemInfo;
+		GetSystemInfo( &systemInfo );
+		mGranularity = systemInfo.dwAllocationGranularity;
+
+		// Get file handle
+		const HANDLE fileHandle( reinterpret_cast<HANDLE>( _get_osfhandle( _fileno( pFile ) ) ) );
+
+		// Check file type & get size
+		LARGE_INTEGER fileSize;
+		if ( fileHandle == INVALID_HANDLE_VALUE || GetFileType( fileHandle ) != FILE_TYPE_DISK || !GetFileSizeEx( fileHandle, &fileSize ) )
+			throw std::runtime_error( "MappedInputSource - file can't be mapped, not a regular file" );
+
+		mFileSize = static_cast<std::uint64_t>( fileSize.QuadPart );
+
+		// Get current position
+		const __int64 position( _ftelli64( pFile ) );
+		mOffset = position > 0 ? static_cast<std::uint64_t>( position ) : 0;
+
+		// Create mapping, empty files can't be mapped
+		if ( mOffset < mFileSize )
+		{
+
+			const HANDLE mappingHandle( CreateFileMappingW( fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr ) );
+
+			if ( mappingHandle == nullptr )
+				throw std::runtime_error( "MappedInputSource - failed to create file mapping" );
+
+			mHandle = reinterpret_cast<std::intptr_t>( mappingHandle );
+
+		}
+
+#else
+
+		// Get mapping granularity
+		mGranularity = static_cast<std::size_t>( sysconf( _SC_PAGESIZE ) );
+
+		// Get file descriptor
+		const int fileDescriptor( fileno( pFile ) );
+
+		// Check file type & get size
+		struct stat fileStat;
+		if ( fileDescriptor < 0 || fstat( fileDescriptor, &fileStat ) != 0 || !S_ISREG( fileStat.st_mode ) )
+			throw std::runtime_error( "MappedInputSource - file can't be mapped, not a regular file" );
+
+		mFileSize = static_cast<std::uint64_t>( fileStat.st_size );
+		mHandle = fileDescriptor;
+
+		// Get current position
+		const off_t position( ftello( pFile ) );
+		mOffset = position > 0 ? static_cast<std::uint64_t>( position ) : 0;
+
+#endif
+
+		// Round window-size up to granularity
+		mWindowSize = std::max<std::size_t>( ( windowSize + mGranularity - 1 ) / mGranularity, 1 ) * mGranularity;
+
+	}
+
+	/* MappedInputSource destructor */
+	MappedInputSource::~MappedInputSource( )
+	{
+
+		// Unmap window
+		unmap( );
+
+#if defined( _WIN32 )
+
+		// Close mapping
+		if ( mHandle != -1 )
+			CloseHandle( reinterpret_cast<HANDLE>( mHandle ) );
+
+#endif
+
+	}
+
+	// ===========================================================
+	// Methods
+	// ===========================================================
+
+	/* Unmaps current window */
+	void MappedInputSource::unmap( ) noexcept
+	{
+
+		// Cancel, if not mapped
+		if ( mView == nullptr )
+			return;
+
+#if defined( _WIN32 )
+		UnmapViewOfFile( mView );
+#else
+		munmap( mView, mViewSize );
+#endif
+
+		mView = nullptr;
+		mViewSize = 0;
+
+	}
+
+	/*
+	 * Maps next window of file & unmaps previous one.
+	 *
+	 * @thread_safety - not thread-safe.
+	 * @param pData - receives pointer to mapped data.
+	 * @return - number of bytes, 0 at end of file.
+	 * @throws - can throw exception.
+	*/
+	std::size_t MappedInputSource::read( const unsigned char *& pData )
+	{
+
+		// Release window behind the cursor
+		unmap( );
+
+		// End of file
+		if ( mOffset >= mFileSize )
+			return( 0 );
+
+		// Mapping offset must be aligned
+		const std::uint64_t viewOffset( mOffset - ( mOffset % mGranularity ) );
+
+		// Skip bytes before the cursor
+		const std::size_t viewSkip( static_cast<std::size_t>( mOffset - viewOffset ) );
+
+		// Size of window
+		const std::size_t viewSize( static_cast<std::size_t>( std::min<std::uint64_t>( mWindowSize, mFileSize - viewOffset ) ) );
+
+#if defined( _WIN32 )
+
+		// Map window
+		mView = MapViewOfFile( reinterpret_cast<HANDLE>( mHandle ), FILE_MAP_READ, static_cast<DWORD>( viewOffset >> 32 ), static_cast<DWORD>( viewOffset & 0xFFFFFFFF ), viewSize );
+
+		if ( mView == nullptr )
+			throw std::runtime_error( "MappedInputSource::read - failed to map file" );
+
+#else
+
+		// Map window
+		void *const view( mmap( nullptr, viewSize, PROT_READ, MAP_PRIVATE, static_cast<int>( mHandle ), static_cast<off_t>( viewOffset ) ) );
+
+		if ( view == MAP_FAILED )
+			throw std::runtime_error( "MappedInputSource::read - failed to map file" );
+
+		mView = view;
+
+		// Window is read once, front to back
+		madvise( mView, viewSize, MADV_SEQUENTIAL );
+
+#endif
+
+		// Move cursor
+		mViewSize = viewSize;
+		mOffset = viewOffset + viewSize;
+
+		// Return
+		pData = static_cast<const unsigned char*>( mView ) + viewSkip;
+		return( viewSize - viewSkip );
+
+	}
+
+	// -------------------------------------------------------- \\
+
+}
\ No newline at end of file
@@ -0,0 +1,155 @@
+/*
+* Copyright  2018 Denis Zyamaev (code4un@yandex.ru) All rights reserved.
+* Authors: Denis Zyamaev (code4un@yandex.ru)
+* All rights reserved.
+* API: C++ 11
+* License: see LICENSE.txt
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+* 1. Redistributions of source code must retain the above copyright notice,
+* this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must display the names 'Denis Zyamaev' and
+* in the credits of the application, if such credits exist.
+* The authors of this work must be notified via email (code4un@yandex.ru) in
+* this case of redistribution.
+* 3. Neither the name of copyright holders nor the names of its contributors
+* may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS
+* IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+* PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+// Include InputSource
+#include "InputSource.hpp"
+
+namespace c0de4un
+{
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Types
+	// ===========================================================
+
+	/*
+	  * MappedInputSource - reads regular file through memory-mapped
+	  * windows, without copying data into a buffer.
+	  *
+	  * Each read maps next window of the file & unmaps previous one,
+	  * so only one window is mapped at a time.
+	  *
+	  * @language C++ 17
+	  *
+	  * @authors Z. Denis (c0de4un@yandex.ru)
+	  * @version 1.0
+	 */
+	class MappedInputSource final : public InputSource
+	{
+
+	private:
+
+		// -------------------------------------------------------- \\
+
+		// ===========================================================
+		// Fields
+		// ===========================================================
+
+		/* File descriptor (POSIX) or file-mapping handle (Windows) */
+		std::intptr_t mHandle;
+
+		/* Size of file */
+		std::uint64_t mFileSize;
+
+		/* Offset of the next byte to map */
+		std::uint64_t mOffset;
+
+		/* Mapping offset alignment (page-size or allocation-granularity) */
+		std::size_t mGranularity;
+
+		/* Size of window */
+		std::size_t mWindowSize;
+
+		/* Mapped window */
+		void * mView;
+
+		/* Size of mapped window */
+		std::size_t mViewSize;
+
+		// ===========================================================
+		// Methods
+		// ===========================================================
+
+		/* Unmaps current window */
+		void unmap( ) noexcept;
+
+		// -------------------------------------------------------- \\
+
+	public:
+
+		// -------------------------------------------------------- \\
+
+		// ===========================================================
+		// Constants
+		// ===========================================================
+
+		/* Default size of mapped window */
+		static constexpr std::size_t DEFAULT_WINDOW_SIZE = 67108864;
+
+		// ===========================================================
+		// Constructor & destructor
+		// ===========================================================
+
+		/*
+		 * MappedInputSource constructor. Data is read from the current
+		 * position of the file.
+		 *
+		 * @param pFile - file to read, must be regular file.
+		 * @param windowSize - size of mapped window.
+		 * @throws - can throw exception, if file can't be mapped.
+		*/
+		explicit MappedInputSource( std::FILE *const pFile, const std::size_t windowSize = DEFAULT_WINDOW_SIZE );
+
+		/* MappedInputSource destructor */
+		~MappedInputSource( );
+
+		/* @deleted MappedInputSource copy-constructor */
+		MappedInputSource( const MappedInputSource & ) = delete;
+
+		/* @deleted MappedInputSource copy-assignment */
+		MappedInputSource & operator=( const MappedInputSource & ) = delete;
+
+		// ===========================================================
+		// Methods
+		// ===========================================================
+
+		/*
+		 * Maps next window of file & unmaps previous one.
+		 *
+		 * @thread_safety - not thread-safe.
+		 * @param pData - receives pointer to mapped data.
+		 * @return - number of bytes, 0 at end of file.
+		 * @throws - can throw exception.
+		*/
+		std::size_t read( const unsigned char *& pData ) override;
+
+		// -------------------------------------------------------- \\
+
+	};
+
+	// -------------------------------------------------------- \\
+
+}
\ No newline at end of file
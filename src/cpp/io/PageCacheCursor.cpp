@@ -0,0 +1,246 @@
+/*
+* Copyright  2018 Denis Zyamaev (code4un@yandex.ru) All rights reserved.
+* Authors: Denis Zyamaev (code4un@yandex.ru)
+* All rights reserved.
+* API: C++ 11
+* License: see LICENSE.txt
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+* 1. Redistributions of source code must retain the above copyright notice,
+* this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must display the names 'Denis Zyamaev' and
+* in the credits of the application, if such credits exist.
+* The authors of this work must be notified via email (code4un@yandex.ru) in
+* this case of redistribution.
+* 3. Neither the name of copyright holders nor the names of its contributors
+* may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS
+* IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+* PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// HEADER
+#include "PageCacheCursor.hpp"
+
+// Include POSIX file API
+#if !defined( _WIN32 )
+#  include <fcntl.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+namespace c0de4un
+{
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Constructor & destructor
+	// ===========================================================
+
+	/*
+	 * PageCacheCursor constructor. Cursor starts at the current
+	 * position of the file.
+	 *
+	 * @param pFile - file, must be regular file.
+	 * @param forWrite - true if file is written, read otherwise.
+	 * @param windowSize - size of readahead & writeback window.
+	 * @throws - can throw exception, if file is not regular.
+	*/
+	PageCacheCursor::PageCacheCursor( std::FILE *const pFile, const bool forWrite, const std::uint64_t windowSize )
+		: mFileDescriptor( -1 ),
+		mForWrite( forWrite ),
+		mWindowSize( std::max( windowSize, MIN_WINDOW_SIZE ) ),
+		mStartOffset( 0 ),
+		mPosition( 0 ),
+		mDroppedEnd( 0 ),
+		mWindowEnd( 0 )
+	{
+
+#if defined( _WIN32 )
+
+		// Not supported
+		static_cast<void>( pFile );
+		throw std::runtime_error( "PageCacheCursor - not supported" );
+
+#else
+
+		// Get file descriptor
+		mFileDescriptor = fileno( pFile );
+
+		// Check file type, pipes & devices have no pages to drop
+		struct stat fileStat;
+		if ( mFileDescriptor < 0 || fstat( mFileDescriptor, &fileStat ) != 0 || !S_ISREG( fileStat.st_mode ) )
+			throw std::runtime_error( "PageCacheCursor - not a regular file" );
+
+		// Get current position
+		const off_t position( ftello( pFile ) );
+		mStartOffset = position > 0 ? static_cast<std::uint64_t>( position ) : 0;
+		mPosition = mStartOffset;
+		mDroppedEnd = mStartOffset;
+		mWindowEnd = mStartOffset;
+
+		// Input is read once, kernel doubles its readahead
+		if ( !mForWrite )
+		{
+
+			static_cast<void>( posix_fadvise( mFileDescriptor, static_cast<off_t>( mStartOffset ), 0, POSIX_FADV_SEQUENTIAL ) );
+			advance( 0 );
+
+		}
+
+#endif
+
+	}
+
+	// ===========================================================
+	// Methods
+	// ===========================================================
+
+	/*
+	 * Drop clean pages of range.
+	 *
+	 * @param pOffset - offset of range.
+	 * @param pSize - size of range, 0 till the end of file.
+	*/
+	void PageCacheCursor::drop( const std::uint64_t pOffset, const std::uint64_t pSize ) noexcept
+	{
+
+#if !defined( _WIN32 )
+		static_cast<void>( posix_fadvise( mFileDescriptor, static_cast<off_t>( pOffset ), static_cast<off_t>( pSize ), POSIX_FADV_DONTNEED ) );
+#else
+		static_cast<void>( pOffset );
+		static_cast<void>( pSize );
+#endif
+
+	}
+
+	/*
+	 * Move cursor: read ahead, start writeback & drop pages behind.
+	 * Errors are ignored, advice only.
+	 *
+	 * @thread_safety - not thread-safe.
+	 * @param pSize - number of bytes read or written.
+	*/
+	void PageCacheCursor::advance( const std::uint64_t pSize ) noexcept
+	{
+
+#if !defined( _WIN32 )
+
+		mPosition += pSize;
+
+		if ( mForWrite )
+		{
+
+			// Wait for full window
+			if ( mPosition - mWindowEnd < mWindowSize )
+				return;
+
+#if defined( __linux__ )
+
+			// Wait writeback of previous window, then drop it
+			if ( mWindowEnd > mDroppedEnd )
+				static_cast<void>( sync_file_range( mFileDescriptor, static_cast<off_t>( mDroppedEnd ), static_cast<off_t>( mWindowEnd - mDroppedEnd ), SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE | SYNC_FILE_RANGE_WAIT_AFTER ) );
+
+			drop( mDroppedEnd, mWindowEnd - mDroppedEnd );
+			mDroppedEnd = mWindowEnd;
+
+			// Start writeback of current window, without waiting
+			static_cast<void>( sync_file_range( mFileDescriptor, static_cast<off_t>( mWindowEnd ), static_cast<off_t>( mPosition - mWindowEnd ), SYNC_FILE_RANGE_WRITE ) );
+
+#else
+
+			// Dirty pages are not dropped, write previous window first
+			if ( mWindowEnd > mDroppedEnd && fdatasync( mFileDescriptor ) == 0 )
+			{
+				drop( mDroppedEnd, mWindowEnd - mDroppedEnd );
+				mDroppedEnd = mWindowEnd;
+			}
+
+#endif
+
+			mWindowEnd = mPosition;
+
+		}
+		else
+		{
+
+			// Read next window, when cursor passed half of current one
+			if ( mPosition + mWindowSize / 2 >= mWindowEnd )
+			{
+
+#if defined( __linux__ )
+				static_cast<void>( readahead( mFileDescriptor, static_cast<off64_t>( mWindowEnd ), static_cast<std::size_t>( mWindowSize ) ) );
+#else
+				static_cast<void>( posix_fadvise( mFileDescriptor, static_cast<off_t>( mWindowEnd ), static_cast<off_t>( mWindowSize ), POSIX_FADV_WILLNEED ) );
+#endif
+
+				mWindowEnd = std::max( mWindowEnd, mPosition ) + mWindowSize;
+
+			}
+
+			// Drop pages, that were read one window ago
+			if ( mPosition - mDroppedEnd >= mWindowSize * 2 )
+			{
+
+				const std::uint64_t dropEnd( mPosition - mWindowSize );
+				drop( mDroppedEnd, dropEnd - mDroppedEnd );
+				mDroppedEnd = dropEnd;
+
+			}
+
+		}
+
+#else
+		static_cast<void>( pSize );
+#endif
+
+	}
+
+	/*
+	 * Drop all pages from the start, output is written to disk first.
+	 * Written data must be flushed from stdio. Errors are ignored.
+	 *
+	 * @thread_safety - not thread-safe.
+	*/
+	void PageCacheCursor::finish( ) noexcept
+	{
+
+#if !defined( _WIN32 )
+
+		// Write remaining output, dirty pages can't be dropped
+		if ( mForWrite )
+		{
+
+#if defined( __linux__ )
+			static_cast<void>( sync_file_range( mFileDescriptor, static_cast<off_t>( mDroppedEnd ), 0, SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE | SYNC_FILE_RANGE_WAIT_AFTER ) );
+#else
+			static_cast<void>( fdatasync( mFileDescriptor ) );
+#endif
+
+		}
+
+		// Drop everything from the start, including readahead past the cursor
+		drop( mStartOffset, 0 );
+		mDroppedEnd = mPosition;
+		mWindowEnd = std::max( mWindowEnd, mPosition );
+
+#endif
+
+	}
+
+	// -------------------------------------------------------- \\
+
+}
\ No newline at end of file
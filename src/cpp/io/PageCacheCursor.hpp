@@ -0,0 +1,171 @@
+/*
+* Copyright  2018 Denis Zyamaev (code4un@yandex.ru) All rights reserved.
+* Authors: Denis Zyamaev (code4un@yandex.ru)
+* All rights reserved.
+* API: C++ 11
+* License: see LICENSE.txt
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+* 1. Redistributions of source code must retain the above copyright notice,
+* this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must display the names 'Denis Zyamaev' and
+* in the credits of the application, if such credits exist.
+* The authors of this work must be notified via email (code4un@yandex.ru) in
+* this case of redistribution.
+* 3. Neither the name of copyright holders nor the names of its contributors
+* may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS
+* IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+* PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+// Include 'pch_cxx'
+#include "../pch_cxx.hpp"
+
+namespace c0de4un
+{
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Types
+	// ===========================================================
+
+	/*
+	  * PageCacheCursor - keeps page-cache footprint of sequential file
+	  * io small.
+	  *
+	  * Input: access is advised sequential, next window is read ahead,
+	  * while the cursor is in the second half of the current one. Output:
+	  * writeback of each full window is started, when the next window
+	  * is full, previous one is waited. Pages behind the cursor are
+	  * dropped, one window later, so buffered stdio data is never dropped.
+	  *
+	  * @language C++ 17
+	  *
+	  * @authors Z. Denis (c0de4un@yandex.ru)
+	  * @version 1.0
+	 */
+	class PageCacheCursor final
+	{
+
+	private:
+
+		// -------------------------------------------------------- \\
+
+		// ===========================================================
+		// Fields
+		// ===========================================================
+
+		/* File-descriptor */
+		int mFileDescriptor;
+
+		/* true, if file is written */
+		bool mForWrite;
+
+		/* Size of window */
+		std::uint64_t mWindowSize;
+
+		/* Offset of the first byte */
+		std::uint64_t mStartOffset;
+
+		/* Offset of the cursor */
+		std::uint64_t mPosition;
+
+		/* End of dropped pages */
+		std::uint64_t mDroppedEnd;
+
+		/* Input: end of requested readahead. Output: end of started writeback. */
+		std::uint64_t mWindowEnd;
+
+		// ===========================================================
+		// Methods
+		// ===========================================================
+
+		/*
+		 * Drop clean pages of range.
+		 *
+		 * @param pOffset - offset of range.
+		 * @param pSize - size of range, 0 till the end of file.
+		*/
+		void drop( const std::uint64_t pOffset, const std::uint64_t pSize ) noexcept;
+
+		// -------------------------------------------------------- \\
+
+	public:
+
+		// -------------------------------------------------------- \\
+
+		// ===========================================================
+		// Constants
+		// ===========================================================
+
+		/* Default size of window */
+		static constexpr std::uint64_t DEFAULT_WINDOW_SIZE = 8388608;
+
+		/* Min size of window */
+		static constexpr std::uint64_t MIN_WINDOW_SIZE = 65536;
+
+		// ===========================================================
+		// Constructor & destructor
+		// ===========================================================
+
+		/*
+		 * PageCacheCursor constructor. Cursor starts at the current
+		 * position of the file.
+		 *
+		 * @param pFile - file, must be regular file.
+		 * @param forWrite - true if file is written, read otherwise.
+		 * @param windowSize - size of readahead & writeback window.
+		 * @throws - can throw exception, if file is not regular.
+		*/
+		explicit PageCacheCursor( std::FILE *const pFile, const bool forWrite, const std::uint64_t windowSize = DEFAULT_WINDOW_SIZE );
+
+		/* @deleted PageCacheCursor copy-constructor */
+		PageCacheCursor( const PageCacheCursor & ) = delete;
+
+		/* @deleted PageCacheCursor copy-assignment */
+		PageCacheCursor & operator=( const PageCacheCursor & ) = delete;
+
+		// ===========================================================
+		// Methods
+		// ===========================================================
+
+		/*
+		 * Move cursor: read ahead, start writeback & drop pages behind.
+		 * Errors are ignored, advice only.
+		 *
+		 * @thread_safety - not thread-safe.
+		 * @param pSize - number of bytes read or written.
+		*/
+		void advance( const std::uint64_t pSize ) noexcept;
+
+		/*
+		 * Drop all pages from the start, output is written to disk first.
+		 * Written data must be flushed from stdio. Errors are ignored.
+		 *
+		 * @thread_safety - not thread-safe.
+		*/
+		void finish( ) noexcept;
+
+		// -------------------------------------------------------- \\
+
+	};
+
+	// -------------------------------------------------------- \\
+
+}
\ No newline at end of file
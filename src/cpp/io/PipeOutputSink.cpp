@@ -0,0 +1,241 @@
+/*
+* Copyright  2018 Denis Zyamaev (code4un@yandex.ru) All rights reserved.
+* Authors: Denis Zyamaev (code4un@yandex.ru)
+* All rights reserved.
+* API: C++ 11
+* License: see LICENSE.txt
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+* 1. Redistributions of source code must retain the above copyright notice,
+* this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must display the names 'Denis Zyamaev' and
+* in the credits of the application, if such credits exist.
+* The authors of this work must be notified via email (code4un@yandex.ru) in
+* this case of redistribution.
+* 3. Neither the name of copyright holders nor the names of its contributors
+* may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS
+* IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+* PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// HEADER
+#include "PipeOutputSink.hpp"
+
+// Include FileUtils
+#include "FileUtils.hpp"
+
+// Include Linux pipe API
+#if defined( __linux__ )
+#  include <cerrno>
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/uio.h>
+#  include <unistd.h>
+#endif
+
+namespace c0de4un
+{
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Constructor & destructor
+	// ===========================================================
+
+	/*
+	 * PipeOutputSink constructor, enlarges pipe.
+	 *
+	 * @param pFile - file to write, must be pipe.
+	 * @param pipeSize - requested size of pipe buffer.
+	 * @throws - can throw exception, if file is not a pipe.
+	*/
+	PipeOutputSink::PipeOutputSink( std::FILE *const pFile, const std::uint32_t pipeSize )
+		: mFileDescriptor( -1 ),
+		mPipeSize( 0 ),
+		mChunkSize( 0 ),
+		mChunk( nullptr ),
+		mFillSize( 0 ),
+		mSplice( true )
+	{
+
+#if !defined( __linux__ )
+
+		// Not supported, stdio is used
+		static_cast<void>( pFile );
+		static_cast<void>( pipeSize );
+		throw std::runtime_error( "PipeOutputSink - not supported" );
+
+#else
+
+		// Enlarge pipe
+		mPipeSize = FileUtils::growPipe( pFile, pipeSize );
+		if ( mPipeSize == 0 )
+			throw std::runtime_error( "PipeOutputSink - not a pipe" );
+
+		// Write pending stdio data, pipe is written by descriptor
+		if ( fflush( pFile ) != 0 )
+			throw std::runtime_error( "PipeOutputSink - failed to flush output file" );
+
+		mFileDescriptor = fileno( pFile );
+
+		// Pipe holds several chunks, reader drains one while the next is filled
+		mChunkSize = std::max( ( mPipeSize / CHUNKS_PER_PIPE + PAGE_SIZE - 1 ) / PAGE_SIZE * PAGE_SIZE, PAGE_SIZE );
+
+#endif
+
+	}
+
+	/* PipeOutputSink destructor, unmaps chunk */
+	PipeOutputSink::~PipeOutputSink( )
+	{
+
+#if defined( __linux__ )
+		if ( mChunk != nullptr )
+			munmap( mChunk, mChunkSize );
+#endif
+
+	}
+
+	// ===========================================================
+	// Methods
+	// ===========================================================
+
+	/*
+	 * Splice (gift) or write the current chunk. Spliced chunk is unmapped,
+	 * it's pages stay owned by the pipe.
+	 *
+	 * @throws - can throw exception.
+	*/
+	void PipeOutputSink::flush( )
+	{
+
+#if defined( __linux__ )
+
+		// Splice, completing short splices
+		for ( std::uint32_t writeCount = 0; writeCount < mFillSize; )
+		{
+
+			ssize_t written( -1 );
+
+			if ( mSplice )
+			{
+
+				iovec chunkVector;
+				chunkVector.iov_base = mChunk + writeCount;
+				chunkVector.iov_len = mFillSize - writeCount;
+
+				written = vmsplice( mFileDescriptor, &chunkVector, 1, SPLICE_F_GIFT );
+
+				// Not supported for this pipe, write
+				if ( written < 0 && ( errno == EINVAL || errno == ENOSYS ) )
+				{
+					mSplice = false;
+					continue;
+				}
+
+			}
+			else
+				written = ::write( mFileDescriptor, mChunk + writeCount, mFillSize - writeCount );
+
+			if ( written < 0 && errno == EINTR )
+				continue;
+
+			if ( written <= 0 )
+				throw std::runtime_error( "PipeOutputSink - failed to write output pipe" );
+
+			writeCount += static_cast<std::uint32_t>( written );
+
+		}
+
+		mFillSize = 0;
+
+		// Gifted pages are never written again, the next chunk is mapped fresh
+		if ( mSplice )
+		{
+			munmap( mChunk, mChunkSize );
+			mChunk = nullptr;
+		}
+
+#endif
+
+	}
+
+	/*
+	 * Copies data into chunk, splicing full chunks.
+	 *
+	 * @thread_safety - not thread-safe.
+	 * @param pData - data to write.
+	 * @param pSize - number of bytes.
+	 * @throws - can throw exception.
+	*/
+	void PipeOutputSink::write( const unsigned char *const pData, const std::size_t pSize )
+	{
+
+		// Number of bytes copied
+		std::size_t copied( 0 );
+
+		// Copy
+		while ( copied < pSize )
+		{
+
+#if defined( __linux__ )
+
+			// Fresh page-aligned chunk
+			if ( mChunk == nullptr )
+			{
+
+				void *const chunkMemory( mmap( nullptr, mChunkSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 ) );
+				if ( chunkMemory == MAP_FAILED )
+					throw std::runtime_error( "PipeOutputSink - failed to map buffer" );
+
+				mChunk = static_cast<unsigned char*>( chunkMemory );
+
+			}
+
+#endif
+
+			// Copy into chunk
+			const std::uint32_t copyCount( static_cast<std::uint32_t>( std::min<std::size_t>( pSize - copied, mChunkSize - mFillSize ) ) );
+			std::memcpy( mChunk + mFillSize, pData + copied, copyCount );
+			mFillSize += copyCount;
+			copied += copyCount;
+
+			// Splice full chunk
+			if ( mFillSize == mChunkSize )
+				flush( );
+
+		}
+
+	}
+
+	/*
+	 * Splices the last chunk.
+	 *
+	 * @thread_safety - not thread-safe.
+	 * @throws - can throw exception.
+	*/
+	void PipeOutputSink::finish( )
+	{
+
+		// Last chunk
+		if ( mFillSize > 0 )
+			flush( );
+
+	}
+
+	// -------------------------------------------------------- \\
+
+}
\ No newline at end of file
@@ -0,0 +1,177 @@
+/*
+* Copyright  2018 Denis Zyamaev (code4un@yandex.ru) All rights reserved.
+* Authors: Denis Zyamaev (code4un@yandex.ru)
+* All rights reserved.
+* API: C++ 11
+* License: see LICENSE.txt
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+* 1. Redistributions of source code must retain the above copyright notice,
+* this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must display the names 'Denis Zyamaev' and
+* in the credits of the application, if such credits exist.
+* The authors of this work must be notified via email (code4un@yandex.ru) in
+* this case of redistribution.
+* 3. Neither the name of copyright holders nor the names of its contributors
+* may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS
+* IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+* PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+// Include OutputSink
+#include "OutputSink.hpp"
+
+namespace c0de4un
+{
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Types
+	// ===========================================================
+
+	/*
+	  * PipeOutputSink - writes pipe with vmsplice, so pipe refers to
+	  * pages of this sink, instead of copying them.
+	  *
+	  * Spliced pages must not change, while pipe or reader refers to
+	  * them: reader can splice them onward (tee, pv). So each chunk is
+	  * mapped fresh, gifted (SPLICE_F_GIFT) & unmapped, it's pages stay
+	  * owned by the pipe & are never written again. If pipe doesn't
+	  * support vmsplice, sink falls back to write.
+	  *
+	  * @language C++ 17
+	  *
+	  * @authors Z. Denis (c0de4un@yandex.ru)
+	  * @version 1.0
+	 */
+	class PipeOutputSink final : public OutputSink
+	{
+
+	private:
+
+		// -------------------------------------------------------- \\
+
+		// ===========================================================
+		// Constants
+		// ===========================================================
+
+		/* Number of chunks pipe holds */
+		static constexpr std::uint32_t CHUNKS_PER_PIPE = 4;
+
+		/* Size of page, spliced chunks are page-aligned */
+		static constexpr std::uint32_t PAGE_SIZE = 4096;
+
+		// ===========================================================
+		// Fields
+		// ===========================================================
+
+		/* Output file-descriptor */
+		int mFileDescriptor;
+
+		/* Size of pipe buffer */
+		std::uint32_t mPipeSize;
+
+		/* Size of chunk */
+		std::uint32_t mChunkSize;
+
+		/* Current chunk, mapped, nullptr until data is written */
+		unsigned char * mChunk;
+
+		/* Number of bytes in the current chunk */
+		std::uint32_t mFillSize;
+
+		/* true, if chunks are spliced, written otherwise */
+		bool mSplice;
+
+		// ===========================================================
+		// Methods
+		// ===========================================================
+
+		/*
+		 * Splice (gift) or write the current chunk. Spliced chunk is unmapped,
+		 * it's pages stay owned by the pipe.
+		 *
+		 * @throws - can throw exception.
+		*/
+		void flush( );
+
+		// -------------------------------------------------------- \\
+
+	public:
+
+		// -------------------------------------------------------- \\
+
+		// ===========================================================
+		// Constants
+		// ===========================================================
+
+		/* Default size of pipe buffer */
+		static constexpr std::uint32_t DEFAULT_PIPE_SIZE = 1048576;
+
+		// ===========================================================
+		// Constructor & destructor
+		// ===========================================================
+
+		/*
+		 * PipeOutputSink constructor, enlarges pipe.
+		 *
+		 * @param pFile - file to write, must be pipe.
+		 * @param pipeSize - requested size of pipe buffer.
+		 * @throws - can throw exception, if file is not a pipe.
+		*/
+		explicit PipeOutputSink( std::FILE *const pFile, const std::uint32_t pipeSize = DEFAULT_PIPE_SIZE );
+
+		/* PipeOutputSink destructor, unmaps chunk */
+		~PipeOutputSink( ) override;
+
+		/* @deleted PipeOutputSink copy-constructor */
+		PipeOutputSink( const PipeOutputSink & ) = delete;
+
+		/* @deleted PipeOutputSink copy-assignment */
+		PipeOutputSink & operator=( const PipeOutputSink & ) = delete;
+
+		// ===========================================================
+		// Methods
+		// ===========================================================
+
+		/*
+		 * Copies data into chunk, splicing full chunks.
+		 *
+		 * @thread_safety - not thread-safe.
+		 * @param pData - data to write.
+		 * @param pSize - number of bytes.
+		 * @throws - can throw exception.
+		*/
+		void write( const unsigned char *const pData, const std::size_t pSize ) override;
+
+		/*
+		 * Splices the last chunk.
+		 *
+		 * @thread_safety - not thread-safe.
+		 * @throws - can throw exception.
+		*/
+		void finish( ) override;
+
+		// -------------------------------------------------------- \\
+
+	};
+
+	// -------------------------------------------------------- \\
+
+}
\ No newline at end of file
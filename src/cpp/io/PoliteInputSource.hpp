@@ -0,0 +1,139 @@
+/*
+* Copyright  2018 Denis Zyamaev (code4un@yandex.ru) All rights reserved.
+* Authors: Denis Zyamaev (code4un@yandex.ru)
+* All rights reserved.
+* API: C++ 11
+* License: see LICENSE.txt
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+* 1. Redistributions of source code must retain the above copyright notice,
+* this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must display the names 'Denis Zyamaev' and
+* in the credits of the application, if such credits exist.
+* The authors of this work must be notified via email (code4un@yandex.ru) in
+* this case of redistribution.
+* 3. Neither the name of copyright holders nor the names of its contributors
+* may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS
+* IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+* PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+// Include InputSource
+#include "InputSource.hpp"
+
+// Include PageCacheCursor
+#include "PageCacheCursor.hpp"
+
+namespace c0de4un
+{
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Types
+	// ===========================================================
+
+	/*
+	  * PoliteInputSource - reads regular file with fread, keeping it's
+	  * page-cache footprint small (see PageCacheCursor): windows are
+	  * read ahead & dropped behind the cursor, all pages are dropped
+	  * when source is destroyed.
+	  *
+	  * @language C++ 17
+	  *
+	  * @authors Z. Denis (c0de4un@yandex.ru)
+	  * @version 1.0
+	 */
+	class PoliteInputSource final : public InputSource
+	{
+
+	private:
+
+		// -------------------------------------------------------- \\
+
+		// ===========================================================
+		// Fields
+		// ===========================================================
+
+		/* Input file */
+		std::FILE * mFile;
+
+		/* Read-buffer */
+		std::vector<unsigned char> mBuffer;
+
+		/* Page-cache cursor */
+		PageCacheCursor mCursor;
+
+		// -------------------------------------------------------- \\
+
+	public:
+
+		// -------------------------------------------------------- \\
+
+		// ===========================================================
+		// Constructor & destructor
+		// ===========================================================
+
+		/*
+		 * PoliteInputSource constructor.
+		 *
+		 * @param pFile - file to read, must be regular file.
+		 * @param bufferSize - size of read-buffer.
+		 * @throws - can throw exception, if file is not regular.
+		*/
+		explicit PoliteInputSource( std::FILE *const pFile, const std::uint32_t bufferSize );
+
+		/* PoliteInputSource destructor, drops pages of read data */
+		~PoliteInputSource( ) override;
+
+		/* @deleted PoliteInputSource copy-constructor */
+		PoliteInputSource( const PoliteInputSource & ) = delete;
+
+		/* @deleted PoliteInputSource copy-assignment */
+		PoliteInputSource & operator=( const PoliteInputSource & ) = delete;
+
+		// ===========================================================
+		// Methods
+		// ===========================================================
+
+		/*
+		 * Reads next piece of file into buffer.
+		 *
+		 * @thread_safety - not thread-safe.
+		 * @param pData - receives pointer to buffer.
+		 * @return - number of bytes, 0 at end of file.
+		 * @throws - can throw exception.
+		*/
+		std::size_t read( const unsigned char *& pData ) override;
+
+		/*
+		 * Resize read-buffer.
+		 *
+		 * @thread_safety - not thread-safe.
+		 * @param readSize - bytes per read.
+		 * @throws - can throw exception (bad_alloc).
+		*/
+		void setReadSize( const std::uint32_t readSize ) override;
+
+		// -------------------------------------------------------- \\
+
+	};
+
+	// -------------------------------------------------------- \\
+
+}
\ No newline at end of file
@@ -0,0 +1,102 @@
+/*
+* Copyright  2018 Denis Zyamaev (code4un@yandex.ru) All rights reserved.
+* Authors: Denis Zyamaev (code4un@yandex.ru)
+* All rights reserved.
+* API: C++ 11
+* License: see LICENSE.txt
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+* 1. Redistributions of source code must retain the above copyright notice,
+* this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must display the names 'Denis Zyamaev' and
+* in the credits of the application, if such credits exist.
+* The authors of this work must be notified via email (code4un@yandex.ru) in
+* this case of redistribution.
+* 3. Neither the name of copyright holders nor the names of its contributors
+* may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS
+* IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+* PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// HEADER
+#include "PoliteOutputSink.hpp"
+
+namespace c0de4un
+{
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Constructor & destructor
+	// ===========================================================
+
+	/*
+	 * PoliteOutputSink constructor.
+	 *
+	 * @param pFile - file to write, must be regular file.
+	 * @throws - can throw exception, if file is not regular.
+	*/
+	PoliteOutputSink::PoliteOutputSink( std::FILE *const pFile )
+		: mFile( pFile ),
+		mCursor( pFile, true )
+	{
+	}
+
+	// ===========================================================
+	// Methods
+	// ===========================================================
+
+	/*
+	 * Writes data to file.
+	 *
+	 * @thread_safety - not thread-safe.
+	 * @param pData - data to write.
+	 * @param pSize - number of bytes.
+	 * @throws - can throw exception.
+	*/
+	void PoliteOutputSink::write( const unsigned char *const pData, const std::size_t pSize )
+	{
+
+		// Write
+		if ( fwrite( pData, sizeof( unsigned char ), pSize, mFile ) != pSize || ferror( mFile ) )
+			throw std::runtime_error( "PoliteOutputSink::write - failed to write output file" );
+
+		// Start writeback & drop pages behind
+		mCursor.advance( pSize );
+
+	}
+
+	/*
+	 * Flushes file, writes it to disk & drops it's pages.
+	 *
+	 * @thread_safety - not thread-safe.
+	 * @throws - can throw exception.
+	*/
+	void PoliteOutputSink::finish( )
+	{
+
+		// Write stdio buffer
+		if ( fflush( mFile ) != 0 )
+			throw std::runtime_error( "PoliteOutputSink::finish - failed to write output file" );
+
+		// Write to disk & drop
+		mCursor.finish( );
+
+	}
+
+	// -------------------------------------------------------- \\
+
+}
\ No newline at end of file
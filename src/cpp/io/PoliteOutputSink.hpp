@@ -0,0 +1,131 @@
+/*
+* Copyright  2018 Denis Zyamaev (code4un@yandex.ru) All rights reserved.
+* Authors: Denis Zyamaev (code4un@yandex.ru)
+* All rights reserved.
+* API: C++ 11
+* License: see LICENSE.txt
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+* 1. Redistributions of source code must retain the above copyright notice,
+* this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must display the names 'Denis Zyamaev' and
+* in the credits of the application, if such credits exist.
+* The authors of this work must be notified via email (code4un@yandex.ru) in
+* this case of redistribution.
+* 3. Neither the name of copyright holders nor the names of its contributors
+* may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS
+* IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+* PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+// Include OutputSink
+#include "OutputSink.hpp"
+
+// Include PageCacheCursor
+#include "PageCacheCursor.hpp"
+
+namespace c0de4un
+{
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Types
+	// ===========================================================
+
+	/*
+	  * PoliteOutputSink - writes regular file with fwrite, keeping it's
+	  * page-cache footprint small (see PageCacheCursor): writeback is
+	  * started per window & written windows are dropped. finish writes
+	  * the rest to disk & drops all pages of the output.
+	  *
+	  * @language C++ 17
+	  *
+	  * @authors Z. Denis (c0de4un@yandex.ru)
+	  * @version 1.0
+	 */
+	class PoliteOutputSink final : public OutputSink
+	{
+
+	private:
+
+		// -------------------------------------------------------- \\
+
+		// ===========================================================
+		// Fields
+		// ===========================================================
+
+		/* Output file */
+		std::FILE * mFile;
+
+		/* Page-cache cursor */
+		PageCacheCursor mCursor;
+
+		// -------------------------------------------------------- \\
+
+	public:
+
+		// -------------------------------------------------------- \\
+
+		// ===========================================================
+		// Constructor & destructor
+		// ===========================================================
+
+		/*
+		 * PoliteOutputSink constructor.
+		 *
+		 * @param pFile - file to write, must be regular file.
+		 * @throws - can throw exception, if file is not regular.
+		*/
+		explicit PoliteOutputSink( std::FILE *const pFile );
+
+		/* @deleted PoliteOutputSink copy-constructor */
+		PoliteOutputSink( const PoliteOutputSink & ) = delete;
+
+		/* @deleted PoliteOutputSink copy-assignment */
+		PoliteOutputSink & operator=( const PoliteOutputSink & ) = delete;
+
+		// ===========================================================
+		// Methods
+		// ===========================================================
+
+		/*
+		 * Writes data to file.
+		 *
+		 * @thread_safety - not thread-safe.
+		 * @param pData - data to write.
+		 * @param pSize - number of bytes.
+		 * @throws - can throw exception.
+		*/
+		void write( const unsigned char *const pData, const std::size_t pSize ) override;
+
+		/*
+		 * Flushes file, writes it to disk & drops it's pages.
+		 *
+		 * @thread_safety - not thread-safe.
+		 * @throws - can throw exception.
+		*/
+		void finish( ) override;
+
+		// -------------------------------------------------------- \\
+
+	};
+
+	// -------------------------------------------------------- \\
+
+}
\ No newline at end of file
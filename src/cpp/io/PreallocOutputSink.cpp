@@ -0,0 +1,259 @@
+/*
+* Copyright  2018 Denis Zyamaev (code4un@yandex.ru) All rights reserved.
+* Authors: Denis Zyamaev (code4un@yandex.ru)
+* All rights reserved.
+* API: C++ 11
+* License: see LICENSE.txt
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+* 1. Redistributions of source code must retain the above copyright notice,
+* this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must display the names 'Denis Zyamaev' and
+* in the credits of the application, if such credits exist.
+* The authors of this work must be notified via email (code4un@yandex.ru) in
+* this case of redistribution.
+* 3. Neither the name of copyright holders nor the names of its contributors
+* may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS
+* IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+* PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// HEADER
+#include "PreallocOutputSink.hpp"
+
+// Include POSIX file API
+#if !defined( _WIN32 )
+#  include <fcntl.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+namespace c0de4un
+{
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Constructor & destructor
+	// ===========================================================
+
+	/*
+	 * PreallocOutputSink constructor. Data is written from the current
+	 * position of the file.
+	 *
+	 * @param pFile - file to write, must be regular file.
+	 * @param expectedSize - expected number of bytes to write, reserved in file. 0 if unknown.
+	 * @param directIO - true to write with O_DIRECT, if file position is aligned & file system supports it.
+	 * @param bufferSize - size of buffer, rounded up to ALIGNMENT.
+	 * @throws - can throw exception, if file is not regular.
+	*/
+	PreallocOutputSink::PreallocOutputSink( std::FILE *const pFile, const std::uint64_t expectedSize, const bool directIO, const std::uint32_t bufferSize )
+		: mFile( pFile ),
+		mFileDescriptor( -1 ),
+		mFileFlags( 0 ),
+		mDirect( false ),
+		mOffset( 0 ),
+		mMemory( ),
+		mBuffer( nullptr ),
+		mBufferSize( ( std::max<std::uint32_t>( bufferSize, ALIGNMENT ) + ALIGNMENT - 1 ) / ALIGNMENT * ALIGNMENT ),
+		mFillSize( 0 )
+	{
+
+#if defined( _WIN32 )
+
+		// Not supported, stdio is used
+		static_cast<void>( expectedSize );
+		static_cast<void>( directIO );
+		throw std::runtime_error( "PreallocOutputSink - not supported" );
+
+#else
+
+		// Write pending stdio data, file is written by descriptor
+		if ( fflush( pFile ) != 0 )
+			throw std::runtime_error( "PreallocOutputSink - failed to flush output file" );
+
+		// Get file descriptor
+		mFileDescriptor = fileno( pFile );
+
+		// Check file type
+		struct stat fileStat;
+		if ( mFileDescriptor < 0 || fstat( mFileDescriptor, &fileStat ) != 0 || !S_ISREG( fileStat.st_mode ) )
+			throw std::runtime_error( "PreallocOutputSink - not a regular file" );
+
+		// Get current position
+		const off_t position( ftello( pFile ) );
+		mOffset = position > 0 ? static_cast<std::uint64_t>( position ) : 0;
+
+		// Reserve space. Not supported by file system or no space: file grows by writes.
+#if defined( __linux__ )
+		if ( expectedSize > 0 )
+			static_cast<void>( fallocate( mFileDescriptor, 0, static_cast<off_t>( mOffset ), static_cast<off_t>( expectedSize ) ) );
+#else
+		static_cast<void>( expectedSize );
+#endif
+
+		// Allocate aligned buffer
+		mMemory.resize( static_cast<std::size_t>( mBufferSize ) + ALIGNMENT );
+		mBuffer = mMemory.data( ) + ( ALIGNMENT - reinterpret_cast<std::uintptr_t>( mMemory.data( ) ) % ALIGNMENT ) % ALIGNMENT;
+
+		// Direct io, only from aligned position. Not supported by file system: buffered writes.
+#if defined( O_DIRECT )
+		if ( directIO && mOffset % ALIGNMENT == 0 )
+		{
+
+			mFileFlags = fcntl( mFileDescriptor, F_GETFL );
+			mDirect = mFileFlags != -1 && fcntl( mFileDescriptor, F_SETFL, mFileFlags | O_DIRECT ) == 0;
+
+		}
+#else
+		static_cast<void>( directIO );
+#endif
+
+#endif
+
+	}
+
+	/* PreallocOutputSink destructor. Restores file-descriptor flags. */
+	PreallocOutputSink::~PreallocOutputSink( )
+	{ restoreFlags( ); }
+
+	// ===========================================================
+	// Methods
+	// ===========================================================
+
+	/*
+	 * Write bytes of buffer at the current offset.
+	 *
+	 * @param pSize - number of bytes to write, aligned for direct io.
+	 * @throws - can throw exception.
+	*/
+	void PreallocOutputSink::writeBuffer( const std::uint32_t pSize )
+	{
+
+#if !defined( _WIN32 )
+
+		// Write, completing short writes
+		for ( std::uint32_t writeCount = 0; writeCount < pSize; )
+		{
+
+			const ssize_t written( pwrite( mFileDescriptor, mBuffer + writeCount, pSize - writeCount, static_cast<off_t>( mOffset + writeCount ) ) );
+
+			if ( written <= 0 )
+				throw std::runtime_error( "PreallocOutputSink - failed to write output file" );
+
+			writeCount += static_cast<std::uint32_t>( written );
+
+		}
+
+#endif
+
+	}
+
+	/* Restores status flags of file-descriptor */
+	void PreallocOutputSink::restoreFlags( ) noexcept
+	{
+
+#if !defined( _WIN32 )
+
+		if ( mDirect )
+		{
+			static_cast<void>( fcntl( mFileDescriptor, F_SETFL, mFileFlags ) );
+			mDirect = false;
+		}
+
+#endif
+
+	}
+
+	/*
+	 * Copies data into buffer, writing full buffer.
+	 *
+	 * @thread_safety - not thread-safe.
+	 * @param pData - data to write.
+	 * @param pSize - number of bytes.
+	 * @throws - can throw exception.
+	*/
+	void PreallocOutputSink::write( const unsigned char *const pData, const std::size_t pSize )
+	{
+
+		// Number of bytes copied
+		std::size_t copied( 0 );
+
+		// Copy
+		while ( copied < pSize )
+		{
+
+			// Copy into buffer
+			const std::uint32_t copyCount( static_cast<std::uint32_t>( std::min<std::size_t>( pSize - copied, mBufferSize - mFillSize ) ) );
+			std::memcpy( mBuffer + mFillSize, pData + copied, copyCount );
+			mFillSize += copyCount;
+			copied += copyCount;
+
+			// Write full buffer
+			if ( mFillSize == mBufferSize )
+			{
+				writeBuffer( mFillSize );
+				mOffset += mFillSize;
+				mFillSize = 0;
+			}
+
+		}
+
+	}
+
+	/*
+	 * Writes last buffer, trims file to the written length & moves
+	 * file position to the end of written data.
+	 *
+	 * @thread_safety - not thread-safe.
+	 * @throws - can throw exception.
+	*/
+	void PreallocOutputSink::finish( )
+	{
+
+		// Write last buffer, direct io writes whole aligned blocks
+		if ( mFillSize > 0 )
+		{
+
+			const std::uint32_t writeSize( mDirect ? ( mFillSize + ALIGNMENT - 1 ) / ALIGNMENT * ALIGNMENT : mFillSize );
+			std::memset( mBuffer + mFillSize, 0, writeSize - mFillSize );
+
+			writeBuffer( writeSize );
+			mOffset += mFillSize;
+			mFillSize = 0;
+
+		}
+
+		// Buffered writes from now
+		restoreFlags( );
+
+#if !defined( _WIN32 )
+
+		// Trim reserved space & padding
+		if ( ftruncate( mFileDescriptor, static_cast<off_t>( mOffset ) ) != 0 )
+			throw std::runtime_error( "PreallocOutputSink::finish - failed to trim output file" );
+
+		// Keep stdio position consistent with written data
+		if ( fseeko( mFile, static_cast<off_t>( mOffset ), SEEK_SET ) != 0 )
+			throw std::runtime_error( "PreallocOutputSink::finish - failed to set output file position" );
+
+#endif
+
+	}
+
+	// -------------------------------------------------------- \\
+
+}
\ No newline at end of file
@@ -0,0 +1,185 @@
+/*
+* Copyright  2018 Denis Zyamaev (code4un@yandex.ru) All rights reserved.
+* Authors: Denis Zyamaev (code4un@yandex.ru)
+* All rights reserved.
+* API: C++ 11
+* License: see LICENSE.txt
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+* 1. Redistributions of source code must retain the above copyright notice,
+* this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must display the names 'Denis Zyamaev' and
+* in the credits of the application, if such credits exist.
+* The authors of this work must be notified via email (code4un@yandex.ru) in
+* this case of redistribution.
+* 3. Neither the name of copyright holders nor the names of its contributors
+* may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS
+* IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+* PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+// Include OutputSink
+#include "OutputSink.hpp"
+
+namespace c0de4un
+{
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Types
+	// ===========================================================
+
+	/*
+	  * PreallocOutputSink - writes regular file with large aligned pwrite's.
+	  *
+	  * Space for the expected size is reserved with fallocate, so large
+	  * outputs don't grow extent by extent. Data is collected into an
+	  * aligned buffer & written at once when buffer is full. With direct
+	  * io, file is written with O_DIRECT, bypassing the page cache; the
+	  * last block is padded & file is trimmed to the written length.
+	  *
+	  * @language C++ 17
+	  *
+	  * @authors Z. Denis (c0de4un@yandex.ru)
+	  * @version 1.0
+	 */
+	class PreallocOutputSink final : public OutputSink
+	{
+
+	private:
+
+		// -------------------------------------------------------- \\
+
+		// ===========================================================
+		// Fields
+		// ===========================================================
+
+		/* Output file */
+		std::FILE * mFile;
+
+		/* File-descriptor */
+		int mFileDescriptor;
+
+		/* Status flags of file-descriptor, before O_DIRECT was set */
+		int mFileFlags;
+
+		/* true, if file-descriptor uses O_DIRECT */
+		bool mDirect;
+
+		/* Offset of the next write */
+		std::uint64_t mOffset;
+
+		/* Buffer memory, oversized for alignment */
+		std::vector<unsigned char> mMemory;
+
+		/* Aligned buffer in mMemory */
+		unsigned char * mBuffer;
+
+		/* Size of buffer */
+		std::uint32_t mBufferSize;
+
+		/* Number of bytes in buffer */
+		std::uint32_t mFillSize;
+
+		// ===========================================================
+		// Methods
+		// ===========================================================
+
+		/*
+		 * Write bytes of buffer at the current offset.
+		 *
+		 * @param pSize - number of bytes to write, aligned for direct io.
+		 * @throws - can throw exception.
+		*/
+		void writeBuffer( const std::uint32_t pSize );
+
+		/* Restores status flags of file-descriptor */
+		void restoreFlags( ) noexcept;
+
+		// -------------------------------------------------------- \\
+
+	public:
+
+		// -------------------------------------------------------- \\
+
+		// ===========================================================
+		// Constants
+		// ===========================================================
+
+		/* Default size of buffer */
+		static constexpr std::uint32_t DEFAULT_BUFFER_SIZE = 1048576;
+
+		/* Alignment of buffer, offsets & sizes for direct io */
+		static constexpr std::uint32_t ALIGNMENT = 4096;
+
+		// ===========================================================
+		// Constructor & destructor
+		// ===========================================================
+
+		/*
+		 * PreallocOutputSink constructor. Data is written from the current
+		 * position of the file.
+		 *
+		 * @param pFile - file to write, must be regular file.
+		 * @param expectedSize - expected number of bytes to write, reserved in file. 0 if unknown.
+		 * @param directIO - true to write with O_DIRECT, if file position is aligned & file system supports it.
+		 * @param bufferSize - size of buffer, rounded up to ALIGNMENT.
+		 * @throws - can throw exception, if file is not regular.
+		*/
+		explicit PreallocOutputSink( std::FILE *const pFile, const std::uint64_t expectedSize, const bool directIO = false, const std::uint32_t bufferSize = DEFAULT_BUFFER_SIZE );
+
+		/* PreallocOutputSink destructor. Restores file-descriptor flags. */
+		~PreallocOutputSink( );
+
+		/* @deleted PreallocOutputSink copy-constructor */
+		PreallocOutputSink( const PreallocOutputSink & ) = delete;
+
+		/* @deleted PreallocOutputSink copy-assignment */
+		PreallocOutputSink & operator=( const PreallocOutputSink & ) = delete;
+
+		// ===========================================================
+		// Methods
+		// ===========================================================
+
+		/*
+		 * Copies data into buffer, writing full buffer.
+		 *
+		 * @thread_safety - not thread-safe.
+		 * @param pData - data to write.
+		 * @param pSize - number of bytes.
+		 * @throws - can throw exception.
+		*/
+		void write( const unsigned char *const pData, const std::size_t pSize ) override;
+
+		/*
+		 * Writes last buffer, trims file to the written length & moves
+		 * file position to the end of written data.
+		 *
+		 * @thread_safety - not thread-safe.
+		 * @throws - can throw exception.
+		*/
+		void finish( ) override;
+
+		// -------------------------------------------------------- \\
+
+	};
+
+	// -------------------------------------------------------- \\
+
+}
\ No newline at end of file
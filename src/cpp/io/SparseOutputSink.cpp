@@ -0,0 +1,325 @@
+/*
+* Copyright  2018 Denis Zyamaev (code4un@yandex.ru) All rights reserved.
+* Authors: Denis Zyamaev (code4un@yandex.ru)
+* All rights reserved.
+* API: C++ 11
+* License: see LICENSE.txt
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+* 1. Redistributions of source code must retain the above copyright notice,
+* this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must display the names 'Denis Zyamaev' and
+* in the credits of the application, if such credits exist.
+* The authors of this work must be notified via email (code4un@yandex.ru) in
+* this case of redistribution.
+* 3. Neither the name of copyright holders nor the names of its contributors
+* may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS
+* IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+* PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// HEADER
+#include "SparseOutputSink.hpp"
+
+// Include POSIX file API
+#if !defined( _WIN32 )
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+// Include SSE2
+#if defined( __SSE2__ ) || defined( _M_X64 )
+#  include <emmintrin.h>
+#  define SPARSE_USE_SSE2
+#endif
+
+namespace c0de4un
+{
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Constructor & destructor
+	// ===========================================================
+
+	/*
+	 * SparseOutputSink constructor. Data is written from the current
+	 * position of the file, file is truncated at it.
+	 *
+	 * @param pFile - file to write, must be regular file.
+	 * @param bufferSize - size of buffer.
+	 * @throws - can throw exception, if file is not regular.
+	*/
+	SparseOutputSink::SparseOutputSink( std::FILE *const pFile, const std::uint32_t bufferSize )
+		: mFile( pFile ),
+		mFileDescriptor( -1 ),
+		mOffset( 0 ),
+		mBuffer( std::max<std::uint32_t>( bufferSize, BLOCK_SIZE ) ),
+		mFillSize( 0 ),
+		mSkippedSize( 0 )
+	{
+
+#if defined( _WIN32 )
+
+		// Not supported, stdio is used
+		throw std::runtime_error( "SparseOutputSink - not supported" );
+
+#else
+
+		// Write pending stdio data, file is written by descriptor
+		if ( fflush( pFile ) != 0 )
+			throw std::runtime_error( "SparseOutputSink - failed to flush output file" );
+
+		// Get file descriptor
+		mFileDescriptor = fileno( pFile );
+
+		// Check file type
+		struct stat fileStat;
+		if ( mFileDescriptor < 0 || fstat( mFileDescriptor, &fileStat ) != 0 || !S_ISREG( fileStat.st_mode ) )
+			throw std::runtime_error( "SparseOutputSink - not a regular file" );
+
+		// Get current position
+		const off_t position( ftello( pFile ) );
+		mOffset = position > 0 ? static_cast<std::uint64_t>( position ) : 0;
+
+		// Holes must read as zeros
+		if ( static_cast<std::uint64_t>( fileStat.st_size ) > mOffset && ftruncate( mFileDescriptor, static_cast<off_t>( mOffset ) ) != 0 )
+			throw std::runtime_error( "SparseOutputSink - failed to truncate output file" );
+
+#endif
+
+	}
+
+	// ===========================================================
+	// Getters
+	// ===========================================================
+
+	/* Returns number of zero bytes, that were not written */
+	std::uint64_t SparseOutputSink::getSkippedSize( ) const noexcept
+	{ return( mSkippedSize ); }
+
+	// ===========================================================
+	// Methods
+	// ===========================================================
+
+	/*
+	 * Returns true, if all bytes are zero.
+	 *
+	 * @param pData - data.
+	 * @param pSize - number of bytes.
+	*/
+	bool SparseOutputSink::isZero( const unsigned char *const pData, const std::size_t pSize ) noexcept
+	{
+
+		// Scanned bytes
+		std::size_t scanCount( 0 );
+
+#if defined( SPARSE_USE_SSE2 )
+
+		// 64 bytes per step, OR of 4 vectors
+		const __m128i zeroVector( _mm_setzero_si128( ) );
+		for ( ; scanCount + 64 <= pSize; scanCount += 64 )
+		{
+
+			const __m128i orVector( _mm_or_si128( _mm_or_si128( _mm_loadu_si128( reinterpret_cast<const __m128i*>( pData + scanCount ) ), _mm_loadu_si128( reinterpret_cast<const __m128i*>( pData + scanCount + 16 ) ) ),
+				_mm_or_si128( _mm_loadu_si128( reinterpret_cast<const __m128i*>( pData + scanCount + 32 ) ), _mm_loadu_si128( reinterpret_cast<const __m128i*>( pData + scanCount + 48 ) ) ) ) );
+
+			if ( _mm_movemask_epi8( _mm_cmpeq_epi8( orVector, zeroVector ) ) != 0xFFFF )
+				return( false );
+
+		}
+
+#else
+
+		// 8 bytes per step
+		for ( ; scanCount + 8 <= pSize; scanCount += 8 )
+		{
+
+			std::uint64_t word;
+			std::memcpy( &word, pData + scanCount, 8 );
+
+			if ( word != 0 )
+				return( false );
+
+		}
+
+#endif
+
+		// Tail
+		for ( ; scanCount < pSize; scanCount++ )
+			if ( pData[scanCount] != 0 )
+				return( false );
+
+		return( true );
+
+	}
+
+	/*
+	 * Write non-zero blocks of buffer & clear it.
+	 *
+	 * @throws - can throw exception.
+	*/
+	void SparseOutputSink::flush( )
+	{
+
+		// Start of non-zero run, mFillSize if none
+		std::size_t runStart( mFillSize );
+
+		// Scan blocks, aligned to file offset
+		for ( std::size_t blockStart = 0; blockStart < mFillSize; )
+		{
+
+			const std::size_t blockEnd( std::min<std::size_t>( mFillSize, blockStart + BLOCK_SIZE - static_cast<std::size_t>( ( mOffset + blockStart ) % BLOCK_SIZE ) ) );
+
+			if ( isZero( mBuffer.data( ) + blockStart, blockEnd - blockStart ) )
+			{
+
+				// Write run before hole
+				if ( runStart < blockStart )
+					writeAt( mBuffer.data( ) + runStart, blockStart - runStart, mOffset + runStart );
+
+				runStart = mFillSize;
+				mSkippedSize += blockEnd - blockStart;
+
+			}
+			else if ( runStart == mFillSize )
+				runStart = blockStart;
+
+			blockStart = blockEnd;
+
+		}
+
+		// Write last run
+		if ( runStart < mFillSize )
+			writeAt( mBuffer.data( ) + runStart, mFillSize - runStart, mOffset + runStart );
+
+		// Clear buffer
+		mOffset += mFillSize;
+		mFillSize = 0;
+
+	}
+
+	/*
+	 * Write bytes at file offset.
+	 *
+	 * @param pData - data.
+	 * @param pSize - number of bytes.
+	 * @param pOffset - file offset.
+	 * @throws - can throw exception.
+	*/
+	void SparseOutputSink::writeAt( const unsigned char *const pData, const std::size_t pSize, const std::uint64_t pOffset )
+	{
+
+#if !defined( _WIN32 )
+
+		// Write, completing short writes
+		for ( std::size_t writeCount = 0; writeCount < pSize; )
+		{
+
+			const ssize_t written( pwrite( mFileDescriptor, pData + writeCount, pSize - writeCount, static_cast<off_t>( pOffset + writeCount ) ) );
+
+			if ( written <= 0 )
+				throw std::runtime_error( "SparseOutputSink - failed to write output file" );
+
+			writeCount += static_cast<std::size_t>( written );
+
+		}
+
+#endif
+
+	}
+
+	/*
+	 * Copies data into buffer, writing full buffer.
+	 *
+	 * @thread_safety - not thread-safe.
+	 * @param pData - data to write.
+	 * @param pSize - number of bytes.
+	 * @throws - can throw exception.
+	*/
+	void SparseOutputSink::write( const unsigned char *const pData, const std::size_t pSize )
+	{
+
+		// Number of bytes copied
+		std::size_t copied( 0 );
+
+		// Copy
+		while ( copied < pSize )
+		{
+
+			// Copy into buffer
+			const std::size_t copyCount( std::min<std::size_t>( pSize - copied, mBuffer.size( ) - mFillSize ) );
+			std::memcpy( mBuffer.data( ) + mFillSize, pData + copied, copyCount );
+			mFillSize += copyCount;
+			copied += copyCount;
+
+			// Write full buffer
+			if ( mFillSize == mBuffer.size( ) )
+				flush( );
+
+		}
+
+	}
+
+	/*
+	 * Skip zero bytes, they become hole.
+	 *
+	 * @thread_safety - not thread-safe.
+	 * @param pSize - number of zero bytes.
+	 * @throws - can throw exception.
+	*/
+	void SparseOutputSink::skip( const std::uint64_t pSize )
+	{
+
+		// Write buffered data
+		flush( );
+
+		// Move offset
+		mOffset += pSize;
+		mSkippedSize += pSize;
+
+	}
+
+	/*
+	 * Writes last buffer, sets file length & moves file position
+	 * to the end of written data.
+	 *
+	 * @thread_safety - not thread-safe.
+	 * @throws - can throw exception.
+	*/
+	void SparseOutputSink::finish( )
+	{
+
+		// Write last buffer
+		flush( );
+
+#if !defined( _WIN32 )
+
+		// Length, trailing zeros were skipped
+		if ( ftruncate( mFileDescriptor, static_cast<off_t>( mOffset ) ) != 0 )
+			throw std::runtime_error( "SparseOutputSink::finish - failed to set output file length" );
+
+		// Keep stdio position consistent with written data
+		if ( fseeko( mFile, static_cast<off_t>( mOffset ), SEEK_SET ) != 0 )
+			throw std::runtime_error( "SparseOutputSink::finish - failed to set output file position" );
+
+#endif
+
+	}
+
+	// -------------------------------------------------------- \\
+
+}
\ No newline at end of file
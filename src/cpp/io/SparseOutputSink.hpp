@@ -0,0 +1,204 @@
+/*
+* Copyright  2018 Denis Zyamaev (code4un@yandex.ru) All rights reserved.
+* Authors: Denis Zyamaev (code4un@yandex.ru)
+* All rights reserved.
+* API: C++ 11
+* License: see LICENSE.txt
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+* 1. Redistributions of source code must retain the above copyright notice,
+* this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must display the names 'Denis Zyamaev' and
+* in the credits of the application, if such credits exist.
+* The authors of this work must be notified via email (code4un@yandex.ru) in
+* this case of redistribution.
+* 3. Neither the name of copyright holders nor the names of its contributors
+* may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS
+* IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+* PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+// Include OutputSink
+#include "OutputSink.hpp"
+
+namespace c0de4un
+{
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Types
+	// ===========================================================
+
+	/*
+	  * SparseOutputSink - writes regular file, skipping all-zero blocks.
+	  *
+	  * Data is collected into a buffer. When buffer is full, it is scanned
+	  * by file-system blocks (aligned to file offset): runs of non-zero
+	  * blocks are written with pwrite, zero blocks are skipped & become
+	  * holes. File is truncated to the written length at the end, so
+	  * trailing zeros are a hole too.
+	  *
+	  * File is truncated at the start position, stale data after it would
+	  * show through holes.
+	  *
+	  * @language C++ 17
+	  *
+	  * @authors Z. Denis (c0de4un@yandex.ru)
+	  * @version 1.0
+	 */
+	class SparseOutputSink final : public OutputSink
+	{
+
+	private:
+
+		// -------------------------------------------------------- \\
+
+		// ===========================================================
+		// Fields
+		// ===========================================================
+
+		/* Output file */
+		std::FILE * mFile;
+
+		/* File-descriptor */
+		int mFileDescriptor;
+
+		/* Offset of the buffer start */
+		std::uint64_t mOffset;
+
+		/* Buffer */
+		std::vector<unsigned char> mBuffer;
+
+		/* Number of bytes in buffer */
+		std::size_t mFillSize;
+
+		/* Number of bytes skipped as holes */
+		std::uint64_t mSkippedSize;
+
+		// ===========================================================
+		// Methods
+		// ===========================================================
+
+		/*
+		 * Returns true, if all bytes are zero.
+		 *
+		 * @param pData - data.
+		 * @param pSize - number of bytes.
+		*/
+		static bool isZero( const unsigned char *const pData, const std::size_t pSize ) noexcept;
+
+		/*
+		 * Write non-zero blocks of buffer & clear it.
+		 *
+		 * @throws - can throw exception.
+		*/
+		void flush( );
+
+		/*
+		 * Write bytes at file offset.
+		 *
+		 * @param pData - data.
+		 * @param pSize - number of bytes.
+		 * @param pOffset - file offset.
+		 * @throws - can throw exception.
+		*/
+		void writeAt( const unsigned char *const pData, const std::size_t pSize, const std::uint64_t pOffset );
+
+		// -------------------------------------------------------- \\
+
+	public:
+
+		// -------------------------------------------------------- \\
+
+		// ===========================================================
+		// Constants
+		// ===========================================================
+
+		/* Default size of buffer */
+		static constexpr std::uint32_t DEFAULT_BUFFER_SIZE = 1048576;
+
+		/* Size of block, scanned for zeros */
+		static constexpr std::uint32_t BLOCK_SIZE = 4096;
+
+		// ===========================================================
+		// Constructor & destructor
+		// ===========================================================
+
+		/*
+		 * SparseOutputSink constructor. Data is written from the current
+		 * position of the file, file is truncated at it.
+		 *
+		 * @param pFile - file to write, must be regular file.
+		 * @param bufferSize - size of buffer.
+		 * @throws - can throw exception, if file is not regular.
+		*/
+		explicit SparseOutputSink( std::FILE *const pFile, const std::uint32_t bufferSize = DEFAULT_BUFFER_SIZE );
+
+		/* @deleted SparseOutputSink copy-constructor */
+		SparseOutputSink( const SparseOutputSink & ) = delete;
+
+		/* @deleted SparseOutputSink copy-assignment */
+		SparseOutputSink & operator=( const SparseOutputSink & ) = delete;
+
+		// ===========================================================
+		// Getters
+		// ===========================================================
+
+		/* Returns number of zero bytes, that were not written */
+		std::uint64_t getSkippedSize( ) const noexcept;
+
+		// ===========================================================
+		// Methods
+		// ===========================================================
+
+		/*
+		 * Copies data into buffer, writing full buffer.
+		 *
+		 * @thread_safety - not thread-safe.
+		 * @param pData - data to write.
+		 * @param pSize - number of bytes.
+		 * @throws - can throw exception.
+		*/
+		void write( const unsigned char *const pData, const std::size_t pSize ) override;
+
+		/*
+		 * Skip zero bytes, they become hole.
+		 *
+		 * @thread_safety - not thread-safe.
+		 * @param pSize - number of zero bytes.
+		 * @throws - can throw exception.
+		*/
+		void skip( const std::uint64_t pSize );
+
+		/*
+		 * Writes last buffer, sets file length & moves file position
+		 * to the end of written data.
+		 *
+		 * @thread_safety - not thread-safe.
+		 * @throws - can throw exception.
+		*/
+		void finish( ) override;
+
+		// -------------------------------------------------------- \\
+
+	};
+
+	// -------------------------------------------------------- \\
+
+}
\ No newline at end of file
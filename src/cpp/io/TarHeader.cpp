@@ -0,0 +1,331 @@
+/*
+* Copyright  2018 Denis Zyamaev (code4un@yandex.ru) All rights reserved.
+* Authors: Denis Zyamaev (code4un@yandex.ru)
+* All rights reserved.
+* API: C++ 11
+* License: see LICENSE.txt
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+* 1. Redistributions of source code must retain the above copyright notice,
+* this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must display the names 'Denis Zyamaev' and
+* in the credits of the application, if such credits exist.
+* The authors of this work must be notified via email (code4un@yandex.ru) in
+* this case of redistribution.
+* 3. Neither the name of copyright holders nor the names of its contributors
+* may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS
+* IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+* PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// HEADER
+#include "TarHeader.hpp"
+
+namespace c0de4un
+{
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Methods
+	// ===========================================================
+
+	/*
+	 * Write octal number, zero-terminated.
+	 *
+	 * @param pField - field.
+	 * @param fieldSize - size of field, with terminator.
+	 * @param pValue - value, must fit into field.
+	*/
+	void TarHeader::putOctal( unsigned char *const pField, const std::size_t fieldSize, const std::uint64_t pValue ) noexcept
+	{
+
+		// Digits, from the last one
+		std::uint64_t value( pValue );
+		for ( std::size_t i = fieldSize - 1; i > 0; i-- )
+		{
+			pField[i - 1] = static_cast<unsigned char>( '0' + ( value & 7 ) );
+			value >>= 3;
+		}
+
+		// Terminator
+		pField[fieldSize - 1] = '\0';
+
+	}
+
+	/*
+	 * Returns number of field: octal or base-256 (GNU).
+	 *
+	 * @param pField - field.
+	 * @param fieldSize - size of field.
+	*/
+	std::uint64_t TarHeader::getNumber( const unsigned char *const pField, const std::size_t fieldSize ) noexcept
+	{
+
+		// Value
+		std::uint64_t value( 0 );
+
+		// Base-256, big-endian with high bit set
+		if ( ( pField[0] & 0x80 ) != 0 )
+		{
+
+			value = pField[0] & 0x7F;
+			for ( std::size_t i = 1; i < fieldSize; i++ )
+				value = ( value << 8 ) | pField[i];
+
+			return( value );
+
+		}
+
+		// Octal, leading spaces are skipped
+		std::size_t i( 0 );
+		while ( i < fieldSize && pField[i] == ' ' )
+			i++;
+
+		for ( ; i < fieldSize && pField[i] >= '0' && pField[i] <= '7'; i++ )
+			value = ( value << 3 ) | static_cast<std::uint64_t>( pField[i] - '0' );
+
+		// Return
+		return( value );
+
+	}
+
+	/*
+	 * Returns text of field, up to terminator.
+	 *
+	 * @param pField - field.
+	 * @param fieldSize - size of field.
+	*/
+	std::string TarHeader::getText( const unsigned char *const pField, const std::size_t fieldSize )
+	{
+
+		// Length
+		std::size_t textSize( 0 );
+		while ( textSize < fieldSize && pField[textSize] != '\0' )
+			textSize++;
+
+		// Return
+		return( std::string( reinterpret_cast<const char*>( pField ), textSize ) );
+
+	}
+
+	/*
+	 * Returns sum of header bytes, checksum field counted as spaces.
+	 *
+	 * @param pBlock - header block.
+	*/
+	std::uint32_t TarHeader::getChecksum( const unsigned char *const pBlock ) noexcept
+	{
+
+		// Sum
+		std::uint32_t checksum( 0 );
+		for ( std::size_t i = 0; i < BLOCK_SIZE; i++ )
+			checksum += i >= CHECKSUM_OFFSET && i < CHECKSUM_OFFSET + 8 ? ' ' : pBlock[i];
+
+		// Return
+		return( checksum );
+
+	}
+
+	/*
+	 * Append pax record: "length key=value\n", length counts itself.
+	 *
+	 * @param pRecords - output.
+	 * @param pKey - key.
+	 * @param pValue - value.
+	 * @throws - can throw exception (bad_alloc).
+	*/
+	void TarHeader::putPaxRecord( std::string & pRecords, const char *const pKey, const std::string & pValue )
+	{
+
+		// Size without length: space, key, '=', value & new-line
+		const std::size_t recordSize( std::strlen( pKey ) + pValue.size( ) + 3 );
+
+		// Length, until number of it's digits is stable
+		std::size_t recordLength( recordSize );
+		while ( recordLength != recordSize + std::to_string( recordLength ).size( ) )
+			recordLength = recordSize + std::to_string( recordLength ).size( );
+
+		// Append
+		pRecords += std::to_string( recordLength ) + ' ' + pKey + '=' + pValue + '\n';
+
+	}
+
+	/*
+	 * Append header block.
+	 *
+	 * @param pOutput - output.
+	 * @param pEntry - entry, name, link name & size are cut to field size.
+	 * @throws - can throw exception (bad_alloc).
+	*/
+	void TarHeader::putBlock( std::vector<unsigned char> & pOutput, const Entry & pEntry )
+	{
+
+		// Zero block
+		const std::size_t blockOffset( pOutput.size( ) );
+		pOutput.resize( blockOffset + BLOCK_SIZE, 0 );
+		unsigned char *const blockData( pOutput.data( ) + blockOffset );
+
+		// Fields, owner is root
+		std::memcpy( blockData + NAME_OFFSET, pEntry.name.data( ), std::min( pEntry.name.size( ), NAME_SIZE ) );
+		putOctal( blockData + MODE_OFFSET, 8, pEntry.mode & 07777 );
+		putOctal( blockData + UID_OFFSET, 8, 0 );
+		putOctal( blockData + GID_OFFSET, 8, 0 );
+		putOctal( blockData + SIZE_OFFSET, 12, std::min( pEntry.size, MAX_OCTAL_SIZE ) );
+		putOctal( blockData + MTIME_OFFSET, 12, pEntry.mtime > 0 ? std::min( static_cast<std::uint64_t>( pEntry.mtime ), MAX_OCTAL_SIZE ) : 0 );
+		blockData[TYPE_OFFSET] = static_cast<unsigned char>( pEntry.type );
+		std::memcpy( blockData + LINK_NAME_OFFSET, pEntry.linkName.data( ), std::min( pEntry.linkName.size( ), NAME_SIZE ) );
+
+		// Magic & version: "ustar\0" "00"
+		std::memcpy( blockData + MAGIC_OFFSET, "ustar\0" "00", 8 );
+
+		// Checksum: 6 digits, terminator & space
+		putOctal( blockData + CHECKSUM_OFFSET, 7, getChecksum( blockData ) );
+		blockData[CHECKSUM_OFFSET + 7] = ' ';
+
+	}
+
+	/*
+	 * Returns number of padding bytes after data.
+	 *
+	 * @param pSize - size of data.
+	*/
+	std::size_t TarHeader::getPaddingSize( const std::uint64_t pSize ) noexcept
+	{ return( static_cast<std::size_t>( ( BLOCK_SIZE - pSize % BLOCK_SIZE ) % BLOCK_SIZE ) ); }
+
+	/*
+	 * Append header of entry, with pax header if required.
+	 *
+	 * @param pOutput - output.
+	 * @param pEntry - entry.
+	 * @throws - can throw exception (bad_alloc).
+	*/
+	void TarHeader::write( std::vector<unsigned char> & pOutput, const Entry & pEntry )
+	{
+
+		// pax records of fields, that don't fit
+		std::string paxRecords;
+
+		if ( pEntry.name.size( ) > NAME_SIZE )
+			putPaxRecord( paxRecords, "path", pEntry.name );
+
+		if ( pEntry.linkName.size( ) > NAME_SIZE )
+			putPaxRecord( paxRecords, "linkpath", pEntry.linkName );
+
+		if ( pEntry.size > MAX_OCTAL_SIZE )
+			putPaxRecord( paxRecords, "size", std::to_string( pEntry.size ) );
+
+		// pax header & records
+		if ( !paxRecords.empty( ) )
+		{
+
+			putBlock( pOutput, Entry{ PAX_NAME, std::string( ), TYPE_PAX, 0644, paxRecords.size( ), pEntry.mtime } );
+			pOutput.insert( pOutput.end( ), paxRecords.begin( ), paxRecords.end( ) );
+			pOutput.resize( pOutput.size( ) + getPaddingSize( paxRecords.size( ) ), 0 );
+
+		}
+
+		// ustar header
+		putBlock( pOutput, pEntry );
+
+	}
+
+	/*
+	 * Read header block.
+	 *
+	 * @param pBlock - header block.
+	 * @param pEntry - receives entry.
+	 * @return - false, if block is zero (end of archive).
+	 * @throws - can throw exception, if checksum is wrong.
+	*/
+	bool TarHeader::read( const unsigned char *const pBlock, Entry & pEntry )
+	{
+
+		// Zero block ends archive
+		if ( std::all_of( pBlock, pBlock + BLOCK_SIZE, []( const unsigned char pByte ) { return( pByte == 0 ); } ) )
+			return( false );
+
+		// Check
+		if ( getChecksum( pBlock ) != getNumber( pBlock + CHECKSUM_OFFSET, 8 ) )
+			throw std::runtime_error( "TarHeader::read - wrong header checksum, not a tar archive" );
+
+		// Name, POSIX ustar has prefix
+		pEntry.name = getText( pBlock + NAME_OFFSET, NAME_SIZE );
+
+		if ( std::memcmp( pBlock + MAGIC_OFFSET, "ustar\0", 6 ) == 0 && pBlock[PREFIX_OFFSET] != '\0' )
+			pEntry.name = getText( pBlock + PREFIX_OFFSET, PREFIX_SIZE ) + '/' + pEntry.name;
+
+		// Fields
+		pEntry.linkName = getText( pBlock + LINK_NAME_OFFSET, NAME_SIZE );
+		pEntry.type = static_cast<char>( pBlock[TYPE_OFFSET] );
+		pEntry.mode = static_cast<std::uint32_t>( getNumber( pBlock + MODE_OFFSET, 8 ) & 07777 );
+		pEntry.size = getNumber( pBlock + SIZE_OFFSET, 12 );
+		pEntry.mtime = static_cast<std::int64_t>( getNumber( pBlock + MTIME_OFFSET, 12 ) );
+
+		// Return
+		return( true );
+
+	}
+
+	/*
+	 * Apply pax records to entry: path, linkpath, size, mtime.
+	 *
+	 * @param pRecords - data of pax header.
+	 * @param pEntry - entry to change.
+	 * @throws - can throw exception, if records are corrupted.
+	*/
+	void TarHeader::readPax( const std::string & pRecords, Entry & pEntry )
+	{
+
+		for ( std::size_t recordOffset = 0; recordOffset < pRecords.size( ); )
+		{
+
+			// Length & key=value
+			const std::size_t spaceOffset( pRecords.find( ' ', recordOffset ) );
+			const std::size_t recordLength( spaceOffset != std::string::npos ? std::strtoull( pRecords.c_str( ) + recordOffset, nullptr, 10 ) : 0 );
+
+			if ( recordLength <= spaceOffset - recordOffset + 1 || recordOffset + recordLength > pRecords.size( ) || pRecords[recordOffset + recordLength - 1] != '\n' )
+				throw std::runtime_error( "TarHeader::readPax - pax records corrupted" );
+
+			const std::string record( pRecords, spaceOffset + 1, recordOffset + recordLength - spaceOffset - 2 );
+			const std::size_t equalOffset( record.find( '=' ) );
+
+			if ( equalOffset == std::string::npos )
+				throw std::runtime_error( "TarHeader::readPax - pax records corrupted" );
+
+			const std::string recordKey( record, 0, equalOffset );
+			const std::string recordValue( record, equalOffset + 1 );
+
+			// Apply, other keys are ignored
+			if ( recordKey == "path" )
+				pEntry.name = recordValue;
+			else if ( recordKey == "linkpath" )
+				pEntry.linkName = recordValue;
+			else if ( recordKey == "size" )
+				pEntry.size = std::strtoull( recordValue.c_str( ), nullptr, 10 );
+			else if ( recordKey == "mtime" )
+				pEntry.mtime = std::strtoll( recordValue.c_str( ), nullptr, 10 );
+
+			// Next
+			recordOffset += recordLength;
+
+		}
+
+	}
+
+	// -------------------------------------------------------- \\
+
+}
\ No newline at end of file
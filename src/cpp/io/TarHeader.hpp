@@ -0,0 +1,279 @@
+/*
+* Copyright  2018 Denis Zyamaev (code4un@yandex.ru) All rights reserved.
+* Authors: Denis Zyamaev (code4un@yandex.ru)
+* All rights reserved.
+* API: C++ 11
+* License: see LICENSE.txt
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+* 1. Redistributions of source code must retain the above copyright notice,
+* this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must display the names 'Denis Zyamaev' and
+* in the credits of the application, if such credits exist.
+* The authors of this work must be notified via email (code4un@yandex.ru) in
+* this case of redistribution.
+* 3. Neither the name of copyright holders nor the names of its contributors
+* may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS
+* IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+* PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+// Include 'pch_cxx'
+#include "../pch_cxx.hpp"
+
+namespace c0de4un
+{
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Types
+	// ===========================================================
+
+	/*
+	  * TarHeader - ustar headers (POSIX.1-1988) with pax extended headers
+	  * (POSIX.1-2001) for long names & large files.
+	  *
+	  * Archive is a sequence of 512-byte blocks: header, data padded to
+	  * block size, next header, ... & two zero blocks at the end. pax
+	  * header is written before ustar header, if name or link name don't
+	  * fit into 100 bytes, or size doesn't fit into 11 octal digits.
+	  * GNU long name headers are read too.
+	  *
+	  * @language C++ 17
+	  *
+	  * @authors Z. Denis (c0de4un@yandex.ru)
+	  * @version 1.0
+	 */
+	class TarHeader final
+	{
+
+	public:
+
+		// -------------------------------------------------------- \\
+
+		// ===========================================================
+		// Types
+		// ===========================================================
+
+		/* Entry of archive */
+		struct Entry final
+		{
+
+			/* Name, '/' separated, directories end with '/' */
+			std::string name;
+
+			/* Target of link */
+			std::string linkName;
+
+			/* Type-flag */
+			char type;
+
+			/* Permissions */
+			std::uint32_t mode;
+
+			/* Size of data */
+			std::uint64_t size;
+
+			/* Modification time, seconds since 1970 */
+			std::int64_t mtime;
+
+		};
+
+		// ===========================================================
+		// Constants
+		// ===========================================================
+
+		/* Size of block */
+		static constexpr std::size_t BLOCK_SIZE = 512;
+
+		/* Regular file */
+		static constexpr char TYPE_FILE = '0';
+
+		/* Regular file, pre-POSIX */
+		static constexpr char TYPE_OLD_FILE = '\0';
+
+		/* Hard link */
+		static constexpr char TYPE_HARD_LINK = '1';
+
+		/* Symbolic link */
+		static constexpr char TYPE_SYMLINK = '2';
+
+		/* Directory */
+		static constexpr char TYPE_DIRECTORY = '5';
+
+		/* Contiguous file, read as regular */
+		static constexpr char TYPE_CONTIGUOUS = '7';
+
+		/* pax extended header of the next entry */
+		static constexpr char TYPE_PAX = 'x';
+
+		/* pax global header */
+		static constexpr char TYPE_PAX_GLOBAL = 'g';
+
+		/* GNU long name of the next entry */
+		static constexpr char TYPE_GNU_LONG_NAME = 'L';
+
+		/* GNU long link name of the next entry */
+		static constexpr char TYPE_GNU_LONG_LINK = 'K';
+
+		// -------------------------------------------------------- \\
+
+	private:
+
+		// -------------------------------------------------------- \\
+
+		// ===========================================================
+		// Constants
+		// ===========================================================
+
+		/* Field offsets & sizes */
+		static constexpr std::size_t NAME_OFFSET = 0;
+		static constexpr std::size_t NAME_SIZE = 100;
+		static constexpr std::size_t MODE_OFFSET = 100;
+		static constexpr std::size_t UID_OFFSET = 108;
+		static constexpr std::size_t GID_OFFSET = 116;
+		static constexpr std::size_t SIZE_OFFSET = 124;
+		static constexpr std::size_t MTIME_OFFSET = 136;
+		static constexpr std::size_t CHECKSUM_OFFSET = 148;
+		static constexpr std::size_t TYPE_OFFSET = 156;
+		static constexpr std::size_t LINK_NAME_OFFSET = 157;
+		static constexpr std::size_t MAGIC_OFFSET = 257;
+		static constexpr std::size_t PREFIX_OFFSET = 345;
+		static constexpr std::size_t PREFIX_SIZE = 155;
+
+		/* Max value of 11 octal digits */
+		static constexpr std::uint64_t MAX_OCTAL_SIZE = 077777777777;
+
+		/* Name of pax header entry */
+		static constexpr const char *const PAX_NAME = "././@PaxHeader";
+
+		// ===========================================================
+		// Methods
+		// ===========================================================
+
+		/*
+		 * Write octal number, zero-terminated.
+		 *
+		 * @param pField - field.
+		 * @param fieldSize - size of field, with terminator.
+		 * @param pValue - value, must fit into field.
+		*/
+		static void putOctal( unsigned char *const pField, const std::size_t fieldSize, const std::uint64_t pValue ) noexcept;
+
+		/*
+		 * Returns number of field: octal or base-256 (GNU).
+		 *
+		 * @param pField - field.
+		 * @param fieldSize - size of field.
+		*/
+		static std::uint64_t getNumber( const unsigned char *const pField, const std::size_t fieldSize ) noexcept;
+
+		/*
+		 * Returns text of field, up to terminator.
+		 *
+		 * @param pField - field.
+		 * @param fieldSize - size of field.
+		*/
+		static std::string getText( const unsigned char *const pField, const std::size_t fieldSize );
+
+		/*
+		 * Returns sum of header bytes, checksum field counted as spaces.
+		 *
+		 * @param pBlock - header block.
+		*/
+		static std::uint32_t getChecksum( const unsigned char *const pBlock ) noexcept;
+
+		/*
+		 * Append pax record: "length key=value\n", length counts itself.
+		 *
+		 * @param pRecords - output.
+		 * @param pKey - key.
+		 * @param pValue - value.
+		 * @throws - can throw exception (bad_alloc).
+		*/
+		static void putPaxRecord( std::string & pRecords, const char *const pKey, const std::string & pValue );
+
+		/*
+		 * Append header block.
+		 *
+		 * @param pOutput - output.
+		 * @param pEntry - entry, name, link name & size are cut to field size.
+		 * @throws - can throw exception (bad_alloc).
+		*/
+		static void putBlock( std::vector<unsigned char> & pOutput, const Entry & pEntry );
+
+		// -------------------------------------------------------- \\
+
+	public:
+
+		// -------------------------------------------------------- \\
+
+		// ===========================================================
+		// Constructor & destructor
+		// ===========================================================
+
+		/* @deleted TarHeader constructor, only static methods */
+		TarHeader( ) = delete;
+
+		// ===========================================================
+		// Methods
+		// ===========================================================
+
+		/*
+		 * Returns number of padding bytes after data.
+		 *
+		 * @param pSize - size of data.
+		*/
+		static std::size_t getPaddingSize( const std::uint64_t pSize ) noexcept;
+
+		/*
+		 * Append header of entry, with pax header if required.
+		 *
+		 * @param pOutput - output.
+		 * @param pEntry - entry.
+		 * @throws - can throw exception (bad_alloc).
+		*/
+		static void write( std::vector<unsigned char> & pOutput, const Entry & pEntry );
+
+		/*
+		 * Read header block.
+		 *
+		 * @param pBlock - header block.
+		 * @param pEntry - receives entry.
+		 * @return - false, if block is zero (end of archive).
+		 * @throws - can throw exception, if checksum is wrong.
+		*/
+		static bool read( const unsigned char *const pBlock, Entry & pEntry );
+
+		/*
+		 * Apply pax records to entry: path, linkpath, size, mtime.
+		 *
+		 * @param pRecords - data of pax header.
+		 * @param pEntry - entry to change.
+		 * @throws - can throw exception, if records are corrupted.
+		*/
+		static void readPax( const std::string & pRecords, Entry & pEntry );
+
+		// -------------------------------------------------------- \\
+
+	};
+
+	// -------------------------------------------------------- \\
+
+}
\ No newline at end of file
@@ -0,0 +1,305 @@
+/*
+* Copyright  2018 Denis Zyamaev (code4un@yandex.ru) All rights reserved.
+* Authors: Denis Zyamaev (code4un@yandex.ru)
+* All rights reserved.
+* API: C++ 11
+* License: see LICENSE.txt
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+* 1. Redistributions of source code must retain the above copyright notice,
+* this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must display the names 'Denis Zyamaev' and
+* in the credits of the application, if such credits exist.
+* The authors of this work must be notified via email (code4un@yandex.ru) in
+* this case of redistribution.
+* 3. Neither the name of copyright holders nor the names of its contributors
+* may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS
+* IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+* PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// HEADER
+#include "TarInputSource.hpp"
+
+// Include file status
+#include <sys/stat.h> // stat, lstat
+
+namespace c0de4un
+{
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Constructor & destructor
+	// ===========================================================
+
+	/*
+	 * TarInputSource constructor.
+	 *
+	 * @param rootPath - directory (or file) to archive.
+	 * @param readSize - bytes per read.
+	 * @throws - can throw exception, if root doesn't exist.
+	*/
+	TarInputSource::TarInputSource( const std::string & rootPath, const std::uint32_t readSize )
+		: mPending( ),
+		mFile( nullptr, &std::fclose ),
+		mFileLeftCount( 0 ),
+		mFilePaddingCount( 0 ),
+		mBuffer( ),
+		mReadSize( std::max<std::size_t>( readSize, TarHeader::BLOCK_SIZE ) ),
+		mEnded( false ),
+		mEntriesCount( 0 )
+	{
+
+		// Root, without trailing separator
+		std::filesystem::path rootFSPath( std::filesystem::u8path( rootPath ).lexically_normal( ) );
+		if ( !rootFSPath.has_filename( ) && rootFSPath.has_parent_path( ) && rootFSPath != rootFSPath.root_path( ) )
+			rootFSPath = rootFSPath.parent_path( );
+
+		if ( !std::filesystem::exists( std::filesystem::symlink_status( rootFSPath ) ) )
+			throw std::runtime_error( "TarInputSource - path not found: " + rootPath );
+
+		// Root name, contents of "." & "/" are archived without it
+		const std::string rootName( rootFSPath.filename( ).u8string( ) );
+
+		if ( rootName.empty( ) || rootName == "." || rootName == ".." )
+			addChildren( rootFSPath, std::string( ) );
+		else
+			mPending.emplace_back( rootFSPath, rootName );
+
+	}
+
+	// ===========================================================
+	// Getters
+	// ===========================================================
+
+	/* Returns number of entries, archived so far */
+	std::uint64_t TarInputSource::getEntriesCount( ) const noexcept
+	{ return( mEntriesCount ); }
+
+	// ===========================================================
+	// Methods
+	// ===========================================================
+
+	/*
+	 * Add directory entries to pending paths, in name order.
+	 *
+	 * @param pPath - directory.
+	 * @param namePrefix - name of directory in archive, with '/'.
+	 * @throws - can throw exception.
+	*/
+	void TarInputSource::addChildren( const std::filesystem::path & pPath, const std::string & namePrefix )
+	{
+
+		// Entries
+		std::vector<std::filesystem::path> childPaths;
+		for ( const std::filesystem::directory_entry & childEntry : std::filesystem::directory_iterator( pPath ) )
+			childPaths.push_back( childEntry.path( ) );
+
+		// Reverse order, the first name is taken from the back
+		std::sort( childPaths.begin( ), childPaths.end( ), []( const std::filesystem::path & a, const std::filesystem::path & b ) { return( a.filename( ) > b.filename( ) ); } );
+
+		for ( const std::filesystem::path & childPath : childPaths )
+			mPending.emplace_back( childPath, namePrefix + childPath.filename( ).u8string( ) );
+
+	}
+
+	/*
+	 * Append header of path to buffer & open it's data.
+	 *
+	 * @param pPath - path to archive.
+	 * @param pName - name in archive.
+	 * @throws - can throw exception.
+	*/
+	void TarInputSource::addEntry( const std::filesystem::path & pPath, const std::string & pName )
+	{
+
+		// Type, links are not followed
+		const std::filesystem::file_status fileStatus( std::filesystem::symlink_status( pPath ) );
+
+		// Entry
+		TarHeader::Entry tarEntry{ pName, std::string( ), TarHeader::TYPE_FILE, static_cast<std::uint32_t>( fileStatus.permissions( ) ) & 07777, 0, getModificationTime( pPath ) };
+
+		if ( std::filesystem::is_directory( fileStatus ) )
+		{
+
+			// Directory, entries follow it
+			tarEntry.type = TarHeader::TYPE_DIRECTORY;
+			tarEntry.name += '/';
+
+			TarHeader::write( mBuffer, tarEntry );
+			addChildren( pPath, tarEntry.name );
+
+		}
+		else if ( std::filesystem::is_symlink( fileStatus ) )
+		{
+
+			// Symbolic link, target as is
+			tarEntry.type = TarHeader::TYPE_SYMLINK;
+			tarEntry.linkName = std::filesystem::read_symlink( pPath ).generic_u8string( );
+
+			TarHeader::write( mBuffer, tarEntry );
+
+		}
+		else if ( std::filesystem::is_regular_file( fileStatus ) )
+		{
+
+			// Open, before header is written
+			std::unique_ptr<std::FILE, int(*)( std::FILE* )> dataFile( std::fopen( pPath.string( ).c_str( ), "rb" ), &std::fclose );
+
+			if ( dataFile == nullptr )
+				throw std::runtime_error( "TarInputSource - failed to open file #" + pPath.u8string( ) );
+
+			// Regular file, data follows header
+			tarEntry.size = std::filesystem::file_size( pPath );
+
+			TarHeader::write( mBuffer, tarEntry );
+
+			if ( tarEntry.size > 0 )
+			{
+				mFile = std::move( dataFile );
+				mFileLeftCount = tarEntry.size;
+				mFilePaddingCount = static_cast<std::uint32_t>( TarHeader::getPaddingSize( tarEntry.size ) );
+			}
+
+		}
+		else
+		{
+
+			// Devices, sockets & pipes are skipped
+			return;
+
+		}
+
+		// Count
+		mEntriesCount++;
+
+	}
+
+	/*
+	 * Returns modification time of path (not followed), 0 if unknown.
+	 *
+	 * @param pPath - path.
+	*/
+	std::int64_t TarInputSource::getModificationTime( const std::filesystem::path & pPath ) noexcept
+	{
+
+		// Status
+		struct stat fileStat;
+
+#if defined( _WIN32 )
+		const int statRet( stat( pPath.string( ).c_str( ), &fileStat ) );
+#else
+		const int statRet( lstat( pPath.c_str( ), &fileStat ) );
+#endif
+
+		// Return
+		return( statRet == 0 ? static_cast<std::int64_t>( fileStat.st_mtime ) : 0 );
+
+	}
+
+	/*
+	 * Reads next piece of archive.
+	 *
+	 * @thread_safety - not thread-safe.
+	 * @param pData - receives pointer to buffer.
+	 * @return - number of bytes, 0 at end of archive.
+	 * @throws - can throw exception, if file can't be read or changed size.
+	*/
+	std::size_t TarInputSource::read( const unsigned char *& pData )
+	{
+
+		// Clear buffer
+		mBuffer.clear( );
+
+		// Fill buffer: file data, next headers, end blocks
+		while ( mBuffer.size( ) < mReadSize )
+		{
+
+			// File data
+			if ( mFile != nullptr )
+			{
+
+				// Read
+				const std::size_t bufferOffset( mBuffer.size( ) );
+				const std::size_t readCount( static_cast<std::size_t>( std::min<std::uint64_t>( mFileLeftCount, mReadSize - bufferOffset ) ) );
+
+				mBuffer.resize( bufferOffset + readCount );
+
+				if ( fread( mBuffer.data( ) + bufferOffset, sizeof( unsigned char ), readCount, mFile.get( ) ) != readCount )
+					throw std::runtime_error( "TarInputSource::read - failed to read file, or file was truncated" );
+
+				mFileLeftCount -= readCount;
+
+				// Padding after the last data
+				if ( mFileLeftCount == 0 )
+				{
+
+					mBuffer.resize( mBuffer.size( ) + mFilePaddingCount, 0 );
+					mFile.reset( );
+
+				}
+
+				continue;
+
+			}
+
+			// Next entry
+			if ( !mPending.empty( ) )
+			{
+
+				const std::pair<std::filesystem::path, std::string> nextPath( std::move( mPending.back( ) ) );
+				mPending.pop_back( );
+
+				addEntry( nextPath.first, nextPath.second );
+
+				continue;
+
+			}
+
+			// End blocks
+			if ( !mEnded )
+			{
+
+				mBuffer.resize( mBuffer.size( ) + TarHeader::BLOCK_SIZE * 2, 0 );
+				mEnded = true;
+
+				continue;
+
+			}
+
+			break;
+
+		}
+
+		// Return
+		pData = mBuffer.data( );
+		return( mBuffer.size( ) );
+
+	}
+
+	/*
+	 * Set number of bytes per read.
+	 *
+	 * @thread_safety - not thread-safe.
+	 * @param readSize - bytes per read.
+	*/
+	void TarInputSource::setReadSize( const std::uint32_t readSize )
+	{ mReadSize = std::max<std::size_t>( readSize, TarHeader::BLOCK_SIZE ); }
+
+	// -------------------------------------------------------- \\
+
+}
\ No newline at end of file
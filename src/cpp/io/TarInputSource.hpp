@@ -0,0 +1,200 @@
+/*
+* Copyright  2018 Denis Zyamaev (code4un@yandex.ru) All rights reserved.
+* Authors: Denis Zyamaev (code4un@yandex.ru)
+* All rights reserved.
+* API: C++ 11
+* License: see LICENSE.txt
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+* 1. Redistributions of source code must retain the above copyright notice,
+* this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must display the names 'Denis Zyamaev' and
+* in the credits of the application, if such credits exist.
+* The authors of this work must be notified via email (code4un@yandex.ru) in
+* this case of redistribution.
+* 3. Neither the name of copyright holders nor the names of its contributors
+* may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS
+* IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+* PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+// Include InputSource
+#include "InputSource.hpp"
+
+// Include TarHeader
+#include "TarHeader.hpp"
+
+// Include C++ filesystem
+#include <filesystem> // std::filesystem::path
+
+namespace c0de4un
+{
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Types
+	// ===========================================================
+
+	/*
+	  * TarInputSource - walks directory tree & reads it as tar archive:
+	  * headers, file data & padding, then end blocks.
+	  *
+	  * Archive is produced while it's read, so it goes straight into
+	  * compression without intermediate tar file. Entries are named
+	  * relative to the parent of the root, in name order. Directories,
+	  * regular files & symbolic links (not followed) are archived, other
+	  * files are skipped.
+	  *
+	  * @language C++ 17
+	  *
+	  * @authors Z. Denis (c0de4un@yandex.ru)
+	  * @version 1.0
+	 */
+	class TarInputSource final : public InputSource
+	{
+
+	private:
+
+		// -------------------------------------------------------- \\
+
+		// ===========================================================
+		// Fields
+		// ===========================================================
+
+		/* Paths to archive & their names, the next one is at the back */
+		std::vector<std::pair<std::filesystem::path, std::string>> mPending;
+
+		/* File, which data is read, null between files */
+		std::unique_ptr<std::FILE, int(*)( std::FILE* )> mFile;
+
+		/* Bytes of file left to read */
+		std::uint64_t mFileLeftCount;
+
+		/* Zero bytes after file data, up to block end */
+		std::uint32_t mFilePaddingCount;
+
+		/* Read-buffer */
+		std::vector<unsigned char> mBuffer;
+
+		/* Number of bytes per read */
+		std::size_t mReadSize;
+
+		/* true, if end blocks are read */
+		bool mEnded;
+
+		/* Number of archived entries */
+		std::uint64_t mEntriesCount;
+
+		// ===========================================================
+		// Methods
+		// ===========================================================
+
+		/*
+		 * Add directory entries to pending paths, in name order.
+		 *
+		 * @param pPath - directory.
+		 * @param namePrefix - name of directory in archive, with '/'.
+		 * @throws - can throw exception.
+		*/
+		void addChildren( const std::filesystem::path & pPath, const std::string & namePrefix );
+
+		/*
+		 * Append header of path to buffer & open it's data.
+		 *
+		 * @param pPath - path to archive.
+		 * @param pName - name in archive.
+		 * @throws - can throw exception.
+		*/
+		void addEntry( const std::filesystem::path & pPath, const std::string & pName );
+
+		/*
+		 * Returns modification time of path (not followed), 0 if unknown.
+		 *
+		 * @param pPath - path.
+		*/
+		static std::int64_t getModificationTime( const std::filesystem::path & pPath ) noexcept;
+
+		// -------------------------------------------------------- \\
+
+	public:
+
+		// -------------------------------------------------------- \\
+
+		// ===========================================================
+		// Constants
+		// ===========================================================
+
+		/* Default number of bytes per read */
+		static constexpr std::uint32_t DEFAULT_READ_SIZE = 262144;
+
+		// ===========================================================
+		// Constructor & destructor
+		// ===========================================================
+
+		/*
+		 * TarInputSource constructor.
+		 *
+		 * @param rootPath - directory (or file) to archive.
+		 * @param readSize - bytes per read.
+		 * @throws - can throw exception, if root doesn't exist.
+		*/
+		explicit TarInputSource( const std::string & rootPath, const std::uint32_t readSize = DEFAULT_READ_SIZE );
+
+		/* @deleted TarInputSource copy-constructor */
+		TarInputSource( const TarInputSource & ) = delete;
+
+		/* @deleted TarInputSource copy-assignment */
+		TarInputSource & operator=( const TarInputSource & ) = delete;
+
+		// ===========================================================
+		// Getters
+		// ===========================================================
+
+		/* Returns number of entries, archived so far */
+		std::uint64_t getEntriesCount( ) const noexcept;
+
+		// ===========================================================
+		// Methods
+		// ===========================================================
+
+		/*
+		 * Reads next piece of archive.
+		 *
+		 * @thread_safety - not thread-safe.
+		 * @param pData - receives pointer to buffer.
+		 * @return - number of bytes, 0 at end of archive.
+		 * @throws - can throw exception, if file can't be read or changed size.
+		*/
+		std::size_t read( const unsigned char *& pData ) override;
+
+		/*
+		 * Set number of bytes per read.
+		 *
+		 * @thread_safety - not thread-safe.
+		 * @param readSize - bytes per read.
+		*/
+		void setReadSize( const std::uint32_t readSize ) override;
+
+		// -------------------------------------------------------- \\
+
+	};
+
+	// -------------------------------------------------------- \\
+
+}
\ No newline at end of file
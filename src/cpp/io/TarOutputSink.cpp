@@ -0,0 +1,473 @@
+/*
+* Copyright  2018 Denis Zyamaev (code4un@yandex.ru) All rights reserved.
+* Authors: Denis Zyamaev (code4un@yandex.ru)
+* All rights reserved.
+* API: C++ 11
+* License: see LICENSE.txt
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+* 1. Redistributions of source code must retain the above copyright notice,
+* this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must display the names 'Denis Zyamaev' and
+* in the credits of the application, if such credits exist.
+* The authors of this work must be notified via email (code4un@yandex.ru) in
+* this case of redistribution.
+* 3. Neither the name of copyright holders nor the names of its contributors
+* may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS
+* IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+* PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// HEADER
+#include "TarOutputSink.hpp"
+
+// Include POSIX file API
+#if !defined( _WIN32 )
+#  include <fcntl.h>
+#  include <sys/stat.h>
+#endif
+
+namespace c0de4un
+{
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Constructor & destructor
+	// ===========================================================
+
+	/*
+	 * TarOutputSink constructor.
+	 *
+	 * @param rootPath - output directory, created if required.
+	 * @throws - can throw exception, if directory can't be created.
+	*/
+	TarOutputSink::TarOutputSink( const std::string & rootPath )
+		: mRootPath( std::filesystem::u8path( rootPath ) ),
+		mState( State::HEADER ),
+		mBlock( TarHeader::BLOCK_SIZE ),
+		mBlockFill( 0 ),
+		mEntry( ),
+		mEntryPath( ),
+		mOverride( ),
+		mExtended( ),
+		mExtendedType( TarHeader::TYPE_PAX ),
+		mDataLeftCount( 0 ),
+		mPaddingCount( 0 ),
+		mFile( nullptr, &std::fclose ),
+		mDirectories( ),
+		mEntriesCount( 0 )
+	{
+
+		// Output directory
+		std::filesystem::create_directories( mRootPath );
+
+		// No override
+		resetOverride( );
+
+	}
+
+	// ===========================================================
+	// Getters
+	// ===========================================================
+
+	/* Returns number of entries, extracted so far */
+	std::uint64_t TarOutputSink::getEntriesCount( ) const noexcept
+	{ return( mEntriesCount ); }
+
+	// ===========================================================
+	// Methods
+	// ===========================================================
+
+	/* Reset override to "not set" */
+	void TarOutputSink::resetOverride( ) noexcept
+	{
+
+		mOverride.name.clear( );
+		mOverride.linkName.clear( );
+		mOverride.size = NO_SIZE;
+		mOverride.mtime = NO_TIME;
+
+	}
+
+	/*
+	 * Handle complete header block.
+	 *
+	 * @throws - can throw exception.
+	*/
+	void TarOutputSink::readHeader( )
+	{
+
+		// Read header, zero block ends archive
+		TarHeader::Entry headerEntry;
+		if ( !TarHeader::read( mBlock.data( ), headerEntry ) )
+		{
+			mState = State::END;
+			return;
+		}
+
+		// Extended headers, they change the next entry
+		if ( headerEntry.type == TarHeader::TYPE_PAX || headerEntry.type == TarHeader::TYPE_GNU_LONG_NAME || headerEntry.type == TarHeader::TYPE_GNU_LONG_LINK )
+		{
+
+			if ( headerEntry.size > MAX_EXTENDED_SIZE )
+				throw std::runtime_error( "TarOutputSink - extended header is too large" );
+
+			mExtended.clear( );
+			mExtendedType = headerEntry.type;
+			startData( State::EXTENDED, headerEntry.size );
+
+			return;
+
+		}
+
+		// Global pax header, not used
+		if ( headerEntry.type == TarHeader::TYPE_PAX_GLOBAL )
+		{
+			startData( State::SKIP, headerEntry.size );
+			return;
+		}
+
+		// Apply override
+		if ( !mOverride.name.empty( ) )
+			headerEntry.name = mOverride.name;
+
+		if ( !mOverride.linkName.empty( ) )
+			headerEntry.linkName = mOverride.linkName;
+
+		if ( mOverride.size != NO_SIZE )
+			headerEntry.size = mOverride.size;
+
+		if ( mOverride.mtime != NO_TIME )
+			headerEntry.mtime = mOverride.mtime;
+
+		resetOverride( );
+
+		// Create entry
+		mEntry = std::move( headerEntry );
+		createEntry( );
+
+	}
+
+	/*
+	 * Create entry, file is opened for it's data.
+	 *
+	 * @throws - can throw exception.
+	*/
+	void TarOutputSink::createEntry( )
+	{
+
+		// Old archives mark directories with '/'
+		if ( mEntry.type == TarHeader::TYPE_OLD_FILE && !mEntry.name.empty( ) && mEntry.name.back( ) == '/' )
+			mEntry.type = TarHeader::TYPE_DIRECTORY;
+
+		// Path
+		mEntryPath = getTargetPath( mEntry.name );
+
+		if ( mEntry.type == TarHeader::TYPE_DIRECTORY )
+		{
+
+			// Directory, symbolic link of earlier entry is replaced, not followed
+			if ( mEntryPath != mRootPath && std::filesystem::is_symlink( std::filesystem::symlink_status( mEntryPath ) ) )
+				std::filesystem::remove( mEntryPath );
+
+			// Metadata is set at finish
+			std::filesystem::create_directories( mEntryPath );
+			mDirectories.emplace_back( mEntryPath, mEntry );
+
+			startData( State::SKIP, mEntry.size );
+
+		}
+		else if ( mEntry.type == TarHeader::TYPE_FILE || mEntry.type == TarHeader::TYPE_OLD_FILE || mEntry.type == TarHeader::TYPE_CONTIGUOUS
+			|| mEntry.type == TarHeader::TYPE_SYMLINK || mEntry.type == TarHeader::TYPE_HARD_LINK )
+		{
+
+			if ( mEntryPath == mRootPath )
+				throw std::runtime_error( "TarOutputSink - entry has no name" );
+
+			// Parent directory, existing file is replaced (symbolic link is not followed)
+			std::filesystem::create_directories( mEntryPath.parent_path( ) );
+
+			if ( !std::filesystem::is_directory( std::filesystem::symlink_status( mEntryPath ) ) )
+				std::filesystem::remove( mEntryPath );
+
+			if ( mEntry.type == TarHeader::TYPE_SYMLINK )
+			{
+
+				// Symbolic link, target as is
+				std::filesystem::create_symlink( std::filesystem::u8path( mEntry.linkName ), mEntryPath );
+				startData( State::SKIP, mEntry.size );
+
+			}
+			else if ( mEntry.type == TarHeader::TYPE_HARD_LINK )
+			{
+
+				// Hard link, target is extracted entry
+				std::filesystem::create_hard_link( getTargetPath( mEntry.linkName ), mEntryPath );
+				startData( State::SKIP, mEntry.size );
+
+			}
+			else
+			{
+
+				// Regular file
+				mFile.reset( std::fopen( mEntryPath.string( ).c_str( ), "wb" ) );
+
+				if ( mFile == nullptr )
+					throw std::runtime_error( "TarOutputSink - failed to create file #" + mEntryPath.u8string( ) );
+
+				startData( State::DATA, mEntry.size );
+
+			}
+
+		}
+		else
+		{
+
+			// Devices, pipes & unknown types are skipped
+			startData( State::SKIP, mEntry.size );
+			return;
+
+		}
+
+		// Count
+		mEntriesCount++;
+
+	}
+
+	/*
+	 * Start data of entry.
+	 *
+	 * @param pState - DATA, EXTENDED or SKIP.
+	 * @param pSize - size of data.
+	 * @throws - can throw exception.
+	*/
+	void TarOutputSink::startData( const State pState, const std::uint64_t pSize )
+	{
+
+		mState = pState;
+		mDataLeftCount = pSize;
+		mPaddingCount = TarHeader::getPaddingSize( pSize );
+
+		// No data
+		if ( pSize == 0 )
+			endData( );
+
+	}
+
+	/*
+	 * Complete data of entry: close file or apply extended header.
+	 *
+	 * @throws - can throw exception.
+	*/
+	void TarOutputSink::endData( )
+	{
+
+		if ( mState == State::DATA )
+		{
+
+			// Close file, buffered data is written
+			if ( std::fclose( mFile.release( ) ) != 0 )
+				throw std::runtime_error( "TarOutputSink - failed to write file #" + mEntryPath.u8string( ) );
+
+			setMetadata( mEntryPath, mEntry );
+
+		}
+		else if ( mState == State::EXTENDED )
+		{
+
+			// Override the next entry
+			if ( mExtendedType == TarHeader::TYPE_PAX )
+				TarHeader::readPax( mExtended, mOverride );
+			else if ( mExtendedType == TarHeader::TYPE_GNU_LONG_NAME )
+				mOverride.name = mExtended.c_str( );
+			else
+				mOverride.linkName = mExtended.c_str( );
+
+		}
+
+		// Padding or the next header
+		mState = mPaddingCount > 0 ? State::PADDING : State::HEADER;
+
+	}
+
+	/*
+	 * Returns path of entry name in output directory.
+	 *
+	 * @param pName - entry name.
+	 * @throws - can throw exception, if name leaves output directory.
+	*/
+	std::filesystem::path TarOutputSink::getTargetPath( const std::string & pName ) const
+	{
+
+		// Relative name
+		const std::filesystem::path namePath( std::filesystem::u8path( pName ).lexically_normal( ) );
+
+		if ( namePath.has_root_path( ) )
+			throw std::runtime_error( "TarOutputSink - absolute entry name: " + pName );
+
+		// Append parts, extracted symbolic links are not followed
+		std::filesystem::path targetPath( mRootPath );
+		for ( const std::filesystem::path & namePart : namePath )
+		{
+
+			if ( namePart.empty( ) || namePart == "." )
+				continue;
+
+			if ( namePart == ".." )
+				throw std::runtime_error( "TarOutputSink - entry name leaves output directory: " + pName );
+
+			if ( targetPath != mRootPath && std::filesystem::is_symlink( std::filesystem::symlink_status( targetPath ) ) )
+				throw std::runtime_error( "TarOutputSink - entry name goes through symbolic link: " + pName );
+
+			targetPath /= namePart;
+
+		}
+
+		// Return
+		return( targetPath );
+
+	}
+
+	/*
+	 * Set permissions & modification time. Symbolic link is not followed.
+	 *
+	 * @param pPath - path.
+	 * @param pEntry - entry.
+	*/
+	void TarOutputSink::setMetadata( const std::filesystem::path & pPath, const TarHeader::Entry & pEntry ) noexcept
+	{
+
+		// Replaced by symbolic link, link target is left as is
+		std::error_code errorCode;
+		if ( std::filesystem::is_symlink( std::filesystem::symlink_status( pPath, errorCode ) ) )
+			return;
+
+		// Permissions, failure is not an error
+		std::filesystem::permissions( pPath, static_cast<std::filesystem::perms>( pEntry.mode & 07777 ), errorCode );
+
+#if !defined( _WIN32 )
+
+		// Modification time, access time is now
+		const struct timespec fileTimes[2] = { { 0, UTIME_NOW }, { static_cast<time_t>( pEntry.mtime ), 0 } };
+		utimensat( AT_FDCWD, pPath.c_str( ), fileTimes, AT_SYMLINK_NOFOLLOW );
+
+#endif
+
+	}
+
+	/*
+	 * Unpacks next piece of archive.
+	 *
+	 * @thread_safety - not thread-safe.
+	 * @param pData - data to write.
+	 * @param pSize - number of bytes.
+	 * @throws - can throw exception, if archive is corrupted or file can't be written.
+	*/
+	void TarOutputSink::write( const unsigned char *const pData, const std::size_t pSize )
+	{
+
+		// Number of bytes handled
+		std::size_t offset( 0 );
+
+		while ( offset < pSize )
+		{
+
+			if ( mState == State::HEADER )
+			{
+
+				// Collect header block
+				const std::size_t copyCount( std::min<std::size_t>( pSize - offset, TarHeader::BLOCK_SIZE - mBlockFill ) );
+				std::memcpy( mBlock.data( ) + mBlockFill, pData + offset, copyCount );
+				mBlockFill += copyCount;
+				offset += copyCount;
+
+				if ( mBlockFill == TarHeader::BLOCK_SIZE )
+				{
+					mBlockFill = 0;
+					readHeader( );
+				}
+
+			}
+			else if ( mState == State::PADDING )
+			{
+
+				// Skip padding
+				const std::size_t skipCount( std::min<std::size_t>( pSize - offset, mPaddingCount ) );
+				mPaddingCount -= skipCount;
+				offset += skipCount;
+
+				if ( mPaddingCount == 0 )
+					mState = State::HEADER;
+
+			}
+			else if ( mState == State::END )
+			{
+
+				// Ignore rest of archive
+				offset = pSize;
+
+			}
+			else
+			{
+
+				// Data
+				const std::size_t copyCount( static_cast<std::size_t>( std::min<std::uint64_t>( pSize - offset, mDataLeftCount ) ) );
+
+				if ( mState == State::DATA )
+				{
+					if ( fwrite( pData + offset, sizeof( unsigned char ), copyCount, mFile.get( ) ) != copyCount )
+						throw std::runtime_error( "TarOutputSink - failed to write file #" + mEntryPath.u8string( ) );
+				}
+				else if ( mState == State::EXTENDED )
+					mExtended.append( reinterpret_cast<const char*>( pData + offset ), copyCount );
+
+				mDataLeftCount -= copyCount;
+				offset += copyCount;
+
+				if ( mDataLeftCount == 0 )
+					endData( );
+
+			}
+
+		}
+
+	}
+
+	/*
+	 * Checks, that archive is complete & sets metadata of directories.
+	 *
+	 * @thread_safety - not thread-safe.
+	 * @throws - can throw exception, if archive is truncated.
+	*/
+	void TarOutputSink::finish( )
+	{
+
+		// Archive must end between entries
+		if ( mState != State::END && ( mState != State::HEADER || mBlockFill != 0 ) )
+			throw std::runtime_error( "TarOutputSink::finish - archive is truncated" );
+
+		// Directories, children first
+		for ( auto directoryIter = mDirectories.rbegin( ); directoryIter != mDirectories.rend( ); directoryIter++ )
+			setMetadata( directoryIter->first, directoryIter->second );
+
+		mDirectories.clear( );
+
+	}
+
+	// -------------------------------------------------------- \\
+
+}
\ No newline at end of file
@@ -0,0 +1,264 @@
+/*
+* Copyright  2018 Denis Zyamaev (code4un@yandex.ru) All rights reserved.
+* Authors: Denis Zyamaev (code4un@yandex.ru)
+* All rights reserved.
+* API: C++ 11
+* License: see LICENSE.txt
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+* 1. Redistributions of source code must retain the above copyright notice,
+* this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must display the names 'Denis Zyamaev' and
+* in the credits of the application, if such credits exist.
+* The authors of this work must be notified via email (code4un@yandex.ru) in
+* this case of redistribution.
+* 3. Neither the name of copyright holders nor the names of its contributors
+* may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS
+* IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+* PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+// Include OutputSink
+#include "OutputSink.hpp"
+
+// Include TarHeader
+#include "TarHeader.hpp"
+
+// Include C++ filesystem
+#include <filesystem> // std::filesystem::path
+
+namespace c0de4un
+{
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Types
+	// ===========================================================
+
+	/*
+	  * TarOutputSink - unpacks tar archive into directory, while it's written.
+	  *
+	  * Inflated data goes straight into files, archive is never stored.
+	  * ustar, pax ('x') & GNU long names ('L', 'K') are read. Directories,
+	  * regular files, symbolic & hard links are created, other entries are
+	  * skipped. Names, which leave the directory (absolute, "..", or
+	  * through an extracted symbolic link), are rejected.
+	  *
+	  * Permissions & modification time are restored, directories get
+	  * them at finish, after their entries are created.
+	  *
+	  * @language C++ 17
+	  *
+	  * @authors Z. Denis (c0de4un@yandex.ru)
+	  * @version 1.0
+	 */
+	class TarOutputSink final : public OutputSink
+	{
+
+	private:
+
+		// -------------------------------------------------------- \\
+
+		// ===========================================================
+		// Types
+		// ===========================================================
+
+		/* Part of archive, which is expected */
+		enum class State : std::uint8_t
+		{
+			HEADER,
+			DATA,
+			EXTENDED,
+			SKIP,
+			PADDING,
+			END
+		};
+
+		// ===========================================================
+		// Constants
+		// ===========================================================
+
+		/* Max size of pax header or long name data */
+		static constexpr std::uint64_t MAX_EXTENDED_SIZE = 1048576;
+
+		/* Size of entry override, which is not set */
+		static constexpr std::uint64_t NO_SIZE = UINT64_MAX;
+
+		/* Time of entry override, which is not set */
+		static constexpr std::int64_t NO_TIME = INT64_MIN;
+
+		// ===========================================================
+		// Fields
+		// ===========================================================
+
+		/* Output directory */
+		const std::filesystem::path mRootPath;
+
+		/* Expected part of archive */
+		State mState;
+
+		/* Header block */
+		std::vector<unsigned char> mBlock;
+
+		/* Number of bytes in header block */
+		std::size_t mBlockFill;
+
+		/* Current entry */
+		TarHeader::Entry mEntry;
+
+		/* Path of current entry */
+		std::filesystem::path mEntryPath;
+
+		/* Fields of the next entry, from pax header or long names */
+		TarHeader::Entry mOverride;
+
+		/* Data of pax header or long name */
+		std::string mExtended;
+
+		/* Type of extended header, which data is collected */
+		char mExtendedType;
+
+		/* Bytes of data left */
+		std::uint64_t mDataLeftCount;
+
+		/* Bytes of padding after data */
+		std::size_t mPaddingCount;
+
+		/* File, which data is written, null between files */
+		std::unique_ptr<std::FILE, int(*)( std::FILE* )> mFile;
+
+		/* Directories, which get metadata at finish */
+		std::vector<std::pair<std::filesystem::path, TarHeader::Entry>> mDirectories;
+
+		/* Number of extracted entries */
+		std::uint64_t mEntriesCount;
+
+		// ===========================================================
+		// Methods
+		// ===========================================================
+
+		/* Reset override to "not set" */
+		void resetOverride( ) noexcept;
+
+		/*
+		 * Handle complete header block.
+		 *
+		 * @throws - can throw exception.
+		*/
+		void readHeader( );
+
+		/*
+		 * Create entry, file is opened for it's data.
+		 *
+		 * @throws - can throw exception.
+		*/
+		void createEntry( );
+
+		/*
+		 * Start data of entry.
+		 *
+		 * @param pState - DATA, EXTENDED or SKIP.
+		 * @param pSize - size of data.
+		 * @throws - can throw exception.
+		*/
+		void startData( const State pState, const std::uint64_t pSize );
+
+		/*
+		 * Complete data of entry: close file or apply extended header.
+		 *
+		 * @throws - can throw exception.
+		*/
+		void endData( );
+
+		/*
+		 * Returns path of entry name in output directory.
+		 *
+		 * @param pName - entry name.
+		 * @throws - can throw exception, if name leaves output directory.
+		*/
+		std::filesystem::path getTargetPath( const std::string & pName ) const;
+
+		/*
+		 * Set permissions & modification time. Symbolic link is not followed.
+		 *
+		 * @param pPath - path.
+		 * @param pEntry - entry.
+		*/
+		static void setMetadata( const std::filesystem::path & pPath, const TarHeader::Entry & pEntry ) noexcept;
+
+		// -------------------------------------------------------- \\
+
+	public:
+
+		// -------------------------------------------------------- \\
+
+		// ===========================================================
+		// Constructor & destructor
+		// ===========================================================
+
+		/*
+		 * TarOutputSink constructor.
+		 *
+		 * @param rootPath - output directory, created if required.
+		 * @throws - can throw exception, if directory can't be created.
+		*/
+		explicit TarOutputSink( const std::string & rootPath );
+
+		/* @deleted TarOutputSink copy-constructor */
+		TarOutputSink( const TarOutputSink & ) = delete;
+
+		/* @deleted TarOutputSink copy-assignment */
+		TarOutputSink & operator=( const TarOutputSink & ) = delete;
+
+		// ===========================================================
+		// Getters
+		// ===========================================================
+
+		/* Returns number of entries, extracted so far */
+		std::uint64_t getEntriesCount( ) const noexcept;
+
+		// ===========================================================
+		// Methods
+		// ===========================================================
+
+		/*
+		 * Unpacks next piece of archive.
+		 *
+		 * @thread_safety - not thread-safe.
+		 * @param pData - data to write.
+		 * @param pSize - number of bytes.
+		 * @throws - can throw exception, if archive is corrupted or file can't be written.
+		*/
+		void write( const unsigned char *const pData, const std::size_t pSize ) override;
+
+		/*
+		 * Checks, that archive is complete & sets metadata of directories.
+		 *
+		 * @thread_safety - not thread-safe.
+		 * @throws - can throw exception, if archive is truncated.
+		*/
+		void finish( ) override;
+
+		// -------------------------------------------------------- \\
+
+	};
+
+	// -------------------------------------------------------- \\
+
+}
\ No newline at end of file
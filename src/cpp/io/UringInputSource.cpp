@@ -0,0 +1,258 @@
+/*
+* Copyright  2018 Denis Zyamaev (code4un@yandex.ru) All rights reserved.
+* Authors: Denis Zyamaev (code4un@yandex.ru)
+* All rights reserved.
+* API: C++ 11
+* License: see LICENSE.txt
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+* 1. Redistributions of source code must retain the above copyright notice,
+* this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must display the names 'Denis Zyamaev' and
+* in the credits of the application, if such credits exist.
+* The authors of this work must be notified via email (code4un@yandex.ru) in
+* this case of redistribution.
+* 3. Neither the name of copyright holders nor the names of its contributors
+* may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS
+* IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+* PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// HEADER
+#include "UringInputSource.hpp"
+
+// Include POSIX file API
+#if !defined( _WIN32 )
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+namespace c0de4un
+{
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Constructor & destructor
+	// ===========================================================
+
+	/*
+	 * UringInputSource constructor. Data is read from the current
+	 * position of the file.
+	 *
+	 * @param pFile - file to read, must be regular file.
+	 * @param bufferSize - size of each buffer.
+	 * @param queueDepth - number of buffers.
+	 * @throws - can throw exception, if io_uring not supported or file is not regular.
+	*/
+	UringInputSource::UringInputSource( std::FILE *const pFile, const std::uint32_t bufferSize, const std::uint32_t queueDepth )
+		: mQueue( std::max<std::uint32_t>( queueDepth, 1 ) ),
+		mFile( -1 ),
+		mFileSize( 0 ),
+		mOffset( 0 ),
+		mBufferSize( std::max<std::uint32_t>( bufferSize, 4096 ) ),
+		mMemory( ),
+		mSlots( std::max<std::uint32_t>( queueDepth, 1 ) ),
+		mNextSlot( 0 ),
+		mReturnedSlot( -1 )
+	{
+
+#if !defined( _WIN32 )
+
+		// Get file descriptor
+		mFile = fileno( pFile );
+
+		// Check file type & get size
+		struct stat fileStat;
+		if ( mFile < 0 || fstat( mFile, &fileStat ) != 0 || !S_ISREG( fileStat.st_mode ) )
+			throw std::runtime_error( "UringInputSource - not a regular file" );
+
+		mFileSize = static_cast<std::uint64_t>( fileStat.st_size );
+
+		// Get current position
+		const off_t position( ftello( pFile ) );
+		mOffset = position > 0 ? static_cast<std::uint64_t>( position ) : 0;
+
+#endif
+
+		// Allocate & register buffers
+		mMemory.resize( static_cast<std::size_t>( mBufferSize ) * mSlots.size( ) );
+		mQueue.registerBuffers( mMemory.data( ), mBufferSize, static_cast<std::uint32_t>( mSlots.size( ) ) );
+
+		// Submit reads into all buffers
+		try
+		{
+
+			for ( std::uint32_t i = 0; i < mSlots.size( ); i++ )
+			{
+				mSlots[i].submitted = false;
+				mSlots[i].completed = false;
+				submitSlot( i );
+			}
+
+		}
+		catch ( ... )
+		{
+			drain( );
+			throw;
+		}
+
+	}
+
+	/* UringInputSource destructor. Waits for reads in flight. */
+	UringInputSource::~UringInputSource( )
+	{ drain( ); }
+
+	// ===========================================================
+	// Methods
+	// ===========================================================
+
+	/*
+	 * Submit read of the next part of file into buffer.
+	 *
+	 * @param pSlot - buffer index.
+	 * @throws - can throw exception.
+	*/
+	void UringInputSource::submitSlot( const std::uint32_t pSlot )
+	{
+
+		// Buffer state
+		Slot & slot( mSlots[pSlot] );
+
+		// Nothing left to read
+		if ( mOffset >= mFileSize )
+		{
+			slot.submitted = false;
+			return;
+		}
+
+		// Set state
+		slot.offset = mOffset;
+		slot.size = static_cast<std::uint32_t>( std::min<std::uint64_t>( mBufferSize, mFileSize - mOffset ) );
+		slot.result = 0;
+		slot.completed = false;
+
+		// Submit
+		mQueue.submitRead( mFile, pSlot, mMemory.data( ) + static_cast<std::size_t>( pSlot ) * mBufferSize, slot.size, slot.offset, pSlot );
+		slot.submitted = true;
+
+		// Move offset
+		mOffset += slot.size;
+
+	}
+
+	/* Waits for all reads in flight */
+	void UringInputSource::drain( ) noexcept
+	{
+
+		// Completed operation
+		std::uint64_t userData( 0 );
+
+		// Wait
+		try
+		{
+			while ( mQueue.getInFlight( ) > 0 )
+				mQueue.waitCompletion( userData );
+		}
+		catch ( ... )
+		{
+			// Ring failed, kernel cancels operations when ring is closed
+		}
+
+	}
+
+	/*
+	 * Returns next completed buffer & submits read into the previous one.
+	 *
+	 * @thread_safety - not thread-safe.
+	 * @param pData - receives pointer to buffer.
+	 * @return - number of bytes, 0 at end of file.
+	 * @throws - can throw exception.
+	*/
+	std::size_t UringInputSource::read( const unsigned char *& pData )
+	{
+
+		// Previous buffer is consumed, read-ahead into it
+		if ( mReturnedSlot >= 0 )
+		{
+			submitSlot( static_cast<std::uint32_t>( mReturnedSlot ) );
+			mReturnedSlot = -1;
+		}
+
+		// Buffers are filled in file order
+		Slot & slot( mSlots[mNextSlot] );
+
+		// End of file
+		if ( !slot.submitted )
+			return( 0 );
+
+		// Wait for this buffer, other completions are stored
+		while ( !slot.completed )
+		{
+
+			std::uint64_t userData( 0 );
+			const std::int32_t result( mQueue.waitCompletion( userData ) );
+
+			mSlots[userData].result = result;
+			mSlots[userData].completed = true;
+
+		}
+
+		// Check io errors
+		if ( slot.result < 0 )
+			throw std::runtime_error( "UringInputSource::read - io error, can't read input file !" );
+
+		// Buffer
+		unsigned char *const buffer( mMemory.data( ) + static_cast<std::size_t>( mNextSlot ) * mBufferSize );
+
+		// Number of bytes read
+		std::uint32_t readCount( static_cast<std::uint32_t>( slot.result ) );
+
+#if !defined( _WIN32 )
+
+		// Complete short read synchronously
+		while ( readCount < slot.size )
+		{
+
+			const ssize_t result( pread( mFile, buffer + readCount, slot.size - readCount, static_cast<off_t>( slot.offset + readCount ) ) );
+
+			if ( result < 0 )
+				throw std::runtime_error( "UringInputSource::read - io error, can't read input file !" );
+
+			// File truncated while reading
+			if ( result == 0 )
+				throw std::runtime_error( "UringInputSource::read - unexpected end of file" );
+
+			readCount += static_cast<std::uint32_t>( result );
+
+		}
+
+#endif
+
+		// Buffer will be reused by the next call
+		slot.submitted = false;
+		mReturnedSlot = mNextSlot;
+		mNextSlot = ( mNextSlot + 1 ) % static_cast<std::uint32_t>( mSlots.size( ) );
+
+		// Return
+		pData = buffer;
+		return( readCount );
+
+	}
+
+	// -------------------------------------------------------- \\
+
+}
\ No newline at end of file
@@ -0,0 +1,198 @@
+/*
+* Copyright  2018 Denis Zyamaev (code4un@yandex.ru) All rights reserved.
+* Authors: Denis Zyamaev (code4un@yandex.ru)
+* All rights reserved.
+* API: C++ 11
+* License: see LICENSE.txt
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+* 1. Redistributions of source code must retain the above copyright notice,
+* this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must display the names 'Denis Zyamaev' and
+* in the credits of the application, if such credits exist.
+* The authors of this work must be notified via email (code4un@yandex.ru) in
+* this case of redistribution.
+* 3. Neither the name of copyright holders nor the names of its contributors
+* may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS
+* IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+* PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+// Include InputSource
+#include "InputSource.hpp"
+
+// Include UringQueue
+#include "UringQueue.hpp"
+
+namespace c0de4un
+{
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Types
+	// ===========================================================
+
+	/*
+	  * UringInputSource - reads regular file with io_uring, keeping
+	  * several reads in flight ahead of the consumer.
+	  *
+	  * @language C++ 17
+	  *
+	  * @authors Z. Denis (c0de4un@yandex.ru)
+	  * @version 1.0
+	 */
+	class UringInputSource final : public InputSource
+	{
+
+	private:
+
+		// -------------------------------------------------------- \\
+
+		// ===========================================================
+		// Types
+		// ===========================================================
+
+		/* Read-buffer state */
+		struct Slot final
+		{
+
+			/* File offset */
+			std::uint64_t offset;
+
+			/* Number of bytes requested */
+			std::uint32_t size;
+
+			/* Number of bytes read, or negative errno */
+			std::int32_t result;
+
+			/* true, if read is submitted */
+			bool submitted;
+
+			/* true, if read is completed */
+			bool completed;
+
+		};
+
+		// ===========================================================
+		// Fields
+		// ===========================================================
+
+		/* io_uring */
+		UringQueue mQueue;
+
+		/* File-descriptor */
+		int mFile;
+
+		/* Size of file */
+		std::uint64_t mFileSize;
+
+		/* Offset of the next read to submit */
+		std::uint64_t mOffset;
+
+		/* Size of each buffer */
+		std::uint32_t mBufferSize;
+
+		/* Buffers memory */
+		std::vector<unsigned char> mMemory;
+
+		/* Buffers state */
+		std::vector<Slot> mSlots;
+
+		/* Index of the next buffer to return */
+		std::uint32_t mNextSlot;
+
+		/* Index of the buffer returned by the previous read, or -1 */
+		std::int64_t mReturnedSlot;
+
+		// ===========================================================
+		// Methods
+		// ===========================================================
+
+		/*
+		 * Submit read of the next part of file into buffer.
+		 *
+		 * @param pSlot - buffer index.
+		 * @throws - can throw exception.
+		*/
+		void submitSlot( const std::uint32_t pSlot );
+
+		/* Waits for all reads in flight */
+		void drain( ) noexcept;
+
+		// -------------------------------------------------------- \\
+
+	public:
+
+		// -------------------------------------------------------- \\
+
+		// ===========================================================
+		// Constants
+		// ===========================================================
+
+		/* Default size of buffer */
+		static constexpr std::uint32_t DEFAULT_BUFFER_SIZE = 524288;
+
+		/* Default number of buffers, max reads in flight */
+		static constexpr std::uint32_t DEFAULT_QUEUE_DEPTH = 8;
+
+		// ===========================================================
+		// Constructor & destructor
+		// ===========================================================
+
+		/*
+		 * UringInputSource constructor. Data is read from the current
+		 * position of the file.
+		 *
+		 * @param pFile - file to read, must be regular file.
+		 * @param bufferSize - size of each buffer.
+		 * @param queueDepth - number of buffers.
+		 * @throws - can throw exception, if io_uring not supported or file is not regular.
+		*/
+		explicit UringInputSource( std::FILE *const pFile, const std::uint32_t bufferSize = DEFAULT_BUFFER_SIZE, const std::uint32_t queueDepth = DEFAULT_QUEUE_DEPTH );
+
+		/* UringInputSource destructor. Waits for reads in flight. */
+		~UringInputSource( );
+
+		/* @deleted UringInputSource copy-constructor */
+		UringInputSource( const UringInputSource & ) = delete;
+
+		/* @deleted UringInputSource copy-assignment */
+		UringInputSource & operator=( const UringInputSource & ) = delete;
+
+		// ===========================================================
+		// Methods
+		// ===========================================================
+
+		/*
+		 * Returns next completed buffer & submits read into the previous one.
+		 *
+		 * @thread_safety - not thread-safe.
+		 * @param pData - receives pointer to buffer.
+		 * @return - number of bytes, 0 at end of file.
+		 * @throws - can throw exception.
+		*/
+		std::size_t read( const unsigned char *& pData ) override;
+
+		// -------------------------------------------------------- \\
+
+	};
+
+	// -------------------------------------------------------- \\
+
+}
\ No newline at end of file
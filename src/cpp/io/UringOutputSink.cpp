@@ -0,0 +1,273 @@
+/*
+* Copyright  2018 Denis Zyamaev (code4un@yandex.ru) All rights reserved.
+* Authors: Denis Zyamaev (code4un@yandex.ru)
+* All rights reserved.
+* API: C++ 11
+* License: see LICENSE.txt
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+* 1. Redistributions of source code must retain the above copyright notice,
+* this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must display the names 'Denis Zyamaev' and
+* in the credits of the application, if such credits exist.
+* The authors of this work must be notified via email (code4un@yandex.ru) in
+* this case of redistribution.
+* 3. Neither the name of copyright holders nor the names of its contributors
+* may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS
+* IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+* PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// HEADER
+#include "UringOutputSink.hpp"
+
+// Include POSIX file API
+#if !defined( _WIN32 )
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+namespace c0de4un
+{
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Constructor & destructor
+	// ===========================================================
+
+	/*
+	 * UringOutputSink constructor. Data is written from the current
+	 * position of the file.
+	 *
+	 * @param pFile - file to write, must be regular file.
+	 * @param bufferSize - size of each buffer.
+	 * @param queueDepth - number of buffers.
+	 * @throws - can throw exception, if io_uring not supported or file is not regular.
+	*/
+	UringOutputSink::UringOutputSink( std::FILE *const pFile, const std::uint32_t bufferSize, const std::uint32_t queueDepth )
+		: mQueue( std::max<std::uint32_t>( queueDepth, 1 ) ),
+		mFile( pFile ),
+		mFileDescriptor( -1 ),
+		mOffset( 0 ),
+		mBufferSize( std::max<std::uint32_t>( bufferSize, 4096 ) ),
+		mMemory( ),
+		mSlots( std::max<std::uint32_t>( queueDepth, 1 ) ),
+		mFillSlot( 0 ),
+		mFillSize( 0 )
+	{
+
+#if !defined( _WIN32 )
+
+		// Write pending stdio data, file is written by descriptor
+		if ( fflush( pFile ) != 0 )
+			throw std::runtime_error( "UringOutputSink - failed to flush output file" );
+
+		// Get file descriptor
+		mFileDescriptor = fileno( pFile );
+
+		// Check file type
+		struct stat fileStat;
+		if ( mFileDescriptor < 0 || fstat( mFileDescriptor, &fileStat ) != 0 || !S_ISREG( fileStat.st_mode ) )
+			throw std::runtime_error( "UringOutputSink - not a regular file" );
+
+		// Get current position
+		const off_t position( ftello( pFile ) );
+		mOffset = position > 0 ? static_cast<std::uint64_t>( position ) : 0;
+
+#endif
+
+		// Allocate & register buffers
+		mMemory.resize( static_cast<std::size_t>( mBufferSize ) * mSlots.size( ) );
+		mQueue.registerBuffers( mMemory.data( ), mBufferSize, static_cast<std::uint32_t>( mSlots.size( ) ) );
+
+		// All buffers are free
+		for ( Slot & slot : mSlots )
+			slot.submitted = false;
+
+	}
+
+	/* UringOutputSink destructor. Waits for writes in flight. */
+	UringOutputSink::~UringOutputSink( )
+	{ drain( ); }
+
+	// ===========================================================
+	// Methods
+	// ===========================================================
+
+	/*
+	 * Submit write of the buffer being filled & switch to the next buffer.
+	 *
+	 * @throws - can throw exception.
+	*/
+	void UringOutputSink::submitFill( )
+	{
+
+		// Buffer state
+		Slot & slot( mSlots[mFillSlot] );
+
+		// Set state
+		slot.offset = mOffset;
+		slot.size = mFillSize;
+
+		// Submit
+		mQueue.submitWrite( mFileDescriptor, mFillSlot, mMemory.data( ) + static_cast<std::size_t>( mFillSlot ) * mBufferSize, slot.size, slot.offset, mFillSlot );
+		slot.submitted = true;
+
+		// Move offset
+		mOffset += mFillSize;
+
+		// Switch buffer
+		mFillSlot = ( mFillSlot + 1 ) % static_cast<std::uint32_t>( mSlots.size( ) );
+		mFillSize = 0;
+
+	}
+
+	/*
+	 * Waits for one completion.
+	 *
+	 * @throws - can throw exception, if write failed.
+	*/
+	void UringOutputSink::waitOne( )
+	{
+
+		// Wait
+		std::uint64_t userData( 0 );
+		const std::int32_t result( mQueue.waitCompletion( userData ) );
+
+		// Completed buffer
+		Slot & slot( mSlots[userData] );
+		slot.submitted = false;
+
+		// Check io errors
+		if ( result < 0 )
+			throw std::runtime_error( "UringOutputSink - failed to write output file" );
+
+#if !defined( _WIN32 )
+
+		// Complete short write synchronously
+		const unsigned char *const buffer( mMemory.data( ) + static_cast<std::size_t>( userData ) * mBufferSize );
+
+		for ( std::uint32_t writeCount = static_cast<std::uint32_t>( result ); writeCount < slot.size; )
+		{
+
+			const ssize_t written( pwrite( mFileDescriptor, buffer + writeCount, slot.size - writeCount, static_cast<off_t>( slot.offset + writeCount ) ) );
+
+			if ( written <= 0 )
+				throw std::runtime_error( "UringOutputSink - failed to write output file" );
+
+			writeCount += static_cast<std::uint32_t>( written );
+
+		}
+
+#endif
+
+	}
+
+	/* Waits for all writes in flight */
+	void UringOutputSink::drain( ) noexcept
+	{
+
+		// Completed operation
+		std::uint64_t userData( 0 );
+
+		// Wait
+		try
+		{
+			while ( mQueue.getInFlight( ) > 0 )
+				mQueue.waitCompletion( userData );
+		}
+		catch ( ... )
+		{
+			// Ring failed, kernel cancels operations when ring is closed
+		}
+
+	}
+
+	/*
+	 * Copies data into buffers, submitting full buffers.
+	 *
+	 * @thread_safety - not thread-safe.
+	 * @param pData - data to write.
+	 * @param pSize - number of bytes.
+	 * @throws - can throw exception.
+	*/
+	void UringOutputSink::write( const unsigned char *const pData, const std::size_t pSize )
+	{
+
+		// Number of bytes copied
+		std::size_t copied( 0 );
+
+		// Copy
+		while ( copied < pSize )
+		{
+
+			// Wait, until buffer is written
+			while ( mSlots[mFillSlot].submitted )
+				waitOne( );
+
+			// Copy into buffer
+			const std::uint32_t copyCount( static_cast<std::uint32_t>( std::min<std::size_t>( pSize - copied, mBufferSize - mFillSize ) ) );
+			std::memcpy( mMemory.data( ) + static_cast<std::size_t>( mFillSlot ) * mBufferSize + mFillSize, pData + copied, copyCount );
+			mFillSize += copyCount;
+			copied += copyCount;
+
+			// Submit full buffer
+			if ( mFillSize == mBufferSize )
+				submitFill( );
+
+		}
+
+	}
+
+	/*
+	 * Submits last buffer, waits for all writes & moves file position
+	 * to the end of written data.
+	 *
+	 * @thread_safety - not thread-safe.
+	 * @throws - can throw exception.
+	*/
+	void UringOutputSink::finish( )
+	{
+
+		// Submit last buffer
+		if ( mFillSize > 0 )
+		{
+
+			while ( mSlots[mFillSlot].submitted )
+				waitOne( );
+
+			submitFill( );
+
+		}
+
+		// Wait for all writes
+		while ( mQueue.getInFlight( ) > 0 )
+			waitOne( );
+
+#if !defined( _WIN32 )
+
+		// Keep stdio position consistent with written data
+		if ( fseeko( mFile, static_cast<off_t>( mOffset ), SEEK_SET ) != 0 )
+			throw std::runtime_error( "UringOutputSink::finish - failed to set output file position" );
+
+#endif
+
+	}
+
+	// -------------------------------------------------------- \\
+
+}
\ No newline at end of file
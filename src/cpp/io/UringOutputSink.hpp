@@ -0,0 +1,208 @@
+/*
+* Copyright  2018 Denis Zyamaev (code4un@yandex.ru) All rights reserved.
+* Authors: Denis Zyamaev (code4un@yandex.ru)
+* All rights reserved.
+* API: C++ 11
+* License: see LICENSE.txt
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+* 1. Redistributions of source code must retain the above copyright notice,
+* this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must display the names 'Denis Zyamaev' and
+* in the credits of the application, if such credits exist.
+* The authors of this work must be notified via email (code4un@yandex.ru) in
+* this case of redistribution.
+* 3. Neither the name of copyright holders nor the names of its contributors
+* may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS
+* IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+* PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+// Include OutputSink
+#include "OutputSink.hpp"
+
+// Include UringQueue
+#include "UringQueue.hpp"
+
+namespace c0de4un
+{
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Types
+	// ===========================================================
+
+	/*
+	  * UringOutputSink - writes regular file with io_uring. Full buffers
+	  * are submitted without waiting, writer blocks only when all
+	  * buffers are in flight.
+	  *
+	  * @language C++ 17
+	  *
+	  * @authors Z. Denis (c0de4un@yandex.ru)
+	  * @version 1.0
+	 */
+	class UringOutputSink final : public OutputSink
+	{
+
+	private:
+
+		// -------------------------------------------------------- \\
+
+		// ===========================================================
+		// Types
+		// ===========================================================
+
+		/* Write-buffer state */
+		struct Slot final
+		{
+
+			/* File offset */
+			std::uint64_t offset;
+
+			/* Number of bytes to write */
+			std::uint32_t size;
+
+			/* true, if write is in flight */
+			bool submitted;
+
+		};
+
+		// ===========================================================
+		// Fields
+		// ===========================================================
+
+		/* io_uring */
+		UringQueue mQueue;
+
+		/* Output file */
+		std::FILE * mFile;
+
+		/* File-descriptor */
+		int mFileDescriptor;
+
+		/* Offset of the next write to submit */
+		std::uint64_t mOffset;
+
+		/* Size of each buffer */
+		std::uint32_t mBufferSize;
+
+		/* Buffers memory */
+		std::vector<unsigned char> mMemory;
+
+		/* Buffers state */
+		std::vector<Slot> mSlots;
+
+		/* Index of the buffer being filled */
+		std::uint32_t mFillSlot;
+
+		/* Number of bytes in the buffer being filled */
+		std::uint32_t mFillSize;
+
+		// ===========================================================
+		// Methods
+		// ===========================================================
+
+		/*
+		 * Submit write of the buffer being filled & switch to the next buffer.
+		 *
+		 * @throws - can throw exception.
+		*/
+		void submitFill( );
+
+		/*
+		 * Waits for one completion.
+		 *
+		 * @throws - can throw exception, if write failed.
+		*/
+		void waitOne( );
+
+		/* Waits for all writes in flight */
+		void drain( ) noexcept;
+
+		// -------------------------------------------------------- \\
+
+	public:
+
+		// -------------------------------------------------------- \\
+
+		// ===========================================================
+		// Constants
+		// ===========================================================
+
+		/* Default size of buffer */
+		static constexpr std::uint32_t DEFAULT_BUFFER_SIZE = 524288;
+
+		/* Default number of buffers, max writes in flight */
+		static constexpr std::uint32_t DEFAULT_QUEUE_DEPTH = 8;
+
+		// ===========================================================
+		// Constructor & destructor
+		// ===========================================================
+
+		/*
+		 * UringOutputSink constructor. Data is written from the current
+		 * position of the file.
+		 *
+		 * @param pFile - file to write, must be regular file.
+		 * @param bufferSize - size of each buffer.
+		 * @param queueDepth - number of buffers.
+		 * @throws - can throw exception, if io_uring not supported or file is not regular.
+		*/
+		explicit UringOutputSink( std::FILE *const pFile, const std::uint32_t bufferSize = DEFAULT_BUFFER_SIZE, const std::uint32_t queueDepth = DEFAULT_QUEUE_DEPTH );
+
+		/* UringOutputSink destructor. Waits for writes in flight. */
+		~UringOutputSink( );
+
+		/* @deleted UringOutputSink copy-constructor */
+		UringOutputSink( const UringOutputSink & ) = delete;
+
+		/* @deleted UringOutputSink copy-assignment */
+		UringOutputSink & operator=( const UringOutputSink & ) = delete;
+
+		// ===========================================================
+		// Methods
+		// ===========================================================
+
+		/*
+		 * Copies data into buffers, submitting full buffers.
+		 *
+		 * @thread_safety - not thread-safe.
+		 * @param pData - data to write.
+		 * @param pSize - number of bytes.
+		 * @throws - can throw exception.
+		*/
+		void write( const unsigned char *const pData, const std::size_t pSize ) override;
+
+		/*
+		 * Submits last buffer, waits for all writes & moves file position
+		 * to the end of written data.
+		 *
+		 * @thread_safety - not thread-safe.
+		 * @throws - can throw exception.
+		*/
+		void finish( ) override;
+
+		// -------------------------------------------------------- \\
+
+	};
+
+	// -------------------------------------------------------- \\
+
+}
\ No newline at end of file
@@ -0,0 +1,372 @@
+/*
+* Copyright  2018 Denis Zyamaev (code4un@yandex.ru) All rights reserved.
+* Authors: Denis Zyamaev (code4un@yandex.ru)
+* All rights reserved.
+* API: C++ 11
+* License: see LICENSE.txt
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+* 1. Redistributions of source code must retain the above copyright notice,
+* this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must display the names 'Denis Zyamaev' and
+* in the credits of the application, if such credits exist.
+* The authors of this work must be notified via email (code4un@yandex.ru) in
+* this case of redistribution.
+* 3. Neither the name of copyright holders nor the names of its contributors
+* may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS
+* IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+* PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// HEADER
+#include "UringQueue.hpp"
+
+// Include Linux io_uring API
+#if defined( __linux__ ) && __has_include( <linux/io_uring.h> )
+#  define GZIP_UTIL_IO_URING 1
+#  include <linux/io_uring.h>
+#  include <sys/mman.h>
+#  include <sys/syscall.h>
+#  include <sys/uio.h>
+#  include <unistd.h>
+#  include <cerrno>
+#  include <cstring>
+#endif
+
+namespace c0de4un
+{
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Constructor & destructor
+	// ===========================================================
+
+	/*
+	 * UringQueue constructor.
+	 *
+	 * @param entries - max number of operations in flight.
+	 * @throws - can throw exception, if io_uring not supported.
+	*/
+	UringQueue::UringQueue( const std::uint32_t entries )
+		: mRing( -1 ),
+		mSubmissionRing( nullptr ),
+		mSubmissionRingSize( 0 ),
+		mCompletionRing( nullptr ),
+		mCompletionRingSize( 0 ),
+		mSubmissionEntries( nullptr ),
+		mSubmissionEntriesSize( 0 ),
+		mSubmissionTail( nullptr ),
+		mSubmissionMask( nullptr ),
+		mSubmissionArray( nullptr ),
+		mCompletionHead( nullptr ),
+		mCompletionTail( nullptr ),
+		mCompletionMask( nullptr ),
+		mCompletionEntries( nullptr ),
+		mFixedBuffers( false ),
+		mInFlight( 0 )
+	{
+
+#if defined( GZIP_UTIL_IO_URING )
+
+		// Ring parameters
+		io_uring_params ringParams;
+		std::memset( &ringParams, 0, sizeof( ringParams ) );
+
+		// Create ring
+		mRing = static_cast<int>( syscall( __NR_io_uring_setup, entries, &ringParams ) );
+
+		if ( mRing < 0 )
+			throw std::runtime_error( "UringQueue - io_uring not supported by kernel" );
+
+		// Ring sizes
+		mSubmissionRingSize = ringParams.sq_off.array + ringParams.sq_entries * sizeof( std::uint32_t );
+		mCompletionRingSize = ringParams.cq_off.cqes + ringParams.cq_entries * sizeof( io_uring_cqe );
+		mSubmissionEntriesSize = ringParams.sq_entries * sizeof( io_uring_sqe );
+
+		// Both rings can be mapped at once
+		const bool singleMapping( ( ringParams.features & IORING_FEAT_SINGLE_MMAP ) != 0 );
+
+		if ( singleMapping )
+			mSubmissionRingSize = mCompletionRingSize = std::max( mSubmissionRingSize, mCompletionRingSize );
+
+		// Map submission-queue ring
+		mSubmissionRing = mmap( nullptr, mSubmissionRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, mRing, IORING_OFF_SQ_RING );
+
+		if ( mSubmissionRing == MAP_FAILED )
+		{
+			mSubmissionRing = nullptr;
+			release( );
+			throw std::runtime_error( "UringQueue - failed to map submission queue" );
+		}
+
+		// Map completion-queue ring
+		if ( singleMapping )
+			mCompletionRing = mSubmissionRing;
+		else
+		{
+
+			mCompletionRing = mmap( nullptr, mCompletionRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, mRing, IORING_OFF_CQ_RING );
+
+			if ( mCompletionRing == MAP_FAILED )
+			{
+				mCompletionRing = nullptr;
+				release( );
+				throw std::runtime_error( "UringQueue - failed to map completion queue" );
+			}
+
+		}
+
+		// Map submission-queue entries
+		mSubmissionEntries = mmap( nullptr, mSubmissionEntriesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, mRing, IORING_OFF_SQES );
+
+		if ( mSubmissionEntries == MAP_FAILED )
+		{
+			mSubmissionEntries = nullptr;
+			release( );
+			throw std::runtime_error( "UringQueue - failed to map submission queue entries" );
+		}
+
+		// Ring pointers
+		unsigned char *const submissionRing( static_cast<unsigned char*>( mSubmissionRing ) );
+		unsigned char *const completionRing( static_cast<unsigned char*>( mCompletionRing ) );
+
+		mSubmissionTail = reinterpret_cast<std::uint32_t*>( submissionRing + ringParams.sq_off.tail );
+		mSubmissionMask = reinterpret_cast<std::uint32_t*>( submissionRing + ringParams.sq_off.ring_mask );
+		mSubmissionArray = reinterpret_cast<std::uint32_t*>( submissionRing + ringParams.sq_off.array );
+		mCompletionHead = reinterpret_cast<std::uint32_t*>( completionRing + ringParams.cq_off.head );
+		mCompletionTail = reinterpret_cast<std::uint32_t*>( completionRing + ringParams.cq_off.tail );
+		mCompletionMask = reinterpret_cast<std::uint32_t*>( completionRing + ringParams.cq_off.ring_mask );
+		mCompletionEntries = completionRing + ringParams.cq_off.cqes;
+
+#else
+
+		// Not supported
+		throw std::runtime_error( "UringQueue - io_uring not supported on this platform" );
+
+#endif
+
+	}
+
+	/* UringQueue destructor. Operations in flight must be completed. */
+	UringQueue::~UringQueue( )
+	{ release( ); }
+
+	// ===========================================================
+	// Getters
+	// ===========================================================
+
+	/* Returns number of submitted & not completed operations */
+	std::uint32_t UringQueue::getInFlight( ) const noexcept
+	{ return( mInFlight ); }
+
+	// ===========================================================
+	// Methods
+	// ===========================================================
+
+	/* Release ring resources */
+	void UringQueue::release( ) noexcept
+	{
+
+#if defined( GZIP_UTIL_IO_URING )
+
+		// Unmap
+		if ( mSubmissionEntries != nullptr )
+			munmap( mSubmissionEntries, mSubmissionEntriesSize );
+
+		if ( mCompletionRing != nullptr && mCompletionRing != mSubmissionRing )
+			munmap( mCompletionRing, mCompletionRingSize );
+
+		if ( mSubmissionRing != nullptr )
+			munmap( mSubmissionRing, mSubmissionRingSize );
+
+		// Close ring, registered buffers are released with it
+		if ( mRing >= 0 )
+			close( mRing );
+
+#endif
+
+		mSubmissionEntries = nullptr;
+		mCompletionRing = nullptr;
+		mSubmissionRing = nullptr;
+		mRing = -1;
+
+	}
+
+	/*
+	 * Register buffers, so kernel doesn't map pages on each operation.
+	 * If registration fails (memlock limit), operations use plain buffers.
+	 *
+	 * @param pMemory - memory, buffersCount * bufferSize bytes.
+	 * @param bufferSize - size of each buffer.
+	 * @param buffersCount - number of buffers.
+	*/
+	void UringQueue::registerBuffers( unsigned char *const pMemory, const std::size_t bufferSize, const std::uint32_t buffersCount ) noexcept
+	{
+
+#if defined( GZIP_UTIL_IO_URING )
+
+		// Buffers
+		std::vector<iovec> buffers( buffersCount );
+
+		for ( std::uint32_t i = 0; i < buffersCount; i++ )
+		{
+			buffers[i].iov_base = pMemory + i * bufferSize;
+			buffers[i].iov_len = bufferSize;
+		}
+
+		// Register
+		mFixedBuffers = syscall( __NR_io_uring_register, mRing, IORING_REGISTER_BUFFERS, buffers.data( ), buffersCount ) == 0;
+
+#endif
+
+	}
+
+	/*
+	 * Submit positioned read or write.
+	 *
+	 * @param pWrite - true to write, false to read.
+	 * @param pFile - file-descriptor.
+	 * @param pBufferIndex - index of registered buffer.
+	 * @param pData - buffer.
+	 * @param pSize - number of bytes.
+	 * @param pOffset - file offset.
+	 * @param pUserData - returned with completion.
+	 * @throws - can throw exception.
+	*/
+	void UringQueue::submit( const bool pWrite, const int pFile, const std::uint32_t pBufferIndex, unsigned char *const pData, const std::uint32_t pSize, const std::uint64_t pOffset, const std::uint64_t pUserData )
+	{
+
+#if defined( GZIP_UTIL_IO_URING )
+
+		// Get free entry, ring is owned by this thread only
+		const std::uint32_t tail( *mSubmissionTail );
+		const std::uint32_t index( tail & *mSubmissionMask );
+		io_uring_sqe *const entry( static_cast<io_uring_sqe*>( mSubmissionEntries ) + index );
+
+		// Fill entry
+		std::memset( entry, 0, sizeof( io_uring_sqe ) );
+		entry->opcode = static_cast<std::uint8_t>( mFixedBuffers ? ( pWrite ? IORING_OP_WRITE_FIXED : IORING_OP_READ_FIXED ) : ( pWrite ? IORING_OP_WRITE : IORING_OP_READ ) );
+		entry->fd = pFile;
+		entry->addr = reinterpret_cast<std::uint64_t>( pData );
+		entry->len = pSize;
+		entry->off = pOffset;
+		entry->buf_index = static_cast<std::uint16_t>( pBufferIndex );
+		entry->user_data = pUserData;
+
+		// Publish entry
+		mSubmissionArray[index] = index;
+		__atomic_store_n( mSubmissionTail, tail + 1, __ATOMIC_RELEASE );
+
+		// Submit, without waiting
+		int submitted( 0 );
+		do
+		{
+			submitted = static_cast<int>( syscall( __NR_io_uring_enter, mRing, 1, 0, 0, nullptr, 0 ) );
+		} while ( submitted < 0 && errno == EINTR );
+
+		if ( submitted != 1 )
+			throw std::runtime_error( "UringQueue::submit - failed to submit io operation" );
+
+		mInFlight++;
+
+#else
+
+		throw std::runtime_error( "UringQueue::submit - io_uring not supported on this platform" );
+
+#endif
+
+	}
+
+	/*
+	 * Submit positioned read into buffer.
+	 *
+	 * @param pFile - file-descriptor.
+	 * @param pBufferIndex - index of registered buffer.
+	 * @param pData - buffer.
+	 * @param pSize - number of bytes.
+	 * @param pOffset - file offset.
+	 * @param pUserData - returned with completion.
+	 * @throws - can throw exception.
+	*/
+	void UringQueue::submitRead( const int pFile, const std::uint32_t pBufferIndex, unsigned char *const pData, const std::uint32_t pSize, const std::uint64_t pOffset, const std::uint64_t pUserData )
+	{ submit( false, pFile, pBufferIndex, pData, pSize, pOffset, pUserData ); }
+
+	/*
+	 * Submit positioned write from buffer.
+	 *
+	 * @param pFile - file-descriptor.
+	 * @param pBufferIndex - index of registered buffer.
+	 * @param pData - buffer.
+	 * @param pSize - number of bytes.
+	 * @param pOffset - file offset.
+	 * @param pUserData - returned with completion.
+	 * @throws - can throw exception.
+	*/
+	void UringQueue::submitWrite( const int pFile, const std::uint32_t pBufferIndex, unsigned char *const pData, const std::uint32_t pSize, const std::uint64_t pOffset, const std::uint64_t pUserData )
+	{ submit( true, pFile, pBufferIndex, pData, pSize, pOffset, pUserData ); }
+
+	/*
+	 * Waits for completion of one operation.
+	 *
+	 * @param pUserData - receives user-data of the operation.
+	 * @return - number of bytes transferred, or negative errno.
+	 * @throws - can throw exception.
+	*/
+	std::int32_t UringQueue::waitCompletion( std::uint64_t & pUserData )
+	{
+
+#if defined( GZIP_UTIL_IO_URING )
+
+		// Check
+		if ( mInFlight == 0 )
+			throw std::runtime_error( "UringQueue::waitCompletion - no operations in flight" );
+
+		// Completion-queue head
+		const std::uint32_t head( *mCompletionHead );
+
+		// Wait until kernel posts completion
+		while ( head == __atomic_load_n( mCompletionTail, __ATOMIC_ACQUIRE ) )
+		{
+
+			if ( syscall( __NR_io_uring_enter, mRing, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0 ) < 0 && errno != EINTR )
+				throw std::runtime_error( "UringQueue::waitCompletion - failed to wait for io completion" );
+
+		}
+
+		// Read completion
+		const io_uring_cqe *const completion( static_cast<const io_uring_cqe*>( mCompletionEntries ) + ( head & *mCompletionMask ) );
+		pUserData = completion->user_data;
+		const std::int32_t result( completion->res );
+
+		// Release completion entry
+		__atomic_store_n( mCompletionHead, head + 1, __ATOMIC_RELEASE );
+		mInFlight--;
+
+		// Return
+		return( result );
+
+#else
+
+		throw std::runtime_error( "UringQueue::waitCompletion - io_uring not supported on this platform" );
+
+#endif
+
+	}
+
+	// -------------------------------------------------------- \\
+
+}
\ No newline at end of file
@@ -0,0 +1,229 @@
+/*
+* Copyright  2018 Denis Zyamaev (code4un@yandex.ru) All rights reserved.
+* Authors: Denis Zyamaev (code4un@yandex.ru)
+* All rights reserved.
+* API: C++ 11
+* License: see LICENSE.txt
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+* 1. Redistributions of source code must retain the above copyright notice,
+* this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must display the names 'Denis Zyamaev' and
+* in the credits of the application, if such credits exist.
+* The authors of this work must be notified via email (code4un@yandex.ru) in
+* this case of redistribution.
+* 3. Neither the name of copyright holders nor the names of its contributors
+* may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS
+* IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+* PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+// Include 'pch_cxx'
+#include "../pch_cxx.hpp"
+
+namespace c0de4un
+{
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Types
+	// ===========================================================
+
+	/*
+	  * UringQueue - minimal Linux io_uring submission/completion queue,
+	  * for positioned reads & writes.
+	  *
+	  * On other platforms, or if kernel doesn't support io_uring,
+	  * constructor throws runtime_error.
+	  *
+	  * @language C++ 17
+	  *
+	  * @authors Z. Denis (c0de4un@yandex.ru)
+	  * @version 1.0
+	 */
+	class UringQueue final
+	{
+
+	private:
+
+		// -------------------------------------------------------- \\
+
+		// ===========================================================
+		// Fields
+		// ===========================================================
+
+		/* Ring file-descriptor */
+		int mRing;
+
+		/* Submission-queue ring mapping */
+		void * mSubmissionRing;
+
+		/* Size of submission-queue ring mapping */
+		std::size_t mSubmissionRingSize;
+
+		/* Completion-queue ring mapping, can be the same as submission-queue ring */
+		void * mCompletionRing;
+
+		/* Size of completion-queue ring mapping */
+		std::size_t mCompletionRingSize;
+
+		/* Submission-queue entries mapping */
+		void * mSubmissionEntries;
+
+		/* Size of submission-queue entries mapping */
+		std::size_t mSubmissionEntriesSize;
+
+		/* Submission-queue tail */
+		std::uint32_t * mSubmissionTail;
+
+		/* Submission-queue index mask */
+		std::uint32_t * mSubmissionMask;
+
+		/* Submission-queue index array */
+		std::uint32_t * mSubmissionArray;
+
+		/* Completion-queue head */
+		std::uint32_t * mCompletionHead;
+
+		/* Completion-queue tail */
+		std::uint32_t * mCompletionTail;
+
+		/* Completion-queue index mask */
+		std::uint32_t * mCompletionMask;
+
+		/* Completion-queue entries */
+		void * mCompletionEntries;
+
+		/* true, if buffers are registered */
+		bool mFixedBuffers;
+
+		/* Number of submitted & not completed operations */
+		std::uint32_t mInFlight;
+
+		// ===========================================================
+		// Methods
+		// ===========================================================
+
+		/*
+		 * Submit positioned read or write.
+		 *
+		 * @param pWrite - true to write, false to read.
+		 * @param pFile - file-descriptor.
+		 * @param pBufferIndex - index of registered buffer.
+		 * @param pData - buffer.
+		 * @param pSize - number of bytes.
+		 * @param pOffset - file offset.
+		 * @param pUserData - returned with completion.
+		 * @throws - can throw exception.
+		*/
+		void submit( const bool pWrite, const int pFile, const std::uint32_t pBufferIndex, unsigned char *const pData, const std::uint32_t pSize, const std::uint64_t pOffset, const std::uint64_t pUserData );
+
+		/* Release ring resources */
+		void release( ) noexcept;
+
+		// -------------------------------------------------------- \\
+
+	public:
+
+		// -------------------------------------------------------- \\
+
+		// ===========================================================
+		// Constructor & destructor
+		// ===========================================================
+
+		/*
+		 * UringQueue constructor.
+		 *
+		 * @param entries - max number of operations in flight.
+		 * @throws - can throw exception, if io_uring not supported.
+		*/
+		explicit UringQueue( const std::uint32_t entries );
+
+		/* UringQueue destructor. Operations in flight must be completed. */
+		~UringQueue( );
+
+		/* @deleted UringQueue copy-constructor */
+		UringQueue( const UringQueue & ) = delete;
+
+		/* @deleted UringQueue copy-assignment */
+		UringQueue & operator=( const UringQueue & ) = delete;
+
+		// ===========================================================
+		// Getters
+		// ===========================================================
+
+		/* Returns number of submitted & not completed operations */
+		std::uint32_t getInFlight( ) const noexcept;
+
+		// ===========================================================
+		// Methods
+		// ===========================================================
+
+		/*
+		 * Register buffers, so kernel doesn't map pages on each operation.
+		 * If registration fails (memlock limit), operations use plain buffers.
+		 *
+		 * @param pMemory - memory, buffersCount * bufferSize bytes.
+		 * @param bufferSize - size of each buffer.
+		 * @param buffersCount - number of buffers.
+		*/
+		void registerBuffers( unsigned char *const pMemory, const std::size_t bufferSize, const std::uint32_t buffersCount ) noexcept;
+
+		/*
+		 * Submit positioned read into buffer.
+		 *
+		 * @param pFile - file-descriptor.
+		 * @param pBufferIndex - index of registered buffer.
+		 * @param pData - buffer.
+		 * @param pSize - number of bytes.
+		 * @param pOffset - file offset.
+		 * @param pUserData - returned with completion.
+		 * @throws - can throw exception.
+		*/
+		void submitRead( const int pFile, const std::uint32_t pBufferIndex, unsigned char *const pData, const std::uint32_t pSize, const std::uint64_t pOffset, const std::uint64_t pUserData );
+
+		/*
+		 * Submit positioned write from buffer.
+		 *
+		 * @param pFile - file-descriptor.
+		 * @param pBufferIndex - index of registered buffer.
+		 * @param pData - buffer.
+		 * @param pSize - number of bytes.
+		 * @param pOffset - file offset.
+		 * @param pUserData - returned with completion.
+		 * @throws - can throw exception.
+		*/
+		void submitWrite( const int pFile, const std::uint32_t pBufferIndex, unsigned char *const pData, const std::uint32_t pSize, const std::uint64_t pOffset, const std::uint64_t pUserData );
+
+		/*
+		 * Waits for completion of one operation.
+		 *
+		 * @param pUserData - receives user-data of the operation.
+		 * @return - number of bytes transferred, or negative errno.
+		 * @throws - can throw exception.
+		*/
+		std::int32_t waitCompletion( std::uint64_t & pUserData );
+
+		// -------------------------------------------------------- \\
+
+	};
+
+	// -------------------------------------------------------- \\
+
+}
\ No newline at end of file
@@ -47,6 +47,48 @@ static std::uint8_t getCommandID( const char *const pCommand )
 	if ( pCommand == "help" )
 		return( CONSOLE_COMMAND_ID_HELP );
 
+	if ( std::strcmp( pCommand, "index" ) == 0 )
+		return( CONSOLE_COMMAND_ID_INDEX );
+
+	if ( std::strcmp( pCommand, "extract" ) == 0 )
+		return( CONSOLE_COMMAND_ID_EXTRACT );
+
+	if ( std::strcmp( pCommand, "batch" ) == 0 )
+		return( CONSOLE_COMMAND_ID_BATCH );
+
+	if ( std::strcmp( pCommand, "test" ) == 0 )
+		return( CONSOLE_COMMAND_ID_TEST );
+
+	if ( std::strcmp( pCommand, "stream" ) == 0 )
+		return( CONSOLE_COMMAND_ID_STREAM );
+
+	if ( std::strcmp( pCommand, "pack" ) == 0 )
+		return( CONSOLE_COMMAND_ID_PACK );
+
+	if ( std::strcmp( pCommand, "unpack" ) == 0 )
+		return( CONSOLE_COMMAND_ID_UNPACK );
+
+	if ( std::strcmp( pCommand, "train-dict" ) == 0 )
+		return( CONSOLE_COMMAND_ID_TRAIN_DICT );
+
+	if ( std::strcmp( pCommand, "decompress" ) == 0 )
+		return( CONSOLE_COMMAND_ID_DECOMPRESS );
+
+	if ( std::strcmp( pCommand, "compress" ) == 0 )
+		return( CONSOLE_COMMAND_ID_COMPRESS );
+
+	if ( std::strcmp( pCommand, "bgzf" ) == 0 )
+		return( CONSOLE_COMMAND_ID_BGZF );
+
+	if ( std::strcmp( pCommand, "bgzf-extract" ) == 0 )
+		return( CONSOLE_COMMAND_ID_BGZF_EXTRACT );
+
+	if ( std::strcmp( pCommand, "zip" ) == 0 )
+		return( CONSOLE_COMMAND_ID_ZIP );
+
+	if ( std::strcmp( pCommand, "unzip-entry" ) == 0 )
+		return( CONSOLE_COMMAND_ID_UNZIP_ENTRY );
+
 	// Return Default
 	return( CONSOLE_COMMAND_ID_HELP );
 
@@ -68,8 +110,10 @@ static void handleCommand( const char *const pArguments, const std::uint8_t pCom
  * 
  * @param srcFile - file (archive, not gzip) to decompress (inflate).
  * @param dstFile - path to result output.
+ * @param pSparse - true to skip zero blocks, so output is sparse (disk images).
+ * @param pDirectIO - true to write preallocated output with O_DIRECT, on one thread.
 */
-void decompressFile( const char *const srcFile, const char *const dstFile )
+void decompressFile( const char *const srcFile, const char *const dstFile, const bool pSparse = false, const bool pDirectIO = false )
 {
 
 	// Input FILE
@@ -124,8 +168,20 @@ void decompressFile( const char *const srcFile, const char *const dstFile )
 	try
 	{
 
-		// Inflate (decompress) & write output to result-file.
-		if ( c0de4un::ZStream::inflateFILE( inputFILE, outFILE, 16384 ) != Z_OK )
+		// Decompression result
+		int zRet( Z_OK );
+
+		// Inflate (decompress) & write output to result-file. gzip-members are inflated on multiple threads, zlib is pipelined.
+		// Sparse output is inflated on one thread, holes of hole map & zero blocks are not written.
+		// Direct io output is inflated on one thread, size is taken from gzip trailers or frame table.
+		if ( pSparse )
+			zRet = c0de4un::ZSparse::inflateFILE( inputFILE, outFILE );
+		else if ( pDirectIO )
+			zRet = c0de4un::ZStream::inflateFILE( inputFILE, outFILE, STREAM_BUFFER_SIZE, c0de4un::IOBackend::DIRECT_IO );
+		else
+			zRet = c0de4un::ZParallelInflate::inflateFILE( inputFILE, outFILE );
+
+		if ( zRet != Z_OK )
 			std::cout << "decompression failed for file#" << srcFile << std::endl;
 		else
 			std::cout << "decompression completed for file#" << srcFile << std::endl;
@@ -197,9 +253,11 @@ void decompressFile( const char *const srcFile, const char *const dstFile )
  * @param srcFile - path to a source-file to compress (deflate).
  * @param dstFile - path to compression (deflate) output-file.
  * @param pCompression - compression-level, must be in range 0-9.
+ * @param pThreads - number of threads, 0 to use all hardware-threads.
+ * @param pDirectIO - true to write preallocated output with O_DIRECT, on one thread.
  * @throws - can throw exception.
 */
-void compressFile( const char *const srcFile, const char *const dstFile, const std::uint32_t & pCompression )
+void compressFile( const char *const srcFile, const char *const dstFile, const std::uint32_t & pCompression, const std::uint32_t pThreads = 0, const bool pDirectIO = false )
 {
 
 	// Input FILE
@@ -254,12 +312,28 @@ void compressFile( const char *const srcFile, const char *const dstFile, const s
 
 		}
 
-		// Read, compress & write compressed data
-		if ( c0de4un::ZStream::deflateFILE( inputFILE, outFILE, 16384, 1 ) != Z_OK )
+		// Compression result
+		int zRet( Z_OK );
+
+		// Buffer statistics of single-thread compression
+		c0de4un::ZStream::Stats streamStats{ 0, 0, 0 };
+
+		// Read, compress & write compressed data. Multiple threads use block-parallel deflate, direct io uses one stream.
+		if ( pThreads != 1 && !pDirectIO )
+			zRet = c0de4un::ZParallelDeflate::deflateFILE( inputFILE, outFILE, static_cast<int>( pCompression ), pThreads );
+		else
+			zRet = c0de4un::ZStream::deflateFILE( inputFILE, outFILE, STREAM_BUFFER_SIZE, static_cast<int>( pCompression ), pDirectIO ? c0de4un::IOBackend::DIRECT_IO : c0de4un::IOBackend::MEMORY_MAPPED, c0de4un::ZFormat::ZLIB, c0de4un::ZGzipHeader( ), &streamStats );
+
+		// Print result
+		if ( zRet != Z_OK )
 			std::cout << "compression failed for file#" << srcFile << std::endl;
 		else
 			std::cout << "compression complete for file#" << srcFile << "; output written to " << dstFile << std::endl;
 
+		// Print chosen buffer size
+		if ( streamStats.bufferSize > 0 )
+			std::cout << "buffer size: " << streamStats.bufferSize << " bytes, grown " << streamStats.growCount << " times, " << streamStats.readCount << " reads" << std::endl;
+
 		// Close Input FILE
 		std::fclose( inputFILE );
 		inputFILE = nullptr;
@@ -323,14 +397,1289 @@ void compressFile( const char *const srcFile, const char *const dstFile, const s
 }
 
 /*
- * MAIN
- * 
- * @param argC - number of arguments.
- * @param argV - arguments, where #0 is app name.
+ * Compress stdin to stdout as gzip, or decompress it, for shell
+ * pipelines. Pipes are enlarged & output is spliced into pipe.
+ * stdout carries data only, messages are printed to stderr.
+ *
+ * @param pDecompress - true to decompress, compress otherwise.
+ * @param pCompression - compression-level, must be in range 0-9.
+ * @param pMaxMemory - memory limit of stream & buffers, 0 for no limit.
+ * @return - Z_OK if complete, Z_ERRNO otherwise.
 */
-int main( int argC, char * argV[] )
+int streamPipe( const bool pDecompress, const std::uint32_t & pCompression, const std::uint64_t pMaxMemory = 0 )
+{
+
+	// Messages of engines go to stderr
+	std::streambuf *const coutBuffer( std::cout.rdbuf( std::cerr.rdbuf( ) ) );
+
+	// Buffers grow up to the planned size
+	c0de4un::MemoryBudget::Plan streamPlan{ 1, c0de4un::ZStream::DEFAULT_MAX_BUFFER_SIZE, MAX_WBITS, c0de4un::MemoryBudget::DEFAULT_MEM_LEVEL };
+	if ( pMaxMemory > 0 )
+		streamPlan = c0de4un::MemoryBudget( pMaxMemory ).plan( 1, c0de4un::ZStream::DEFAULT_MAX_BUFFER_SIZE, pDecompress );
+
+	// Engine
+	c0de4un::ZStream zEngine( std::min( STREAM_BUFFER_SIZE, streamPlan.bufferSize ), &c0de4un::ZArena::getThreadArena( ), streamPlan.bufferSize );
+	zEngine.setDeflateMemory( streamPlan.windowBits, streamPlan.memLevel );
+
+	// Stream
+	int zRet( pDecompress ? zEngine.decompressFILE( stdin, stdout, c0de4un::IOBackend::PIPE )
+		: zEngine.compressFILE( stdin, stdout, static_cast<int>( pCompression ), c0de4un::IOBackend::PIPE, c0de4un::ZFormat::GZIP ) );
+
+	// Write stdio buffer, when stdout is not a pipe
+	if ( std::fflush( stdout ) != 0 )
+		zRet = Z_ERRNO;
+
+	// Print result
+	if ( zRet != Z_OK )
+		std::cerr << "stream " << ( pDecompress ? "decompression" : "compression" ) << " failed" << std::endl;
+
+	// Restore stdout messages
+	std::cout.rdbuf( coutBuffer );
+
+	// Return
+	return( zRet == Z_OK ? Z_OK : Z_ERRNO );
+
+}
+
+/*
+ * Compress sparse file (disk image) as gzip with hole map. Holes are
+ * not read, decompressFile with pSparse recreates them.
+ *
+ * @param srcFile - path to a source-file to compress (deflate).
+ * @param dstFile - path to compression (deflate) output-file.
+ * @param pCompression - compression-level, must be in range 0-9.
+*/
+void compressSparseFile( const char *const srcFile, const char *const dstFile, const std::uint32_t & pCompression )
+{
+
+	// Input FILE
+	std::FILE * inputFILE( nullptr );
+
+	// Output FILE
+	std::FILE * outFILE( nullptr );
+
+	// FILE fopen_s errno
+	errno_t errCode;
+
+	// Guarded-Block
+	try
+	{
+
+		// Open input (source) FILE
+		errCode = fopen_s( &inputFILE, srcFile, "rb" );
+
+		// Check errors
+		if ( errCode != 0 || inputFILE == nullptr )
+			throw std::runtime_error( "failed to open input-file" );
+
+		// Open output (destination) FILE
+		errCode = fopen_s( &outFILE, dstFile, "wb" );
+
+		// Check errors
+		if ( errCode != 0 || outFILE == nullptr )
+			throw std::runtime_error( "failed to open output-file" );
+
+		// Compress data extents, holes are recorded in hole map
+		if ( c0de4un::ZSparse::deflateFILE( inputFILE, outFILE, static_cast<int>( pCompression ) ) != Z_OK )
+			throw std::runtime_error( "compression failed" );
+
+		// Print result
+		std::cout << "sparse compression complete for file#" << srcFile << "; output written to " << dstFile << std::endl;
+
+	}
+	catch ( const std::exception & pException )
+	{
+
+		// Print ERROR-message
+		std::cout << "failed to compress sparse file#" << srcFile << ", error: " << pException.what( ) << std::endl;
+
+	}
+
+	// Close Input FILE
+	if ( inputFILE != nullptr )
+		std::fclose( inputFILE );
+
+	// Close Output FILE
+	if ( outFILE != nullptr )
+		std::fclose( outFILE );
+
+}
+
+/*
+ * Compress file as BGZF (blocked gzip), members are compressed on multiple threads.
+ *
+ * @param srcFile - path to a source-file to compress (deflate).
+ * @param dstFile - path to compression (deflate) output-file.
+ * @param pCompression - compression-level, must be in range 0-9.
+ * @param pThreads - number of threads, 0 to use all hardware-threads.
+*/
+void compressBgzfFile( const char *const srcFile, const char *const dstFile, const std::uint32_t & pCompression, const std::uint32_t pThreads = 0 )
+{
+
+	// Input FILE
+	std::FILE * inputFILE( nullptr );
+
+	// Output FILE
+	std::FILE * outFILE( nullptr );
+
+	// FILE fopen_s errno
+	errno_t errCode;
+
+	// Guarded-Block
+	try
+	{
+
+		// Open input (source) FILE
+		errCode = fopen_s( &inputFILE, srcFile, "rb" );
+
+		// Check errors
+		if ( errCode != 0 || inputFILE == nullptr )
+			throw std::runtime_error( "failed to open input-file" );
+
+		// Open output (destination) FILE
+		errCode = fopen_s( &outFILE, dstFile, "wb" );
+
+		// Check errors
+		if ( errCode != 0 || outFILE == nullptr )
+			throw std::runtime_error( "failed to open output-file" );
+
+		// Compress
+		if ( c0de4un::ZBgzf::deflateFILE( inputFILE, outFILE, static_cast<int>( pCompression ), pThreads ) != Z_OK )
+			throw std::runtime_error( "compression failed" );
+
+		// Print result
+		std::cout << "BGZF compression complete for file#" << srcFile << "; output written to " << dstFile << std::endl;
+
+	}
+	catch ( const std::exception & pException )
+	{
+
+		// Print ERROR-message
+		std::cout << "failed to compress BGZF file#" << srcFile << ", error: " << pException.what( ) << std::endl;
+
+	}
+
+	// Close Input FILE
+	if ( inputFILE != nullptr )
+		std::fclose( inputFILE );
+
+	// Close Output FILE
+	if ( outFILE != nullptr )
+		std::fclose( outFILE );
+
+}
+
+/*
+ * Decompress range of BGZF file, starting from virtual offset.
+ *
+ * @param srcFile - BGZF file.
+ * @param dstFile - path to range output.
+ * @param pVirtualOffset - virtual offset: member offset << 16 | offset in member.
+ * @param pLength - size of the range.
+*/
+void extractBgzfFile( const char *const srcFile, const char *const dstFile, const std::uint64_t pVirtualOffset, const std::uint64_t pLength )
+{
+
+	// Input FILE
+	std::FILE * inputFILE( nullptr );
+
+	// Output FILE
+	std::FILE * outFILE( nullptr );
+
+	// FILE fopen_s errno
+	errno_t errCode;
+
+	// Guarded-Block
+	try
+	{
+
+		// Open input (source) FILE
+		errCode = fopen_s( &inputFILE, srcFile, "rb" );
+
+		if ( errCode != 0 || inputFILE == nullptr )
+			throw std::runtime_error( "failed to open input-file" );
+
+		// Open output (destination) FILE
+		errCode = fopen_s( &outFILE, dstFile, "wb" );
+
+		if ( errCode != 0 || outFILE == nullptr )
+			throw std::runtime_error( "failed to open output-file" );
+
+		// Output
+		std::unique_ptr<c0de4un::OutputSink> outputSink( c0de4un::IOFactory::openSink( outFILE, c0de4un::IOBackend::STDIO ) );
+
+		// Decompress members from virtual offset
+		if ( c0de4un::ZBgzf::inflateFILE( inputFILE, *outputSink, pVirtualOffset, pLength ) != Z_OK )
+			throw std::runtime_error( "failed to extract range" );
+
+		// Print result
+		std::cout << "BGZF extract complete for file#" << srcFile << "; output written to " << dstFile << std::endl;
+
+	}
+	catch ( const std::exception & pException )
+	{
+
+		// Print ERROR-message
+		std::cout << "failed to extract BGZF file#" << srcFile << ", error: " << pException.what( ) << std::endl;
+
+	}
+
+	// Close Input FILE
+	if ( inputFILE != nullptr )
+		std::fclose( inputFILE );
+
+	// Close Output FILE
+	if ( outFILE != nullptr )
+		std::fclose( outFILE );
+
+}
+
+/*
+ * Compress files into ZIP archive, entries are compressed on multiple
+ * threads. Entry name is the file name, without directories.
+ *
+ * @param srcFiles - paths of files to add.
+ * @param dstFile - path to archive.
+ * @param pCompression - compression-level, must be in range 0-9.
+ * @param pThreads - number of threads, 0 to use all hardware-threads.
+*/
+void archiveFiles( const std::vector<std::string> & srcFiles, const char *const dstFile, const std::uint32_t & pCompression, const std::uint32_t pThreads = 0 )
+{
+
+	// Output FILE
+	std::FILE * outFILE( nullptr );
+
+	// FILE fopen_s errno
+	errno_t errCode;
+
+	// Guarded-Block
+	try
+	{
+
+		// Entries
+		std::vector<c0de4un::ZArchive::Item> archiveItems;
+		for ( const std::string & srcPath : srcFiles )
+			archiveItems.push_back( { srcPath, srcPath.substr( srcPath.find_last_of( "/\\" ) + 1 ) } );
+
+		// Open output (destination) FILE
+		errCode = fopen_s( &outFILE, dstFile, "wb" );
+
+		// Check errors
+		if ( errCode != 0 || outFILE == nullptr )
+			throw std::runtime_error( "failed to open output-file" );
+
+		// Compress
+		if ( c0de4un::ZArchive::deflateFiles( archiveItems, outFILE, static_cast<int>( pCompression ), pThreads ) != Z_OK )
+			throw std::runtime_error( "compression failed" );
+
+		// Print result
+		std::cout << "archive complete: " << archiveItems.size( ) << " files written to " << dstFile << std::endl;
+
+	}
+	catch ( const std::exception & pException )
+	{
+
+		// Print ERROR-message
+		std::cout << "failed to write archive#" << dstFile << ", error: " << pException.what( ) << std::endl;
+
+	}
+
+	// Close Output FILE
+	if ( outFILE != nullptr )
+		std::fclose( outFILE );
+
+}
+
+/*
+ * Decompress one entry of ZIP archive, using central directory.
+ *
+ * @param srcFile - ZIP archive.
+ * @param entryName - name of entry in archive.
+ * @param dstFile - path to entry output.
+*/
+void extractArchiveEntry( const char *const srcFile, const char *const entryName, const char *const dstFile )
 {
 
+	// Input FILE
+	std::FILE * inputFILE( nullptr );
+
+	// Output FILE
+	std::FILE * outFILE( nullptr );
+
+	// FILE fopen_s errno
+	errno_t errCode;
+
+	// Guarded-Block
+	try
+	{
+
+		// Open input (source) FILE
+		errCode = fopen_s( &inputFILE, srcFile, "rb" );
+
+		if ( errCode != 0 || inputFILE == nullptr )
+			throw std::runtime_error( "failed to open input-file" );
+
+		// Read central directory
+		c0de4un::ZArchive zArchive;
+		if ( zArchive.load( inputFILE ) != Z_OK )
+			throw std::runtime_error( "failed to read central directory" );
+
+		// Find entry
+		const std::size_t entryIndex( zArchive.findEntry( entryName ) );
+		if ( entryIndex == c0de4un::ZArchive::NO_ENTRY )
+			throw std::runtime_error( "entry not found" );
+
+		// Open output (destination) FILE
+		errCode = fopen_s( &outFILE, dstFile, "wb" );
+
+		if ( errCode != 0 || outFILE == nullptr )
+			throw std::runtime_error( "failed to open output-file" );
+
+		// Output, preallocated for the entry size
+		std::unique_ptr<c0de4un::OutputSink> outputSink( c0de4un::IOFactory::openSink( outFILE, c0de4un::IOBackend::STDIO, zArchive.getEntry( entryIndex ).uncompressedSize ) );
+
+		// Decompress entry
+		if ( zArchive.extract( inputFILE, entryIndex, *outputSink ) != Z_OK )
+			throw std::runtime_error( "failed to extract entry" );
+
+		// Print result
+		std::cout << "extract complete for entry#" << entryName << "; output written to " << dstFile << std::endl;
+
+	}
+	catch ( const std::exception & pException )
+	{
+
+		// Print ERROR-message
+		std::cout << "failed to extract entry#" << entryName << " of archive#" << srcFile << ", error: " << pException.what( ) << std::endl;
+
+	}
+
+	// Close Input FILE
+	if ( inputFILE != nullptr )
+		std::fclose( inputFILE );
+
+	// Close Output FILE
+	if ( outFILE != nullptr )
+		std::fclose( outFILE );
+
+}
+
+/*
+ * Pack directory into tar.gz. Tar headers & file data are produced while
+ * they are compressed, no intermediate tar file is written.
+ *
+ * @param srcDir - directory to pack.
+ * @param dstFile - path to tar.gz output.
+ * @param pCompression - compression-level, must be in range 0-9.
+ * @return - Z_OK if sucessfull, Z_ERRNO otherwise.
+*/
+int packDirectory( const char *const srcDir, const char *const dstFile, const std::uint32_t & pCompression )
+{
+
+	// Output FILE
+	std::FILE * outFILE( nullptr );
+
+	// FILE fopen_s errno
+	errno_t errCode;
+
+	// Result
+	int zRet( Z_ERRNO );
+
+	// Guarded-Block
+	try
+	{
+
+		// Archive of directory
+		c0de4un::TarInputSource tarSource( srcDir );
+
+		// Open output (destination) FILE
+		errCode = fopen_s( &outFILE, dstFile, "wb" );
+
+		if ( errCode != 0 || outFILE == nullptr )
+			throw std::runtime_error( "failed to open output-file" );
+
+		// Compress
+		std::unique_ptr<c0de4un::OutputSink> outputSink( c0de4un::IOFactory::openSink( outFILE, c0de4un::IOBackend::STDIO ) );
+		if ( c0de4un::ZStream::deflateSource( tarSource, *outputSink, STREAM_BUFFER_SIZE, static_cast<int>( pCompression ), c0de4un::ZFormat::GZIP ) != Z_OK )
+			throw std::runtime_error( "compression failed" );
+
+		// Print result
+		std::cout << "pack complete: " << tarSource.getEntriesCount( ) << " entries written to " << dstFile << std::endl;
+
+		zRet = Z_OK;
+
+	}
+	catch ( const std::exception & pException )
+	{
+
+		// Print ERROR-message
+		std::cout << "failed to pack directory#" << srcDir << ", error: " << pException.what( ) << std::endl;
+
+	}
+
+	// Close Output FILE
+	if ( outFILE != nullptr && std::fclose( outFILE ) != 0 )
+		zRet = Z_ERRNO;
+
+	return( zRet );
+
+}
+
+/*
+ * Unpack tar.gz into directory. Inflated archive goes straight into
+ * files, it's never stored.
+ *
+ * @param srcFile - tar.gz (or zlib compressed tar) to unpack.
+ * @param dstDir - output directory, created if required.
+ * @return - Z_OK if sucessfull, Z_ERRNO otherwise.
+*/
+int unpackArchive( const char *const srcFile, const char *const dstDir )
+{
+
+	// Input FILE
+	std::FILE * inputFILE( nullptr );
+
+	// FILE fopen_s errno
+	errno_t errCode;
+
+	// Result
+	int zRet( Z_ERRNO );
+
+	// Guarded-Block
+	try
+	{
+
+		// Open input (source) FILE
+		errCode = fopen_s( &inputFILE, srcFile, "rb" );
+
+		if ( errCode != 0 || inputFILE == nullptr )
+			throw std::runtime_error( "failed to open input-file" );
+
+		// Output directory
+		c0de4un::TarOutputSink tarSink( dstDir );
+
+		// Decompress
+		std::unique_ptr<c0de4un::InputSource> inputSource( c0de4un::IOFactory::openSource( inputFILE, STREAM_BUFFER_SIZE, c0de4un::IOBackend::STDIO ) );
+		if ( c0de4un::ZStream::inflateSource( *inputSource, tarSink, STREAM_BUFFER_SIZE ) != Z_OK )
+			throw std::runtime_error( "decompression failed" );
+
+		// Print result
+		std::cout << "unpack complete: " << tarSink.getEntriesCount( ) << " entries written to " << dstDir << std::endl;
+
+		zRet = Z_OK;
+
+	}
+	catch ( const std::exception & pException )
+	{
+
+		// Print ERROR-message
+		std::cout << "failed to unpack archive#" << srcFile << ", error: " << pException.what( ) << std::endl;
+
+	}
+
+	// Close Input FILE
+	if ( inputFILE != nullptr )
+		std::fclose( inputFILE );
+
+	return( zRet );
+
+}
+
+/*
+ * Train preset dictionary from sample files & write it.
+ *
+ * @param dstFile - path to dictionary output, registry directory loads ZDictionary::FILE_EXTENSION files.
+ * @param sampleFiles - sample files or directories.
+ * @return - Z_OK if sucessfull, Z_ERRNO otherwise.
+*/
+int trainDictionary( const char *const dstFile, const std::vector<std::string> & sampleFiles )
+{
+
+	// Output FILE
+	std::FILE * outFILE( nullptr );
+
+	// FILE fopen_s errno
+	errno_t errCode;
+
+	// Result
+	int zRet( Z_ERRNO );
+
+	// Guarded-Block
+	try
+	{
+
+		// Train
+		std::vector<unsigned char> zDictionary;
+		if ( c0de4un::ZDictionary::train( sampleFiles, zDictionary ) != Z_OK )
+			throw std::runtime_error( "training failed" );
+
+		// Open output (destination) FILE
+		errCode = fopen_s( &outFILE, dstFile, "wb" );
+
+		if ( errCode != 0 || outFILE == nullptr )
+			throw std::runtime_error( "failed to open output-file" );
+
+		// Write
+		if ( fwrite( zDictionary.data( ), sizeof( unsigned char ), zDictionary.size( ), outFILE ) != zDictionary.size( ) )
+			throw std::runtime_error( "failed to write output-file" );
+
+		// Print result
+		std::cout << "dictionary complete: " << zDictionary.size( ) << " bytes, id " << c0de4un::ZDictionary::getID( zDictionary ) << ", written to " << dstFile << std::endl;
+
+		zRet = Z_OK;
+
+	}
+	catch ( const std::exception & pException )
+	{
+
+		// Print ERROR-message
+		std::cout << "failed to train dictionary#" << dstFile << ", error: " << pException.what( ) << std::endl;
+
+	}
+
+	// Close Output FILE
+	if ( outFILE != nullptr && std::fclose( outFILE ) != 0 )
+		zRet = Z_ERRNO;
+
+	return( zRet );
+
+}
+
+/*
+ * Compress file as zlib with preset dictionary.
+ *
+ * @param srcFile - file to compress.
+ * @param dstFile - path to output.
+ * @param dictionaryFile - dictionary, written by trainDictionary.
+ * @param pCompression - compression-level, must be in range 0-9.
+*/
+void compressDictionaryFile( const char *const srcFile, const char *const dstFile, const char *const dictionaryFile, const std::uint32_t & pCompression )
+{
+
+	// Input FILE
+	std::FILE * inputFILE( nullptr );
+
+	// Output FILE
+	std::FILE * outFILE( nullptr );
+
+	// FILE fopen_s errno
+	errno_t errCode;
+
+	// Guarded-Block
+	try
+	{
+
+		// Dictionary
+		std::vector<unsigned char> zDictionary;
+		c0de4un::ZDictionary::read( dictionaryFile, zDictionary );
+
+		// Open input (source) FILE
+		errCode = fopen_s( &inputFILE, srcFile, "rb" );
+
+		if ( errCode != 0 || inputFILE == nullptr )
+			throw std::runtime_error( "failed to open input-file" );
+
+		// Open output (destination) FILE
+		errCode = fopen_s( &outFILE, dstFile, "wb" );
+
+		if ( errCode != 0 || outFILE == nullptr )
+			throw std::runtime_error( "failed to open output-file" );
+
+		// Compress, zlib header stores id of dictionary
+		if ( c0de4un::ZStream::deflateFILE( inputFILE, outFILE, STREAM_BUFFER_SIZE, static_cast<int>( pCompression ), c0de4un::IOBackend::STDIO, c0de4un::ZFormat::ZLIB, c0de4un::ZGzipHeader( ), nullptr, &zDictionary ) != Z_OK )
+			throw std::runtime_error( "compression failed" );
+
+		// Print result
+		std::cout << "compression complete for file#" << srcFile << " with dictionary id " << c0de4un::ZDictionary::getID( zDictionary ) << "; output written to " << dstFile << std::endl;
+
+	}
+	catch ( const std::exception & pException )
+	{
+
+		// Print ERROR-message
+		std::cout << "failed to compress file#" << srcFile << ", error: " << pException.what( ) << std::endl;
+
+	}
+
+	// Close Input FILE
+	if ( inputFILE != nullptr )
+		std::fclose( inputFILE );
+
+	// Close Output FILE
+	if ( outFILE != nullptr )
+		std::fclose( outFILE );
+
+}
+
+/*
+ * Decompress zlib or gzip file, stream requiring preset dictionary
+ * gets it from registry by id.
+ *
+ * @param srcFile - file to decompress.
+ * @param dstFile - path to output.
+ * @param registryPath - dictionary file, or directory of ZDictionary::FILE_EXTENSION files.
+*/
+void decompressDictionaryFile( const char *const srcFile, const char *const dstFile, const char *const registryPath )
+{
+
+	// Input FILE
+	std::FILE * inputFILE( nullptr );
+
+	// Output FILE
+	std::FILE * outFILE( nullptr );
+
+	// FILE fopen_s errno
+	errno_t errCode;
+
+	// Guarded-Block
+	try
+	{
+
+		// Registry
+		c0de4un::ZDictionary zDictionaries;
+		zDictionaries.load( registryPath );
+
+		// Open input (source) FILE
+		errCode = fopen_s( &inputFILE, srcFile, "rb" );
+
+		if ( errCode != 0 || inputFILE == nullptr )
+			throw std::runtime_error( "failed to open input-file" );
+
+		// Open output (destination) FILE
+		errCode = fopen_s( &outFILE, dstFile, "wb" );
+
+		if ( errCode != 0 || outFILE == nullptr )
+			throw std::runtime_error( "failed to open output-file" );
+
+		// Decompress, zlib with preset dictionary is inflated on one thread
+		if ( c0de4un::ZParallelInflate::inflateFILE( inputFILE, outFILE, 0, &zDictionaries ) != Z_OK )
+			throw std::runtime_error( "decompression failed" );
+
+		// Print result
+		std::cout << "decompression complete for file#" << srcFile << "; output written to " << dstFile << std::endl;
+
+	}
+	catch ( const std::exception & pException )
+	{
+
+		// Print ERROR-message
+		std::cout << "failed to decompress file#" << srcFile << ", error: " << pException.what( ) << std::endl;
+
+	}
+
+	// Close Input FILE
+	if ( inputFILE != nullptr )
+		std::fclose( inputFILE );
+
+	// Close Output FILE
+	if ( outFILE != nullptr )
+		std::fclose( outFILE );
+
+}
+
+/*
+ * Build random-access index of compressed file, index is written to
+ * sidecar-file (srcFile + INDEX_FILE_EXTENSION).
+ *
+ * @param srcFile - zlib or gzip file to index.
+ * @param dstFile - path to decompressed output, so file is decompressed &
+ * indexed in one pass. Can be null.
+ * @param pSpan - distance between access-points, in uncompressed bytes.
+*/
+void indexFile( const char *const srcFile, const char *const dstFile = nullptr, const std::uint64_t pSpan = c0de4un::ZIndex::DEFAULT_SPAN )
+{
+
+	// Input FILE
+	std::FILE * inputFILE( nullptr );
+
+	// Output FILE
+	std::FILE * outFILE( nullptr );
+
+	// Index FILE
+	std::FILE * indexFILE( nullptr );
+
+	// Index-file path
+	const std::string indexPath( std::string( srcFile ) + INDEX_FILE_EXTENSION );
+
+	// FILE fopen_s errno
+	errno_t errCode;
+
+	// Guarded-Block
+	try
+	{
+
+		// Open input (source) FILE
+		errCode = fopen_s( &inputFILE, srcFile, "rb" );
+
+		// Check errors
+		if ( errCode != 0 || inputFILE == nullptr )
+			throw std::runtime_error( "failed to open input-file" );
+
+		// Open output (destination) FILE
+		if ( dstFile != nullptr )
+		{
+
+			errCode = fopen_s( &outFILE, dstFile, "wb" );
+
+			if ( errCode != 0 || outFILE == nullptr )
+				throw std::runtime_error( "failed to open output-file" );
+
+		}
+
+		// Output
+		std::unique_ptr<c0de4un::FileOutputSink> outputSink( outFILE != nullptr ? new c0de4un::FileOutputSink( outFILE ) : nullptr );
+
+		// Index
+		c0de4un::ZIndex zIndex;
+
+		// Decompress & record access-points
+		if ( zIndex.build( inputFILE, pSpan, outputSink.get( ) ) != Z_OK )
+			throw std::runtime_error( "failed to build index" );
+
+		// Open index FILE
+		errCode = fopen_s( &indexFILE, indexPath.c_str( ), "wb" );
+
+		if ( errCode != 0 || indexFILE == nullptr )
+			throw std::runtime_error( "failed to open index-file" );
+
+		// Write index
+		if ( zIndex.save( indexFILE ) != Z_OK )
+			throw std::runtime_error( "failed to write index-file" );
+
+		// Print result
+		std::cout << "index complete for file#" << srcFile << ", " << zIndex.getPointsCount( ) << " access-points written to " << indexPath << std::endl;
+
+	}
+	catch ( const std::exception & pException )
+	{
+
+		// Print ERROR-message
+		std::cout << "failed to index file#" << srcFile << ", error: " << pException.what( ) << std::endl;
+
+	}
+
+	// Close Input FILE
+	if ( inputFILE != nullptr )
+		std::fclose( inputFILE );
+
+	// Close Output FILE
+	if ( outFILE != nullptr )
+		std::fclose( outFILE );
+
+	// Close Index FILE
+	if ( indexFILE != nullptr )
+		std::fclose( indexFILE );
+
+}
+
+/*
+ * Decompress range of compressed file, using index sidecar-file
+ * (srcFile + INDEX_FILE_EXTENSION), built with indexFile.
+ *
+ * @param srcFile - indexed zlib or gzip file.
+ * @param dstFile - path to range output.
+ * @param pOffset - uncompressed offset of the range.
+ * @param pLength - size of the range.
+*/
+void extractFile( const char *const srcFile, const char *const dstFile, const std::uint64_t pOffset, const std::uint64_t pLength )
+{
+
+	// Input FILE
+	std::FILE * inputFILE( nullptr );
+
+	// Output FILE
+	std::FILE * outFILE( nullptr );
+
+	// Index FILE
+	std::FILE * indexFILE( nullptr );
+
+	// Index-file path
+	const std::string indexPath( std::string( srcFile ) + INDEX_FILE_EXTENSION );
+
+	// FILE fopen_s errno
+	errno_t errCode;
+
+	// Guarded-Block
+	try
+	{
+
+		// Open index FILE
+		errCode = fopen_s( &indexFILE, indexPath.c_str( ), "rb" );
+
+		if ( errCode != 0 || indexFILE == nullptr )
+			throw std::runtime_error( "failed to open index-file, run index command first" );
+
+		// Read index
+		c0de4un::ZIndex zIndex;
+		if ( zIndex.load( indexFILE ) != Z_OK )
+			throw std::runtime_error( "failed to read index-file" );
+
+		// Open input (source) FILE
+		errCode = fopen_s( &inputFILE, srcFile, "rb" );
+
+		if ( errCode != 0 || inputFILE == nullptr )
+			throw std::runtime_error( "failed to open input-file" );
+
+		// Open output (destination) FILE
+		errCode = fopen_s( &outFILE, dstFile, "wb" );
+
+		if ( errCode != 0 || outFILE == nullptr )
+			throw std::runtime_error( "failed to open output-file" );
+
+		// Output, preallocated for the range size, known from index
+		const std::uint64_t rangeSize( pOffset < zIndex.getUncompressedSize( ) ? std::min<std::uint64_t>( pLength, zIndex.getUncompressedSize( ) - pOffset ) : 0 );
+		std::unique_ptr<c0de4un::OutputSink> outputSink( c0de4un::IOFactory::openSink( outFILE, c0de4un::IOBackend::STDIO, rangeSize ) );
+
+		// Decompress range from the closest access-point
+		if ( zIndex.extract( inputFILE, pOffset, pLength, *outputSink ) != Z_OK )
+			throw std::runtime_error( "failed to extract range" );
+
+		// Print result
+		std::cout << "extract complete for file#" << srcFile << "; output written to " << dstFile << std::endl;
+
+	}
+	catch ( const std::exception & pException )
+	{
+
+		// Print ERROR-message
+		std::cout << "failed to extract file#" << srcFile << ", error: " << pException.what( ) << std::endl;
+
+	}
+
+	// Close Input FILE
+	if ( inputFILE != nullptr )
+		std::fclose( inputFILE );
+
+	// Close Output FILE
+	if ( outFILE != nullptr )
+		std::fclose( outFILE );
+
+	// Close Index FILE
+	if ( indexFILE != nullptr )
+		std::fclose( indexFILE );
+
+}
+
+/*
+ * Compress files of list-file as gzip on one pool of threads.
+ * Each line of list-file is a source path, optionally followed by
+ * TAB & output path (source path + BATCH_FILE_EXTENSION by default).
+ *
+ * @param listFile - path to list-file.
+ * @param pCompression - compression-level, must be in range 0-9.
+ * @param pThreads - number of threads, 0 to use all hardware-threads.
+ * @param pCachePolite - true to drop pages of files behind the cursor (database hosts).
+ * @param pMaxMemory - memory limit of all workers, 0 for no limit.
+*/
+void compressFileList( const char *const listFile, const std::uint32_t & pCompression, const std::uint32_t pThreads = 0, const bool pCachePolite = false, const std::uint64_t pMaxMemory = 0 )
+{
+
+	// List FILE
+	std::FILE * listFILE( nullptr );
+
+	// FILE fopen_s errno
+	errno_t errCode;
+
+	// Guarded-Block
+	try
+	{
+
+		// Open list FILE
+		errCode = fopen_s( &listFILE, listFile, "rb" );
+
+		if ( errCode != 0 || listFILE == nullptr )
+			throw std::runtime_error( "failed to open list-file" );
+
+		// Files
+		std::vector<c0de4un::ZBatch::Item> batchItems;
+
+		// Read lines
+		std::string listLine;
+		int listChar( 0 );
+		do
+		{
+
+			listChar = std::fgetc( listFILE );
+
+			if ( listChar != EOF && listChar != '\n' )
+			{
+				listLine.push_back( static_cast<char>( listChar ) );
+				continue;
+			}
+
+			// Skip '\r' of CRLF & empty lines
+			if ( !listLine.empty( ) && listLine.back( ) == '\r' )
+				listLine.pop_back( );
+
+			if ( !listLine.empty( ) )
+			{
+
+				c0de4un::ZBatch::Item batchItem;
+
+				const std::size_t tabPos( listLine.find( '\t' ) );
+				batchItem.srcPath = listLine.substr( 0, tabPos );
+				batchItem.dstPath = tabPos != std::string::npos ? listLine.substr( tabPos + 1 ) : batchItem.srcPath + BATCH_FILE_EXTENSION;
+				batchItem.status = Z_ERRNO;
+				batchItem.size = 0;
+
+				batchItems.emplace_back( std::move( batchItem ) );
+
+			}
+
+			listLine.clear( );
+
+		} while ( listChar != EOF );
+
+		// Close list FILE
+		std::fclose( listFILE );
+		listFILE = nullptr;
+
+		// Compress
+		std::unique_ptr<c0de4un::MemoryBudget> memoryBudget( pMaxMemory > 0 ? new c0de4un::MemoryBudget( pMaxMemory ) : nullptr );
+		const int zRet( c0de4un::ZBatch::deflateFiles( batchItems, static_cast<int>( pCompression ), pThreads, c0de4un::ZFormat::GZIP, c0de4un::ZBatch::DEFAULT_SPLIT_SIZE, pCachePolite, memoryBudget.get( ) ) );
+
+		// Print result
+		std::size_t completeCount( 0 );
+		for ( const c0de4un::ZBatch::Item & batchItem : batchItems )
+			if ( batchItem.status == Z_OK )
+				completeCount++;
+
+		if ( zRet != Z_OK )
+			std::cout << "batch compression failed for " << ( batchItems.size( ) - completeCount ) << " of " << batchItems.size( ) << " files from list#" << listFile << std::endl;
+		else
+			std::cout << "batch compression complete, " << completeCount << " files from list#" << listFile << std::endl;
+
+	}
+	catch ( const std::exception & pException )
+	{
+
+		// Print ERROR-message
+		std::cout << "failed to compress list#" << listFile << ", error: " << pException.what( ) << std::endl;
+
+	}
+
+	// Close list FILE
+	if ( listFILE != nullptr )
+		std::fclose( listFILE );
+
+}
+
+/*
+ * Verify compressed files on one pool of threads. Files are inflated,
+ * output is discarded, stream structure & trailer checksums are checked.
+ * Prints status of each file & aggregate throughput.
+ *
+ * @param srcFiles - zlib or gzip files to verify.
+ * @param pThreads - number of threads, 0 to use all hardware-threads.
+ * @param pCachePolite - true to drop pages of files behind the cursor (database hosts).
+ * @param pMaxMemory - memory limit of all workers, 0 for no limit.
+ * @return - Z_OK if all files are valid, error-code otherwise.
+*/
+int testFiles( const std::vector<std::string> & srcFiles, const std::uint32_t pThreads = 0, const bool pCachePolite = false, const std::uint64_t pMaxMemory = 0 )
+{
+
+	// Files
+	std::vector<c0de4un::ZBatch::Item> batchItems( srcFiles.size( ) );
+	for ( std::size_t i = 0; i < srcFiles.size( ); i++ )
+	{
+		batchItems[i].srcPath = srcFiles[i];
+		batchItems[i].status = Z_ERRNO;
+		batchItems[i].size = 0;
+	}
+
+	// Verify
+	const std::chrono::steady_clock::time_point startTime( std::chrono::steady_clock::now( ) );
+	std::unique_ptr<c0de4un::MemoryBudget> memoryBudget( pMaxMemory > 0 ? new c0de4un::MemoryBudget( pMaxMemory ) : nullptr );
+	const int zRet( c0de4un::ZBatch::testFiles( batchItems, pThreads, pCachePolite, memoryBudget.get( ) ) );
+	const double elapsedSeconds( std::chrono::duration<double>( std::chrono::steady_clock::now( ) - startTime ).count( ) );
+
+	// Print status of each file
+	std::uint64_t totalSize( 0 );
+	for ( const c0de4un::ZBatch::Item & batchItem : batchItems )
+	{
+
+		std::cout << ( batchItem.status == Z_OK ? "OK     " : "FAILED " ) << batchItem.srcPath << std::endl;
+		totalSize += batchItem.size;
+
+	}
+
+	// Print aggregate throughput, of compressed input
+	std::cout << "test " << ( zRet == Z_OK ? "complete" : "failed" ) << ", " << batchItems.size( ) << " files, " << ( totalSize / 1048576.0 ) << " MB in " << elapsedSeconds << " s, " << ( elapsedSeconds > 0.0 ? totalSize / 1048576.0 / elapsedSeconds : 0.0 ) << " MB/s" << std::endl;
+
+	return( zRet );
+
+}
+
+/*
+ * MAIN
+ * 
+ * @param argC - number of arguments.
+ * @param argV - arguments, where #0 is app name.
+*/
+int main( int argC, char * argV[] )
+{
+
+	// Stream stdin to stdout, nothing else is printed to stdout
+	if ( argC > 1 && getCommandID( argV[1] ) == CONSOLE_COMMAND_ID_STREAM )
+	{
+
+		// Options: -d, compression-level, memory limit
+		bool streamDecompress( false );
+		std::uint32_t streamCompression( 6 );
+		std::uint64_t maxMemory( 0 );
+
+		for ( int i = 2; i < argC; i++ )
+		{
+
+			if ( std::strcmp( argV[i], "-d" ) == 0 )
+				streamDecompress = true;
+			else if ( std::strcmp( argV[i], MAX_MEMORY_OPTION ) == 0 && i + 1 < argC )
+				maxMemory = c0de4un::MemoryBudget::parseSize( argV[++i] );
+			else
+				streamCompression = static_cast<std::uint32_t>( std::atoi( argV[i] ) );
+
+		}
+
+		return( streamPipe( streamDecompress, streamCompression, maxMemory ) == Z_OK ? 0 : 1 );
+
+	}
+
+	// Pack directory: pack <dir> <out.tar.gz> [level]
+	if ( argC > 3 && getCommandID( argV[1] ) == CONSOLE_COMMAND_ID_PACK )
+		return( packDirectory( argV[2], argV[3], argC > 4 ? static_cast<std::uint32_t>( std::atoi( argV[4] ) ) : 6 ) == Z_OK ? 0 : 1 );
+
+	// Unpack archive: unpack <in.tar.gz> <dir>
+	if ( argC > 3 && getCommandID( argV[1] ) == CONSOLE_COMMAND_ID_UNPACK )
+		return( unpackArchive( argV[2], argV[3] ) == Z_OK ? 0 : 1 );
+
+	// Train dictionary: train-dict <out.zdict> <samples...>
+	if ( argC > 3 && getCommandID( argV[1] ) == CONSOLE_COMMAND_ID_TRAIN_DICT )
+		return( trainDictionary( argV[2], std::vector<std::string>( argV + 3, argV + argC ) ) == Z_OK ? 0 : 1 );
+
+	// Build index: index <file> [output] [--span <bytes>]
+	if ( argC > 2 && getCommandID( argV[1] ) == CONSOLE_COMMAND_ID_INDEX )
+	{
+
+		const char * indexOutput( nullptr );
+		std::uint64_t indexSpan( c0de4un::ZIndex::DEFAULT_SPAN );
+
+		for ( int i = 3; i < argC; i++ )
+		{
+
+			if ( std::strcmp( argV[i], SPAN_OPTION ) == 0 && i + 1 < argC )
+				indexSpan = std::strtoull( argV[++i], nullptr, 10 );
+			else
+				indexOutput = argV[i];
+
+		}
+
+		indexFile( argV[2], indexOutput, indexSpan );
+		return( 0 );
+
+	}
+
+	// Extract range using index: extract <file> <output> [--offset <bytes>] [--length <bytes>]
+	if ( argC > 3 && getCommandID( argV[1] ) == CONSOLE_COMMAND_ID_EXTRACT )
+	{
+
+		std::uint64_t rangeOffset( 0 );
+		std::uint64_t rangeLength( UINT64_MAX );
+
+		for ( int i = 4; i + 1 < argC; i++ )
+		{
+
+			if ( std::strcmp( argV[i], OFFSET_OPTION ) == 0 )
+				rangeOffset = std::strtoull( argV[++i], nullptr, 10 );
+			else if ( std::strcmp( argV[i], LENGTH_OPTION ) == 0 )
+				rangeLength = std::strtoull( argV[++i], nullptr, 10 );
+
+		}
+
+		extractFile( argV[2], argV[3], rangeOffset, rangeLength );
+		return( 0 );
+
+	}
+
+	// Compress files of list-file: batch <list> [level] [threads] [--cache-polite] [--max-memory <size>]
+	if ( argC > 2 && getCommandID( argV[1] ) == CONSOLE_COMMAND_ID_BATCH )
+	{
+
+		std::uint32_t batchCompression( 6 );
+		std::uint32_t batchThreads( 0 );
+		bool cachePolite( false );
+		std::uint64_t maxMemory( 0 );
+		int positionalCount( 0 );
+
+		for ( int i = 3; i < argC; i++ )
+		{
+
+			if ( std::strcmp( argV[i], CACHE_POLITE_OPTION ) == 0 )
+				cachePolite = true;
+			else if ( std::strcmp( argV[i], MAX_MEMORY_OPTION ) == 0 && i + 1 < argC )
+				maxMemory = c0de4un::MemoryBudget::parseSize( argV[++i] );
+			else if ( positionalCount++ == 0 )
+				batchCompression = static_cast<std::uint32_t>( std::atoi( argV[i] ) );
+			else
+				batchThreads = static_cast<std::uint32_t>( std::atoi( argV[i] ) );
+
+		}
+
+		compressFileList( argV[2], batchCompression, batchThreads, cachePolite, maxMemory );
+		return( 0 );
+
+	}
+
+	// Verify compressed files: test <files...> [--threads <count>] [--cache-polite] [--max-memory <size>]
+	if ( argC > 2 && getCommandID( argV[1] ) == CONSOLE_COMMAND_ID_TEST )
+	{
+
+		std::vector<std::string> testPaths;
+		std::uint32_t testThreads( 0 );
+		bool cachePolite( false );
+		std::uint64_t maxMemory( 0 );
+
+		for ( int i = 2; i < argC; i++ )
+		{
+
+			if ( std::strcmp( argV[i], THREADS_OPTION ) == 0 && i + 1 < argC )
+				testThreads = static_cast<std::uint32_t>( std::atoi( argV[++i] ) );
+			else if ( std::strcmp( argV[i], CACHE_POLITE_OPTION ) == 0 )
+				cachePolite = true;
+			else if ( std::strcmp( argV[i], MAX_MEMORY_OPTION ) == 0 && i + 1 < argC )
+				maxMemory = c0de4un::MemoryBudget::parseSize( argV[++i] );
+			else
+				testPaths.push_back( argV[i] );
+
+		}
+
+		return( testFiles( testPaths, testThreads, cachePolite, maxMemory ) == Z_OK ? 0 : 1 );
+
+	}
+
+	// Decompress file: decompress <file> <output> [--sparse] [--direct-io] [--dict <registry>]
+	if ( argC > 3 && getCommandID( argV[1] ) == CONSOLE_COMMAND_ID_DECOMPRESS )
+	{
+
+		bool sparseOutput( false );
+		bool directOutput( false );
+		const char * registryPath( nullptr );
+
+		for ( int i = 4; i < argC; i++ )
+		{
+
+			if ( std::strcmp( argV[i], SPARSE_OPTION ) == 0 )
+				sparseOutput = true;
+			else if ( std::strcmp( argV[i], DIRECT_IO_OPTION ) == 0 )
+				directOutput = true;
+			else if ( std::strcmp( argV[i], DICT_OPTION ) == 0 && i + 1 < argC )
+				registryPath = argV[++i];
+
+		}
+
+		if ( registryPath != nullptr )
+			decompressDictionaryFile( argV[2], argV[3], registryPath );
+		else
+			decompressFile( argV[2], argV[3], sparseOutput, directOutput );
+
+		return( 0 );
+
+	}
+
+	// Compress file: compress <file> <output> [level] [--threads <count>] [--sparse] [--direct-io] [--dict <dictionary>]
+	if ( argC > 3 && getCommandID( argV[1] ) == CONSOLE_COMMAND_ID_COMPRESS )
+	{
+
+		std::uint32_t fileCompression( 6 );
+		std::uint32_t fileThreads( 0 );
+		bool sparseInput( false );
+		bool directOutput( false );
+		const char * dictionaryPath( nullptr );
+
+		for ( int i = 4; i < argC; i++ )
+		{
+
+			if ( std::strcmp( argV[i], THREADS_OPTION ) == 0 && i + 1 < argC )
+				fileThreads = static_cast<std::uint32_t>( std::atoi( argV[++i] ) );
+			else if ( std::strcmp( argV[i], SPARSE_OPTION ) == 0 )
+				sparseInput = true;
+			else if ( std::strcmp( argV[i], DIRECT_IO_OPTION ) == 0 )
+				directOutput = true;
+			else if ( std::strcmp( argV[i], DICT_OPTION ) == 0 && i + 1 < argC )
+				dictionaryPath = argV[++i];
+			else
+				fileCompression = static_cast<std::uint32_t>( std::atoi( argV[i] ) );
+
+		}
+
+		if ( dictionaryPath != nullptr )
+			compressDictionaryFile( argV[2], argV[3], dictionaryPath, fileCompression );
+		else if ( sparseInput )
+			compressSparseFile( argV[2], argV[3], fileCompression );
+		else
+			compressFile( argV[2], argV[3], fileCompression, fileThreads, directOutput );
+
+		return( 0 );
+
+	}
+
+	// Compress file as BGZF: bgzf <file> <output> [level] [threads]
+	if ( argC > 3 && getCommandID( argV[1] ) == CONSOLE_COMMAND_ID_BGZF )
+	{
+		compressBgzfFile( argV[2], argV[3], argC > 4 ? static_cast<std::uint32_t>( std::atoi( argV[4] ) ) : 6, argC > 5 ? static_cast<std::uint32_t>( std::atoi( argV[5] ) ) : 0 );
+		return( 0 );
+	}
+
+	// Extract range of BGZF file: bgzf-extract <file> <output> [--offset <virtual-offset>] [--length <bytes>]
+	if ( argC > 3 && getCommandID( argV[1] ) == CONSOLE_COMMAND_ID_BGZF_EXTRACT )
+	{
+
+		std::uint64_t virtualOffset( 0 );
+		std::uint64_t rangeLength( UINT64_MAX );
+
+		for ( int i = 4; i + 1 < argC; i++ )
+		{
+
+			if ( std::strcmp( argV[i], OFFSET_OPTION ) == 0 )
+				virtualOffset = std::strtoull( argV[++i], nullptr, 10 );
+			else if ( std::strcmp( argV[i], LENGTH_OPTION ) == 0 )
+				rangeLength = std::strtoull( argV[++i], nullptr, 10 );
+
+		}
+
+		extractBgzfFile( argV[2], argV[3], virtualOffset, rangeLength );
+		return( 0 );
+
+	}
+
+	// Compress files into ZIP archive: zip <out.zip> <files...> [--threads <count>]
+	if ( argC > 3 && getCommandID( argV[1] ) == CONSOLE_COMMAND_ID_ZIP )
+	{
+
+		std::vector<std::string> archivePaths;
+		std::uint32_t archiveThreads( 0 );
+
+		for ( int i = 3; i < argC; i++ )
+		{
+
+			if ( std::strcmp( argV[i], THREADS_OPTION ) == 0 && i + 1 < argC )
+				archiveThreads = static_cast<std::uint32_t>( std::atoi( argV[++i] ) );
+			else
+				archivePaths.push_back( argV[i] );
+
+		}
+
+		archiveFiles( archivePaths, argV[2], 6, archiveThreads );
+		return( 0 );
+
+	}
+
+	// Decompress entry of ZIP archive: unzip-entry <in.zip> <entry> <output>
+	if ( argC > 4 && getCommandID( argV[1] ) == CONSOLE_COMMAND_ID_UNZIP_ENTRY )
+	{
+		extractArchiveEntry( argV[2], argV[3], argV[4] );
+		return( 0 );
+	}
+
 	// Print Hello World !
 	std::cout << "Hello World !" << std::endl;
 
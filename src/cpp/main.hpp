@@ -39,5 +39,122 @@
 // Include ZStream
 #include "zip/ZStream.hpp"
 
+// Include ZParallelDeflate
+#include "zip/ZParallelDeflate.hpp"
+
+// Include ZPipeline
+#include "zip/ZPipeline.hpp"
+
+// Include ZParallelInflate
+#include "zip/ZParallelInflate.hpp"
+
+// Include ZIndex
+#include "zip/ZIndex.hpp"
+
+// Include ZBatch
+#include "zip/ZBatch.hpp"
+
+// Include ZSparse
+#include "zip/ZSparse.hpp"
+
+// Include ZBgzf
+#include "zip/ZBgzf.hpp"
+
+// Include ZArchive
+#include "zip/ZArchive.hpp"
+
+// Include C++ chrono
+#include <chrono> // std::chrono::steady_clock
+
+// Include FileOutputSink
+#include "io/FileOutputSink.hpp"
+
+// Include IOFactory
+#include "io/IOFactory.hpp"
+
+// Include TarInputSource
+#include "io/TarInputSource.hpp"
+
+// Include TarOutputSink
+#include "io/TarOutputSink.hpp"
+
 /* Help Command-ID */
-static constexpr std::uint8_t CONSOLE_COMMAND_ID_HELP = 0;
\ No newline at end of file
+static constexpr std::uint8_t CONSOLE_COMMAND_ID_HELP = 0;
+
+/* Index Command-ID, builds random-access index of compressed file */
+static constexpr std::uint8_t CONSOLE_COMMAND_ID_INDEX = 1;
+
+/* Extract Command-ID, decompresses range using index */
+static constexpr std::uint8_t CONSOLE_COMMAND_ID_EXTRACT = 2;
+
+/* Batch Command-ID, compresses files of list-file on one pool */
+static constexpr std::uint8_t CONSOLE_COMMAND_ID_BATCH = 3;
+
+/* Test Command-ID, verifies compressed files without writing output */
+static constexpr std::uint8_t CONSOLE_COMMAND_ID_TEST = 4;
+
+/* Stream Command-ID, compresses stdin to stdout (-d decompresses) */
+static constexpr std::uint8_t CONSOLE_COMMAND_ID_STREAM = 5;
+
+/* Pack Command-ID, compresses directory into tar.gz */
+static constexpr std::uint8_t CONSOLE_COMMAND_ID_PACK = 6;
+
+/* Unpack Command-ID, decompresses tar.gz into directory */
+static constexpr std::uint8_t CONSOLE_COMMAND_ID_UNPACK = 7;
+
+/* Train-dict Command-ID, trains preset dictionary from sample files */
+static constexpr std::uint8_t CONSOLE_COMMAND_ID_TRAIN_DICT = 8;
+
+/* Decompress Command-ID, decompresses file (--sparse skips zero blocks) */
+static constexpr std::uint8_t CONSOLE_COMMAND_ID_DECOMPRESS = 9;
+
+/* Compress Command-ID, compresses file (--sparse reads only data of sparse file) */
+static constexpr std::uint8_t CONSOLE_COMMAND_ID_COMPRESS = 10;
+
+/* BGZF Command-ID, compresses file as blocked gzip */
+static constexpr std::uint8_t CONSOLE_COMMAND_ID_BGZF = 11;
+
+/* BGZF-extract Command-ID, decompresses range of BGZF file from virtual offset */
+static constexpr std::uint8_t CONSOLE_COMMAND_ID_BGZF_EXTRACT = 12;
+
+/* Zip Command-ID, compresses files into ZIP archive */
+static constexpr std::uint8_t CONSOLE_COMMAND_ID_ZIP = 13;
+
+/* Unzip-entry Command-ID, decompresses one entry of ZIP archive */
+static constexpr std::uint8_t CONSOLE_COMMAND_ID_UNZIP_ENTRY = 14;
+
+/* Initial size of ZStream buffers, ZStream grows them while io stays slower than the codec */
+static constexpr std::uint32_t STREAM_BUFFER_SIZE = 65536;
+
+/* Option of memory limit, followed by size ("--max-memory 512M") */
+static constexpr const char *const MAX_MEMORY_OPTION = "--max-memory";
+
+/* Option of extract range start, followed by uncompressed offset (BGZF virtual offset for bgzf-extract) */
+static constexpr const char *const OFFSET_OPTION = "--offset";
+
+/* Option of extract range size, followed by number of bytes */
+static constexpr const char *const LENGTH_OPTION = "--length";
+
+/* Option of index access-points distance, followed by uncompressed bytes */
+static constexpr const char *const SPAN_OPTION = "--span";
+
+/* Option of sparse output, zero blocks & holes are not written */
+static constexpr const char *const SPARSE_OPTION = "--sparse";
+
+/* Option of preset dictionary, followed by dictionary file (compress) or registry file/directory (decompress) */
+static constexpr const char *const DICT_OPTION = "--dict";
+
+/* Option of O_DIRECT output, file is preallocated & written bypassing the page cache by one stream */
+static constexpr const char *const DIRECT_IO_OPTION = "--direct-io";
+
+/* Option of number of threads, followed by count (0 for all hardware-threads) */
+static constexpr const char *const THREADS_OPTION = "--threads";
+
+/* Option of cache-polite io, pages of files are dropped behind the cursor */
+static constexpr const char *const CACHE_POLITE_OPTION = "--cache-polite";
+
+/* Extension of index sidecar-file */
+static constexpr const char *const INDEX_FILE_EXTENSION = ".zidx";
+
+/* Extension of batch output-file, when list-file line has no output path */
+static constexpr const char *const BATCH_FILE_EXTENSION = ".gz";
\ No newline at end of file
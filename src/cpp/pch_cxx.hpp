@@ -44,6 +44,18 @@
 #include <cstdlib> // C++
 #include <cstdint> // C++ numerics
 #include <string> // std::string, std::wstring
+#include <cstring> // std::memcpy, std::memset
+#include <stdexcept> // std::runtime_error
+#include <memory> // std::shared_ptr, std::unique_ptr
+#include <memory_resource> // std::pmr::memory_resource
+#include <vector> // std::vector
+#include <deque> // std::deque
+#include <functional> // std::function
+#include <thread> // std::thread
+#include <mutex> // std::mutex, std::lock_guard
+#include <condition_variable> // std::condition_variable
+#include <future> // std::future, std::packaged_task
+#include <algorithm> // std::min, std::max
 
 // Include zlib.h
 #include <zlib.h>
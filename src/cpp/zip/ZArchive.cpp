@@ -0,0 +1,1099 @@
+/*
+* Copyright  2018 Denis Zyamaev (code4un@yandex.ru) All rights reserved.
+* Authors: Denis Zyamaev (code4un@yandex.ru)
+* All rights reserved.
+* API: C++ 11
+* License: see LICENSE.txt
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+* 1. Redistributions of source code must retain the above copyright notice,
+* this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must display the names 'Denis Zyamaev' and
+* in the credits of the application, if such credits exist.
+* The authors of this work must be notified via email (code4un@yandex.ru) in
+* this case of redistribution.
+* 3. Neither the name of copyright holders nor the names of its contributors
+* may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS
+* IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+* PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// HEADER
+#include "ZArchive.hpp"
+
+// Include ZArena
+#include "ZArena.hpp"
+
+// Include FileUtils
+#include "../io/FileUtils.hpp"
+
+// Include C time
+#include <ctime> // std::localtime
+
+// Include file status
+#include <sys/stat.h> // stat
+
+namespace c0de4un
+{
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// SpillBuffer
+	// ===========================================================
+
+	/* SpillBuffer constructor, buffer is empty */
+	ZArchive::SpillBuffer::SpillBuffer( ) noexcept
+		: mMemory( ),
+		mFile( nullptr, &std::fclose ),
+		mSize( 0 )
+	{
+	}
+
+	/* Returns number of bytes */
+	std::uint64_t ZArchive::SpillBuffer::getSize( ) const noexcept
+	{ return( mSize ); }
+
+	/*
+	 * Appends data, spilling to temporary file when memory is full.
+	 *
+	 * @param pData - data to write.
+	 * @param pSize - number of bytes.
+	 * @throws - can throw exception.
+	*/
+	void ZArchive::SpillBuffer::write( const unsigned char *const pData, const std::size_t pSize )
+	{
+
+		// Number of bytes, that fit into memory
+		const std::size_t memoryCount( mFile == nullptr ? std::min( pSize, SPILL_MEMORY_SIZE - mMemory.size( ) ) : 0 );
+
+		// Copy into memory
+		mMemory.insert( mMemory.end( ), pData, pData + memoryCount );
+
+		// Write rest into temporary file
+		if ( memoryCount < pSize )
+		{
+
+			// Create temporary file, removed on close
+			if ( mFile == nullptr )
+			{
+
+				mFile.reset( std::tmpfile( ) );
+
+				if ( mFile == nullptr )
+					throw std::runtime_error( "failed to create temporary file" );
+
+			}
+
+			// Write
+			if ( fwrite( pData + memoryCount, sizeof( unsigned char ), pSize - memoryCount, mFile.get( ) ) != pSize - memoryCount || ferror( mFile.get( ) ) )
+				throw std::runtime_error( "failed to write temporary file" );
+
+		}
+
+		// Count
+		mSize += pSize;
+
+	}
+
+	/* Removes data, temporary file is deleted */
+	void ZArchive::SpillBuffer::clear( ) noexcept
+	{
+
+		mMemory.clear( );
+		mFile.reset( );
+		mSize = 0;
+
+	}
+
+	/*
+	 * Writes data to file.
+	 *
+	 * @param dstFile - output file.
+	 * @throws - can throw exception.
+	*/
+	void ZArchive::SpillBuffer::copyTo( std::FILE *const dstFile )
+	{
+
+		// Write memory
+		if ( fwrite( mMemory.data( ), sizeof( unsigned char ), mMemory.size( ), dstFile ) != mMemory.size( ) || ferror( dstFile ) )
+			throw std::runtime_error( "failed to write output file" );
+
+		// Without temporary file
+		if ( mFile == nullptr )
+			return;
+
+		// Copy temporary file
+		std::vector<unsigned char> copyBuffer( CHUNK_SIZE );
+		std::rewind( mFile.get( ) );
+
+		for ( std::size_t readCount = 0; ( readCount = fread( copyBuffer.data( ), sizeof( unsigned char ), copyBuffer.size( ), mFile.get( ) ) ) > 0; )
+		{
+
+			if ( fwrite( copyBuffer.data( ), sizeof( unsigned char ), readCount, dstFile ) != readCount || ferror( dstFile ) )
+				throw std::runtime_error( "failed to write output file" );
+
+		}
+
+		if ( ferror( mFile.get( ) ) )
+			throw std::runtime_error( "failed to read temporary file" );
+
+	}
+
+	// ===========================================================
+	// Constructor & destructor
+	// ===========================================================
+
+	/* ZArchive constructor, directory is empty */
+	ZArchive::ZArchive( ) noexcept
+		: mEntries( )
+	{
+	}
+
+	// ===========================================================
+	// Getters
+	// ===========================================================
+
+	/* Returns number of entries */
+	std::size_t ZArchive::getEntriesCount( ) const noexcept
+	{ return( mEntries.size( ) ); }
+
+	/*
+	 * Returns entry.
+	 *
+	 * @param pIndex - entry index, must be less than entries count.
+	*/
+	const ZArchive::Entry & ZArchive::getEntry( const std::size_t pIndex ) const noexcept
+	{ return( mEntries[pIndex] ); }
+
+	/*
+	 * Returns index of entry with name, NO_ENTRY if not found.
+	 *
+	 * @param pName - name in archive.
+	*/
+	std::size_t ZArchive::findEntry( const std::string & pName ) const noexcept
+	{
+
+		for ( std::size_t i = 0; i < mEntries.size( ); i++ )
+			if ( mEntries[i].name == pName )
+				return( i );
+
+		return( NO_ENTRY );
+
+	}
+
+	// ===========================================================
+	// Methods
+	// ===========================================================
+
+	/*
+	 * Append little-endian value.
+	 *
+	 * @param pBuffer - output.
+	 * @param pValue - value.
+	 * @param bytesCount - number of bytes to write.
+	 * @throws - can throw exception (bad_alloc).
+	*/
+	void ZArchive::putValue( std::vector<unsigned char> & pBuffer, const std::uint64_t pValue, const std::size_t bytesCount )
+	{
+
+		for ( std::size_t i = 0; i < bytesCount; i++ )
+			pBuffer.push_back( static_cast<unsigned char>( ( pValue >> ( i * 8 ) ) & 0xFF ) );
+
+	}
+
+	/*
+	 * Returns little-endian value.
+	 *
+	 * @param pData - input.
+	 * @param bytesCount - number of bytes to read.
+	*/
+	std::uint64_t ZArchive::getValue( const unsigned char *const pData, const std::size_t bytesCount ) noexcept
+	{
+
+		// Value
+		std::uint64_t value( 0 );
+		for ( std::size_t i = 0; i < bytesCount; i++ )
+			value |= static_cast<std::uint64_t>( pData[i] ) << ( i * 8 );
+
+		// Return
+		return( value );
+
+	}
+
+	/*
+	 * Compress source file into pending entry: deflate, or stored if
+	 * deflate does not make it smaller.
+	 *
+	 * @thread_safety - thread-safe, if entry not shared.
+	 * @param pItem - file to add.
+	 * @param pEntry - receives compressed data.
+	 * @param compressionLevel - Compression-Level to use, must be in range 0-9.
+	 * @throws - can throw exception.
+	*/
+	void ZArchive::deflateEntry( const Item & pItem, PendingEntry & pEntry, const int compressionLevel )
+	{
+
+		// Return code
+		int zRet( 0 );
+
+		// Flush mode, Z_FINISH after the last read
+		int zFlush( Z_NO_FLUSH );
+
+		// Source file
+		std::unique_ptr<std::FILE, int(*)( std::FILE* )> srcFile( std::fopen( pItem.srcPath.c_str( ), "rb" ), &std::fclose );
+
+		if ( srcFile == nullptr )
+			throw std::runtime_error( "failed to open input-file #" + pItem.srcPath );
+
+		// Modification time
+		struct stat fileStat;
+		pEntry.mtime = stat( pItem.srcPath.c_str( ), &fileStat ) == 0 ? static_cast<std::int64_t>( fileStat.st_mtime ) : 0;
+
+		// Buffers
+		std::vector<unsigned char> inBuffer( CHUNK_SIZE );
+		std::vector<unsigned char> outBuffer( CHUNK_SIZE );
+
+		// CRC-32 & size of uncompressed data
+		uLong crc( crc32( 0L, Z_NULL, 0 ) );
+		std::uint64_t inputSize( 0 );
+
+		// z_stream
+		z_stream zStream;
+
+		// Allocate z_stream state from the thread's arena
+		ZArena::getThreadArena( ).attach( zStream );
+
+		// Initialize raw deflate, ZIP has own headers
+		if ( deflateInit2( &zStream, compressionLevel, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY ) != Z_OK )
+			throw std::runtime_error( "ZArchive::deflateEntry - failed to initialize deflate." );
+
+		// Guarded-Block
+		try
+		{
+
+			// Read & compress
+			do
+			{
+
+				// Read
+				const std::size_t readCount( fread( inBuffer.data( ), sizeof( unsigned char ), inBuffer.size( ), srcFile.get( ) ) );
+
+				if ( ferror( srcFile.get( ) ) )
+					throw std::runtime_error( "io error, can't read input file #" + pItem.srcPath );
+
+				// Count input
+				crc = crc32( crc, inBuffer.data( ), static_cast<uInt>( readCount ) );
+				inputSize += readCount;
+
+				// Last read finishes the stream
+				zFlush = feof( srcFile.get( ) ) ? Z_FINISH : Z_NO_FLUSH;
+
+				// Set input
+				zStream.next_in = inBuffer.data( );
+				zStream.avail_in = static_cast<uInt>( readCount );
+
+				// Compress, until output-buffer is not full
+				do
+				{
+
+					zStream.next_out = outBuffer.data( );
+					zStream.avail_out = static_cast<uInt>( outBuffer.size( ) );
+
+					zRet = deflate( &zStream, zFlush );
+
+					if ( zRet == Z_STREAM_ERROR )
+						throw std::runtime_error( "ZArchive::deflateEntry - compression failed, stream error" );
+
+					pEntry.data.write( outBuffer.data( ), outBuffer.size( ) - zStream.avail_out );
+
+				} while ( zStream.avail_out == 0 );
+
+			} while ( zFlush != Z_FINISH );
+
+		}
+		catch ( ... )
+		{
+
+			// Release z_stream resources
+			deflateEnd( &zStream );
+
+			// Rethrow
+			throw;
+
+		}
+
+		// Release z_stream resources
+		deflateEnd( &zStream );
+
+		// Set entry
+		pEntry.method = METHOD_DEFLATE;
+		pEntry.crc = static_cast<std::uint32_t>( crc );
+		pEntry.uncompressedSize = inputSize;
+
+		// Deflate made it larger, store
+		if ( pEntry.data.getSize( ) >= inputSize )
+		{
+
+			// Remove compressed data
+			pEntry.data.clear( );
+			pEntry.method = METHOD_STORED;
+
+			// Copy
+			std::rewind( srcFile.get( ) );
+			for ( std::size_t readCount = 0; ( readCount = fread( inBuffer.data( ), sizeof( unsigned char ), inBuffer.size( ), srcFile.get( ) ) ) > 0; )
+				pEntry.data.write( inBuffer.data( ), readCount );
+
+			// File must not change
+			if ( ferror( srcFile.get( ) ) || pEntry.data.getSize( ) != inputSize )
+				throw std::runtime_error( "io error, input file changed #" + pItem.srcPath );
+
+		}
+
+	}
+
+	/*
+	 * Write local header & data of entry.
+	 *
+	 * @thread_safety - not thread-safe.
+	 * @param dstFile - output file.
+	 * @param pEntry - central directory entry, offset & sizes are set.
+	 * @param pPending - compressed data.
+	 * @return - number of bytes written.
+	 * @throws - can throw exception.
+	*/
+	std::uint64_t ZArchive::writeEntry( std::FILE *const dstFile, const Entry & pEntry, PendingEntry & pPending )
+	{
+
+		// Sizes don't fit into 32 bits, both are in ZIP64 extra-field
+		const bool zip64( pEntry.compressedSize >= ZIP64_MARK_32 || pEntry.uncompressedSize >= ZIP64_MARK_32 );
+
+		// Local header
+		std::vector<unsigned char> localHeader;
+		localHeader.reserve( LOCAL_HEADER_SIZE + pEntry.name.size( ) + 20 );
+
+		putValue( localHeader, LOCAL_HEADER_SIGNATURE, 4 );
+		putValue( localHeader, zip64 ? VERSION_ZIP64 : VERSION_DEFLATE, 2 );
+		putValue( localHeader, pEntry.flags, 2 );
+		putValue( localHeader, pEntry.method, 2 );
+		putValue( localHeader, pEntry.dosTime, 2 );
+		putValue( localHeader, pEntry.dosDate, 2 );
+		putValue( localHeader, pEntry.crc, 4 );
+		putValue( localHeader, zip64 ? ZIP64_MARK_32 : pEntry.compressedSize, 4 );
+		putValue( localHeader, zip64 ? ZIP64_MARK_32 : pEntry.uncompressedSize, 4 );
+		putValue( localHeader, pEntry.name.size( ), 2 );
+		putValue( localHeader, zip64 ? 20 : 0, 2 );
+		localHeader.insert( localHeader.end( ), pEntry.name.begin( ), pEntry.name.end( ) );
+
+		// ZIP64 extra-field: uncompressed & compressed size
+		if ( zip64 )
+		{
+			putValue( localHeader, ZIP64_EXTRA_ID, 2 );
+			putValue( localHeader, 16, 2 );
+			putValue( localHeader, pEntry.uncompressedSize, 8 );
+			putValue( localHeader, pEntry.compressedSize, 8 );
+		}
+
+		// Write header
+		if ( fwrite( localHeader.data( ), sizeof( unsigned char ), localHeader.size( ), dstFile ) != localHeader.size( ) || ferror( dstFile ) )
+			throw std::runtime_error( "failed to write output file" );
+
+		// Write data
+		pPending.data.copyTo( dstFile );
+
+		// Return
+		return( localHeader.size( ) + pEntry.compressedSize );
+
+	}
+
+	/*
+	 * Write central directory & end records.
+	 *
+	 * @thread_safety - not thread-safe.
+	 * @param dstFile - output file.
+	 * @param pEntries - entries, in file order.
+	 * @param directoryOffset - offset of central directory.
+	 * @throws - can throw exception.
+	*/
+	void ZArchive::writeDirectory( std::FILE *const dstFile, const std::vector<Entry> & pEntries, const std::uint64_t directoryOffset )
+	{
+
+		// Central directory & end records
+		std::vector<unsigned char> directory;
+
+		for ( const Entry & entry : pEntries )
+		{
+
+			// Fields, that don't fit into 32 bits
+			const bool uncompressedZip64( entry.uncompressedSize >= ZIP64_MARK_32 );
+			const bool compressedZip64( entry.compressedSize >= ZIP64_MARK_32 );
+			const bool offsetZip64( entry.localOffset >= ZIP64_MARK_32 );
+
+			// ZIP64 extra-field holds only those fields
+			const std::size_t zip64Size( ( uncompressedZip64 ? 8 : 0 ) + ( compressedZip64 ? 8 : 0 ) + ( offsetZip64 ? 8 : 0 ) );
+
+			// Header
+			putValue( directory, CENTRAL_HEADER_SIGNATURE, 4 );
+			putValue( directory, VERSION_ZIP64, 2 );
+			putValue( directory, zip64Size > 0 ? VERSION_ZIP64 : VERSION_DEFLATE, 2 );
+			putValue( directory, entry.flags, 2 );
+			putValue( directory, entry.method, 2 );
+			putValue( directory, entry.dosTime, 2 );
+			putValue( directory, entry.dosDate, 2 );
+			putValue( directory, entry.crc, 4 );
+			putValue( directory, compressedZip64 ? ZIP64_MARK_32 : entry.compressedSize, 4 );
+			putValue( directory, uncompressedZip64 ? ZIP64_MARK_32 : entry.uncompressedSize, 4 );
+			putValue( directory, entry.name.size( ), 2 );
+			putValue( directory, zip64Size > 0 ? zip64Size + 4 : 0, 2 );
+
+			// Comment length, disk, internal & external attributes
+			putValue( directory, 0, 2 );
+			putValue( directory, 0, 2 );
+			putValue( directory, 0, 2 );
+			putValue( directory, 0, 4 );
+
+			putValue( directory, offsetZip64 ? ZIP64_MARK_32 : entry.localOffset, 4 );
+			directory.insert( directory.end( ), entry.name.begin( ), entry.name.end( ) );
+
+			// ZIP64 extra-field, fields in fixed order
+			if ( zip64Size > 0 )
+			{
+
+				putValue( directory, ZIP64_EXTRA_ID, 2 );
+				putValue( directory, zip64Size, 2 );
+
+				if ( uncompressedZip64 )
+					putValue( directory, entry.uncompressedSize, 8 );
+
+				if ( compressedZip64 )
+					putValue( directory, entry.compressedSize, 8 );
+
+				if ( offsetZip64 )
+					putValue( directory, entry.localOffset, 8 );
+
+			}
+
+		}
+
+		// Size of central directory
+		const std::uint64_t directorySize( directory.size( ) );
+
+		// ZIP64 end records, if number of entries, size or offset don't fit
+		if ( pEntries.size( ) >= ZIP64_MARK_16 || directorySize >= ZIP64_MARK_32 || directoryOffset >= ZIP64_MARK_32 )
+		{
+
+			// ZIP64 end of central directory
+			putValue( directory, ZIP64_END_SIGNATURE, 4 );
+			putValue( directory, ZIP64_END_SIZE - 12, 8 );
+			putValue( directory, VERSION_ZIP64, 2 );
+			putValue( directory, VERSION_ZIP64, 2 );
+			putValue( directory, 0, 4 );
+			putValue( directory, 0, 4 );
+			putValue( directory, pEntries.size( ), 8 );
+			putValue( directory, pEntries.size( ), 8 );
+			putValue( directory, directorySize, 8 );
+			putValue( directory, directoryOffset, 8 );
+
+			// Locator: disk, offset of ZIP64 end, disks count
+			putValue( directory, ZIP64_LOCATOR_SIGNATURE, 4 );
+			putValue( directory, 0, 4 );
+			putValue( directory, directoryOffset + directorySize, 8 );
+			putValue( directory, 1, 4 );
+
+		}
+
+		// End of central directory, ZIP64 fields are marked
+		putValue( directory, END_SIGNATURE, 4 );
+		putValue( directory, 0, 2 );
+		putValue( directory, 0, 2 );
+		putValue( directory, std::min<std::uint64_t>( pEntries.size( ), ZIP64_MARK_16 ), 2 );
+		putValue( directory, std::min<std::uint64_t>( pEntries.size( ), ZIP64_MARK_16 ), 2 );
+		putValue( directory, std::min<std::uint64_t>( directorySize, ZIP64_MARK_32 ), 4 );
+		putValue( directory, std::min<std::uint64_t>( directoryOffset, ZIP64_MARK_32 ), 4 );
+		putValue( directory, 0, 2 );
+
+		// Write
+		if ( fwrite( directory.data( ), sizeof( unsigned char ), directory.size( ), dstFile ) != directory.size( ) || ferror( dstFile ) )
+			throw std::runtime_error( "failed to write output file" );
+
+	}
+
+	/*
+	 * Compress files into archive on multiple threads.
+	 *
+	 * @thread_safety - not thread-safe.
+	 * @param pItems - files to add, in archive order.
+	 * @param dstFile - output file.
+	 * @param compressionLevel - Compression-Level to use, must be in range 0-9.
+	 * @param threadsCount - number of worker-threads, 0 to use all hardware-threads.
+	 * @throws - can throw exception.
+	*/
+	void ZArchive::deflateItems( const std::vector<Item> & pItems, std::FILE *const dstFile, const int compressionLevel, const std::uint32_t threadsCount )
+	{
+
+		// Check names
+		for ( const Item & item : pItems )
+		{
+
+			if ( item.name.empty( ) || item.name.size( ) > ZIP64_MARK_16 )
+				throw std::runtime_error( "wrong entry name #" + item.name );
+
+		}
+
+		// Worker-threads
+		ThreadPool threadPool( threadsCount );
+
+		// Max number of entries compressed & not written yet, limits memory usage
+		const std::size_t maxEntriesInFlight( threadPool.getThreadsCount( ) * 2 );
+
+		// Entries in archive order
+		std::deque<std::pair<std::shared_ptr<PendingEntry>, std::future<void>>> entriesInFlight;
+
+		// Central directory
+		std::vector<Entry> entries;
+		entries.reserve( pItems.size( ) );
+
+		// Offset of the next local header
+		std::uint64_t fileOffset( 0 );
+
+		// Index of the next item to compress
+		std::size_t itemIndex( 0 );
+
+		while ( itemIndex < pItems.size( ) || !entriesInFlight.empty( ) )
+		{
+
+			// Compress next item on worker-thread
+			if ( itemIndex < pItems.size( ) )
+			{
+
+				const Item & item( pItems[itemIndex++] );
+				std::shared_ptr<PendingEntry> pendingEntry( std::make_shared<PendingEntry>( ) );
+
+				entriesInFlight.emplace_back( pendingEntry, threadPool.submit( [&item, pendingEntry, compressionLevel]( ) { deflateEntry( item, *pendingEntry, compressionLevel ); } ) );
+
+			}
+
+			// Write compressed entries in order
+			while ( !entriesInFlight.empty( ) && ( entriesInFlight.size( ) >= maxEntriesInFlight || itemIndex == pItems.size( ) ) )
+			{
+
+				// Oldest entry
+				PendingEntry & pendingEntry( *entriesInFlight.front( ).first );
+
+				// Wait, rethrows worker exception
+				entriesInFlight.front( ).second.get( );
+
+				// Central directory entry
+				Entry entry;
+				entry.name = pItems[entries.size( )].name;
+				entry.flags = FLAG_UTF8;
+				entry.method = pendingEntry.method;
+				entry.crc = pendingEntry.crc;
+				entry.compressedSize = pendingEntry.data.getSize( );
+				entry.uncompressedSize = pendingEntry.uncompressedSize;
+				entry.localOffset = fileOffset;
+
+				// MS-DOS time & date, 1980-01-01 if unknown
+				const std::time_t fileTime( static_cast<std::time_t>( pendingEntry.mtime ) );
+				const std::tm *const localTime( pendingEntry.mtime > 0 ? std::localtime( &fileTime ) : nullptr );
+
+				if ( localTime != nullptr && localTime->tm_year >= 80 )
+				{
+					entry.dosTime = static_cast<std::uint16_t>( ( localTime->tm_hour << 11 ) | ( localTime->tm_min << 5 ) | ( localTime->tm_sec / 2 ) );
+					entry.dosDate = static_cast<std::uint16_t>( ( ( localTime->tm_year - 80 ) << 9 ) | ( ( localTime->tm_mon + 1 ) << 5 ) | localTime->tm_mday );
+				}
+				else
+				{
+					entry.dosTime = 0;
+					entry.dosDate = ( 1 << 5 ) | 1;
+				}
+
+				// Write
+				fileOffset += writeEntry( dstFile, entry, pendingEntry );
+				entries.push_back( entry );
+
+				// Release entry
+				entriesInFlight.pop_front( );
+
+			}
+
+		}
+
+		// Write central directory
+		writeDirectory( dstFile, entries, fileOffset );
+
+	}
+
+	/*
+	 * Read central directory from the end of archive.
+	 *
+	 * @thread_safety - not thread-safe.
+	 * @param srcFile - archive, must be seekable.
+	 * @throws - can throw exception.
+	*/
+	void ZArchive::loadDirectory( std::FILE *const srcFile )
+	{
+
+		// Size of file
+		const std::uint64_t fileSize( FileUtils::getSize( srcFile ) );
+
+		if ( fileSize < END_SIZE )
+			throw std::runtime_error( "not a ZIP archive." );
+
+		// End of file, where end of central directory can be: record & comment
+		const std::size_t tailSize( static_cast<std::size_t>( std::min<std::uint64_t>( fileSize, END_SIZE + MAX_COMMENT_SIZE ) ) );
+		std::vector<unsigned char> tailData( tailSize );
+
+		FileUtils::seek( srcFile, fileSize - tailSize );
+		if ( fread( tailData.data( ), sizeof( unsigned char ), tailSize, srcFile ) != tailSize )
+			throw std::runtime_error( "io error, can't read input file !" );
+
+		// Find end of central directory, from the end
+		std::size_t endPosition( tailSize - END_SIZE );
+		while ( getValue( tailData.data( ) + endPosition, 4 ) != END_SIGNATURE || endPosition + END_SIZE + getValue( tailData.data( ) + endPosition + 20, 2 ) > tailSize )
+		{
+
+			if ( endPosition == 0 )
+				throw std::runtime_error( "not a ZIP archive, end of central directory not found." );
+
+			endPosition--;
+
+		}
+
+		// Offset of end of central directory
+		const std::uint64_t endOffset( fileSize - tailSize + endPosition );
+
+		// Number of entries, size & offset of central directory
+		std::uint64_t entriesCount( getValue( tailData.data( ) + endPosition + 10, 2 ) );
+		std::uint64_t directorySize( getValue( tailData.data( ) + endPosition + 12, 4 ) );
+		std::uint64_t directoryOffset( getValue( tailData.data( ) + endPosition + 16, 4 ) );
+
+		// ZIP64 end of central directory, found by locator
+		if ( ( entriesCount == ZIP64_MARK_16 || directorySize == ZIP64_MARK_32 || directoryOffset == ZIP64_MARK_32 ) && endOffset >= ZIP64_LOCATOR_SIZE )
+		{
+
+			// Locator
+			unsigned char locatorData[ZIP64_LOCATOR_SIZE];
+			FileUtils::seek( srcFile, endOffset - ZIP64_LOCATOR_SIZE );
+
+			if ( fread( locatorData, sizeof( unsigned char ), ZIP64_LOCATOR_SIZE, srcFile ) != ZIP64_LOCATOR_SIZE )
+				throw std::runtime_error( "io error, can't read input file !" );
+
+			if ( getValue( locatorData, 4 ) == ZIP64_LOCATOR_SIGNATURE )
+			{
+
+				// ZIP64 end of central directory
+				unsigned char zip64EndData[ZIP64_END_SIZE];
+				const std::uint64_t zip64EndOffset( getValue( locatorData + 8, 8 ) );
+
+				if ( zip64EndOffset + ZIP64_END_SIZE > endOffset )
+					throw std::runtime_error( "ZIP64 end of central directory out of file." );
+
+				FileUtils::seek( srcFile, zip64EndOffset );
+
+				if ( fread( zip64EndData, sizeof( unsigned char ), ZIP64_END_SIZE, srcFile ) != ZIP64_END_SIZE || getValue( zip64EndData, 4 ) != ZIP64_END_SIGNATURE )
+					throw std::runtime_error( "ZIP64 end of central directory corrupted." );
+
+				entriesCount = getValue( zip64EndData + 32, 8 );
+				directorySize = getValue( zip64EndData + 40, 8 );
+				directoryOffset = getValue( zip64EndData + 48, 8 );
+
+			}
+
+		}
+
+		if ( directoryOffset > endOffset || directorySize > endOffset - directoryOffset )
+			throw std::runtime_error( "central directory out of file." );
+
+		// Read central directory
+		std::vector<unsigned char> directory( static_cast<std::size_t>( directorySize ) );
+
+		FileUtils::seek( srcFile, directoryOffset );
+		if ( fread( directory.data( ), sizeof( unsigned char ), directory.size( ), srcFile ) != directory.size( ) )
+			throw std::runtime_error( "io error, can't read input file !" );
+
+		// Parse entries
+		mEntries.reserve( static_cast<std::size_t>( std::min<std::uint64_t>( entriesCount, directorySize / CENTRAL_HEADER_SIZE ) ) );
+
+		std::size_t position( 0 );
+		for ( std::uint64_t i = 0; i < entriesCount; i++ )
+		{
+
+			// Header
+			const unsigned char *const headerData( directory.data( ) + position );
+
+			if ( position + CENTRAL_HEADER_SIZE > directory.size( ) || getValue( headerData, 4 ) != CENTRAL_HEADER_SIGNATURE )
+				throw std::runtime_error( "central directory corrupted." );
+
+			const std::size_t nameSize( static_cast<std::size_t>( getValue( headerData + 28, 2 ) ) );
+			const std::size_t extraSize( static_cast<std::size_t>( getValue( headerData + 30, 2 ) ) );
+			const std::size_t commentSize( static_cast<std::size_t>( getValue( headerData + 32, 2 ) ) );
+
+			if ( position + CENTRAL_HEADER_SIZE + nameSize + extraSize + commentSize > directory.size( ) )
+				throw std::runtime_error( "central directory corrupted." );
+
+			// Entry
+			Entry entry;
+			entry.flags = static_cast<std::uint16_t>( getValue( headerData + 8, 2 ) );
+			entry.method = static_cast<std::uint16_t>( getValue( headerData + 10, 2 ) );
+			entry.dosTime = static_cast<std::uint16_t>( getValue( headerData + 12, 2 ) );
+			entry.dosDate = static_cast<std::uint16_t>( getValue( headerData + 14, 2 ) );
+			entry.crc = static_cast<std::uint32_t>( getValue( headerData + 16, 4 ) );
+			entry.compressedSize = getValue( headerData + 20, 4 );
+			entry.uncompressedSize = getValue( headerData + 24, 4 );
+			entry.localOffset = getValue( headerData + 42, 4 );
+			entry.name.assign( reinterpret_cast<const char*>( headerData + CENTRAL_HEADER_SIZE ), nameSize );
+
+			// ZIP64 extra-field: marked fields, in fixed order
+			const unsigned char *const extraData( headerData + CENTRAL_HEADER_SIZE + nameSize );
+			for ( std::size_t fieldOffset = 0; fieldOffset + 4 <= extraSize; )
+			{
+
+				const std::size_t fieldSize( static_cast<std::size_t>( getValue( extraData + fieldOffset + 2, 2 ) ) );
+
+				if ( getValue( extraData + fieldOffset, 2 ) == ZIP64_EXTRA_ID && fieldOffset + 4 + fieldSize <= extraSize )
+				{
+
+					const unsigned char * fieldData( extraData + fieldOffset + 4 );
+					const unsigned char *const fieldEnd( fieldData + fieldSize );
+
+					if ( entry.uncompressedSize == ZIP64_MARK_32 && fieldData + 8 <= fieldEnd )
+					{
+						entry.uncompressedSize = getValue( fieldData, 8 );
+						fieldData += 8;
+					}
+
+					if ( entry.compressedSize == ZIP64_MARK_32 && fieldData + 8 <= fieldEnd )
+					{
+						entry.compressedSize = getValue( fieldData, 8 );
+						fieldData += 8;
+					}
+
+					if ( entry.localOffset == ZIP64_MARK_32 && fieldData + 8 <= fieldEnd )
+						entry.localOffset = getValue( fieldData, 8 );
+
+				}
+
+				fieldOffset += 4 + fieldSize;
+
+			}
+
+			// Add
+			mEntries.push_back( entry );
+			position += CENTRAL_HEADER_SIZE + nameSize + extraSize + commentSize;
+
+		}
+
+	}
+
+	/*
+	 * Decompress entry data.
+	 *
+	 * @thread_safety - thread-safe, if file not shared.
+	 * @param srcFile - archive, must be seekable.
+	 * @param pEntry - entry.
+	 * @param pOutput - receives decompressed data.
+	 * @throws - can throw exception.
+	*/
+	void ZArchive::inflateEntry( std::FILE *const srcFile, const Entry & pEntry, OutputSink & pOutput )
+	{
+
+		// Check entry
+		if ( ( pEntry.flags & FLAG_ENCRYPTED ) != 0 )
+			throw std::runtime_error( "encrypted entries are not supported." );
+
+		if ( pEntry.method != METHOD_STORED && pEntry.method != METHOD_DEFLATE )
+			throw std::runtime_error( "compression method is not supported." );
+
+		// Local header, it's name & extra-field can differ from central directory
+		unsigned char localHeader[LOCAL_HEADER_SIZE];
+
+		FileUtils::seek( srcFile, pEntry.localOffset );
+		if ( fread( localHeader, sizeof( unsigned char ), LOCAL_HEADER_SIZE, srcFile ) != LOCAL_HEADER_SIZE || getValue( localHeader, 4 ) != LOCAL_HEADER_SIGNATURE )
+			throw std::runtime_error( "local header corrupted." );
+
+		// Seek to data
+		FileUtils::seek( srcFile, pEntry.localOffset + LOCAL_HEADER_SIZE + getValue( localHeader + 26, 2 ) + getValue( localHeader + 28, 2 ) );
+
+		// Return code
+		int zRet( Z_OK );
+
+		// Buffers
+		std::vector<unsigned char> inBuffer( CHUNK_SIZE );
+		std::vector<unsigned char> outBuffer( CHUNK_SIZE );
+
+		// Compressed bytes left to read
+		std::uint64_t leftCount( pEntry.compressedSize );
+
+		// CRC-32 & size of output
+		uLong crc( crc32( 0L, Z_NULL, 0 ) );
+		std::uint64_t outputSize( 0 );
+
+		// true, if deflate data
+		const bool deflated( pEntry.method == METHOD_DEFLATE );
+
+		// z_stream
+		z_stream zStream;
+
+		// Set z_stream state
+		zStream.zalloc = Z_NULL;
+		zStream.zfree = Z_NULL;
+		zStream.opaque = Z_NULL;
+		zStream.avail_in = 0;
+		zStream.next_in = Z_NULL;
+
+		// Initialize raw inflate
+		if ( deflated && inflateInit2( &zStream, -MAX_WBITS ) != Z_OK )
+			throw std::runtime_error( "failed to initialize decompression stream." );
+
+		// Guarded-Block
+		try
+		{
+
+			while ( leftCount > 0 )
+			{
+
+				// Read
+				const std::size_t readCount( fread( inBuffer.data( ), sizeof( unsigned char ), static_cast<std::size_t>( std::min<std::uint64_t>( leftCount, inBuffer.size( ) ) ), srcFile ) );
+
+				if ( ferror( srcFile ) )
+					throw std::runtime_error( "io error, can't read input file !" );
+
+				if ( readCount == 0 )
+					throw std::runtime_error( "decompression (inflate) failed, unexpected end of file." );
+
+				leftCount -= readCount;
+
+				// Stored data is written as is
+				if ( !deflated )
+				{
+
+					crc = crc32( crc, inBuffer.data( ), static_cast<uInt>( readCount ) );
+					pOutput.write( inBuffer.data( ), readCount );
+					outputSize += readCount;
+
+					continue;
+
+				}
+
+				// Set input
+				zStream.next_in = inBuffer.data( );
+				zStream.avail_in = static_cast<uInt>( readCount );
+
+				// Decompress, until output-buffer is not full
+				do
+				{
+
+					zStream.next_out = outBuffer.data( );
+					zStream.avail_out = static_cast<uInt>( outBuffer.size( ) );
+
+					zRet = inflate( &zStream, Z_NO_FLUSH );
+
+					// Check inflate-status, Z_BUF_ERROR means more input required
+					switch ( zRet )
+					{
+
+					case Z_DATA_ERROR:
+						throw std::runtime_error( "decompression (inflate) failed, data corrupted." );
+
+					case Z_MEM_ERROR:
+						throw std::runtime_error( "decompression (inflate) failed, insufficent memory" );
+
+					case Z_NEED_DICT:
+						throw std::runtime_error( "decompression (inflate) failed, dictionary required." );
+
+					case Z_STREAM_ERROR:
+						throw std::runtime_error( "decompression (inflate) failed, stream structure inconsistent." );
+
+					}
+
+					// Write
+					const std::size_t outCount( outBuffer.size( ) - zStream.avail_out );
+					crc = crc32( crc, outBuffer.data( ), static_cast<uInt>( outCount ) );
+					pOutput.write( outBuffer.data( ), outCount );
+					outputSize += outCount;
+
+				} while ( zStream.avail_out == 0 && zRet != Z_STREAM_END );
+
+				// End of deflate data
+				if ( zRet == Z_STREAM_END )
+					break;
+
+			}
+
+			// Check data
+			if ( deflated && zRet != Z_STREAM_END )
+				throw std::runtime_error( "decompression (inflate) failed, unexpected end of data." );
+
+			if ( outputSize != pEntry.uncompressedSize || static_cast<std::uint32_t>( crc ) != pEntry.crc )
+				throw std::runtime_error( "decompression (inflate) failed, CRC-32 or size mismatch." );
+
+			// Complete pending writes
+			pOutput.finish( );
+
+		}
+		catch ( ... )
+		{
+
+			// Release z_stream resources
+			if ( deflated )
+				inflateEnd( &zStream );
+
+			// Rethrow
+			throw;
+
+		}
+
+		// Release z_stream resources
+		if ( deflated )
+			inflateEnd( &zStream );
+
+	}
+
+	/*
+	 * Compress files into ZIP archive, entries are compressed on multiple threads.
+	 *
+	 * @thread_safety - not thread-safe.
+	 * @param pItems - files to add, in archive order.
+	 * @param dstFile - output file, empty. Written sequentially, can be a pipe.
+	 * @param compressionLevel - Compression-Level to use, must be in range 0-9.
+	 * @param threadsCount - number of worker-threads, 0 to use all hardware-threads.
+	 * @return - Z_OK if archive written, Z_ERRNO otherwise.
+	*/
+	int ZArchive::deflateFiles( const std::vector<Item> & pItems, std::FILE *const dstFile, const int compressionLevel, const std::uint32_t threadsCount )
+	{
+
+		// Guarded-Block
+		try
+		{
+
+			// Check arguments
+			if ( compressionLevel < Z_DEFAULT_COMPRESSION || compressionLevel > Z_BEST_COMPRESSION )
+				throw std::runtime_error( "ZArchive::deflateFiles - wrong compression level" );
+
+			// Compress
+			deflateItems( pItems, dstFile, compressionLevel, threadsCount );
+
+		}
+		catch ( const std::exception & pException )
+		{
+
+			// Print ERROR-message
+			std::cout << "ZArchive::deflateFiles - error: " << pException.what( ) << std::endl;
+
+			// Return ERROR
+			return( Z_ERRNO );
+
+		}
+		catch ( ... )
+		{
+
+			// Print ERROR-message
+			std::cout << "ZArchive::deflateFiles - unknown error" << std::endl;
+
+			// Return ERROR
+			return( Z_ERRNO );
+
+		}
+
+		// Return Z_OK
+		return( Z_OK );
+
+	}
+
+	/*
+	 * Read central directory of archive.
+	 *
+	 * @thread_safety - not thread-safe.
+	 * @param srcFile - ZIP archive, must be seekable.
+	 * @return - Z_OK if read, Z_ERRNO otherwise (not a ZIP archive).
+	*/
+	int ZArchive::load( std::FILE *const srcFile )
+	{
+
+		// Clear
+		mEntries.clear( );
+
+		// Guarded-Block
+		try
+		{
+
+			// Read
+			loadDirectory( srcFile );
+
+		}
+		catch ( const std::exception & pException )
+		{
+
+			// Print ERROR-message
+			std::cout << "ZArchive::load - error: " << pException.what( ) << std::endl;
+
+			// Clear
+			mEntries.clear( );
+
+			// Return ERROR
+			return( Z_ERRNO );
+
+		}
+
+		// Return OK
+		return( Z_OK );
+
+	}
+
+	/*
+	 * Decompress entry, seeking directly to it. CRC-32 & size are checked.
+	 *
+	 * @thread_safety - thread-safe, if file not shared.
+	 * @param srcFile - ZIP archive, the one directory is loaded from.
+	 * @param pIndex - entry index, must be less than entries count.
+	 * @param pOutput - receives decompressed data.
+	 * @return - Z_OK if entry decompressed, Z_ERRNO otherwise.
+	*/
+	int ZArchive::extract( std::FILE *const srcFile, const std::size_t pIndex, OutputSink & pOutput ) const
+	{
+
+		// Guarded-Block
+		try
+		{
+
+			// Check index
+			if ( pIndex >= mEntries.size( ) )
+				throw std::runtime_error( "entry not found." );
+
+			// Decompress
+			inflateEntry( srcFile, mEntries[pIndex], pOutput );
+
+		}
+		catch ( const std::exception & pException )
+		{
+
+			// Print ERROR-message
+			std::cout << "ZArchive::extract - error: " << pException.what( ) << std::endl;
+
+			// Return ERROR
+			return( Z_ERRNO );
+
+		}
+
+		// Return OK
+		return( Z_OK );
+
+	}
+
+	// -------------------------------------------------------- \\
+
+}
\ No newline at end of file
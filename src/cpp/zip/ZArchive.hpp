@@ -0,0 +1,456 @@
+/*
+* Copyright  2018 Denis Zyamaev (code4un@yandex.ru) All rights reserved.
+* Authors: Denis Zyamaev (code4un@yandex.ru)
+* All rights reserved.
+* API: C++ 11
+* License: see LICENSE.txt
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+* 1. Redistributions of source code must retain the above copyright notice,
+* this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must display the names 'Denis Zyamaev' and
+* in the credits of the application, if such credits exist.
+* The authors of this work must be notified via email (code4un@yandex.ru) in
+* this case of redistribution.
+* 3. Neither the name of copyright holders nor the names of its contributors
+* may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS
+* IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+* PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+// Include 'pch_cxx'
+#include "../pch_cxx.hpp"
+
+// Include ThreadPool
+#include "../core/ThreadPool.hpp"
+
+// Include OutputSink
+#include "../io/OutputSink.hpp"
+
+namespace c0de4un
+{
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Types
+	// ===========================================================
+
+	/*
+	  * ZArchive - ZIP archive (PKWARE APPNOTE) writer & reader.
+	  *
+	  * Writer compresses entries on worker-threads, each entry as raw
+	  * deflate into own spill-buffer (memory, then temporary file), and
+	  * writes them in order: local header with known sizes & CRC-32, data,
+	  * then central directory. ZIP64 records are written only if sizes,
+	  * offsets or number of entries do not fit into ZIP fields. Entry is
+	  * stored, if deflate does not make it smaller.
+	  *
+	  * Reader loads central directory from the end of the archive, entry
+	  * is extracted by seeking to it's local header, archive is not scanned.
+	  *
+	  * @language C++ 17
+	  *
+	  * @authors Z. Denis (c0de4un@yandex.ru)
+	  * @version 1.0
+	 */
+	class ZArchive final
+	{
+
+	public:
+
+		// -------------------------------------------------------- \\
+
+		// ===========================================================
+		// Types
+		// ===========================================================
+
+		/* File to add */
+		struct Item final
+		{
+
+			/* Source file path */
+			std::string srcPath;
+
+			/* Name in archive, '/' separated */
+			std::string name;
+
+		};
+
+		/* Entry of central directory */
+		struct Entry final
+		{
+
+			/* Name in archive */
+			std::string name;
+
+			/* General purpose flags */
+			std::uint16_t flags;
+
+			/* Compression method: 0 (stored) or 8 (deflate) */
+			std::uint16_t method;
+
+			/* Modification time, MS-DOS format */
+			std::uint16_t dosTime;
+
+			/* Modification date, MS-DOS format */
+			std::uint16_t dosDate;
+
+			/* CRC-32 of uncompressed data */
+			std::uint32_t crc;
+
+			/* Size of compressed data */
+			std::uint64_t compressedSize;
+
+			/* Size of uncompressed data */
+			std::uint64_t uncompressedSize;
+
+			/* Offset of local header */
+			std::uint64_t localOffset;
+
+		};
+
+		// ===========================================================
+		// Constants
+		// ===========================================================
+
+		/* Stored (no compression) method */
+		static constexpr std::uint16_t METHOD_STORED = 0;
+
+		/* Deflate method */
+		static constexpr std::uint16_t METHOD_DEFLATE = 8;
+
+		/* Returned by findEntry, if entry not found */
+		static constexpr std::size_t NO_ENTRY = SIZE_MAX;
+
+		// -------------------------------------------------------- \\
+
+	private:
+
+		// -------------------------------------------------------- \\
+
+		// ===========================================================
+		// Types
+		// ===========================================================
+
+		/* Collects compressed data in memory, then in temporary file */
+		class SpillBuffer final : public OutputSink
+		{
+
+		private:
+
+			/* Data, up to SPILL_MEMORY_SIZE */
+			std::vector<unsigned char> mMemory;
+
+			/* Data after memory, null until memory is full */
+			std::unique_ptr<std::FILE, int(*)( std::FILE* )> mFile;
+
+			/* Number of bytes */
+			std::uint64_t mSize;
+
+		public:
+
+			/* SpillBuffer constructor, buffer is empty */
+			explicit SpillBuffer( ) noexcept;
+
+			/* Returns number of bytes */
+			std::uint64_t getSize( ) const noexcept;
+
+			/*
+			 * Appends data, spilling to temporary file when memory is full.
+			 *
+			 * @param pData - data to write.
+			 * @param pSize - number of bytes.
+			 * @throws - can throw exception.
+			*/
+			void write( const unsigned char *const pData, const std::size_t pSize ) override;
+
+			/* Removes data, temporary file is deleted */
+			void clear( ) noexcept;
+
+			/*
+			 * Writes data to file.
+			 *
+			 * @param dstFile - output file.
+			 * @throws - can throw exception.
+			*/
+			void copyTo( std::FILE *const dstFile );
+
+		};
+
+		/* Compressed entry, waiting to be written */
+		struct PendingEntry final
+		{
+
+			/* Compressed (or stored) data */
+			SpillBuffer data;
+
+			/* Compression method */
+			std::uint16_t method;
+
+			/* CRC-32 of uncompressed data */
+			std::uint32_t crc;
+
+			/* Size of uncompressed data */
+			std::uint64_t uncompressedSize;
+
+			/* Modification time of source file, seconds since 1970. 0 if unknown. */
+			std::int64_t mtime;
+
+		};
+
+		// ===========================================================
+		// Constants
+		// ===========================================================
+
+		/* Max size of spill-buffer memory, rest goes to temporary file */
+		static constexpr std::size_t SPILL_MEMORY_SIZE = 4194304;
+
+		/* Size of input & output buffers */
+		static constexpr std::size_t CHUNK_SIZE = 262144;
+
+		/* Local header signature */
+		static constexpr std::uint32_t LOCAL_HEADER_SIGNATURE = 0x04034B50;
+
+		/* Central directory header signature */
+		static constexpr std::uint32_t CENTRAL_HEADER_SIGNATURE = 0x02014B50;
+
+		/* End of central directory signature */
+		static constexpr std::uint32_t END_SIGNATURE = 0x06054B50;
+
+		/* ZIP64 end of central directory signature */
+		static constexpr std::uint32_t ZIP64_END_SIGNATURE = 0x06064B50;
+
+		/* ZIP64 end of central directory locator signature */
+		static constexpr std::uint32_t ZIP64_LOCATOR_SIGNATURE = 0x07064B50;
+
+		/* ZIP64 extra-field ID */
+		static constexpr std::uint16_t ZIP64_EXTRA_ID = 0x0001;
+
+		/* Size of local header, without name & extra-field */
+		static constexpr std::size_t LOCAL_HEADER_SIZE = 30;
+
+		/* Size of central directory header, without name & extra-field */
+		static constexpr std::size_t CENTRAL_HEADER_SIZE = 46;
+
+		/* Size of end of central directory, without comment */
+		static constexpr std::size_t END_SIZE = 22;
+
+		/* Size of ZIP64 end of central directory */
+		static constexpr std::size_t ZIP64_END_SIZE = 56;
+
+		/* Size of ZIP64 end of central directory locator */
+		static constexpr std::size_t ZIP64_LOCATOR_SIZE = 20;
+
+		/* Max size of archive comment */
+		static constexpr std::size_t MAX_COMMENT_SIZE = 65535;
+
+		/* Version needed to extract: deflate */
+		static constexpr std::uint16_t VERSION_DEFLATE = 20;
+
+		/* Version needed to extract: ZIP64 */
+		static constexpr std::uint16_t VERSION_ZIP64 = 45;
+
+		/* Flag: data is encrypted */
+		static constexpr std::uint16_t FLAG_ENCRYPTED = 0x0001;
+
+		/* Flag: name is UTF-8 */
+		static constexpr std::uint16_t FLAG_UTF8 = 0x0800;
+
+		/* Value of 16-bit field, replaced by ZIP64 field */
+		static constexpr std::uint32_t ZIP64_MARK_16 = 0xFFFF;
+
+		/* Value of 32-bit field, replaced by ZIP64 field */
+		static constexpr std::uint32_t ZIP64_MARK_32 = 0xFFFFFFFF;
+
+		// ===========================================================
+		// Fields
+		// ===========================================================
+
+		/* Entries, in central directory order */
+		std::vector<Entry> mEntries;
+
+		// ===========================================================
+		// Methods
+		// ===========================================================
+
+		/*
+		 * Append little-endian value.
+		 *
+		 * @param pBuffer - output.
+		 * @param pValue - value.
+		 * @param bytesCount - number of bytes to write.
+		 * @throws - can throw exception (bad_alloc).
+		*/
+		static void putValue( std::vector<unsigned char> & pBuffer, const std::uint64_t pValue, const std::size_t bytesCount );
+
+		/*
+		 * Returns little-endian value.
+		 *
+		 * @param pData - input.
+		 * @param bytesCount - number of bytes to read.
+		*/
+		static std::uint64_t getValue( const unsigned char *const pData, const std::size_t bytesCount ) noexcept;
+
+		/*
+		 * Compress source file into pending entry: deflate, or stored if
+		 * deflate does not make it smaller.
+		 *
+		 * @thread_safety - thread-safe, if entry not shared.
+		 * @param pItem - file to add.
+		 * @param pEntry - receives compressed data.
+		 * @param compressionLevel - Compression-Level to use, must be in range 0-9.
+		 * @throws - can throw exception.
+		*/
+		static void deflateEntry( const Item & pItem, PendingEntry & pEntry, const int compressionLevel );
+
+		/*
+		 * Write local header & data of entry.
+		 *
+		 * @thread_safety - not thread-safe.
+		 * @param dstFile - output file.
+		 * @param pEntry - central directory entry, offset & sizes are set.
+		 * @param pPending - compressed data.
+		 * @return - number of bytes written.
+		 * @throws - can throw exception.
+		*/
+		static std::uint64_t writeEntry( std::FILE *const dstFile, const Entry & pEntry, PendingEntry & pPending );
+
+		/*
+		 * Write central directory & end records.
+		 *
+		 * @thread_safety - not thread-safe.
+		 * @param dstFile - output file.
+		 * @param pEntries - entries, in file order.
+		 * @param directoryOffset - offset of central directory.
+		 * @throws - can throw exception.
+		*/
+		static void writeDirectory( std::FILE *const dstFile, const std::vector<Entry> & pEntries, const std::uint64_t directoryOffset );
+
+		/*
+		 * Compress files into archive on multiple threads.
+		 *
+		 * @thread_safety - not thread-safe.
+		 * @param pItems - files to add, in archive order.
+		 * @param dstFile - output file.
+		 * @param compressionLevel - Compression-Level to use, must be in range 0-9.
+		 * @param threadsCount - number of worker-threads, 0 to use all hardware-threads.
+		 * @throws - can throw exception.
+		*/
+		static void deflateItems( const std::vector<Item> & pItems, std::FILE *const dstFile, const int compressionLevel, const std::uint32_t threadsCount );
+
+		/*
+		 * Read central directory from the end of archive.
+		 *
+		 * @thread_safety - not thread-safe.
+		 * @param srcFile - archive, must be seekable.
+		 * @throws - can throw exception.
+		*/
+		void loadDirectory( std::FILE *const srcFile );
+
+		/*
+		 * Decompress entry data.
+		 *
+		 * @thread_safety - thread-safe, if file not shared.
+		 * @param srcFile - archive, must be seekable.
+		 * @param pEntry - entry.
+		 * @param pOutput - receives decompressed data.
+		 * @throws - can throw exception.
+		*/
+		static void inflateEntry( std::FILE *const srcFile, const Entry & pEntry, OutputSink & pOutput );
+
+		// -------------------------------------------------------- \\
+
+	public:
+
+		// -------------------------------------------------------- \\
+
+		// ===========================================================
+		// Constructor & destructor
+		// ===========================================================
+
+		/* ZArchive constructor, directory is empty */
+		explicit ZArchive( ) noexcept;
+
+		/* ZArchive destructor */
+		~ZArchive( ) = default;
+
+		// ===========================================================
+		// Getters
+		// ===========================================================
+
+		/* Returns number of entries */
+		std::size_t getEntriesCount( ) const noexcept;
+
+		/*
+		 * Returns entry.
+		 *
+		 * @param pIndex - entry index, must be less than entries count.
+		*/
+		const Entry & getEntry( const std::size_t pIndex ) const noexcept;
+
+		/*
+		 * Returns index of entry with name, NO_ENTRY if not found.
+		 *
+		 * @param pName - name in archive.
+		*/
+		std::size_t findEntry( const std::string & pName ) const noexcept;
+
+		// ===========================================================
+		// Methods
+		// ===========================================================
+
+		/*
+		 * Compress files into ZIP archive, entries are compressed on multiple threads.
+		 *
+		 * @thread_safety - not thread-safe.
+		 * @param pItems - files to add, in archive order.
+		 * @param dstFile - output file, empty. Written sequentially, can be a pipe.
+		 * @param compressionLevel - Compression-Level to use, must be in range 0-9.
+		 * @param threadsCount - number of worker-threads, 0 to use all hardware-threads.
+		 * @return - Z_OK if archive written, Z_ERRNO otherwise.
+		*/
+		static int deflateFiles( const std::vector<Item> & pItems, std::FILE *const dstFile, const int compressionLevel, const std::uint32_t threadsCount = 0 );
+
+		/*
+		 * Read central directory of archive.
+		 *
+		 * @thread_safety - not thread-safe.
+		 * @param srcFile - ZIP archive, must be seekable.
+		 * @return - Z_OK if read, Z_ERRNO otherwise (not a ZIP archive).
+		*/
+		int load( std::FILE *const srcFile );
+
+		/*
+		 * Decompress entry, seeking directly to it. CRC-32 & size are checked.
+		 *
+		 * @thread_safety - thread-safe, if file not shared.
+		 * @param srcFile - ZIP archive, the one directory is loaded from.
+		 * @param pIndex - entry index, must be less than entries count.
+		 * @param pOutput - receives decompressed data.
+		 * @return - Z_OK if entry decompressed, Z_ERRNO otherwise.
+		*/
+		int extract( std::FILE *const srcFile, const std::size_t pIndex, OutputSink & pOutput ) const;
+
+		// -------------------------------------------------------- \\
+
+	};
+
+	// -------------------------------------------------------- \\
+
+}
\ No newline at end of file
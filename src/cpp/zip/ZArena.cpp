@@ -0,0 +1,279 @@
+/*
+* Copyright  2018 Denis Zyamaev (code4un@yandex.ru) All rights reserved.
+* Authors: Denis Zyamaev (code4un@yandex.ru)
+* All rights reserved.
+* API: C++ 11
+* License: see LICENSE.txt
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+* 1. Redistributions of source code must retain the above copyright notice,
+* this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must display the names 'Denis Zyamaev' and
+* in the credits of the application, if such credits exist.
+* The authors of this work must be notified via email (code4un@yandex.ru) in
+* this case of redistribution.
+* 3. Neither the name of copyright holders nor the names of its contributors
+* may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS
+* IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+* PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// HEADER
+#include "ZArena.hpp"
+
+namespace c0de4un
+{
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Constructor & destructor
+	// ===========================================================
+
+	/*
+	 * ZArena constructor.
+	 *
+	 * @param pUpstream - memory resource to allocate from, if null, new/delete resource is used.
+	 * @param maxCachedBytes - max size of cached free blocks.
+	*/
+	ZArena::ZArena( std::pmr::memory_resource *const pUpstream, const std::size_t maxCachedBytes ) noexcept
+		: mUpstream( pUpstream != nullptr ? pUpstream : std::pmr::new_delete_resource( ) ),
+		mBuckets( ),
+		mCachedBytes( 0 ),
+		mMaxCachedBytes( maxCachedBytes )
+	{
+	}
+
+	/* ZArena destructor. All z_stream's using this arena must be ended before. */
+	ZArena::~ZArena( )
+	{
+
+		// Release cached blocks
+		release( );
+
+	}
+
+	// ===========================================================
+	// Getters
+	// ===========================================================
+
+	/*
+	 * Returns arena of the calling thread.
+	 *
+	 * @thread_safety - thread-safe, each thread has own arena.
+	*/
+	ZArena & ZArena::getThreadArena( ) noexcept
+	{
+
+		// Arena of the calling thread
+		static thread_local ZArena threadArena;
+
+		// Return
+		return( threadArena );
+
+	}
+
+	/* Returns total size of cached free blocks */
+	std::size_t ZArena::getCachedBytes( ) const noexcept
+	{ return( mCachedBytes ); }
+
+	// ===========================================================
+	// Methods
+	// ===========================================================
+
+	/*
+	 * zlib alloc-callback.
+	 *
+	 * @param pOpaque - ZArena.
+	 * @param itemsCount - number of items.
+	 * @param itemSize - size of item.
+	 * @return - memory, or Z_NULL if failed.
+	*/
+	voidpf ZArena::zAlloc( voidpf pOpaque, uInt itemsCount, uInt itemSize ) noexcept
+	{
+
+		// Guarded-Block
+		try
+		{
+			return( static_cast<ZArena*>( pOpaque )->allocate( static_cast<std::size_t>( itemsCount ) * itemSize ) );
+		}
+		catch ( ... )
+		{
+			// zlib reports Z_MEM_ERROR
+			return( Z_NULL );
+		}
+
+	}
+
+	/*
+	 * zlib free-callback.
+	 *
+	 * @param pOpaque - ZArena.
+	 * @param pAddress - memory, returned by zAlloc.
+	*/
+	void ZArena::zFree( voidpf pOpaque, voidpf pAddress ) noexcept
+	{ static_cast<ZArena*>( pOpaque )->deallocate( pAddress ); }
+
+	/*
+	 * Set z_stream allocator to this arena. Must be called before
+	 * deflateInit/inflateInit.
+	 *
+	 * @thread_safety - not thread-safe, z_stream must be used by the arena's thread only.
+	 * @param pStream - z_stream.
+	*/
+	void ZArena::attach( z_stream & pStream ) noexcept
+	{
+
+		// Set z_stream allocator
+		pStream.zalloc = &ZArena::zAlloc;
+		pStream.zfree = &ZArena::zFree;
+		pStream.opaque = this;
+
+	}
+
+	/*
+	 * Allocate block, reusing cached block of the same size if any.
+	 *
+	 * @thread_safety - not thread-safe.
+	 * @param pSize - size of block.
+	 * @return - memory, aligned as std::max_align_t.
+	 * @throws - can throw exception (bad_alloc).
+	*/
+	void* ZArena::allocate( const std::size_t pSize )
+	{
+
+		// Block memory (header & data)
+		void * blockMemory( nullptr );
+
+		// Search free block of the same size
+		for ( Bucket & bucket : mBuckets )
+		{
+
+			if ( bucket.size == pSize && !bucket.blocks.empty( ) )
+			{
+
+				// Take cached block
+				blockMemory = bucket.blocks.back( );
+				bucket.blocks.pop_back( );
+				mCachedBytes -= pSize;
+
+				break;
+
+			}
+
+		}
+
+		// Allocate new block
+		if ( blockMemory == nullptr )
+		{
+
+			// Allocate from upstream
+			blockMemory = mUpstream->allocate( HEADER_SIZE + pSize, alignof( std::max_align_t ) );
+
+			// Store size in header
+			*static_cast<std::size_t*>( blockMemory ) = pSize;
+
+		}
+
+		// Return user-data
+		return( static_cast<unsigned char*>( blockMemory ) + HEADER_SIZE );
+
+	}
+
+	/*
+	 * Return block to the free-list, or upstream if cache is full.
+	 *
+	 * @thread_safety - not thread-safe.
+	 * @param pAddress - memory, returned by allocate. Can be null.
+	*/
+	void ZArena::deallocate( void *const pAddress ) noexcept
+	{
+
+		// Ignore null
+		if ( pAddress == nullptr )
+			return;
+
+		// Block memory (header & data)
+		void *const blockMemory( static_cast<unsigned char*>( pAddress ) - HEADER_SIZE );
+
+		// Size of block
+		const std::size_t blockSize( *static_cast<std::size_t*>( blockMemory ) );
+
+		// Guarded-Block
+		try
+		{
+
+			// Cache, if limit allows
+			if ( mCachedBytes + blockSize <= mMaxCachedBytes )
+			{
+
+				// Search bucket
+				auto bucketIter( std::find_if( mBuckets.begin( ), mBuckets.end( ), [blockSize]( const Bucket & pBucket ) { return( pBucket.size == blockSize ); } ) );
+
+				// Add bucket
+				if ( bucketIter == mBuckets.end( ) )
+				{
+					mBuckets.push_back( Bucket{ blockSize, { } } );
+					bucketIter = mBuckets.end( ) - 1;
+				}
+
+				// Cache block
+				bucketIter->blocks.push_back( blockMemory );
+				mCachedBytes += blockSize;
+
+				// Stop
+				return;
+
+			}
+
+		}
+		catch ( ... )
+		{
+			// Free-list can't grow (bad_alloc), return block to upstream
+		}
+
+		// Return to upstream
+		mUpstream->deallocate( blockMemory, HEADER_SIZE + blockSize, alignof( std::max_align_t ) );
+
+	}
+
+	/*
+	 * Return all cached free blocks to upstream.
+	 *
+	 * @thread_safety - not thread-safe.
+	*/
+	void ZArena::release( ) noexcept
+	{
+
+		// Free blocks
+		for ( Bucket & bucket : mBuckets )
+		{
+
+			for ( void * blockMemory : bucket.blocks )
+				mUpstream->deallocate( blockMemory, HEADER_SIZE + bucket.size, alignof( std::max_align_t ) );
+
+			bucket.blocks.clear( );
+
+		}
+
+		// Reset
+		mCachedBytes = 0;
+
+	}
+
+	// -------------------------------------------------------- \\
+
+}
\ No newline at end of file
@@ -0,0 +1,222 @@
+/*
+* Copyright  2018 Denis Zyamaev (code4un@yandex.ru) All rights reserved.
+* Authors: Denis Zyamaev (code4un@yandex.ru)
+* All rights reserved.
+* API: C++ 11
+* License: see LICENSE.txt
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+* 1. Redistributions of source code must retain the above copyright notice,
+* this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must display the names 'Denis Zyamaev' and
+* in the credits of the application, if such credits exist.
+* The authors of this work must be notified via email (code4un@yandex.ru) in
+* this case of redistribution.
+* 3. Neither the name of copyright holders nor the names of its contributors
+* may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS
+* IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+* PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+// Include 'pch_cxx'
+#include "../pch_cxx.hpp"
+
+namespace c0de4un
+{
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Types
+	// ===========================================================
+
+	/*
+	  * ZArena - pool-allocator for zlib internal state.
+	  *
+	  * zlib allocates a few fixed-size blocks per stream (state, window,
+	  * hash-chains, pending-buffer). Freed blocks are kept in per-size
+	  * free-lists & handed to the next stream, so repeated init/end
+	  * doesn't hit the global heap. Memory is taken from the upstream
+	  * memory_resource, which allows to use application's own arenas.
+	  *
+	  * @language C++ 17
+	  *
+	  * @authors Z. Denis (c0de4un@yandex.ru)
+	  * @version 1.0
+	 */
+	class ZArena final
+	{
+
+	private:
+
+		// -------------------------------------------------------- \\
+
+		// ===========================================================
+		// Types
+		// ===========================================================
+
+		/* Free-list of blocks with the same size */
+		struct Bucket final
+		{
+
+			/* Size of block, without header */
+			std::size_t size;
+
+			/* Free blocks (pointers to header) */
+			std::vector<void*> blocks;
+
+		};
+
+		// ===========================================================
+		// Constants
+		// ===========================================================
+
+		/* Size of block header, keeps block-size & alignment of user-data */
+		static constexpr std::size_t HEADER_SIZE = alignof( std::max_align_t ) > sizeof( std::size_t ) ? alignof( std::max_align_t ) : sizeof( std::size_t );
+
+		// ===========================================================
+		// Fields
+		// ===========================================================
+
+		/* Upstream memory resource */
+		std::pmr::memory_resource * mUpstream;
+
+		/* Free-lists */
+		std::vector<Bucket> mBuckets;
+
+		/* Total size of cached free blocks */
+		std::size_t mCachedBytes;
+
+		/* Max size of cached free blocks, larger blocks are returned to upstream */
+		std::size_t mMaxCachedBytes;
+
+		// ===========================================================
+		// Methods
+		// ===========================================================
+
+		/*
+		 * zlib alloc-callback.
+		 *
+		 * @param pOpaque - ZArena.
+		 * @param itemsCount - number of items.
+		 * @param itemSize - size of item.
+		 * @return - memory, or Z_NULL if failed.
+		*/
+		static voidpf zAlloc( voidpf pOpaque, uInt itemsCount, uInt itemSize ) noexcept;
+
+		/*
+		 * zlib free-callback.
+		 *
+		 * @param pOpaque - ZArena.
+		 * @param pAddress - memory, returned by zAlloc.
+		*/
+		static void zFree( voidpf pOpaque, voidpf pAddress ) noexcept;
+
+		// -------------------------------------------------------- \\
+
+	public:
+
+		// -------------------------------------------------------- \\
+
+		// ===========================================================
+		// Constants
+		// ===========================================================
+
+		/* Default max size of cached free blocks */
+		static constexpr std::size_t DEFAULT_MAX_CACHED_BYTES = 8388608;
+
+		// ===========================================================
+		// Constructor & destructor
+		// ===========================================================
+
+		/*
+		 * ZArena constructor.
+		 *
+		 * @param pUpstream - memory resource to allocate from, if null, new/delete resource is used.
+		 * @param maxCachedBytes - max size of cached free blocks.
+		*/
+		explicit ZArena( std::pmr::memory_resource *const pUpstream = nullptr, const std::size_t maxCachedBytes = DEFAULT_MAX_CACHED_BYTES ) noexcept;
+
+		/* ZArena destructor. All z_stream's using this arena must be ended before. */
+		~ZArena( );
+
+		/* @deleted ZArena copy-constructor */
+		ZArena( const ZArena & ) = delete;
+
+		/* @deleted ZArena copy-assignment */
+		ZArena & operator=( const ZArena & ) = delete;
+
+		// ===========================================================
+		// Getters
+		// ===========================================================
+
+		/*
+		 * Returns arena of the calling thread.
+		 *
+		 * @thread_safety - thread-safe, each thread has own arena.
+		*/
+		static ZArena & getThreadArena( ) noexcept;
+
+		/* Returns total size of cached free blocks */
+		std::size_t getCachedBytes( ) const noexcept;
+
+		// ===========================================================
+		// Methods
+		// ===========================================================
+
+		/*
+		 * Set z_stream allocator to this arena. Must be called before
+		 * deflateInit/inflateInit.
+		 *
+		 * @thread_safety - not thread-safe, z_stream must be used by the arena's thread only.
+		 * @param pStream - z_stream.
+		*/
+		void attach( z_stream & pStream ) noexcept;
+
+		/*
+		 * Allocate block, reusing cached block of the same size if any.
+		 *
+		 * @thread_safety - not thread-safe.
+		 * @param pSize - size of block.
+		 * @return - memory, aligned as std::max_align_t.
+		 * @throws - can throw exception (bad_alloc).
+		*/
+		void* allocate( const std::size_t pSize );
+
+		/*
+		 * Return block to the free-list, or upstream if cache is full.
+		 *
+		 * @thread_safety - not thread-safe.
+		 * @param pAddress - memory, returned by allocate. Can be null.
+		*/
+		void deallocate( void *const pAddress ) noexcept;
+
+		/*
+		 * Return all cached free blocks to upstream.
+		 *
+		 * @thread_safety - not thread-safe.
+		*/
+		void release( ) noexcept;
+
+		// -------------------------------------------------------- \\
+
+	};
+
+	// -------------------------------------------------------- \\
+
+}
\ No newline at end of file
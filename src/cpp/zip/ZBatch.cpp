@@ -0,0 +1,799 @@
+/*
+* Copyright  2018 Denis Zyamaev (code4un@yandex.ru) All rights reserved.
+* Authors: Denis Zyamaev (code4un@yandex.ru)
+* All rights reserved.
+* API: C++ 11
+* License: see LICENSE.txt
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+* 1. Redistributions of source code must retain the above copyright notice,
+* this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must display the names 'Denis Zyamaev' and
+* in the credits of the application, if such credits exist.
+* The authors of this work must be notified via email (code4un@yandex.ru) in
+* this case of redistribution.
+* 3. Neither the name of copyright holders nor the names of its contributors
+* may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS
+* IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+* PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// HEADER
+#include "ZBatch.hpp"
+
+// Include ZParallelDeflate
+#include "ZParallelDeflate.hpp"
+
+// Include IOFactory
+#include "../io/IOFactory.hpp"
+
+// Include C++ filesystem
+#include <filesystem> // std::filesystem::file_size
+
+namespace c0de4un
+{
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Methods
+	// ===========================================================
+
+	/*
+	 * Returns state of the calling worker, initializes deflate or inflate on first use.
+	 *
+	 * @thread_safety - thread-safe, for worker-threads of context.
+	 * @param pContext - batch context.
+	 * @param forInflate - true to initialize inflate, deflate otherwise.
+	 * @throws - can throw exception.
+	*/
+	ZBatch::WorkerState & ZBatch::getWorkerState( Context & pContext, const bool forInflate )
+	{
+
+		// State of the calling worker
+		const std::uint32_t workerIndex( pContext.pool->getWorkerIndex( ) );
+		if ( workerIndex == WorkStealingPool::NO_WORKER )
+			throw std::runtime_error( "ZBatch::getWorkerState - called not by worker" );
+
+		WorkerState & workerState( pContext.workers[workerIndex] );
+
+		// Buffers
+		if ( workerState.inBuffer.empty( ) )
+		{
+			workerState.inBuffer.resize( pContext.bufferSize );
+			workerState.outBuffer.resize( pContext.bufferSize );
+		}
+
+		// Streams live as long as batch & are ended after worker-threads exit, so worker's own arena is used instead of thread's arena
+		if ( workerState.arena == nullptr )
+			workerState.arena = std::make_unique<ZArena>( );
+
+		if ( forInflate && !workerState.inflateInitialized )
+		{
+
+			workerState.arena->attach( workerState.inflateStream );
+			workerState.inflateStream.avail_in = 0;
+			workerState.inflateStream.next_in = Z_NULL;
+
+			// zlib or gzip, detected from header
+			if ( inflateInit2( &workerState.inflateStream, MAX_WBITS + 32 ) != Z_OK )
+				throw std::runtime_error( "ZBatch::getWorkerState - failed to initialize inflate." );
+
+			workerState.inflateInitialized = true;
+
+		}
+		else if ( !forInflate && !workerState.deflateInitialized )
+		{
+
+			workerState.arena->attach( workerState.deflateStream );
+
+			// Raw deflate, wrapper is written by ZParallelDeflate
+			if ( deflateInit2( &workerState.deflateStream, pContext.compressionLevel, Z_DEFLATED, -pContext.windowBits, pContext.memLevel, Z_DEFAULT_STRATEGY ) != Z_OK )
+				throw std::runtime_error( "ZBatch::getWorkerState - failed to initialize deflate." );
+
+			workerState.deflateInitialized = true;
+
+		}
+
+		// Return
+		return( workerState );
+
+	}
+
+	/*
+	 * Compress file as one stream on the calling worker.
+	 *
+	 * @param pContext - batch context.
+	 * @param srcFile - file to compress.
+	 * @param dstFile - output file.
+	 * @param srcCursor - page-cache cursor of input, can be null.
+	 * @param dstCursor - page-cache cursor of output, can be null.
+	 * @throws - can throw exception.
+	*/
+	void ZBatch::deflateWhole( Context & pContext, std::FILE *const srcFile, std::FILE *const dstFile, PageCacheCursor *const srcCursor, PageCacheCursor *const dstCursor )
+	{
+
+		// Return code
+		int zRet( Z_OK );
+
+		// Worker state
+		WorkerState & workerState( getWorkerState( pContext, false ) );
+		z_stream & zStream( workerState.deflateStream );
+
+		if ( deflateReset( &zStream ) != Z_OK )
+			throw std::runtime_error( "failed to reset deflate." );
+
+		// Check-value & size of input
+		uLong check( pContext.format == ZFormat::GZIP ? crc32( 0L, Z_NULL, 0 ) : adler32( 0L, Z_NULL, 0 ) );
+		std::uint64_t inputSize( 0 );
+
+		// Header
+		ZParallelDeflate::writeHeader( dstFile, pContext.compressionLevel, pContext.format, ZGzipHeader( ) );
+
+		// Compress, until input end
+		int zFlush( Z_NO_FLUSH );
+		do
+		{
+
+			// Read
+			zStream.avail_in = static_cast<uInt>( fread( workerState.inBuffer.data( ), sizeof( unsigned char ), workerState.inBuffer.size( ), srcFile ) );
+			zStream.next_in = workerState.inBuffer.data( );
+
+			// Check io errors
+			if ( ferror( srcFile ) )
+				throw std::runtime_error( "io error, can't read input file !" );
+
+			if ( srcCursor != nullptr )
+				srcCursor->advance( zStream.avail_in );
+
+			zFlush = feof( srcFile ) ? Z_FINISH : Z_NO_FLUSH;
+
+			// Check-value
+			check = pContext.format == ZFormat::GZIP ? crc32( check, zStream.next_in, zStream.avail_in ) : adler32( check, zStream.next_in, zStream.avail_in );
+			inputSize += zStream.avail_in;
+
+			// Compress input
+			do
+			{
+
+				// Set output
+				zStream.next_out = workerState.outBuffer.data( );
+				zStream.avail_out = static_cast<uInt>( workerState.outBuffer.size( ) );
+
+				// Compress
+				zRet = deflate( &zStream, zFlush );
+
+				if ( zRet == Z_STREAM_ERROR )
+					throw std::runtime_error( "compression failed, stream error" );
+
+				// Write output
+				const std::size_t outCount( workerState.outBuffer.size( ) - zStream.avail_out );
+				if ( fwrite( workerState.outBuffer.data( ), sizeof( unsigned char ), outCount, dstFile ) != outCount || ferror( dstFile ) )
+					throw std::runtime_error( "io error, can't write output file !" );
+
+				if ( dstCursor != nullptr )
+					dstCursor->advance( outCount );
+
+			} while ( zStream.avail_out == 0 );
+
+		} while ( zFlush != Z_FINISH );
+
+		// Trailer
+		ZParallelDeflate::writeTrailer( dstFile, pContext.format, check, inputSize );
+
+	}
+
+	/*
+	 * Compress block into raw deflate on the calling worker.
+	 *
+	 * @param pContext - batch context.
+	 * @param pBlock - block to compress.
+	 * @throws - can throw exception.
+	*/
+	void ZBatch::deflateBlock( Context & pContext, Block & pBlock )
+	{
+
+		// Number of compressed bytes
+		std::size_t zOutCount( 0 );
+
+		// Worker state
+		z_stream & zStream( getWorkerState( pContext, false ).deflateStream );
+
+		if ( deflateReset( &zStream ) != Z_OK )
+			throw std::runtime_error( "failed to reset deflate." );
+
+		// Set preset dictionary
+		if ( !pBlock.dictionary.empty( ) && deflateSetDictionary( &zStream, pBlock.dictionary.data( ), static_cast<uInt>( pBlock.dictionary.size( ) ) ) != Z_OK )
+			throw std::runtime_error( "failed to set dictionary." );
+
+		// Allocate output, enough for most blocks
+		pBlock.output.resize( deflateBound( &zStream, static_cast<uLong>( pBlock.input.size( ) ) ) + 16 );
+
+		// Set input
+		zStream.next_in = pBlock.input.data( );
+		zStream.avail_in = static_cast<uInt>( pBlock.input.size( ) );
+
+		// Compress. Last block finishes the stream, others end byte-aligned with empty stored block.
+		do
+		{
+
+			// Grow output-buffer by +50%
+			if ( zOutCount == pBlock.output.size( ) )
+				pBlock.output.resize( pBlock.output.size( ) + pBlock.output.size( ) / 2 );
+
+			// Set output
+			zStream.next_out = pBlock.output.data( ) + zOutCount;
+			zStream.avail_out = static_cast<uInt>( pBlock.output.size( ) - zOutCount );
+
+			if ( deflate( &zStream, pBlock.last ? Z_FINISH : Z_SYNC_FLUSH ) == Z_STREAM_ERROR )
+				throw std::runtime_error( "compression failed, stream error" );
+
+			// Count compressed bytes
+			zOutCount = pBlock.output.size( ) - zStream.avail_out;
+
+		} while ( zStream.avail_out == 0 );
+
+		// Cut output
+		pBlock.output.resize( zOutCount );
+
+		// Compute check-value
+		if ( pContext.format == ZFormat::GZIP )
+			pBlock.check = crc32( crc32( 0L, Z_NULL, 0 ), pBlock.input.data( ), static_cast<uInt>( pBlock.input.size( ) ) );
+		else
+			pBlock.check = adler32( adler32( 0L, Z_NULL, 0 ), pBlock.input.data( ), static_cast<uInt>( pBlock.input.size( ) ) );
+
+	}
+
+	/*
+	 * Compress file as blocks, that are compressed on any worker.
+	 *
+	 * @param pContext - batch context.
+	 * @param srcFile - file to compress.
+	 * @param dstFile - output file.
+	 * @param srcCursor - page-cache cursor of input, can be null.
+	 * @param dstCursor - page-cache cursor of output, can be null.
+	 * @throws - can throw exception.
+	*/
+	void ZBatch::deflateSplit( Context & pContext, std::FILE *const srcFile, std::FILE *const dstFile, PageCacheCursor *const srcCursor, PageCacheCursor *const dstCursor )
+	{
+
+		// Max number of blocks read & not written yet, limits memory usage
+		const std::size_t maxBlocksInFlight( pContext.maxBlocksInFlight );
+
+		// Blocks in output order
+		std::deque<std::pair<std::shared_ptr<Block>, std::future<void>>> blocksInFlight;
+
+		// Combined check-value & size of input
+		uLong check( pContext.format == ZFormat::GZIP ? crc32( 0L, Z_NULL, 0 ) : adler32( 0L, Z_NULL, 0 ) );
+		std::uint64_t inputSize( 0 );
+
+		// Write the oldest block, compressing other blocks while waiting
+		auto writeFront = [&]( )
+		{
+
+			std::shared_ptr<Block> writeBlock( blocksInFlight.front( ).first );
+
+			// Wait, rethrows exception of block
+			pContext.pool->get( blocksInFlight.front( ).second );
+			blocksInFlight.pop_front( );
+
+			// Write compressed output
+			if ( fwrite( writeBlock->output.data( ), sizeof( unsigned char ), writeBlock->output.size( ), dstFile ) != writeBlock->output.size( ) || ferror( dstFile ) )
+				throw std::runtime_error( "io error, can't write output file !" );
+
+			if ( dstCursor != nullptr )
+				dstCursor->advance( writeBlock->output.size( ) );
+
+			// Combine check-value
+			if ( pContext.format == ZFormat::GZIP )
+				check = crc32_combine( check, writeBlock->check, static_cast<z_off_t>( writeBlock->input.size( ) ) );
+			else
+				check = adler32_combine( check, writeBlock->check, static_cast<z_off_t>( writeBlock->input.size( ) ) );
+
+			inputSize += writeBlock->input.size( );
+
+		};
+
+		// Guarded-Block, blocks must complete before return, they refer to context
+		try
+		{
+
+			// Header
+			ZParallelDeflate::writeHeader( dstFile, pContext.compressionLevel, pContext.format, ZGzipHeader( ) );
+
+			// Read first block
+			std::shared_ptr<Block> currentBlock( std::make_shared<Block>( ) );
+			currentBlock->input.resize( BLOCK_SIZE );
+			currentBlock->input.resize( fread( currentBlock->input.data( ), sizeof( unsigned char ), BLOCK_SIZE, srcFile ) );
+
+			while ( currentBlock != nullptr )
+			{
+
+				// Check io errors
+				if ( ferror( srcFile ) )
+					throw std::runtime_error( "io error, can't read input file !" );
+
+				if ( srcCursor != nullptr )
+					srcCursor->advance( currentBlock->input.size( ) );
+
+				// Read next block, to know if current block is the last one
+				std::shared_ptr<Block> nextBlock( std::make_shared<Block>( ) );
+				nextBlock->input.resize( BLOCK_SIZE );
+				nextBlock->input.resize( currentBlock->input.size( ) < BLOCK_SIZE ? 0 : fread( nextBlock->input.data( ), sizeof( unsigned char ), BLOCK_SIZE, srcFile ) );
+
+				if ( nextBlock->input.empty( ) )
+					nextBlock = nullptr;
+				else
+					nextBlock->dictionary.assign( currentBlock->input.end( ) - std::min<std::size_t>( currentBlock->input.size( ), DICTIONARY_SIZE ), currentBlock->input.end( ) );
+
+				// Compress as sub-task
+				currentBlock->last = ( nextBlock == nullptr );
+				blocksInFlight.emplace_back( currentBlock, pContext.pool->submit( [&pContext, currentBlock]( ) { deflateBlock( pContext, *currentBlock ); } ) );
+
+				// Write compressed blocks in order
+				while ( blocksInFlight.size( ) >= maxBlocksInFlight )
+					writeFront( );
+
+				currentBlock = nextBlock;
+
+			}
+
+			// Write remaining blocks
+			while ( !blocksInFlight.empty( ) )
+				writeFront( );
+
+		}
+		catch ( ... )
+		{
+
+			// Wait blocks
+			for ( std::pair<std::shared_ptr<Block>, std::future<void>> & blockInFlight : blocksInFlight )
+			{
+
+				while ( blockInFlight.second.wait_for( std::chrono::seconds( 0 ) ) != std::future_status::ready )
+					if ( !pContext.pool->runPendingTask( ) )
+						blockInFlight.second.wait( );
+
+			}
+
+			// Rethrow
+			throw;
+
+		}
+
+		// Trailer
+		ZParallelDeflate::writeTrailer( dstFile, pContext.format, check, inputSize );
+
+	}
+
+	/*
+	 * Decompress zlib or gzip file on the calling worker.
+	 *
+	 * @param pContext - batch context.
+	 * @param srcFile - file to decompress.
+	 * @param dstFile - output file, nullptr to discard output (test).
+	 * @param srcCursor - page-cache cursor of input, can be null.
+	 * @param dstCursor - page-cache cursor of output, can be null.
+	 * @throws - can throw exception.
+	*/
+	void ZBatch::inflateWhole( Context & pContext, std::FILE *const srcFile, std::FILE *const dstFile, PageCacheCursor *const srcCursor, PageCacheCursor *const dstCursor )
+	{
+
+		// Return code
+		int zRet( Z_OK );
+
+		// Worker state
+		WorkerState & workerState( getWorkerState( pContext, true ) );
+		z_stream & zStream( workerState.inflateStream );
+
+		if ( inflateReset( &zStream ) != Z_OK )
+			throw std::runtime_error( "failed to reset inflate." );
+
+		zStream.avail_in = 0;
+
+		// Decompress, until the last member end
+		do
+		{
+
+			// Read
+			if ( zStream.avail_in == 0 )
+			{
+
+				zStream.avail_in = static_cast<uInt>( fread( workerState.inBuffer.data( ), sizeof( unsigned char ), workerState.inBuffer.size( ), srcFile ) );
+				zStream.next_in = workerState.inBuffer.data( );
+
+				// Check io errors
+				if ( ferror( srcFile ) )
+					throw std::runtime_error( "io error, can't read input file !" );
+
+				if ( srcCursor != nullptr )
+					srcCursor->advance( zStream.avail_in );
+
+				if ( zStream.avail_in == 0 )
+					throw std::runtime_error( "decompression (inflate) failed, unexpected end of file." );
+
+			}
+
+			// Decompress input
+			do
+			{
+
+				// Set output
+				zStream.next_out = workerState.outBuffer.data( );
+				zStream.avail_out = static_cast<uInt>( workerState.outBuffer.size( ) );
+
+				// Decompress
+				zRet = inflate( &zStream, Z_NO_FLUSH );
+
+				// Check inflate-status, Z_BUF_ERROR means more input required
+				switch ( zRet )
+				{
+
+				case Z_DATA_ERROR:
+					throw std::runtime_error( "decompression (inflate) failed, data corrupted." );
+
+				case Z_MEM_ERROR:
+					throw std::runtime_error( "decompression (inflate) failed, insufficent memory" );
+
+				case Z_NEED_DICT:
+					throw std::runtime_error( "decompression (inflate) failed, dictionary required." );
+
+				case Z_STREAM_ERROR:
+					throw std::runtime_error( "decompression (inflate) failed, stream structure inconsistent." );
+
+				}
+
+				// Write output, if not discarded
+				const std::size_t outCount( workerState.outBuffer.size( ) - zStream.avail_out );
+				if ( dstFile != nullptr && ( fwrite( workerState.outBuffer.data( ), sizeof( unsigned char ), outCount, dstFile ) != outCount || ferror( dstFile ) ) )
+					throw std::runtime_error( "io error, can't write output file !" );
+
+				if ( dstCursor != nullptr )
+					dstCursor->advance( outCount );
+
+			} while ( zRet != Z_STREAM_END && zStream.avail_out == 0 );
+
+			// gzip member end: continue with the next member, if any
+			if ( zRet == Z_STREAM_END )
+			{
+
+				if ( zStream.avail_in == 0 )
+				{
+
+					zStream.avail_in = static_cast<uInt>( fread( workerState.inBuffer.data( ), sizeof( unsigned char ), workerState.inBuffer.size( ), srcFile ) );
+					zStream.next_in = workerState.inBuffer.data( );
+
+					if ( srcCursor != nullptr )
+						srcCursor->advance( zStream.avail_in );
+
+				}
+
+				if ( zStream.avail_in > 0 )
+				{
+
+					if ( inflateReset( &zStream ) != Z_OK )
+						throw std::runtime_error( "failed to reset inflate." );
+
+					zRet = Z_OK;
+
+				}
+
+			}
+
+		} while ( zRet != Z_STREAM_END );
+
+	}
+
+	/*
+	 * Open files of item & process them.
+	 *
+	 * @param pContext - batch context.
+	 * @param pItem - item, receives status.
+	 * @param pSize - size of source file.
+	 * @param forInflate - true to decompress, compress otherwise.
+	*/
+	void ZBatch::processItem( Context & pContext, Item & pItem, const std::uint64_t pSize, const bool forInflate ) noexcept
+	{
+
+		// Guarded-Block
+		try
+		{
+
+			// Memory of split file blocks, waits while budget is exhausted
+			MemoryBudget::Lease blocksLease( pContext.budget, !forInflate && pSize >= pContext.splitSize ? ( pContext.maxBlocksInFlight + 2 ) * BLOCK_MEMORY_SIZE : 0 );
+
+			// Open files
+			std::unique_ptr<std::FILE, int(*)( std::FILE* )> srcFile( std::fopen( pItem.srcPath.c_str( ), "rb" ), &std::fclose );
+			if ( srcFile == nullptr )
+				throw std::runtime_error( "failed to open input-file" );
+
+			// No output, when only verified
+			std::unique_ptr<std::FILE, int(*)( std::FILE* )> dstFile( pContext.discardOutput ? nullptr : std::fopen( pItem.dstPath.c_str( ), "wb" ), &std::fclose );
+			if ( dstFile == nullptr && !pContext.discardOutput )
+				throw std::runtime_error( "failed to open output-file" );
+
+			// Page-cache cursors, no cursor for pipes & devices
+			std::unique_ptr<PageCacheCursor> srcCursor( pContext.cachePolite ? IOFactory::openCursor( srcFile.get( ), false ) : nullptr );
+			std::unique_ptr<PageCacheCursor> dstCursor( pContext.cachePolite && dstFile != nullptr ? IOFactory::openCursor( dstFile.get( ), true ) : nullptr );
+
+			// Process
+			if ( forInflate )
+				inflateWhole( pContext, srcFile.get( ), dstFile.get( ), srcCursor.get( ), dstCursor.get( ) );
+			else if ( pSize >= pContext.splitSize )
+				deflateSplit( pContext, srcFile.get( ), dstFile.get( ), srcCursor.get( ), dstCursor.get( ) );
+			else
+				deflateWhole( pContext, srcFile.get( ), dstFile.get( ), srcCursor.get( ), dstCursor.get( ) );
+
+			// Drop pages of input
+			if ( srcCursor != nullptr )
+				srcCursor->finish( );
+
+			// Write output to disk & drop it's pages
+			if ( dstCursor != nullptr )
+			{
+
+				if ( fflush( dstFile.get( ) ) != 0 )
+					throw std::runtime_error( "io error, can't write output file !" );
+
+				dstCursor->finish( );
+
+			}
+
+			// Flush & close output, to report write errors
+			if ( dstFile != nullptr && std::fclose( dstFile.release( ) ) != 0 )
+				throw std::runtime_error( "io error, can't write output file !" );
+
+			pItem.status = Z_OK;
+
+		}
+		catch ( const std::exception & pException )
+		{
+
+			// Print ERROR-message
+			std::cout << "ZBatch - error: file#" << pItem.srcPath << ", " << pException.what( ) << std::endl;
+
+			pItem.status = Z_ERRNO;
+
+		}
+
+	}
+
+	/*
+	 * Run batch: schedule items largest first & wait.
+	 *
+	 * @param pItems - files, receive status.
+	 * @param pContext - batch context, without pool.
+	 * @param threadsCount - number of worker-threads, 0 to use all hardware-threads.
+	 * @param forInflate - true to decompress, compress otherwise.
+	 * @return - Z_OK if all files complete, Z_ERRNO otherwise.
+	*/
+	int ZBatch::run( std::vector<Item> & pItems, Context & pContext, const std::uint32_t threadsCount, const bool forInflate )
+	{
+
+		// Size of each file, 0 if not available (open fails later & reports error)
+		std::vector<std::pair<std::uint64_t, std::size_t>> itemsOrder;
+		itemsOrder.reserve( pItems.size( ) );
+
+		for ( std::size_t itemIndex = 0; itemIndex < pItems.size( ); itemIndex++ )
+		{
+
+			std::error_code errorCode;
+			const std::uintmax_t fileSize( std::filesystem::file_size( pItems[itemIndex].srcPath, errorCode ) );
+
+			itemsOrder.emplace_back( errorCode ? 0 : static_cast<std::uint64_t>( fileSize ), itemIndex );
+			pItems[itemIndex].size = itemsOrder.back( ).first;
+			pItems[itemIndex].status = Z_ERRNO;
+
+		}
+
+		// Largest first, so the long jobs start early
+		std::stable_sort( itemsOrder.begin( ), itemsOrder.end( ), []( const std::pair<std::uint64_t, std::size_t> & a, const std::pair<std::uint64_t, std::size_t> & b ) { return( a.first > b.first ); } );
+
+		// Streams settings, that fit into memory budget
+		const MemoryBudget::Plan streamsPlan( pContext.budget != nullptr ? pContext.budget->plan( threadsCount, BUFFER_SIZE, forInflate )
+			: MemoryBudget::Plan{ threadsCount, BUFFER_SIZE, MAX_WBITS, MemoryBudget::DEFAULT_MEM_LEVEL } );
+
+		pContext.bufferSize = streamsPlan.bufferSize;
+		pContext.windowBits = streamsPlan.windowBits;
+		pContext.memLevel = streamsPlan.memLevel;
+
+		// Memory of worker streams, released after streams
+		std::unique_ptr<MemoryBudget::Lease> workersLease;
+
+		// Guarded-Block
+		try
+		{
+
+			// Worker-threads, joined before worker states are released
+			WorkStealingPool workersPool( streamsPlan.threadsCount );
+			pContext.pool = &workersPool;
+			pContext.workers.resize( workersPool.getThreadsCount( ) );
+
+			// Reserve worker streams, rest of budget is shared by split files
+			workersLease = std::make_unique<MemoryBudget::Lease>( pContext.budget, MemoryBudget::getStreamSize( streamsPlan, forInflate ) * workersPool.getThreadsCount( ) );
+
+			pContext.maxBlocksInFlight = workersPool.getThreadsCount( ) * 2;
+			if ( pContext.budget != nullptr )
+			{
+
+				// Split needs 1 block in flight, 1 being read & 1 being written
+				const std::uint64_t budgetBlocks( pContext.budget->getAvailable( ) / BLOCK_MEMORY_SIZE );
+
+				if ( budgetBlocks < 3 )
+					pContext.splitSize = UINT64_MAX;
+				else
+					pContext.maxBlocksInFlight = std::min<std::size_t>( pContext.maxBlocksInFlight, static_cast<std::size_t>( budgetBlocks - 2 ) );
+
+			}
+
+			for ( WorkerState & workerState : pContext.workers )
+			{
+				workerState.deflateInitialized = false;
+				workerState.inflateInitialized = false;
+			}
+
+			// Submit files
+			std::vector<std::future<void>> itemsFutures;
+			itemsFutures.reserve( itemsOrder.size( ) );
+
+			for ( const std::pair<std::uint64_t, std::size_t> & itemOrder : itemsOrder )
+			{
+				Item & item( pItems[itemOrder.second] );
+				const std::uint64_t itemSize( itemOrder.first );
+				itemsFutures.emplace_back( workersPool.submit( [&pContext, &item, itemSize, forInflate]( ) { processItem( pContext, item, itemSize, forInflate ); } ) );
+			}
+
+			// Wait
+			for ( std::future<void> & itemFuture : itemsFutures )
+				itemFuture.wait( );
+
+		}
+		catch ( const std::exception & pException )
+		{
+
+			// Print ERROR-message
+			std::cout << "ZBatch::run - error: " << pException.what( ) << std::endl;
+
+		}
+
+		// Release streams
+		for ( WorkerState & workerState : pContext.workers )
+		{
+
+			if ( workerState.deflateInitialized )
+				deflateEnd( &workerState.deflateStream );
+
+			if ( workerState.inflateInitialized )
+				inflateEnd( &workerState.inflateStream );
+
+		}
+
+		pContext.pool = nullptr;
+		pContext.workers.clear( );
+		workersLease.reset( );
+
+		// Complete, if all files complete
+		for ( const Item & item : pItems )
+			if ( item.status != Z_OK )
+				return( Z_ERRNO );
+
+		return( Z_OK );
+
+	}
+
+	/*
+	 * Compress files as zlib or gzip on multiple threads.
+	 *
+	 * @thread_safety - not thread-safe.
+	 * @param pItems - files to compress, receive status.
+	 * @param compressionLevel - Compression-Level to use, must be in range 0-9.
+	 * @param threadsCount - number of worker-threads, 0 to use all hardware-threads.
+	 * @param format - stream format.
+	 * @param splitSize - size of file, from which it is compressed on multiple workers.
+	 * @param cachePolite - true to drop pages of files behind the cursor, so page-cache of other processes is kept.
+	 * @param pBudget - memory budget: limits workers, their buffers & deflate memory, split files wait for memory. Null for no limit.
+	 * @return - Z_OK if all files compressed, Z_ERRNO otherwise.
+	*/
+	int ZBatch::deflateFiles( std::vector<Item> & pItems, const int compressionLevel, const std::uint32_t threadsCount, const ZFormat format, const std::uint64_t splitSize, const bool cachePolite, MemoryBudget *const pBudget )
+	{
+
+		// Check arguments
+		if ( compressionLevel < Z_DEFAULT_COMPRESSION || compressionLevel > Z_BEST_COMPRESSION )
+		{
+
+			// Print ERROR-message
+			std::cout << "ZBatch::deflateFiles - error: wrong compression level" << std::endl;
+
+			// Return ERROR
+			return( Z_ERRNO );
+
+		}
+
+		// Context
+		Context batchContext;
+		batchContext.pool = nullptr;
+		batchContext.compressionLevel = compressionLevel;
+		batchContext.format = format;
+		batchContext.splitSize = splitSize > BLOCK_SIZE ? splitSize : BLOCK_SIZE;
+		batchContext.discardOutput = false;
+		batchContext.cachePolite = cachePolite;
+		batchContext.budget = pBudget;
+
+		// Run
+		return( run( pItems, batchContext, threadsCount, false ) );
+
+	}
+
+	/*
+	 * Decompress zlib or gzip files on multiple threads, each file on one worker.
+	 *
+	 * @thread_safety - not thread-safe.
+	 * @param pItems - files to decompress, receive status.
+	 * @param threadsCount - number of worker-threads, 0 to use all hardware-threads.
+	 * @param cachePolite - true to drop pages of files behind the cursor, so page-cache of other processes is kept.
+	 * @param pBudget - memory budget: limits workers & their buffers. Null for no limit.
+	 * @return - Z_OK if all files decompressed, Z_ERRNO otherwise.
+	*/
+	int ZBatch::inflateFiles( std::vector<Item> & pItems, const std::uint32_t threadsCount, const bool cachePolite, MemoryBudget *const pBudget )
+	{
+
+		// Context
+		Context batchContext;
+		batchContext.pool = nullptr;
+		batchContext.compressionLevel = Z_DEFAULT_COMPRESSION;
+		batchContext.format = ZFormat::GZIP;
+		batchContext.splitSize = UINT64_MAX;
+		batchContext.discardOutput = false;
+		batchContext.cachePolite = cachePolite;
+		batchContext.budget = pBudget;
+
+		// Run
+		return( run( pItems, batchContext, threadsCount, true ) );
+
+	}
+
+	/*
+	 * Verify zlib or gzip files on multiple threads: inflate without
+	 * output, so stream structure & trailer checksums are checked.
+	 *
+	 * @thread_safety - not thread-safe.
+	 * @param pItems - files to verify (dstPath is not used), receive status.
+	 * @param threadsCount - number of worker-threads, 0 to use all hardware-threads.
+	 * @param cachePolite - true to drop pages of files behind the cursor, so page-cache of other processes is kept.
+	 * @param pBudget - memory budget: limits workers & their buffers. Null for no limit.
+	 * @return - Z_OK if all files are intact, Z_ERRNO otherwise.
+	*/
+	int ZBatch::testFiles( std::vector<Item> & pItems, const std::uint32_t threadsCount, const bool cachePolite, MemoryBudget *const pBudget )
+	{
+
+		// Context
+		Context batchContext;
+		batchContext.pool = nullptr;
+		batchContext.compressionLevel = Z_DEFAULT_COMPRESSION;
+		batchContext.format = ZFormat::GZIP;
+		batchContext.splitSize = UINT64_MAX;
+		batchContext.discardOutput = true;
+		batchContext.cachePolite = cachePolite;
+		batchContext.budget = pBudget;
+
+		// Run
+		return( run( pItems, batchContext, threadsCount, true ) );
+
+	}
+
+	// -------------------------------------------------------- \\
+
+}
\ No newline at end of file
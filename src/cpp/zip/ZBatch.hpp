@@ -0,0 +1,376 @@
+/*
+* Copyright  2018 Denis Zyamaev (code4un@yandex.ru) All rights reserved.
+* Authors: Denis Zyamaev (code4un@yandex.ru)
+* All rights reserved.
+* API: C++ 11
+* License: see LICENSE.txt
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+* 1. Redistributions of source code must retain the above copyright notice,
+* this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must display the names 'Denis Zyamaev' and
+* in the credits of the application, if such credits exist.
+* The authors of this work must be notified via email (code4un@yandex.ru) in
+* this case of redistribution.
+* 3. Neither the name of copyright holders nor the names of its contributors
+* may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS
+* IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+* PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+// Include 'pch_cxx'
+#include "../pch_cxx.hpp"
+
+// Include WorkStealingPool
+#include "../core/WorkStealingPool.hpp"
+
+// Include ZFormat
+#include "ZFormat.hpp"
+
+// Include ZArena
+#include "ZArena.hpp"
+
+// Include PageCacheCursor
+#include "../io/PageCacheCursor.hpp"
+
+// Include MemoryBudget
+#include "../core/MemoryBudget.hpp"
+
+namespace c0de4un
+{
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Types
+	// ===========================================================
+
+	/*
+	  * ZBatch - compression, decompression & verification of many files
+	  * on one work-stealing pool.
+	  *
+	  * Files are scheduled largest first, so the longest jobs don't end
+	  * up in the tail. Each worker keeps its own z_stream & buffers, reset
+	  * between files. Files larger than split-size are compressed as
+	  * blocks (pigz-style, see ZParallelDeflate): the file's task submits
+	  * blocks as sub-tasks, so idle workers steal them.
+	  *
+	  * Output of a split file is a single zlib or gzip stream, the same
+	  * as ZParallelDeflate::deflateFILE writes.
+	  *
+	  * @language C++ 17
+	  *
+	  * @authors Z. Denis (c0de4un@yandex.ru)
+	  * @version 1.0
+	 */
+	class ZBatch final
+	{
+
+	public:
+
+		// -------------------------------------------------------- \\
+
+		// ===========================================================
+		// Types
+		// ===========================================================
+
+		/* File of batch */
+		struct Item final
+		{
+
+			/* Source file path */
+			std::string srcPath;
+
+			/* Output file path */
+			std::string dstPath;
+
+			/* Result: Z_OK if complete, Z_ERRNO otherwise */
+			int status;
+
+			/* Result: size of source file */
+			std::uint64_t size;
+
+		};
+
+		// ===========================================================
+		// Constants
+		// ===========================================================
+
+		/* Default size of file, from which it is compressed as blocks on multiple workers */
+		static constexpr std::uint64_t DEFAULT_SPLIT_SIZE = 16777216;
+
+		// -------------------------------------------------------- \\
+
+	private:
+
+		// -------------------------------------------------------- \\
+
+		// ===========================================================
+		// Types
+		// ===========================================================
+
+		/* Reusable state of worker */
+		struct WorkerState final
+		{
+
+			/* Raw deflate stream */
+			z_stream deflateStream;
+
+			/* true, if deflate initialized */
+			bool deflateInitialized;
+
+			/* Inflate stream, zlib or gzip */
+			z_stream inflateStream;
+
+			/* true, if inflate initialized */
+			bool inflateInitialized;
+
+			/* Input-buffer */
+			std::vector<unsigned char> inBuffer;
+
+			/* Output-buffer */
+			std::vector<unsigned char> outBuffer;
+
+			/* Allocator of streams. Owned by state, not by thread: streams are ended after workers are joined */
+			std::unique_ptr<ZArena> arena;
+
+		};
+
+		/* Block of split file & it's compressed output */
+		struct Block final
+		{
+
+			/* Uncompressed data */
+			std::vector<unsigned char> input;
+
+			/* Preset dictionary (tail of the previous block), can be empty */
+			std::vector<unsigned char> dictionary;
+
+			/* Compressed data */
+			std::vector<unsigned char> output;
+
+			/* Check-value of input */
+			uLong check;
+
+			/* true, if this is the last block of the stream */
+			bool last;
+
+		};
+
+		/* Batch settings & per-worker state */
+		struct Context final
+		{
+
+			/* Worker-threads */
+			WorkStealingPool * pool;
+
+			/* State of each worker */
+			std::vector<WorkerState> workers;
+
+			/* Compression-Level */
+			int compressionLevel;
+
+			/* Stream format */
+			ZFormat format;
+
+			/* Size of file, from which it is split */
+			std::uint64_t splitSize;
+
+			/* true, if decompressed output is not written (test) */
+			bool discardOutput;
+
+			/* true, if pages of files are dropped behind the cursor (see PageCacheCursor) */
+			bool cachePolite;
+
+			/* Memory budget, null for no limit */
+			MemoryBudget * budget;
+
+			/* Size of worker buffers */
+			std::uint32_t bufferSize;
+
+			/* deflateInit2 window-bits */
+			int windowBits;
+
+			/* deflateInit2 mem-level */
+			int memLevel;
+
+			/* Max number of blocks of split file, read & not written yet */
+			std::size_t maxBlocksInFlight;
+
+		};
+
+		// ===========================================================
+		// Constants
+		// ===========================================================
+
+		/* Default size of worker buffers */
+		static constexpr std::uint32_t BUFFER_SIZE = 262144;
+
+		/* Size of uncompressed block of split file */
+		static constexpr std::size_t BLOCK_SIZE = 1048576;
+
+		/* Size of the deflate window (preset dictionary) */
+		static constexpr std::size_t DICTIONARY_SIZE = 32768;
+
+		/* Memory of block in flight: input, dictionary & output (deflateBound & headroom) */
+		static constexpr std::uint64_t BLOCK_MEMORY_SIZE = BLOCK_SIZE * 2 + DICTIONARY_SIZE + 65536;
+
+		// ===========================================================
+		// Methods
+		// ===========================================================
+
+		/*
+		 * Returns state of the calling worker, initializes deflate or inflate on first use.
+		 *
+		 * @thread_safety - thread-safe, for worker-threads of context.
+		 * @param pContext - batch context.
+		 * @param forInflate - true to initialize inflate, deflate otherwise.
+		 * @throws - can throw exception.
+		*/
+		static WorkerState & getWorkerState( Context & pContext, const bool forInflate );
+
+		/*
+		 * Compress file as one stream on the calling worker.
+		 *
+		 * @param pContext - batch context.
+		 * @param srcFile - file to compress.
+		 * @param dstFile - output file.
+		 * @param srcCursor - page-cache cursor of input, can be null.
+		 * @param dstCursor - page-cache cursor of output, can be null.
+		 * @throws - can throw exception.
+		*/
+		static void deflateWhole( Context & pContext, std::FILE *const srcFile, std::FILE *const dstFile, PageCacheCursor *const srcCursor, PageCacheCursor *const dstCursor );
+
+		/*
+		 * Compress block into raw deflate on the calling worker.
+		 *
+		 * @param pContext - batch context.
+		 * @param pBlock - block to compress.
+		 * @throws - can throw exception.
+		*/
+		static void deflateBlock( Context & pContext, Block & pBlock );
+
+		/*
+		 * Compress file as blocks, that are compressed on any worker.
+		 *
+		 * @param pContext - batch context.
+		 * @param srcFile - file to compress.
+		 * @param dstFile - output file.
+		 * @param srcCursor - page-cache cursor of input, can be null.
+		 * @param dstCursor - page-cache cursor of output, can be null.
+		 * @throws - can throw exception.
+		*/
+		static void deflateSplit( Context & pContext, std::FILE *const srcFile, std::FILE *const dstFile, PageCacheCursor *const srcCursor, PageCacheCursor *const dstCursor );
+
+		/*
+		 * Decompress zlib or gzip file on the calling worker.
+		 *
+		 * @param pContext - batch context.
+		 * @param srcFile - file to decompress.
+		 * @param dstFile - output file, nullptr to discard output (test).
+		 * @param srcCursor - page-cache cursor of input, can be null.
+		 * @param dstCursor - page-cache cursor of output, can be null.
+		 * @throws - can throw exception.
+		*/
+		static void inflateWhole( Context & pContext, std::FILE *const srcFile, std::FILE *const dstFile, PageCacheCursor *const srcCursor, PageCacheCursor *const dstCursor );
+
+		/*
+		 * Open files of item & process them.
+		 *
+		 * @param pContext - batch context.
+		 * @param pItem - item, receives status.
+		 * @param pSize - size of source file.
+		 * @param forInflate - true to decompress, compress otherwise.
+		*/
+		static void processItem( Context & pContext, Item & pItem, const std::uint64_t pSize, const bool forInflate ) noexcept;
+
+		/*
+		 * Run batch: schedule items largest first & wait.
+		 *
+		 * @param pItems - files, receive status.
+		 * @param pContext - batch context, without pool.
+		 * @param threadsCount - number of worker-threads, 0 to use all hardware-threads.
+		 * @param forInflate - true to decompress, compress otherwise.
+		 * @return - Z_OK if all files complete, Z_ERRNO otherwise.
+		*/
+		static int run( std::vector<Item> & pItems, Context & pContext, const std::uint32_t threadsCount, const bool forInflate );
+
+		// -------------------------------------------------------- \\
+
+	public:
+
+		// -------------------------------------------------------- \\
+
+		// ===========================================================
+		// Constructor & destructor
+		// ===========================================================
+
+		/* @deleted ZBatch constructor, only static methods */
+		ZBatch( ) = delete;
+
+		// ===========================================================
+		// Methods
+		// ===========================================================
+
+		/*
+		 * Compress files as zlib or gzip on multiple threads.
+		 *
+		 * @thread_safety - not thread-safe.
+		 * @param pItems - files to compress, receive status.
+		 * @param compressionLevel - Compression-Level to use, must be in range 0-9.
+		 * @param threadsCount - number of worker-threads, 0 to use all hardware-threads.
+		 * @param format - stream format.
+		 * @param splitSize - size of file, from which it is compressed on multiple workers.
+		 * @param cachePolite - true to drop pages of files behind the cursor, so page-cache of other processes is kept.
+		 * @param pBudget - memory budget: limits workers, their buffers & deflate memory, split files wait for memory. Null for no limit.
+		 * @return - Z_OK if all files compressed, Z_ERRNO otherwise.
+		*/
+		static int deflateFiles( std::vector<Item> & pItems, const int compressionLevel, const std::uint32_t threadsCount = 0, const ZFormat format = ZFormat::GZIP, const std::uint64_t splitSize = DEFAULT_SPLIT_SIZE, const bool cachePolite = false, MemoryBudget *const pBudget = nullptr );
+
+		/*
+		 * Decompress zlib or gzip files on multiple threads, each file on one worker.
+		 *
+		 * @thread_safety - not thread-safe.
+		 * @param pItems - files to decompress, receive status.
+		 * @param threadsCount - number of worker-threads, 0 to use all hardware-threads.
+		 * @param cachePolite - true to drop pages of files behind the cursor, so page-cache of other processes is kept.
+		 * @param pBudget - memory budget: limits workers & their buffers. Null for no limit.
+		 * @return - Z_OK if all files decompressed, Z_ERRNO otherwise.
+		*/
+		static int inflateFiles( std::vector<Item> & pItems, const std::uint32_t threadsCount = 0, const bool cachePolite = false, MemoryBudget *const pBudget = nullptr );
+
+		/*
+		 * Verify zlib or gzip files on multiple threads: inflate without
+		 * output, so stream structure & trailer checksums are checked.
+		 *
+		 * @thread_safety - not thread-safe.
+		 * @param pItems - files to verify (dstPath is not used), receive status.
+		 * @param threadsCount - number of worker-threads, 0 to use all hardware-threads.
+		 * @param cachePolite - true to drop pages of files behind the cursor, so page-cache of other processes is kept.
+		 * @param pBudget - memory budget: limits workers & their buffers. Null for no limit.
+		 * @return - Z_OK if all files are intact, Z_ERRNO otherwise.
+		*/
+		static int testFiles( std::vector<Item> & pItems, const std::uint32_t threadsCount = 0, const bool cachePolite = false, MemoryBudget *const pBudget = nullptr );
+
+		// -------------------------------------------------------- \\
+
+	};
+
+	// -------------------------------------------------------- \\
+
+}
\ No newline at end of file
@@ -0,0 +1,632 @@
+/*
+* Copyright  2018 Denis Zyamaev (code4un@yandex.ru) All rights reserved.
+* Authors: Denis Zyamaev (code4un@yandex.ru)
+* All rights reserved.
+* API: C++ 11
+* License: see LICENSE.txt
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+* 1. Redistributions of source code must retain the above copyright notice,
+* this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must display the names 'Denis Zyamaev' and
+* in the credits of the application, if such credits exist.
+* The authors of this work must be notified via email (code4un@yandex.ru) in
+* this case of redistribution.
+* 3. Neither the name of copyright holders nor the names of its contributors
+* may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS
+* IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+* PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// HEADER
+#include "ZBgzf.hpp"
+
+// Include ZArena
+#include "ZArena.hpp"
+
+// Include FileUtils
+#include "../io/FileUtils.hpp"
+
+namespace c0de4un
+{
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Methods
+	// ===========================================================
+
+	/*
+	 * Returns virtual offset.
+	 *
+	 * @param blockOffset - offset of member in compressed file, less than 2^48.
+	 * @param inBlockOffset - offset in uncompressed data of the member.
+	*/
+	std::uint64_t ZBgzf::makeVirtualOffset( const std::uint64_t blockOffset, const std::uint32_t inBlockOffset ) noexcept
+	{ return( ( blockOffset << 16 ) | ( inBlockOffset & 0xFFFF ) ); }
+
+	/*
+	 * Compress chunk input into members.
+	 *
+	 * @thread_safety - thread-safe, if chunk not shared.
+	 * @param pChunk - chunk to compress.
+	 * @param compressionLevel - Compression-Level to use, must be in range 0-9.
+	 * @throws - can throw exception.
+	*/
+	void ZBgzf::deflateChunk( Chunk & pChunk, const int compressionLevel )
+	{
+
+		// Return code
+		int zRet( 0 );
+
+		// z_stream
+		z_stream zStream;
+
+		// Allocate z_stream state from the thread's arena
+		ZArena::getThreadArena( ).attach( zStream );
+
+		// Initialize raw deflate, member header & trailer are written here
+		if ( deflateInit2( &zStream, compressionLevel, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY ) != Z_OK )
+			throw std::runtime_error( "ZBgzf::deflateChunk - failed to initialize deflate." );
+
+		// Guarded-Block
+		try
+		{
+
+			// Number of members
+			const std::size_t blocksCount( ( pChunk.input.size( ) + MAX_INPUT_SIZE - 1 ) / MAX_INPUT_SIZE );
+
+			// Number of compressed bytes
+			std::size_t outCount( 0 );
+
+			// Allocate output, member is never larger
+			pChunk.output.resize( blocksCount * MAX_BLOCK_SIZE );
+
+			for ( std::size_t blockIndex = 0; blockIndex < blocksCount; blockIndex++ )
+			{
+
+				// Uncompressed data of member
+				const unsigned char *const inData( pChunk.input.data( ) + blockIndex * MAX_INPUT_SIZE );
+				const std::size_t inSize( std::min<std::size_t>( pChunk.input.size( ) - blockIndex * MAX_INPUT_SIZE, MAX_INPUT_SIZE ) );
+
+				// Member
+				unsigned char *const blockData( pChunk.output.data( ) + outCount );
+
+				// Reset stream, members are independent
+				if ( deflateReset( &zStream ) != Z_OK )
+					throw std::runtime_error( "ZBgzf::deflateChunk - failed to reset deflate." );
+
+				// Set input
+				zStream.next_in = const_cast<Bytef*>( inData );
+				zStream.avail_in = static_cast<uInt>( inSize );
+
+				// Set output, space left for header & trailer
+				zStream.next_out = blockData + HEADER_SIZE;
+				zStream.avail_out = static_cast<uInt>( MAX_BLOCK_SIZE - HEADER_SIZE - TRAILER_SIZE );
+
+				// Compress
+				zRet = deflate( &zStream, Z_FINISH );
+
+				// Check compression result-status.
+				if ( zRet == Z_STREAM_ERROR )
+					throw std::runtime_error( "ZBgzf::deflateChunk - compression failed, stream error" );
+
+				// Size of deflate data
+				std::size_t dataSize( static_cast<std::size_t>( zStream.total_out ) );
+
+				// Incompressible data does not fit into member, stored as is
+				if ( zRet != Z_STREAM_END )
+				{
+
+					// Final stored block: flag, length & one's complement, little-endian
+					blockData[HEADER_SIZE] = 0x01;
+					blockData[HEADER_SIZE + 1] = static_cast<unsigned char>( inSize & 0xFF );
+					blockData[HEADER_SIZE + 2] = static_cast<unsigned char>( inSize >> 8 );
+					blockData[HEADER_SIZE + 3] = static_cast<unsigned char>( ~inSize & 0xFF );
+					blockData[HEADER_SIZE + 4] = static_cast<unsigned char>( ( ~inSize >> 8 ) & 0xFF );
+
+					// Data
+					std::memcpy( blockData + HEADER_SIZE + STORED_HEADER_SIZE, inData, inSize );
+					dataSize = STORED_HEADER_SIZE + inSize;
+
+				}
+
+				// Size of member
+				const std::size_t blockSize( HEADER_SIZE + dataSize + TRAILER_SIZE );
+
+				// Header bytes: magic, deflate, flags (FEXTRA), mtime, extra-flags, OS (unknown), extra-field length, 'B','C' subfield with BSIZE
+				const unsigned char headerBytes[HEADER_SIZE] = { 0x1F, 0x8B, Z_DEFLATED, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF, 0x06, 0x00, 'B', 'C', 0x02, 0x00,
+					static_cast<unsigned char>( ( blockSize - 1 ) & 0xFF ), static_cast<unsigned char>( ( blockSize - 1 ) >> 8 ) };
+
+				std::memcpy( blockData, headerBytes, HEADER_SIZE );
+
+				// CRC-32
+				const uLong crc( crc32( crc32( 0L, Z_NULL, 0 ), inData, static_cast<uInt>( inSize ) ) );
+
+				// Trailer: CRC-32 & input size, little-endian
+				for ( std::size_t i = 0; i < 4; i++ )
+				{
+					blockData[HEADER_SIZE + dataSize + i] = static_cast<unsigned char>( ( crc >> ( i * 8 ) ) & 0xFF );
+					blockData[HEADER_SIZE + dataSize + 4 + i] = static_cast<unsigned char>( ( inSize >> ( i * 8 ) ) & 0xFF );
+				}
+
+				// Count
+				outCount += blockSize;
+
+			}
+
+			// Cut output
+			pChunk.output.resize( outCount );
+
+		}
+		catch ( ... )
+		{
+
+			// Release z_stream resources
+			deflateEnd( &zStream );
+
+			// Rethrow
+			throw;
+
+		}
+
+		// Release z_stream resources
+		deflateEnd( &zStream );
+
+	}
+
+	/*
+	 * Compress the given file as BGZF on multiple threads.
+	 *
+	 * @thread_safety - not thread-safe.
+	 * @param srcFile - file to compress.
+	 * @param dstFile - output file.
+	 * @param compressionLevel - Compression-Level to use, must be in range 0-9.
+	 * @param threadsCount - number of worker-threads, 0 to use all hardware-threads.
+	 * @throws - can throw exception.
+	*/
+	void ZBgzf::deflateChunks( std::FILE *const srcFile, std::FILE *const dstFile, const int compressionLevel, const std::uint32_t threadsCount )
+	{
+
+		// Worker-threads
+		ThreadPool threadPool( threadsCount );
+
+		// Max number of chunks read & not written yet, limits memory usage
+		const std::size_t maxChunksInFlight( threadPool.getThreadsCount( ) * 2 );
+
+		// Chunks in output order
+		std::deque<std::pair<std::shared_ptr<Chunk>, std::future<void>>> chunksInFlight;
+
+		// Size of chunk input
+		const std::size_t chunkSize( static_cast<std::size_t>( MAX_INPUT_SIZE ) * BLOCKS_PER_CHUNK );
+
+		// true, if input-file is fully read
+		bool inputEnd( false );
+
+		// Read & compress chunks
+		while ( !inputEnd || !chunksInFlight.empty( ) )
+		{
+
+			// Read next chunk
+			if ( !inputEnd )
+			{
+
+				// Read
+				std::shared_ptr<Chunk> readChunk( std::make_shared<Chunk>( ) );
+				readChunk->input.resize( chunkSize );
+				const std::size_t readCount( fread( readChunk->input.data( ), sizeof( unsigned char ), chunkSize, srcFile ) );
+				readChunk->input.resize( readCount );
+
+				// Check io errors
+				if ( ferror( srcFile ) )
+					throw std::runtime_error( "ZBgzf::deflateFILE - io error, can't read input file !" );
+
+				// Check end of input
+				inputEnd = readCount < chunkSize;
+
+				// Compress on worker-thread
+				if ( readCount > 0 )
+					chunksInFlight.emplace_back( readChunk, threadPool.submit( [readChunk, compressionLevel]( ) { deflateChunk( *readChunk, compressionLevel ); } ) );
+
+			}
+
+			// Write compressed chunks in order
+			while ( !chunksInFlight.empty( ) && ( chunksInFlight.size( ) >= maxChunksInFlight || inputEnd ) )
+			{
+
+				// Oldest chunk
+				std::shared_ptr<Chunk> & writeChunk( chunksInFlight.front( ).first );
+
+				// Wait, rethrows worker exception
+				chunksInFlight.front( ).second.get( );
+
+				// Write members
+				if ( fwrite( writeChunk->output.data( ), sizeof( unsigned char ), writeChunk->output.size( ), dstFile ) != writeChunk->output.size( ) || ferror( dstFile ) )
+					throw std::runtime_error( "ZBgzf::deflateFILE - failed to write output file" );
+
+				// Release chunk
+				chunksInFlight.pop_front( );
+
+			}
+
+		}
+
+		// Write EOF-member
+		if ( fwrite( EOF_BLOCK, sizeof( unsigned char ), sizeof( EOF_BLOCK ), dstFile ) != sizeof( EOF_BLOCK ) || ferror( dstFile ) )
+			throw std::runtime_error( "ZBgzf::deflateFILE - failed to write output file" );
+
+	}
+
+	/*
+	 * Returns member size (BSIZE + 1) from 'B','C' subfield, 0 if not found.
+	 *
+	 * @param pHeader - gzip-header with extra-field.
+	 * @param headerSize - size of header with extra-field.
+	*/
+	std::size_t ZBgzf::findBlockSize( const unsigned char *const pHeader, const std::size_t headerSize ) noexcept
+	{
+
+		// Subfields: ID, length (2), data
+		std::size_t blockSize( 0 );
+		for ( std::size_t fieldOffset = GZIP_HEADER_SIZE; fieldOffset + 4 <= headerSize; )
+		{
+
+			const unsigned char *const fieldData( pHeader + fieldOffset );
+			const std::size_t fieldSize( fieldData[2] | ( fieldData[3] << 8 ) );
+
+			if ( fieldData[0] == 'B' && fieldData[1] == 'C' && fieldSize == 2 && fieldOffset + 6 <= headerSize )
+				blockSize = static_cast<std::size_t>( fieldData[4] | ( fieldData[5] << 8 ) ) + 1;
+
+			fieldOffset += 4 + fieldSize;
+
+		}
+
+		// Return
+		return( blockSize );
+
+	}
+
+	/*
+	 * Decompress members, starting from virtual offset.
+	 *
+	 * @thread_safety - not thread-safe.
+	 * @param srcFile - BGZF file, must be seekable.
+	 * @param pOutput - receives decompressed data.
+	 * @param virtualOffset - virtual offset to start from.
+	 * @param length - number of bytes to decompress, cut at the end of data.
+	 * @throws - can throw exception.
+	*/
+	void ZBgzf::inflateBlocks( std::FILE *const srcFile, OutputSink & pOutput, const std::uint64_t virtualOffset, const std::uint64_t length )
+	{
+
+		// Member buffer
+		std::vector<unsigned char> inBuffer( MAX_BLOCK_SIZE );
+
+		// Uncompressed data of member
+		std::vector<unsigned char> outBuffer( MAX_BLOCK_SIZE );
+
+		// Uncompressed bytes to skip in the first member
+		std::uint64_t skipCount( virtualOffset & 0xFFFF );
+
+		// Uncompressed bytes to write
+		std::uint64_t leftCount( length );
+
+		// z_stream
+		z_stream zStream;
+
+		// Set z_stream state
+		zStream.zalloc = Z_NULL;
+		zStream.zfree = Z_NULL;
+		zStream.opaque = Z_NULL;
+		zStream.avail_in = 0;
+		zStream.next_in = Z_NULL;
+
+		// Initialize raw inflate, member header & trailer are checked here
+		if ( inflateInit2( &zStream, -MAX_WBITS ) != Z_OK )
+			throw std::runtime_error( "failed to initialize decompression stream." );
+
+		// Guarded-Block
+		try
+		{
+
+			// Seek to member
+			FileUtils::seek( srcFile, virtualOffset >> 16 );
+
+			// Decompress members, until range written or end of file
+			while ( leftCount > 0 )
+			{
+
+				// Read gzip-header
+				const std::size_t headerCount( fread( inBuffer.data( ), sizeof( unsigned char ), GZIP_HEADER_SIZE, srcFile ) );
+
+				if ( ferror( srcFile ) )
+					throw std::runtime_error( "io error, can't read input file !" );
+
+				// End of file
+				if ( headerCount == 0 )
+					break;
+
+				// Check magic, method & flags: FEXTRA only
+				if ( headerCount < GZIP_HEADER_SIZE || inBuffer[0] != 0x1F || inBuffer[1] != 0x8B || inBuffer[2] != Z_DEFLATED || ( inBuffer[3] & 0x1E ) != 0x04 )
+					throw std::runtime_error( "not a BGZF member." );
+
+				// Size of header with extra-field
+				const std::size_t headerSize( GZIP_HEADER_SIZE + ( inBuffer[10] | ( inBuffer[11] << 8 ) ) );
+
+				if ( headerSize + TRAILER_SIZE > MAX_BLOCK_SIZE )
+					throw std::runtime_error( "not a BGZF member, extra-field too large." );
+
+				// Read extra-field
+				if ( fread( inBuffer.data( ) + GZIP_HEADER_SIZE, sizeof( unsigned char ), headerSize - GZIP_HEADER_SIZE, srcFile ) != headerSize - GZIP_HEADER_SIZE )
+					throw std::runtime_error( "decompression (inflate) failed, unexpected end of file." );
+
+				// Find 'B','C' subfield
+				const std::size_t blockSize( findBlockSize( inBuffer.data( ), headerSize ) );
+
+				if ( blockSize < headerSize + TRAILER_SIZE )
+					throw std::runtime_error( "not a BGZF member, block size missing." );
+
+				// Read deflate data & trailer
+				if ( fread( inBuffer.data( ) + headerSize, sizeof( unsigned char ), blockSize - headerSize, srcFile ) != blockSize - headerSize )
+					throw std::runtime_error( "decompression (inflate) failed, unexpected end of file." );
+
+				// Trailer: CRC-32 & input size, little-endian
+				const unsigned char *const trailerData( inBuffer.data( ) + blockSize - TRAILER_SIZE );
+				uLong blockCRC( 0 );
+				std::uint64_t inputSize( 0 );
+				for ( std::size_t i = 0; i < 4; i++ )
+				{
+					blockCRC |= static_cast<uLong>( trailerData[i] ) << ( i * 8 );
+					inputSize |= static_cast<std::uint64_t>( trailerData[4 + i] ) << ( i * 8 );
+				}
+
+				if ( inputSize > MAX_BLOCK_SIZE )
+					throw std::runtime_error( "not a BGZF member, input size too large." );
+
+				// Reset stream, members are independent
+				if ( inflateReset( &zStream ) != Z_OK )
+					throw std::runtime_error( "failed to reset inflate." );
+
+				// Set input & output
+				zStream.next_in = inBuffer.data( ) + headerSize;
+				zStream.avail_in = static_cast<uInt>( blockSize - headerSize - TRAILER_SIZE );
+				zStream.next_out = outBuffer.data( );
+				zStream.avail_out = static_cast<uInt>( outBuffer.size( ) );
+
+				// Decompress, member is complete
+				if ( inflate( &zStream, Z_FINISH ) != Z_STREAM_END || zStream.total_out != inputSize
+					|| crc32( crc32( 0L, Z_NULL, 0 ), outBuffer.data( ), static_cast<uInt>( inputSize ) ) != blockCRC )
+					throw std::runtime_error( "decompression (inflate) failed, data corrupted." );
+
+				// Skip output before in-block offset
+				if ( skipCount > inputSize )
+					throw std::runtime_error( "virtual offset is out of member." );
+
+				// Write
+				const std::uint64_t outCount( std::min( inputSize - skipCount, leftCount ) );
+				pOutput.write( outBuffer.data( ) + skipCount, static_cast<std::size_t>( outCount ) );
+				leftCount -= outCount;
+				skipCount = 0;
+
+			}
+
+			// Complete pending writes
+			pOutput.finish( );
+
+		}
+		catch ( ... )
+		{
+
+			// Release z_stream resources
+			inflateEnd( &zStream );
+
+			// Rethrow
+			throw;
+
+		}
+
+		// Release z_stream resources
+		inflateEnd( &zStream );
+
+	}
+
+	/*
+	 * Compress the given file as BGZF on multiple threads.
+	 *
+	 * @thread_safety - not thread-safe.
+	 * @param srcFile - file to compress.
+	 * @param dstFile - output file.
+	 * @param compressionLevel - Compression-Level to use, must be in range 0-9.
+	 * @param threadsCount - number of worker-threads, 0 to use all hardware-threads.
+	 * @return - Z_OK if compression complete, Z_ERRNO otherwise.
+	*/
+	int ZBgzf::deflateFILE( std::FILE *const srcFile, std::FILE *const dstFile, const int compressionLevel, const std::uint32_t threadsCount )
+	{
+
+		// Guarded-Block
+		try
+		{
+
+			// Check arguments
+			if ( compressionLevel < Z_DEFAULT_COMPRESSION || compressionLevel > Z_BEST_COMPRESSION )
+				throw std::runtime_error( "ZBgzf::deflateFILE - wrong compression level" );
+
+			// Compress
+			deflateChunks( srcFile, dstFile, compressionLevel, threadsCount );
+
+		}
+		catch ( const std::exception & pException )
+		{
+
+			// Print ERROR-message
+			std::cout << "ZBgzf::deflateFILE - error: " << pException.what( ) << std::endl;
+
+			// Return ERROR
+			return( Z_ERRNO );
+
+		}
+		catch ( ... )
+		{
+
+			// Print ERROR-message
+			std::cout << "ZBgzf::deflateFILE - unknown error" << std::endl;
+
+			// Return ERROR
+			return( Z_ERRNO );
+
+		}
+
+		// Return Z_OK
+		return( Z_OK );
+
+	}
+
+	/*
+	 * Decompress BGZF file, starting from virtual offset. Member sizes
+	 * & CRC-32 are checked.
+	 *
+	 * @thread_safety - not thread-safe.
+	 * @param srcFile - BGZF file, must be seekable.
+	 * @param pOutput - receives decompressed data.
+	 * @param virtualOffset - virtual offset to start from, 0 for the whole file.
+	 * @param length - number of bytes to decompress, cut at the end of data.
+	 * @return - Z_OK if decompressed, Z_ERRNO otherwise.
+	*/
+	int ZBgzf::inflateFILE( std::FILE *const srcFile, OutputSink & pOutput, const std::uint64_t virtualOffset, const std::uint64_t length )
+	{
+
+		// Guarded-Block
+		try
+		{
+
+			// Decompress
+			inflateBlocks( srcFile, pOutput, virtualOffset, length );
+
+		}
+		catch ( const std::exception & pException )
+		{
+
+			// Print ERROR-message
+			std::cout << "ZBgzf::inflateFILE - error: " << pException.what( ) << std::endl;
+
+			// Return ERROR
+			return( Z_ERRNO );
+
+		}
+		catch ( ... )
+		{
+
+			// Print ERROR-message
+			std::cout << "ZBgzf::inflateFILE - unknown error" << std::endl;
+
+			// Return ERROR
+			return( Z_ERRNO );
+
+		}
+
+		// Return Z_OK
+		return( Z_OK );
+
+	}
+
+	/*
+	 * Returns uncompressed size of BGZF file: sum of member input sizes.
+	 * Only headers & trailers are read, position is not changed.
+	 *
+	 * @thread_safety - not thread-safe.
+	 * @param srcFile - file, must be seekable.
+	 * @return - uncompressed size, 0 if file is not BGZF (or empty).
+	*/
+	std::uint64_t ZBgzf::getUncompressedSize( std::FILE *const srcFile ) noexcept
+	{
+
+		// Uncompressed size
+		std::uint64_t totalSize( 0 );
+
+		// Position to restore
+		std::uint64_t position( 0 );
+
+		// Guarded-Block
+		try
+		{
+
+			position = FileUtils::tell( srcFile );
+			const std::uint64_t fileSize( FileUtils::getSize( srcFile ) );
+
+			// Header of member
+			std::vector<unsigned char> headerBuffer( MAX_BLOCK_SIZE );
+
+			// Members, from header to trailer
+			for ( std::uint64_t blockOffset = position; blockOffset < fileSize; )
+			{
+
+				// gzip-header: magic, method, flags (FEXTRA only), extra-field length
+				FileUtils::seek( srcFile, blockOffset );
+
+				if ( fread( headerBuffer.data( ), sizeof( unsigned char ), GZIP_HEADER_SIZE, srcFile ) != GZIP_HEADER_SIZE
+					|| headerBuffer[0] != 0x1F || headerBuffer[1] != 0x8B || headerBuffer[2] != Z_DEFLATED || ( headerBuffer[3] & 0x1E ) != 0x04 )
+					throw std::runtime_error( "not a BGZF member." );
+
+				// Extra-field
+				const std::size_t headerSize( GZIP_HEADER_SIZE + ( headerBuffer[10] | ( headerBuffer[11] << 8 ) ) );
+
+				if ( headerSize + TRAILER_SIZE > MAX_BLOCK_SIZE
+					|| fread( headerBuffer.data( ) + GZIP_HEADER_SIZE, sizeof( unsigned char ), headerSize - GZIP_HEADER_SIZE, srcFile ) != headerSize - GZIP_HEADER_SIZE )
+					throw std::runtime_error( "not a BGZF member." );
+
+				// Member size
+				const std::size_t blockSize( findBlockSize( headerBuffer.data( ), headerSize ) );
+
+				if ( blockSize < headerSize + TRAILER_SIZE || blockOffset + blockSize > fileSize )
+					throw std::runtime_error( "not a BGZF member, block size missing." );
+
+				// Input size, little-endian at the end of member
+				unsigned char sizeBytes[4];
+				FileUtils::seek( srcFile, blockOffset + blockSize - 4 );
+
+				if ( fread( sizeBytes, sizeof( unsigned char ), 4, srcFile ) != 4 )
+					throw std::runtime_error( "unexpected end of file." );
+
+				totalSize += static_cast<std::uint64_t>( sizeBytes[0] ) | ( static_cast<std::uint64_t>( sizeBytes[1] ) << 8 ) | ( static_cast<std::uint64_t>( sizeBytes[2] ) << 16 ) | ( static_cast<std::uint64_t>( sizeBytes[3] ) << 24 );
+				blockOffset += blockSize;
+
+			}
+
+		}
+		catch ( const std::exception & )
+		{
+			// Not BGZF or not seekable
+			totalSize = 0;
+		}
+
+		// Restore position
+		try
+		{
+			FileUtils::seek( srcFile, position );
+		}
+		catch ( const std::exception & )
+		{
+			// Not seekable, position was not changed
+		}
+
+		// Return
+		return( totalSize );
+
+	}
+
+	// -------------------------------------------------------- \\
+
+}
\ No newline at end of file
@@ -0,0 +1,247 @@
+/*
+* Copyright  2018 Denis Zyamaev (code4un@yandex.ru) All rights reserved.
+* Authors: Denis Zyamaev (code4un@yandex.ru)
+* All rights reserved.
+* API: C++ 11
+* License: see LICENSE.txt
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+* 1. Redistributions of source code must retain the above copyright notice,
+* this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must display the names 'Denis Zyamaev' and
+* in the credits of the application, if such credits exist.
+* The authors of this work must be notified via email (code4un@yandex.ru) in
+* this case of redistribution.
+* 3. Neither the name of copyright holders nor the names of its contributors
+* may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS
+* IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+* PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+// Include 'pch_cxx'
+#include "../pch_cxx.hpp"
+
+// Include ThreadPool
+#include "../core/ThreadPool.hpp"
+
+// Include OutputSink
+#include "../io/OutputSink.hpp"
+
+namespace c0de4un
+{
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Types
+	// ===========================================================
+
+	/*
+	  * ZBgzf - BGZF (blocked gzip) compression & random access.
+	  *
+	  * BGZF file is a sequence of gzip-members of at most 64 KB, each
+	  * holds up to 65280 uncompressed bytes & stores own size in the
+	  * extra-field (FEXTRA, subfield 'B','C', BSIZE = member size - 1).
+	  * File ends with empty EOF-member. It is a valid gzip, readable by
+	  * ZStream::inflateFILE & gzip -d, and by htslib (bgzip, samtools).
+	  *
+	  * Position in BGZF file is a virtual offset: offset of the member in
+	  * compressed file << 16 | offset in it's uncompressed data.
+	  *
+	  * Members are independent, so they are compressed on worker-threads,
+	  * BLOCKS_PER_CHUNK members per task.
+	  *
+	  * @language C++ 17
+	  *
+	  * @authors Z. Denis (c0de4un@yandex.ru)
+	  * @version 1.0
+	 */
+	class ZBgzf final
+	{
+
+	public:
+
+		// -------------------------------------------------------- \\
+
+		// ===========================================================
+		// Constants
+		// ===========================================================
+
+		/* Max size of member */
+		static constexpr std::uint32_t MAX_BLOCK_SIZE = 65536;
+
+		/* Max size of uncompressed data in member, the same as htslib uses */
+		static constexpr std::uint32_t MAX_INPUT_SIZE = 65280;
+
+		/* Number of members, compressed by one task */
+		static constexpr std::uint32_t BLOCKS_PER_CHUNK = 16;
+
+		// -------------------------------------------------------- \\
+
+	private:
+
+		// -------------------------------------------------------- \\
+
+		// ===========================================================
+		// Types
+		// ===========================================================
+
+		/* Input of BLOCKS_PER_CHUNK members & compressed members */
+		struct Chunk final
+		{
+
+			/* Uncompressed data */
+			std::vector<unsigned char> input;
+
+			/* Compressed members */
+			std::vector<unsigned char> output;
+
+		};
+
+		// ===========================================================
+		// Constants
+		// ===========================================================
+
+		/* Size of member header: gzip-header, extra-field length & 'B','C' subfield */
+		static constexpr std::size_t HEADER_SIZE = 18;
+
+		/* Size of gzip-header with extra-field length */
+		static constexpr std::size_t GZIP_HEADER_SIZE = 12;
+
+		/* Size of gzip-trailer: CRC-32 & input size */
+		static constexpr std::size_t TRAILER_SIZE = 8;
+
+		/* Size of stored deflate block header: final flag, length, ~length */
+		static constexpr std::size_t STORED_HEADER_SIZE = 5;
+
+		/* EOF-member, empty member that ends BGZF file */
+		static constexpr unsigned char EOF_BLOCK[28] = { 0x1F, 0x8B, 0x08, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF, 0x06, 0x00, 0x42, 0x43, 0x02, 0x00, 0x1B, 0x00, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 };
+
+		// ===========================================================
+		// Methods
+		// ===========================================================
+
+		/*
+		 * Compress chunk input into members.
+		 *
+		 * @thread_safety - thread-safe, if chunk not shared.
+		 * @param pChunk - chunk to compress.
+		 * @param compressionLevel - Compression-Level to use, must be in range 0-9.
+		 * @throws - can throw exception.
+		*/
+		static void deflateChunk( Chunk & pChunk, const int compressionLevel );
+
+		/*
+		 * Compress the given file as BGZF on multiple threads.
+		 *
+		 * @thread_safety - not thread-safe.
+		 * @param srcFile - file to compress.
+		 * @param dstFile - output file.
+		 * @param compressionLevel - Compression-Level to use, must be in range 0-9.
+		 * @param threadsCount - number of worker-threads, 0 to use all hardware-threads.
+		 * @throws - can throw exception.
+		*/
+		static void deflateChunks( std::FILE *const srcFile, std::FILE *const dstFile, const int compressionLevel, const std::uint32_t threadsCount );
+
+		/*
+		 * Decompress members, starting from virtual offset.
+		 *
+		 * @thread_safety - not thread-safe.
+		 * @param srcFile - BGZF file, must be seekable.
+		 * @param pOutput - receives decompressed data.
+		 * @param virtualOffset - virtual offset to start from.
+		 * @param length - number of bytes to decompress, cut at the end of data.
+		 * @throws - can throw exception.
+		*/
+		static void inflateBlocks( std::FILE *const srcFile, OutputSink & pOutput, const std::uint64_t virtualOffset, const std::uint64_t length );
+
+		/*
+		 * Returns member size (BSIZE + 1) from 'B','C' subfield, 0 if not found.
+		 *
+		 * @param pHeader - gzip-header with extra-field.
+		 * @param headerSize - size of header with extra-field.
+		*/
+		static std::size_t findBlockSize( const unsigned char *const pHeader, const std::size_t headerSize ) noexcept;
+
+		// -------------------------------------------------------- \\
+
+	public:
+
+		// -------------------------------------------------------- \\
+
+		// ===========================================================
+		// Constructor & destructor
+		// ===========================================================
+
+		/* @deleted ZBgzf constructor, only static methods */
+		ZBgzf( ) = delete;
+
+		// ===========================================================
+		// Methods
+		// ===========================================================
+
+		/*
+		 * Returns virtual offset.
+		 *
+		 * @param blockOffset - offset of member in compressed file, less than 2^48.
+		 * @param inBlockOffset - offset in uncompressed data of the member.
+		*/
+		static std::uint64_t makeVirtualOffset( const std::uint64_t blockOffset, const std::uint32_t inBlockOffset ) noexcept;
+
+		/*
+		 * Compress the given file as BGZF on multiple threads.
+		 *
+		 * @thread_safety - not thread-safe.
+		 * @param srcFile - file to compress.
+		 * @param dstFile - output file.
+		 * @param compressionLevel - Compression-Level to use, must be in range 0-9.
+		 * @param threadsCount - number of worker-threads, 0 to use all hardware-threads.
+		 * @return - Z_OK if compression complete, Z_ERRNO otherwise.
+		*/
+		static int deflateFILE( std::FILE *const srcFile, std::FILE *const dstFile, const int compressionLevel, const std::uint32_t threadsCount = 0 );
+
+		/*
+		 * Decompress BGZF file, starting from virtual offset. Member sizes
+		 * & CRC-32 are checked.
+		 *
+		 * @thread_safety - not thread-safe.
+		 * @param srcFile - BGZF file, must be seekable.
+		 * @param pOutput - receives decompressed data.
+		 * @param virtualOffset - virtual offset to start from, 0 for the whole file.
+		 * @param length - number of bytes to decompress, cut at the end of data.
+		 * @return - Z_OK if decompressed, Z_ERRNO otherwise.
+		*/
+		static int inflateFILE( std::FILE *const srcFile, OutputSink & pOutput, const std::uint64_t virtualOffset = 0, const std::uint64_t length = UINT64_MAX );
+
+		/*
+		 * Returns uncompressed size of BGZF file: sum of member input sizes.
+		 * Only headers & trailers are read, position is not changed.
+		 *
+		 * @thread_safety - not thread-safe.
+		 * @param srcFile - file, must be seekable.
+		 * @return - uncompressed size, 0 if file is not BGZF (or empty).
+		*/
+		static std::uint64_t getUncompressedSize( std::FILE *const srcFile ) noexcept;
+
+		// -------------------------------------------------------- \\
+
+	};
+
+	// -------------------------------------------------------- \\
+
+}
\ No newline at end of file
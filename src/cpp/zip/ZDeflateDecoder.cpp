@@ -0,0 +1,698 @@
+/*
+* Copyright  2018 Denis Zyamaev (code4un@yandex.ru) All rights reserved.
+* Authors: Denis Zyamaev (code4un@yandex.ru)
+* All rights reserved.
+* API: C++ 11
+* License: see LICENSE.txt
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+* 1. Redistributions of source code must retain the above copyright notice,
+* this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must display the names 'Denis Zyamaev' and
+* in the credits of the application, if such credits exist.
+* The authors of this work must be notified via email (code4un@yandex.ru) in
+* this case of redistribution.
+* 3. Neither the name of copyright holders nor the names of its contributors
+* may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS
+* IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+* PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// HEADER
+#include "ZDeflateDecoder.hpp"
+
+namespace c0de4un
+{
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Constants
+	// ===========================================================
+
+	/* Base of length codes 257..285 */
+	static constexpr std::uint16_t LENGTH_BASE[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+
+	/* Extra bits of length codes 257..285 */
+	static constexpr std::uint8_t LENGTH_EXTRA[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+
+	/* Base of distance codes 0..29 */
+	static constexpr std::uint16_t DISTANCE_BASE[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+
+	/* Extra bits of distance codes 0..29 */
+	static constexpr std::uint8_t DISTANCE_EXTRA[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+	/* Order of code-length code lengths */
+	static constexpr std::uint8_t PRECODE_ORDER[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+	// ===========================================================
+	// Constructor
+	// ===========================================================
+
+	/* ZDeflateDecoder constructor, builds fixed codes */
+	ZDeflateDecoder::ZDeflateDecoder( ) noexcept
+		: mData( nullptr ),
+		mSize( 0 ),
+		mBitBuffer( 0 ),
+		mBitCount( 0 ),
+		mBytePos( 0 )
+	{
+
+		// Fixed code lengths (RFC 1951, 3.2.6)
+		std::uint8_t lengths[288];
+
+		for ( unsigned int symbolIndex = 0; symbolIndex < 288; symbolIndex++ )
+			lengths[symbolIndex] = symbolIndex < 144 ? 8 : ( symbolIndex < 256 ? 9 : ( symbolIndex < 280 ? 7 : 8 ) );
+		build( mFixedLengths, lengths, 288, CodeKind::FIXED );
+
+		for ( unsigned int symbolIndex = 0; symbolIndex < 30; symbolIndex++ )
+			lengths[symbolIndex] = 5;
+		build( mFixedDistances, lengths, 30, CodeKind::FIXED );
+
+	}
+
+	// ===========================================================
+	// Methods
+	// ===========================================================
+
+	/* Loads bytes into bit-buffer, bytes after input end are 0 */
+	void ZDeflateDecoder::refill( ) noexcept
+	{
+
+		while ( mBitCount <= 56 )
+		{
+
+			if ( mBytePos < mSize )
+				mBitBuffer |= static_cast<std::uint64_t>( mData[mBytePos] ) << mBitCount;
+
+			mBytePos++;
+			mBitCount += 8;
+
+		}
+
+	}
+
+	/*
+	 * Read bits.
+	 *
+	 * @param bitsCount - number of bits, up to 32.
+	*/
+	std::uint32_t ZDeflateDecoder::getBits( const unsigned int bitsCount ) noexcept
+	{
+
+		if ( mBitCount < bitsCount )
+			refill( );
+
+		const std::uint32_t bitsValue( static_cast<std::uint32_t>( mBitBuffer & ( ( std::uint64_t( 1 ) << bitsCount ) - 1 ) ) );
+		mBitBuffer >>= bitsCount;
+		mBitCount -= bitsCount;
+
+		return( bitsValue );
+
+	}
+
+	/* Returns bit offset of the next bit */
+	std::uint64_t ZDeflateDecoder::tell( ) const noexcept
+	{ return( static_cast<std::uint64_t>( mBytePos ) * 8 - mBitCount ); }
+
+	/*
+	 * Set bit offset.
+	 *
+	 * @param pBit - bit offset in input.
+	*/
+	void ZDeflateDecoder::seek( const std::uint64_t pBit ) noexcept
+	{
+
+		mBytePos = static_cast<std::size_t>( pBit / 8 );
+		mBitBuffer = 0;
+		mBitCount = 0;
+
+		refill( );
+		getBits( static_cast<unsigned int>( pBit % 8 ) );
+
+	}
+
+	/*
+	 * Build canonical Huffman code.
+	 *
+	 * @param pCode - output.
+	 * @param pLengths - code length of each symbol.
+	 * @param symbolsCount - number of symbols.
+	 * @param pKind - completeness rule.
+	 * @return - false, if lengths don't make a valid code.
+	*/
+	bool ZDeflateDecoder::build( Huffman & pCode, const std::uint8_t *const pLengths, const unsigned int symbolsCount, const CodeKind pKind ) noexcept
+	{
+
+		// Count codes of each length
+		std::memset( pCode.count, 0, sizeof( pCode.count ) );
+		for ( unsigned int symbolIndex = 0; symbolIndex < symbolsCount; symbolIndex++ )
+			pCode.count[pLengths[symbolIndex]]++;
+
+		// Check, code is not over-subscribed
+		int codesLeft( 1 );
+		for ( unsigned int codeLength = 1; codeLength <= MAX_BITS; codeLength++ )
+		{
+
+			codesLeft <<= 1;
+			codesLeft -= pCode.count[codeLength];
+
+			if ( codesLeft < 0 )
+				return( false );
+
+		}
+
+		// Incomplete code: not allowed for code-lengths, single code (or none) for literal/length & distance
+		if ( codesLeft > 0 )
+		{
+
+			if ( pKind == CodeKind::PRECODE )
+				return( false );
+
+			if ( pKind == CodeKind::CODE && pCode.count[0] + pCode.count[1] != static_cast<std::int16_t>( symbolsCount ) )
+				return( false );
+
+			if ( pKind == CodeKind::CODE && pCode.count[1] > 1 )
+				return( false );
+
+		}
+
+		// Offsets of each length in symbol table
+		std::uint16_t offsets[MAX_BITS + 1];
+		offsets[1] = 0;
+		for ( unsigned int codeLength = 1; codeLength < MAX_BITS; codeLength++ )
+			offsets[codeLength + 1] = static_cast<std::uint16_t>( offsets[codeLength] + pCode.count[codeLength] );
+
+		// Symbols ordered by length, then by value
+		for ( unsigned int symbolIndex = 0; symbolIndex < symbolsCount; symbolIndex++ )
+			if ( pLengths[symbolIndex] != 0 )
+				pCode.symbol[offsets[pLengths[symbolIndex]]++] = static_cast<std::uint16_t>( symbolIndex );
+
+		// Fast lookup, indexed by bit-reversed code (deflate stores codes MSB first)
+		std::memset( pCode.fast, 0, sizeof( pCode.fast ) );
+
+		unsigned int codeValue( 0 );
+		unsigned int symbolOffset( 0 );
+
+		for ( unsigned int codeLength = 1; codeLength <= FAST_BITS; codeLength++ )
+		{
+
+			for ( int codeIndex = 0; codeIndex < pCode.count[codeLength]; codeIndex++ )
+			{
+
+				// Reverse code bits
+				unsigned int reversedCode( 0 );
+				for ( unsigned int bitIndex = 0; bitIndex < codeLength; bitIndex++ )
+					reversedCode |= ( ( codeValue >> bitIndex ) & 1 ) << ( codeLength - 1 - bitIndex );
+
+				// Fill all entries with this prefix
+				const std::uint16_t entryValue( static_cast<std::uint16_t>( ( pCode.symbol[symbolOffset] << 4 ) | codeLength ) );
+				for ( unsigned int entryIndex = reversedCode; entryIndex < ( 1u << FAST_BITS ); entryIndex += ( 1u << codeLength ) )
+					pCode.fast[entryIndex] = entryValue;
+
+				codeValue++;
+				symbolOffset++;
+
+			}
+
+			codeValue <<= 1;
+
+		}
+
+		// OK
+		return( true );
+
+	}
+
+	/*
+	 * Decode symbol.
+	 *
+	 * @param pCode - Huffman code.
+	 * @return - symbol, -1 if code is invalid.
+	*/
+	int ZDeflateDecoder::decodeSymbol( const Huffman & pCode ) noexcept
+	{
+
+		if ( mBitCount < MAX_BITS )
+			refill( );
+
+		// Short code
+		const std::uint16_t entryValue( pCode.fast[mBitBuffer & ( ( 1u << FAST_BITS ) - 1 )] );
+		if ( entryValue != 0 )
+		{
+
+			mBitBuffer >>= ( entryValue & 15 );
+			mBitCount -= ( entryValue & 15 );
+
+			return( entryValue >> 4 );
+
+		}
+
+		// Long code, bit by bit
+		int codeValue( 0 );
+		int firstCode( 0 );
+		int symbolOffset( 0 );
+
+		for ( unsigned int codeLength = 1; codeLength <= MAX_BITS; codeLength++ )
+		{
+
+			codeValue |= static_cast<int>( ( mBitBuffer >> ( codeLength - 1 ) ) & 1 );
+
+			const int codesCount( pCode.count[codeLength] );
+			if ( codeValue - codesCount < firstCode )
+			{
+
+				mBitBuffer >>= codeLength;
+				mBitCount -= codeLength;
+
+				return( pCode.symbol[symbolOffset + ( codeValue - firstCode )] );
+
+			}
+
+			symbolOffset += codesCount;
+			firstCode += codesCount;
+			firstCode <<= 1;
+			codeValue <<= 1;
+
+		}
+
+		// Invalid code
+		return( -1 );
+
+	}
+
+	/*
+	 * Read dynamic block header & build codes.
+	 *
+	 * @return - false, if header is invalid.
+	*/
+	bool ZDeflateDecoder::readDynamicHeader( ) noexcept
+	{
+
+		// Number of literal/length, distance & code-length codes
+		const unsigned int lengthsCount( getBits( 5 ) + 257 );
+		const unsigned int distancesCount( getBits( 5 ) + 1 );
+		const unsigned int precodeCount( getBits( 4 ) + 4 );
+
+		if ( lengthsCount > 286 || distancesCount > 30 )
+			return( false );
+
+		// Code-length code
+		std::uint8_t codeLengths[320];
+		std::memset( codeLengths, 0, 19 );
+
+		for ( unsigned int lengthIndex = 0; lengthIndex < precodeCount; lengthIndex++ )
+			codeLengths[PRECODE_ORDER[lengthIndex]] = static_cast<std::uint8_t>( getBits( 3 ) );
+
+		if ( !build( mPrecode, codeLengths, 19, CodeKind::PRECODE ) )
+			return( false );
+
+		// Literal/length & distance code lengths
+		unsigned int lengthIndex( 0 );
+		while ( lengthIndex < lengthsCount + distancesCount )
+		{
+
+			const int symbolValue( decodeSymbol( mPrecode ) );
+
+			if ( symbolValue < 0 )
+				return( false );
+
+			// Length
+			if ( symbolValue < 16 )
+			{
+				codeLengths[lengthIndex++] = static_cast<std::uint8_t>( symbolValue );
+				continue;
+			}
+
+			// Repeat
+			std::uint8_t repeatLength( 0 );
+			unsigned int repeatCount( 0 );
+
+			if ( symbolValue == 16 )
+			{
+
+				if ( lengthIndex == 0 )
+					return( false );
+
+				repeatLength = codeLengths[lengthIndex - 1];
+				repeatCount = 3 + getBits( 2 );
+
+			}
+			else if ( symbolValue == 17 )
+				repeatCount = 3 + getBits( 3 );
+			else
+				repeatCount = 11 + getBits( 7 );
+
+			if ( lengthIndex + repeatCount > lengthsCount + distancesCount )
+				return( false );
+
+			while ( repeatCount-- > 0 )
+				codeLengths[lengthIndex++] = repeatLength;
+
+		}
+
+		// End-of-block code required
+		if ( codeLengths[256] == 0 )
+			return( false );
+
+		// Build codes
+		return( build( mLengths, codeLengths, lengthsCount, CodeKind::CODE ) && build( mDistances, codeLengths + lengthsCount, distancesCount, CodeKind::CODE ) );
+
+	}
+
+	/*
+	 * Decode compressed block data.
+	 *
+	 * @param pLengths - literal/length code.
+	 * @param pDistances - distance code.
+	 * @param pResult - output.
+	 * @param outCount - number of symbols in output, updated.
+	 * @param windowStart - first symbol back-references can refer to.
+	 * @param outLimit - max number of symbols.
+	 * @throws - can throw exception (bad_alloc).
+	*/
+	ZDeflateDecoder::Status ZDeflateDecoder::decodeCodes( const Huffman & pLengths, const Huffman & pDistances, Result & pResult, std::size_t & outCount, const std::size_t windowStart, const std::size_t outLimit )
+	{
+
+		std::uint16_t * outData( pResult.symbols.data( ) );
+
+		while ( true )
+		{
+
+			// Input end reached
+			if ( mBytePos > mSize + 8 )
+				return( Status::LIMIT );
+
+			const int symbolValue( decodeSymbol( pLengths ) );
+
+			if ( symbolValue < 0 )
+				return( Status::DATA_ERROR );
+
+			// Block end
+			if ( symbolValue == 256 )
+				return( Status::OK );
+
+			// Length & distance
+			unsigned int copyLength( 1 );
+			std::size_t copyDistance( 0 );
+
+			if ( symbolValue > 256 )
+			{
+
+				const int lengthIndex( symbolValue - 257 );
+				if ( lengthIndex >= 29 )
+					return( Status::DATA_ERROR );
+
+				copyLength = LENGTH_BASE[lengthIndex] + getBits( LENGTH_EXTRA[lengthIndex] );
+
+				const int distanceIndex( decodeSymbol( pDistances ) );
+				if ( distanceIndex < 0 || distanceIndex >= 30 )
+					return( Status::DATA_ERROR );
+
+				copyDistance = DISTANCE_BASE[distanceIndex] + getBits( DISTANCE_EXTRA[distanceIndex] );
+				if ( copyDistance > outCount - windowStart )
+					return( Status::DATA_ERROR );
+
+			}
+
+			// Grow output by x2, up to limit
+			if ( outCount + copyLength > pResult.symbols.size( ) )
+			{
+
+				if ( outCount + copyLength > outLimit )
+					return( Status::LIMIT );
+
+				pResult.symbols.resize( std::min( std::max( pResult.symbols.size( ) * 2, outCount + copyLength ), outLimit ) );
+				outData = pResult.symbols.data( );
+
+			}
+
+			// Literal
+			if ( copyDistance == 0 )
+			{
+				outData[outCount++] = static_cast<std::uint16_t>( symbolValue );
+				continue;
+			}
+
+			// Copy, can overlap
+			const std::uint16_t * copySource( outData + outCount - copyDistance );
+			std::uint16_t * copyTarget( outData + outCount );
+			for ( unsigned int copyIndex = 0; copyIndex < copyLength; copyIndex++ )
+				copyTarget[copyIndex] = copySource[copyIndex];
+
+			outCount += copyLength;
+
+		}
+
+	}
+
+	/*
+	 * Check, that dynamic block header can start at bit offset & build its codes.
+	 *
+	 * @param pBit - bit offset.
+	*/
+	bool ZDeflateDecoder::isDynamicStart( const std::uint64_t pBit ) noexcept
+	{
+
+		seek( pBit );
+
+		// Not final, dynamic, valid code lengths
+		return( getBits( 3 ) == 4 && readDynamicHeader( ) );
+
+	}
+
+	/*
+	 * Quick check, that stored block header can start at bit offset.
+	 *
+	 * @param pBit - bit offset.
+	 * @return - bit offset of the last possible header before LEN, UINT64_MAX if not a stored block.
+	*/
+	std::uint64_t ZDeflateDecoder::getStoredStart( const std::uint64_t pBit ) noexcept
+	{
+
+		// Byte offset of LEN, header & padding are before it
+		const std::size_t lengthOffset( static_cast<std::size_t>( ( pBit + 3 + 7 ) / 8 ) );
+
+		if ( lengthOffset + 4 > mSize )
+			return( UINT64_MAX );
+
+		// Not final, stored, zero padding
+		seek( pBit );
+		if ( getBits( static_cast<unsigned int>( lengthOffset * 8 - pBit ) ) != 0 )
+			return( UINT64_MAX );
+
+		// LEN & NLEN
+		const unsigned int storedLength( mData[lengthOffset] | ( mData[lengthOffset + 1] << 8 ) );
+		const unsigned int storedLengthComplement( mData[lengthOffset + 2] | ( mData[lengthOffset + 3] << 8 ) );
+
+		if ( storedLength != ( ~storedLengthComplement & 0xFFFF ) )
+			return( UINT64_MAX );
+
+		// Start of the last possible header (any of this range decodes the same)
+		return( lengthOffset * 8 - 3 );
+
+	}
+
+	/*
+	 * Decode blocks, until block boundary at or after stop-offset, or stream end.
+	 *
+	 * @thread_safety - not thread-safe, decoder per thread.
+	 * @param pData - input.
+	 * @param pSize - size of input.
+	 * @param startBit - bit offset of block start.
+	 * @param stopBit - bit offset to stop at the next block boundary.
+	 * @param useMarkers - true, if window before start is unknown. Otherwise start is stream start.
+	 * @param outLimit - max number of output symbols.
+	 * @param pResult - output.
+	 * @return - status.
+	 * @throws - can throw exception (bad_alloc).
+	*/
+	ZDeflateDecoder::Status ZDeflateDecoder::decode( const unsigned char *const pData, const std::size_t pSize, const std::uint64_t startBit, const std::uint64_t stopBit, const bool useMarkers, const std::size_t outLimit, Result & pResult )
+	{
+
+		mData = pData;
+		mSize = pSize;
+
+		// Window: markers, if unknown, not referenced otherwise
+		const std::size_t windowStart( useMarkers ? 0 : WINDOW_SIZE );
+		std::size_t outCount( WINDOW_SIZE );
+
+		pResult.symbols.resize( std::min( WINDOW_SIZE + pSize * 4, outLimit ) );
+		for ( std::size_t windowIndex = 0; windowIndex < WINDOW_SIZE; windowIndex++ )
+			pResult.symbols[windowIndex] = static_cast<std::uint16_t>( useMarkers ? MARKER_BASE + windowIndex : 0 );
+
+		pResult.startBitMin = startBit;
+		pResult.startBitMax = startBit;
+		pResult.streamEnd = false;
+		pResult.hasMarkers = useMarkers;
+
+		seek( startBit );
+
+		// Decode blocks
+		Status decodeStatus( Status::OK );
+		while ( decodeStatus == Status::OK )
+		{
+
+			// Block boundary after stop-offset
+			const std::uint64_t blockStart( tell( ) );
+			if ( blockStart != startBit && blockStart >= stopBit )
+			{
+				pResult.endBit = blockStart;
+				break;
+			}
+
+			// Input end reached
+			if ( mBytePos > mSize + 8 )
+				return( Status::LIMIT );
+
+			// Block header
+			const bool finalBlock( getBits( 1 ) != 0 );
+			const std::uint32_t blockType( getBits( 2 ) );
+
+			if ( blockType == 0 )
+			{
+
+				// Stored: skip to byte boundary, LEN & NLEN
+				getBits( static_cast<unsigned int>( ( 8 - tell( ) % 8 ) % 8 ) );
+
+				const std::uint32_t storedLength( getBits( 16 ) );
+				if ( storedLength != ( ~getBits( 16 ) & 0xFFFF ) )
+					return( Status::DATA_ERROR );
+
+				const std::size_t dataOffset( static_cast<std::size_t>( tell( ) / 8 ) );
+				if ( dataOffset + storedLength > mSize )
+					return( Status::LIMIT );
+
+				// Grow output
+				if ( outCount + storedLength > pResult.symbols.size( ) )
+				{
+
+					if ( outCount + storedLength > outLimit )
+						return( Status::LIMIT );
+
+					pResult.symbols.resize( std::min( std::max( pResult.symbols.size( ) * 2, outCount + storedLength ), outLimit ) );
+
+				}
+
+				// Copy bytes
+				for ( std::uint32_t byteIndex = 0; byteIndex < storedLength; byteIndex++ )
+					pResult.symbols[outCount++] = mData[dataOffset + byteIndex];
+
+				seek( static_cast<std::uint64_t>( dataOffset + storedLength ) * 8 );
+
+			}
+			else if ( blockType == 1 )
+				decodeStatus = decodeCodes( mFixedLengths, mFixedDistances, pResult, outCount, windowStart, outLimit );
+			else if ( blockType == 2 )
+				decodeStatus = readDynamicHeader( ) ? decodeCodes( mLengths, mDistances, pResult, outCount, windowStart, outLimit ) : Status::DATA_ERROR;
+			else
+				decodeStatus = Status::DATA_ERROR;
+
+			// Stream end
+			if ( decodeStatus == Status::OK && finalBlock )
+			{
+				pResult.endBit = tell( );
+				pResult.streamEnd = true;
+				break;
+			}
+
+		}
+
+		if ( decodeStatus != Status::OK )
+			return( decodeStatus );
+
+		// Check input end
+		if ( pResult.endBit > static_cast<std::uint64_t>( mSize ) * 8 )
+			return( Status::LIMIT );
+
+		pResult.symbols.resize( outCount );
+
+		// OK
+		return( Status::OK );
+
+	}
+
+	/*
+	 * Find the first block start in range & decode from it, until
+	 * block boundary at or after stop-offset, or stream end.
+	 *
+	 * @thread_safety - not thread-safe, decoder per thread.
+	 * @param pData - input.
+	 * @param pSize - size of input.
+	 * @param searchBegin - first bit offset to try.
+	 * @param searchEnd - bit offset to stop search at.
+	 * @param stopBit - bit offset to stop decode at the next block boundary.
+	 * @param outLimit - max number of output symbols.
+	 * @param pResult - output.
+	 * @return - true, if block start found & decoded.
+	 * @throws - can throw exception (bad_alloc).
+	*/
+	bool ZDeflateDecoder::findAndDecode( const unsigned char *const pData, const std::size_t pSize, const std::uint64_t searchBegin, const std::uint64_t searchEnd, const std::uint64_t stopBit, const std::size_t outLimit, Result & pResult )
+	{
+
+		mData = pData;
+		mSize = pSize;
+
+		const std::uint64_t searchLast( std::min( searchEnd, static_cast<std::uint64_t>( pSize ) * 8 ) );
+
+		for ( std::uint64_t candidateBit = searchBegin; candidateBit < searchLast; candidateBit++ )
+		{
+
+			// 3 bits of block header from input, to skip most offsets without seek
+			const std::size_t byteOffset( static_cast<std::size_t>( candidateBit / 8 ) );
+			const unsigned int bitOffset( static_cast<unsigned int>( candidateBit % 8 ) );
+			const unsigned int headerBits( ( ( mData[byteOffset] | ( byteOffset + 1 < mSize ? mData[byteOffset + 1] << 8 : 0 ) ) >> bitOffset ) & 7 );
+
+			std::uint64_t blockStart( candidateBit );
+
+			if ( headerBits == 0 )
+			{
+
+				// Stored block
+				blockStart = getStoredStart( candidateBit );
+				if ( blockStart == UINT64_MAX )
+					continue;
+
+			}
+			else if ( headerBits != 4 || !isDynamicStart( candidateBit ) )
+				continue;
+
+			// Decode
+			const Status decodeStatus( decode( pData, pSize, blockStart, stopBit, true, outLimit, pResult ) );
+
+			// Not a block start
+			if ( decodeStatus == Status::DATA_ERROR )
+				continue;
+
+			// Output too large or input too short
+			if ( decodeStatus == Status::LIMIT )
+				return( false );
+
+			pResult.startBitMin = candidateBit;
+
+			// OK
+			return( true );
+
+		}
+
+		// Not found
+		return( false );
+
+	}
+
+	// -------------------------------------------------------- \\
+
+}
\ No newline at end of file
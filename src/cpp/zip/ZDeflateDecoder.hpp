@@ -0,0 +1,345 @@
+/*
+* Copyright  2018 Denis Zyamaev (code4un@yandex.ru) All rights reserved.
+* Authors: Denis Zyamaev (code4un@yandex.ru)
+* All rights reserved.
+* API: C++ 11
+* License: see LICENSE.txt
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+* 1. Redistributions of source code must retain the above copyright notice,
+* this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must display the names 'Denis Zyamaev' and
+* in the credits of the application, if such credits exist.
+* The authors of this work must be notified via email (code4un@yandex.ru) in
+* this case of redistribution.
+* 3. Neither the name of copyright holders nor the names of its contributors
+* may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS
+* IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+* PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+// Include 'pch_cxx'
+#include "../pch_cxx.hpp"
+
+namespace c0de4un
+{
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Types
+	// ===========================================================
+
+	/*
+	  * ZDeflateDecoder - raw deflate (RFC 1951) decoder for speculative
+	  * decompression, that can start at any block boundary.
+	  *
+	  * Output is 16-bit symbols: bytes (0-255) & markers (256 + index),
+	  * that refer to the 32 KB window before start, unknown at decode time.
+	  * Markers are replaced, when window is known (see ZSpeculativeInflate).
+	  *
+	  * Decoder can search for a block start: bit offset, where valid
+	  * dynamic or stored block header begins & data decodes without error.
+	  *
+	  * @language C++ 17
+	  *
+	  * @authors Z. Denis (c0de4un@yandex.ru)
+	  * @version 1.0
+	 */
+	class ZDeflateDecoder final
+	{
+
+	public:
+
+		// -------------------------------------------------------- \\
+
+		// ===========================================================
+		// Types
+		// ===========================================================
+
+		/* Decoded part of deflate stream */
+		struct Result final
+		{
+
+			/* Symbols, first WINDOW_SIZE are window, output follows */
+			std::vector<std::uint16_t> symbols;
+
+			/* First bit offset, decoding from which gives the same output (zero bits before stored block) */
+			std::uint64_t startBitMin;
+
+			/* Bit offset of the first block */
+			std::uint64_t startBitMax;
+
+			/* Bit offset after the last decoded block */
+			std::uint64_t endBit;
+
+			/* true, if the last decoded block is the final block of stream */
+			bool streamEnd;
+
+			/* true, if output contains window markers */
+			bool hasMarkers;
+
+		};
+
+		/* Decode status */
+		enum class Status : std::uint8_t
+		{
+
+			/* Decoded until stop-offset or stream end */
+			OK = 0,
+
+			/* Invalid data (corrupted or not a block start) */
+			DATA_ERROR = 1,
+
+			/* Output or input limit reached */
+			LIMIT = 2
+
+		};
+
+		// ===========================================================
+		// Constants
+		// ===========================================================
+
+		/* Size of deflate window */
+		static constexpr std::size_t WINDOW_SIZE = 32768;
+
+		/* First marker symbol, marker refers to window[symbol - MARKER_BASE] */
+		static constexpr std::uint16_t MARKER_BASE = 256;
+
+		// -------------------------------------------------------- \\
+
+	private:
+
+		// -------------------------------------------------------- \\
+
+		// ===========================================================
+		// Types
+		// ===========================================================
+
+		/* Canonical Huffman code */
+		struct Huffman final
+		{
+
+			/* Number of codes of each length */
+			std::int16_t count[16];
+
+			/* Symbols ordered by code */
+			std::uint16_t symbol[320];
+
+			/* Lookup of short codes by FAST_BITS bits: symbol << 4 | length, 0 for long code */
+			std::uint16_t fast[1 << 10];
+
+		};
+
+		/* Huffman code completeness rule */
+		enum class CodeKind : std::uint8_t
+		{
+
+			/* Code-lengths code, must be complete */
+			PRECODE = 0,
+
+			/* Literal/length or distance code, incomplete only if single code */
+			CODE = 1,
+
+			/* Fixed code, incomplete distance code */
+			FIXED = 2
+
+		};
+
+		// ===========================================================
+		// Constants
+		// ===========================================================
+
+		/* Number of bits of fast lookup */
+		static constexpr unsigned int FAST_BITS = 10;
+
+		/* Max code length */
+		static constexpr unsigned int MAX_BITS = 15;
+
+		// ===========================================================
+		// Fields
+		// ===========================================================
+
+		/* Input */
+		const unsigned char * mData;
+
+		/* Size of input */
+		std::size_t mSize;
+
+		/* Bit-buffer, next bits are low bits */
+		std::uint64_t mBitBuffer;
+
+		/* Number of bits in bit-buffer */
+		unsigned int mBitCount;
+
+		/* Offset of the next byte to load into bit-buffer */
+		std::size_t mBytePos;
+
+		/* Fixed literal/length code */
+		Huffman mFixedLengths;
+
+		/* Fixed distance code */
+		Huffman mFixedDistances;
+
+		/* Dynamic literal/length code */
+		Huffman mLengths;
+
+		/* Dynamic distance code */
+		Huffman mDistances;
+
+		/* Code-lengths code */
+		Huffman mPrecode;
+
+		// ===========================================================
+		// Methods
+		// ===========================================================
+
+		/* Loads bytes into bit-buffer, bytes after input end are 0 */
+		void refill( ) noexcept;
+
+		/*
+		 * Read bits.
+		 *
+		 * @param bitsCount - number of bits, up to 32.
+		*/
+		std::uint32_t getBits( const unsigned int bitsCount ) noexcept;
+
+		/* Returns bit offset of the next bit */
+		std::uint64_t tell( ) const noexcept;
+
+		/*
+		 * Set bit offset.
+		 *
+		 * @param pBit - bit offset in input.
+		*/
+		void seek( const std::uint64_t pBit ) noexcept;
+
+		/*
+		 * Build canonical Huffman code.
+		 *
+		 * @param pCode - output.
+		 * @param pLengths - code length of each symbol.
+		 * @param symbolsCount - number of symbols.
+		 * @param pKind - completeness rule.
+		 * @return - false, if lengths don't make a valid code.
+		*/
+		static bool build( Huffman & pCode, const std::uint8_t *const pLengths, const unsigned int symbolsCount, const CodeKind pKind ) noexcept;
+
+		/*
+		 * Decode symbol.
+		 *
+		 * @param pCode - Huffman code.
+		 * @return - symbol, -1 if code is invalid.
+		*/
+		int decodeSymbol( const Huffman & pCode ) noexcept;
+
+		/*
+		 * Read dynamic block header & build codes.
+		 *
+		 * @return - false, if header is invalid.
+		*/
+		bool readDynamicHeader( ) noexcept;
+
+		/*
+		 * Decode compressed block data.
+		 *
+		 * @param pLengths - literal/length code.
+		 * @param pDistances - distance code.
+		 * @param pResult - output.
+		 * @param outCount - number of symbols in output, updated.
+		 * @param windowStart - first symbol back-references can refer to.
+		 * @param outLimit - max number of symbols.
+		 * @throws - can throw exception (bad_alloc).
+		*/
+		Status decodeCodes( const Huffman & pLengths, const Huffman & pDistances, Result & pResult, std::size_t & outCount, const std::size_t windowStart, const std::size_t outLimit );
+
+		/*
+		 * Check, that dynamic block header can start at bit offset & build its codes.
+		 *
+		 * @param pBit - bit offset.
+		*/
+		bool isDynamicStart( const std::uint64_t pBit ) noexcept;
+
+		/*
+		 * Quick check, that stored block header can start at bit offset.
+		 *
+		 * @param pBit - bit offset.
+		 * @return - bit offset of the last possible header before LEN, UINT64_MAX if not a stored block.
+		*/
+		std::uint64_t getStoredStart( const std::uint64_t pBit ) noexcept;
+
+		// -------------------------------------------------------- \\
+
+	public:
+
+		// -------------------------------------------------------- \\
+
+		// ===========================================================
+		// Constructor & destructor
+		// ===========================================================
+
+		/* ZDeflateDecoder constructor, builds fixed codes */
+		explicit ZDeflateDecoder( ) noexcept;
+
+		/* ZDeflateDecoder destructor */
+		~ZDeflateDecoder( ) = default;
+
+		// ===========================================================
+		// Methods
+		// ===========================================================
+
+		/*
+		 * Decode blocks, until block boundary at or after stop-offset, or stream end.
+		 *
+		 * @thread_safety - not thread-safe, decoder per thread.
+		 * @param pData - input.
+		 * @param pSize - size of input.
+		 * @param startBit - bit offset of block start.
+		 * @param stopBit - bit offset to stop at the next block boundary.
+		 * @param useMarkers - true, if window before start is unknown. Otherwise start is stream start.
+		 * @param outLimit - max number of output symbols.
+		 * @param pResult - output.
+		 * @return - status.
+		 * @throws - can throw exception (bad_alloc).
+		*/
+		Status decode( const unsigned char *const pData, const std::size_t pSize, const std::uint64_t startBit, const std::uint64_t stopBit, const bool useMarkers, const std::size_t outLimit, Result & pResult );
+
+		/*
+		 * Find the first block start in range & decode from it, until
+		 * block boundary at or after stop-offset, or stream end.
+		 *
+		 * @thread_safety - not thread-safe, decoder per thread.
+		 * @param pData - input.
+		 * @param pSize - size of input.
+		 * @param searchBegin - first bit offset to try.
+		 * @param searchEnd - bit offset to stop search at.
+		 * @param stopBit - bit offset to stop decode at the next block boundary.
+		 * @param outLimit - max number of output symbols.
+		 * @param pResult - output.
+		 * @return - true, if block start found & decoded.
+		 * @throws - can throw exception (bad_alloc).
+		*/
+		bool findAndDecode( const unsigned char *const pData, const std::size_t pSize, const std::uint64_t searchBegin, const std::uint64_t searchEnd, const std::uint64_t stopBit, const std::size_t outLimit, Result & pResult );
+
+		// -------------------------------------------------------- \\
+
+	};
+
+	// -------------------------------------------------------- \\
+
+}
\ No newline at end of file
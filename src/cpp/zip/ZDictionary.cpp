@@ -0,0 +1,410 @@
+/*
+* Copyright  2018 Denis Zyamaev (code4un@yandex.ru) All rights reserved.
+* Authors: Denis Zyamaev (code4un@yandex.ru)
+* All rights reserved.
+* API: C++ 11
+* License: see LICENSE.txt
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+* 1. Redistributions of source code must retain the above copyright notice,
+* this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must display the names 'Denis Zyamaev' and
+* in the credits of the application, if such credits exist.
+* The authors of this work must be notified via email (code4un@yandex.ru) in
+* this case of redistribution.
+* 3. Neither the name of copyright holders nor the names of its contributors
+* may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS
+* IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+* PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// HEADER
+#include "ZDictionary.hpp"
+
+// Include FileUtils
+#include "../io/FileUtils.hpp"
+
+// Include C++ filesystem
+#include <filesystem> // std::filesystem::directory_iterator
+
+namespace c0de4un
+{
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Constructor & destructor
+	// ===========================================================
+
+	/* ZDictionary constructor, registry is empty */
+	ZDictionary::ZDictionary( ) noexcept
+		: mDictionaries( )
+	{
+	}
+
+	// ===========================================================
+	// Getters
+	// ===========================================================
+
+	/* Returns number of dictionaries in registry */
+	std::size_t ZDictionary::getCount( ) const noexcept
+	{ return( mDictionaries.size( ) ); }
+
+	/*
+	 * Returns dictionary by id, null if not registered.
+	 *
+	 * @thread_safety - thread-safe, if registry is not changed.
+	 * @param dictionaryID - Adler-32 of dictionary.
+	*/
+	const std::vector<unsigned char> * ZDictionary::find( const std::uint32_t dictionaryID ) const noexcept
+	{
+
+		for ( const std::pair<std::uint32_t, std::vector<unsigned char>> & dictionaryEntry : mDictionaries )
+			if ( dictionaryEntry.first == dictionaryID )
+				return( &dictionaryEntry.second );
+
+		return( nullptr );
+
+	}
+
+	/*
+	 * Returns id of dictionary, Adler-32 as zlib stores it.
+	 *
+	 * @param pDictionary - dictionary.
+	*/
+	std::uint32_t ZDictionary::getID( const std::vector<unsigned char> & pDictionary ) noexcept
+	{ return( static_cast<std::uint32_t>( adler32( adler32( 0, Z_NULL, 0 ), pDictionary.data( ), static_cast<uInt>( pDictionary.size( ) ) ) ) ); }
+
+	// ===========================================================
+	// Methods
+	// ===========================================================
+
+	/*
+	 * Returns counter index of k-mer.
+	 *
+	 * @param pData - k-mer, KMER_SIZE bytes.
+	*/
+	std::size_t ZDictionary::getKmerIndex( const unsigned char *const pData ) noexcept
+	{
+
+		// Multiplicative hash, top bits
+		std::uint64_t kmerValue;
+		std::memcpy( &kmerValue, pData, KMER_SIZE );
+
+		return( static_cast<std::size_t>( ( kmerValue * 0x9E3779B97F4A7C15ULL ) >> ( 64 - TABLE_BITS ) ) );
+
+	}
+
+	/*
+	 * Read file, up to the given size.
+	 *
+	 * @param pPath - file.
+	 * @param pOutput - receives data, appended.
+	 * @param maxSize - max number of bytes.
+	 * @throws - can throw exception.
+	*/
+	void ZDictionary::readFile( const std::string & pPath, std::vector<unsigned char> & pOutput, const std::uint64_t maxSize )
+	{
+
+		// Open
+		std::unique_ptr<std::FILE, int(*)( std::FILE* )> inputFile( std::fopen( pPath.c_str( ), "rb" ), &std::fclose );
+
+		if ( inputFile == nullptr )
+			throw std::runtime_error( "ZDictionary - failed to open file #" + pPath );
+
+		// Read
+		const std::size_t readCount( static_cast<std::size_t>( std::min<std::uint64_t>( FileUtils::getSize( inputFile.get( ) ), maxSize ) ) );
+		const std::size_t outputOffset( pOutput.size( ) );
+		pOutput.resize( outputOffset + readCount );
+
+		if ( fread( pOutput.data( ) + outputOffset, sizeof( unsigned char ), readCount, inputFile.get( ) ) != readCount )
+			throw std::runtime_error( "ZDictionary - failed to read file #" + pPath );
+
+	}
+
+	/*
+	 * Train dictionary.
+	 *
+	 * @param samplePaths - sample files or directories.
+	 * @param pDictionary - receives dictionary.
+	 * @param maxSize - max size of dictionary.
+	 * @throws - can throw exception.
+	*/
+	void ZDictionary::trainDictionary( const std::vector<std::string> & samplePaths, std::vector<unsigned char> & pDictionary, const std::size_t maxSize )
+	{
+
+		// Sample files, directories are read recursively
+		std::vector<std::string> sampleFiles;
+		for ( const std::string & samplePath : samplePaths )
+		{
+
+			if ( std::filesystem::is_directory( std::filesystem::u8path( samplePath ) ) )
+			{
+
+				std::vector<std::string> directoryFiles;
+				for ( const std::filesystem::directory_entry & fileEntry : std::filesystem::recursive_directory_iterator( std::filesystem::u8path( samplePath ) ) )
+					if ( fileEntry.is_regular_file( ) )
+						directoryFiles.push_back( fileEntry.path( ).string( ) );
+
+				std::sort( directoryFiles.begin( ), directoryFiles.end( ) );
+				sampleFiles.insert( sampleFiles.end( ), directoryFiles.begin( ), directoryFiles.end( ) );
+
+			}
+			else
+				sampleFiles.push_back( samplePath );
+
+		}
+
+		// Samples & their documents
+		std::vector<unsigned char> samplesData;
+		std::vector<std::size_t> documentStarts;
+		for ( const std::string & sampleFile : sampleFiles )
+		{
+
+			if ( samplesData.size( ) >= MAX_SAMPLES_SIZE )
+				break;
+
+			const std::size_t fileStart( samplesData.size( ) );
+			readFile( sampleFile, samplesData, MAX_SAMPLES_SIZE - fileStart );
+
+			for ( std::size_t documentStart = fileStart; documentStart < samplesData.size( ); documentStart += DOCUMENT_SIZE )
+				documentStarts.push_back( documentStart );
+
+		}
+
+		// Small samples are dictionary as is
+		if ( samplesData.size( ) <= maxSize )
+		{
+
+			if ( samplesData.empty( ) )
+				throw std::runtime_error( "ZDictionary::train - samples are empty" );
+
+			pDictionary = std::move( samplesData );
+			return;
+
+		}
+
+		// Count documents of each k-mer
+		std::vector<std::uint32_t> kmerCounts( static_cast<std::size_t>( 1 ) << TABLE_BITS, 0 );
+		{
+
+			std::vector<std::uint32_t> kmerDocuments( kmerCounts.size( ), UINT32_MAX );
+			documentStarts.push_back( samplesData.size( ) );
+
+			for ( std::size_t documentIndex = 0; documentIndex + 1 < documentStarts.size( ); documentIndex++ )
+			{
+				for ( std::size_t kmerStart = documentStarts[documentIndex]; kmerStart + KMER_SIZE <= documentStarts[documentIndex + 1]; kmerStart++ )
+				{
+
+					const std::size_t kmerIndex( getKmerIndex( samplesData.data( ) + kmerStart ) );
+
+					// Once per document
+					if ( kmerDocuments[kmerIndex] != documentIndex )
+					{
+						kmerDocuments[kmerIndex] = static_cast<std::uint32_t>( documentIndex );
+						kmerCounts[kmerIndex]++;
+					}
+
+				}
+			}
+
+		}
+
+		// Score of k-mer, it's useful if shared by other documents
+		const auto getScore = [&]( const std::size_t kmerStart ) -> std::uint64_t
+		{
+			const std::uint32_t kmerCount( kmerCounts[getKmerIndex( samplesData.data( ) + kmerStart )] );
+			return( kmerCount > 1 ? kmerCount - 1 : 0 );
+		};
+
+		// Epochs, one segment from each
+		const std::size_t segmentSize( std::min( SEGMENT_SIZE, maxSize ) );
+		const std::size_t windowKmers( segmentSize - KMER_SIZE + 1 );
+		const std::size_t epochCount( maxSize / segmentSize );
+		const std::size_t epochSize( samplesData.size( ) / epochCount );
+
+		// Selected segments: score & start
+		std::vector<std::pair<std::uint64_t, std::size_t>> selectedSegments;
+
+		for ( std::size_t epochIndex = 0; epochIndex < epochCount; epochIndex++ )
+		{
+
+			const std::size_t epochStart( epochIndex * epochSize );
+			const std::size_t epochEnd( epochIndex + 1 < epochCount ? epochStart + epochSize : samplesData.size( ) );
+
+			// Best window of segment size
+			std::uint64_t windowScore( 0 );
+			std::uint64_t bestScore( 0 );
+			std::size_t bestStart( 0 );
+
+			for ( std::size_t kmerStart = epochStart; kmerStart + KMER_SIZE <= epochEnd; kmerStart++ )
+			{
+
+				windowScore += getScore( kmerStart );
+
+				if ( kmerStart >= epochStart + windowKmers )
+					windowScore -= getScore( kmerStart - windowKmers );
+
+				if ( kmerStart + 1 >= epochStart + windowKmers && windowScore > bestScore )
+				{
+					bestScore = windowScore;
+					bestStart = kmerStart + 1 - windowKmers;
+				}
+
+			}
+
+			if ( bestScore == 0 )
+				continue;
+
+			// Select, k-mers of segment are not counted again
+			selectedSegments.emplace_back( bestScore, bestStart );
+
+			for ( std::size_t kmerStart = bestStart; kmerStart < bestStart + windowKmers; kmerStart++ )
+				kmerCounts[getKmerIndex( samplesData.data( ) + kmerStart )] = 0;
+
+		}
+
+		if ( selectedSegments.empty( ) )
+			throw std::runtime_error( "ZDictionary::train - samples have no common substrings" );
+
+		// Best segment last, it's closest to the data
+		std::stable_sort( selectedSegments.begin( ), selectedSegments.end( ), []( const std::pair<std::uint64_t, std::size_t> & a, const std::pair<std::uint64_t, std::size_t> & b ) { return( a.first < b.first ); } );
+
+		pDictionary.clear( );
+		for ( const std::pair<std::uint64_t, std::size_t> & selectedSegment : selectedSegments )
+			pDictionary.insert( pDictionary.end( ), samplesData.begin( ) + selectedSegment.second, samplesData.begin( ) + selectedSegment.second + segmentSize );
+
+	}
+
+	/*
+	 * Add dictionary to registry, same id replaces it.
+	 *
+	 * @thread_safety - not thread-safe.
+	 * @param pDictionary - dictionary.
+	 * @return - id of dictionary.
+	 * @throws - can throw exception (bad_alloc).
+	*/
+	std::uint32_t ZDictionary::add( const std::vector<unsigned char> & pDictionary )
+	{
+
+		const std::uint32_t dictionaryID( getID( pDictionary ) );
+
+		// Replace
+		for ( std::pair<std::uint32_t, std::vector<unsigned char>> & dictionaryEntry : mDictionaries )
+		{
+			if ( dictionaryEntry.first == dictionaryID )
+			{
+				dictionaryEntry.second = pDictionary;
+				return( dictionaryID );
+			}
+		}
+
+		// Add
+		mDictionaries.emplace_back( dictionaryID, pDictionary );
+
+		return( dictionaryID );
+
+	}
+
+	/*
+	 * Add dictionary file, or all FILE_EXTENSION files of directory.
+	 *
+	 * @thread_safety - not thread-safe.
+	 * @param pPath - dictionary file or directory.
+	 * @throws - can throw exception, if file can't be read.
+	*/
+	void ZDictionary::load( const std::string & pPath )
+	{
+
+		// Files
+		std::vector<std::string> dictionaryFiles;
+		if ( std::filesystem::is_directory( std::filesystem::u8path( pPath ) ) )
+		{
+			for ( const std::filesystem::directory_entry & fileEntry : std::filesystem::directory_iterator( std::filesystem::u8path( pPath ) ) )
+				if ( fileEntry.is_regular_file( ) && fileEntry.path( ).extension( ) == FILE_EXTENSION )
+					dictionaryFiles.push_back( fileEntry.path( ).string( ) );
+		}
+		else
+			dictionaryFiles.push_back( pPath );
+
+		// Read & add
+		for ( const std::string & dictionaryFile : dictionaryFiles )
+		{
+
+			std::vector<unsigned char> dictionaryData;
+			read( dictionaryFile, dictionaryData );
+
+			add( dictionaryData );
+
+		}
+
+	}
+
+	/*
+	 * Read dictionary file.
+	 *
+	 * @thread_safety - thread-safe.
+	 * @param pPath - dictionary file.
+	 * @param pDictionary - receives dictionary.
+	 * @throws - can throw exception, if file can't be read.
+	*/
+	void ZDictionary::read( const std::string & pPath, std::vector<unsigned char> & pDictionary )
+	{
+
+		pDictionary.clear( );
+		readFile( pPath, pDictionary, UINT64_MAX );
+
+	}
+
+	/*
+	 * Train dictionary from samples. Samples are files, directories are
+	 * read recursively, files larger than DOCUMENT_SIZE are split.
+	 *
+	 * @thread_safety - thread-safe.
+	 * @param samplePaths - sample files or directories.
+	 * @param pDictionary - receives dictionary.
+	 * @param maxSize - max size of dictionary.
+	 * @return - Z_OK if dictionary trained, Z_ERRNO otherwise.
+	*/
+	int ZDictionary::train( const std::vector<std::string> & samplePaths, std::vector<unsigned char> & pDictionary, const std::size_t maxSize )
+	{
+
+		// Guarded-Block
+		try
+		{
+
+			trainDictionary( samplePaths, pDictionary, std::max( maxSize, KMER_SIZE ) );
+
+		}
+		catch ( const std::exception & pException )
+		{
+
+			// Print ERROR-message
+			std::cout << "ZDictionary::train - error: " << pException.what( ) << std::endl;
+
+			// Return ERROR
+			return( Z_ERRNO );
+
+		}
+
+		// Return OK
+		return( Z_OK );
+
+	}
+
+	// -------------------------------------------------------- \\
+
+}
\ No newline at end of file
@@ -0,0 +1,225 @@
+/*
+* Copyright  2018 Denis Zyamaev (code4un@yandex.ru) All rights reserved.
+* Authors: Denis Zyamaev (code4un@yandex.ru)
+* All rights reserved.
+* API: C++ 11
+* License: see LICENSE.txt
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+* 1. Redistributions of source code must retain the above copyright notice,
+* this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must display the names 'Denis Zyamaev' and
+* in the credits of the application, if such credits exist.
+* The authors of this work must be notified via email (code4un@yandex.ru) in
+* this case of redistribution.
+* 3. Neither the name of copyright holders nor the names of its contributors
+* may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS
+* IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+* PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+// Include 'pch_cxx'
+#include "../pch_cxx.hpp"
+
+namespace c0de4un
+{
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Types
+	// ===========================================================
+
+	/*
+	  * ZDictionary - preset dictionaries for zlib streams.
+	  *
+	  * Trains dictionary from sample documents: k-mers, shared by many
+	  * documents, are counted & the best scoring segment of each part
+	  * of the samples is selected. Segments are ordered by score, the
+	  * best one is the last, closest to the data.
+	  *
+	  * Instance is a registry of dictionaries by id (Adler-32 of the
+	  * dictionary, as zlib stores it in FDICT streams), which inflate
+	  * uses, when stream requires a dictionary.
+	  *
+	  * @language C++ 17
+	  *
+	  * @authors Z. Denis (c0de4un@yandex.ru)
+	  * @version 1.0
+	 */
+	class ZDictionary final
+	{
+
+	private:
+
+		// -------------------------------------------------------- \\
+
+		// ===========================================================
+		// Constants
+		// ===========================================================
+
+		/* Size of k-mer, counted substring */
+		static constexpr std::size_t KMER_SIZE = 8;
+
+		/* Size of selected segment */
+		static constexpr std::size_t SEGMENT_SIZE = 256;
+
+		/* Samples are split into documents of this size */
+		static constexpr std::size_t DOCUMENT_SIZE = 4096;
+
+		/* Max size of samples, read for training */
+		static constexpr std::uint64_t MAX_SAMPLES_SIZE = 134217728;
+
+		/* Number of k-mer counters, as bits */
+		static constexpr int TABLE_BITS = 20;
+
+		// ===========================================================
+		// Fields
+		// ===========================================================
+
+		/* Dictionaries & their ids */
+		std::vector<std::pair<std::uint32_t, std::vector<unsigned char>>> mDictionaries;
+
+		// ===========================================================
+		// Methods
+		// ===========================================================
+
+		/*
+		 * Returns counter index of k-mer.
+		 *
+		 * @param pData - k-mer, KMER_SIZE bytes.
+		*/
+		static std::size_t getKmerIndex( const unsigned char *const pData ) noexcept;
+
+		/*
+		 * Read file, up to the given size.
+		 *
+		 * @param pPath - file.
+		 * @param pOutput - receives data, appended.
+		 * @param maxSize - max number of bytes.
+		 * @throws - can throw exception.
+		*/
+		static void readFile( const std::string & pPath, std::vector<unsigned char> & pOutput, const std::uint64_t maxSize );
+
+		/*
+		 * Train dictionary.
+		 *
+		 * @param samplePaths - sample files or directories.
+		 * @param pDictionary - receives dictionary.
+		 * @param maxSize - max size of dictionary.
+		 * @throws - can throw exception.
+		*/
+		static void trainDictionary( const std::vector<std::string> & samplePaths, std::vector<unsigned char> & pDictionary, const std::size_t maxSize );
+
+		// -------------------------------------------------------- \\
+
+	public:
+
+		// -------------------------------------------------------- \\
+
+		// ===========================================================
+		// Constants
+		// ===========================================================
+
+		/* Max size of dictionary, deflate window */
+		static constexpr std::size_t MAX_SIZE = 32768;
+
+		/* Extension of dictionary files in registry directory */
+		static constexpr const char *const FILE_EXTENSION = ".zdict";
+
+		// ===========================================================
+		// Constructor & destructor
+		// ===========================================================
+
+		/* ZDictionary constructor, registry is empty */
+		ZDictionary( ) noexcept;
+
+		// ===========================================================
+		// Getters
+		// ===========================================================
+
+		/* Returns number of dictionaries in registry */
+		std::size_t getCount( ) const noexcept;
+
+		/*
+		 * Returns dictionary by id, null if not registered.
+		 *
+		 * @thread_safety - thread-safe, if registry is not changed.
+		 * @param dictionaryID - Adler-32 of dictionary.
+		*/
+		const std::vector<unsigned char> * find( const std::uint32_t dictionaryID ) const noexcept;
+
+		/*
+		 * Returns id of dictionary, Adler-32 as zlib stores it.
+		 *
+		 * @param pDictionary - dictionary.
+		*/
+		static std::uint32_t getID( const std::vector<unsigned char> & pDictionary ) noexcept;
+
+		// ===========================================================
+		// Methods
+		// ===========================================================
+
+		/*
+		 * Add dictionary to registry, same id replaces it.
+		 *
+		 * @thread_safety - not thread-safe.
+		 * @param pDictionary - dictionary.
+		 * @return - id of dictionary.
+		 * @throws - can throw exception (bad_alloc).
+		*/
+		std::uint32_t add( const std::vector<unsigned char> & pDictionary );
+
+		/*
+		 * Add dictionary file, or all FILE_EXTENSION files of directory.
+		 *
+		 * @thread_safety - not thread-safe.
+		 * @param pPath - dictionary file or directory.
+		 * @throws - can throw exception, if file can't be read.
+		*/
+		void load( const std::string & pPath );
+
+		/*
+		 * Read dictionary file.
+		 *
+		 * @thread_safety - thread-safe.
+		 * @param pPath - dictionary file.
+		 * @param pDictionary - receives dictionary.
+		 * @throws - can throw exception, if file can't be read.
+		*/
+		static void read( const std::string & pPath, std::vector<unsigned char> & pDictionary );
+
+		/*
+		 * Train dictionary from samples. Samples are files, directories are
+		 * read recursively, files larger than DOCUMENT_SIZE are split.
+		 *
+		 * @thread_safety - thread-safe.
+		 * @param samplePaths - sample files or directories.
+		 * @param pDictionary - receives dictionary.
+		 * @param maxSize - max size of dictionary.
+		 * @return - Z_OK if dictionary trained, Z_ERRNO otherwise.
+		*/
+		static int train( const std::vector<std::string> & samplePaths, std::vector<unsigned char> & pDictionary, const std::size_t maxSize = MAX_SIZE );
+
+		// -------------------------------------------------------- \\
+
+	};
+
+	// -------------------------------------------------------- \\
+
+}
\ No newline at end of file
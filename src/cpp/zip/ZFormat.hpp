@@ -0,0 +1,93 @@
+/*
+* Copyright  2018 Denis Zyamaev (code4un@yandex.ru) All rights reserved.
+* Authors: Denis Zyamaev (code4un@yandex.ru)
+* All rights reserved.
+* API: C++ 11
+* License: see LICENSE.txt
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+* 1. Redistributions of source code must retain the above copyright notice,
+* this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must display the names 'Denis Zyamaev' and
+* in the credits of the application, if such credits exist.
+* The authors of this work must be notified via email (code4un@yandex.ru) in
+* this case of redistribution.
+* 3. Neither the name of copyright holders nor the names of its contributors
+* may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS
+* IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+* PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+// Include 'pch_cxx'
+#include "../pch_cxx.hpp"
+
+namespace c0de4un
+{
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Types
+	// ===========================================================
+
+	/* Compressed stream wrapper */
+	enum class ZFormat : std::uint8_t
+	{
+
+		/* zlib (RFC 1950), Adler-32 */
+		ZLIB = 0,
+
+		/* gzip (RFC 1952), CRC-32 & header with file name & mtime */
+		GZIP = 1
+
+	};
+
+	/* gzip header fields */
+	struct ZGzipHeader final
+	{
+
+		// ===========================================================
+		// Constants
+		// ===========================================================
+
+#if defined(WIN32) || defined(_WIN32)
+		/* OS of this platform (NTFS) */
+		static constexpr int DEFAULT_OS = 11;
+#else
+		/* OS of this platform (Unix) */
+		static constexpr int DEFAULT_OS = 3;
+#endif
+
+		// ===========================================================
+		// Fields
+		// ===========================================================
+
+		/* Original file name, without path. Empty to omit. */
+		std::string name;
+
+		/* Modification time of original file, seconds since 1970. 0 if unknown. */
+		std::uint32_t mtime = 0;
+
+		/* OS code, 255 if unknown */
+		int os = DEFAULT_OS;
+
+	};
+
+	// -------------------------------------------------------- \\
+
+}
\ No newline at end of file
@@ -0,0 +1,766 @@
+/*
+* Copyright  2018 Denis Zyamaev (code4un@yandex.ru) All rights reserved.
+* Authors: Denis Zyamaev (code4un@yandex.ru)
+* All rights reserved.
+* API: C++ 11
+* License: see LICENSE.txt
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+* 1. Redistributions of source code must retain the above copyright notice,
+* this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must display the names 'Denis Zyamaev' and
+* in the credits of the application, if such credits exist.
+* The authors of this work must be notified via email (code4un@yandex.ru) in
+* this case of redistribution.
+* 3. Neither the name of copyright holders nor the names of its contributors
+* may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS
+* IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+* PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// HEADER
+#include "ZIndex.hpp"
+
+// Include FileUtils
+#include "../io/FileUtils.hpp"
+
+namespace c0de4un
+{
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Constructor & destructor
+	// ===========================================================
+
+	/* ZIndex constructor, index is empty */
+	ZIndex::ZIndex( ) noexcept
+		: mPoints( ),
+		mGzip( false ),
+		mCompressedSize( 0 ),
+		mUncompressedSize( 0 )
+	{
+	}
+
+	// ===========================================================
+	// Getters
+	// ===========================================================
+
+	/* Returns number of access-points */
+	std::size_t ZIndex::getPointsCount( ) const noexcept
+	{ return( mPoints.size( ) ); }
+
+	/* Returns size of indexed compressed file */
+	std::uint64_t ZIndex::getCompressedSize( ) const noexcept
+	{ return( mCompressedSize ); }
+
+	/* Returns size of uncompressed data */
+	std::uint64_t ZIndex::getUncompressedSize( ) const noexcept
+	{ return( mUncompressedSize ); }
+
+	// ===========================================================
+	// Methods
+	// ===========================================================
+
+	/*
+	 * Add access-point.
+	 *
+	 * @param pWindow - circular output-window.
+	 * @param windowLeft - number of free bytes at the end of output-window.
+	 * @param bits - number of unused bits of the last consumed byte.
+	 * @param inOffset - compressed offset.
+	 * @param outOffset - uncompressed offset.
+	 * @throws - can throw exception (bad_alloc).
+	*/
+	void ZIndex::addPoint( const unsigned char *const pWindow, const std::size_t windowLeft, const int bits, const std::uint64_t inOffset, const std::uint64_t outOffset )
+	{
+
+		// Access-point
+		mPoints.emplace_back( );
+		AccessPoint & point( mPoints.back( ) );
+
+		point.outOffset = outOffset;
+		point.inOffset = inOffset;
+		point.bits = bits;
+
+		// Unroll window, oldest bytes are at the end of output-window
+		point.window.resize( WINDOW_SIZE );
+		std::memcpy( point.window.data( ), pWindow + WINDOW_SIZE - windowLeft, windowLeft );
+		std::memcpy( point.window.data( ) + windowLeft, pWindow, WINDOW_SIZE - windowLeft );
+
+		// Keep only produced output
+		if ( outOffset < WINDOW_SIZE )
+			point.window.erase( point.window.begin( ), point.window.end( ) - static_cast<std::ptrdiff_t>( outOffset ) );
+
+	}
+
+	/*
+	 * Write little-endian value.
+	 *
+	 * @param pFile - output file.
+	 * @param pValue - value.
+	 * @param bytesCount - number of bytes to write.
+	 * @throws - can throw exception.
+	*/
+	void ZIndex::writeValue( std::FILE *const pFile, const std::uint64_t pValue, const std::size_t bytesCount )
+	{
+
+		// Bytes
+		unsigned char valueBytes[8];
+		for ( std::size_t i = 0; i < bytesCount; i++ )
+			valueBytes[i] = static_cast<unsigned char>( ( pValue >> ( i * 8 ) ) & 0xFF );
+
+		// Write
+		if ( fwrite( valueBytes, sizeof( unsigned char ), bytesCount, pFile ) != bytesCount )
+			throw std::runtime_error( "ZIndex::writeValue - failed to write index file" );
+
+	}
+
+	/*
+	 * Read little-endian value.
+	 *
+	 * @param pFile - input file.
+	 * @param bytesCount - number of bytes to read.
+	 * @return - value.
+	 * @throws - can throw exception, if end of file reached.
+	*/
+	std::uint64_t ZIndex::readValue( std::FILE *const pFile, const std::size_t bytesCount )
+	{
+
+		// Bytes
+		unsigned char valueBytes[8];
+
+		// Read
+		if ( fread( valueBytes, sizeof( unsigned char ), bytesCount, pFile ) != bytesCount )
+			throw std::runtime_error( "ZIndex::readValue - failed to read index file, unexpected end of file" );
+
+		// Value
+		std::uint64_t value( 0 );
+		for ( std::size_t i = 0; i < bytesCount; i++ )
+			value |= static_cast<std::uint64_t>( valueBytes[i] ) << ( i * 8 );
+
+		// Return
+		return( value );
+
+	}
+
+	/*
+	 * Build index, decompressing whole file. Concatenated gzip-members
+	 * are supported.
+	 *
+	 * @thread_safety - not thread-safe.
+	 * @param srcFile - zlib or gzip file, position must be at the beginning.
+	 * @param span - min distance between access-points, in uncompressed bytes.
+	 * @param pOutput - receives decompressed data, so file is decompressed &
+	 * indexed in one pass. Can be null.
+	 * @return - Z_OK if index built, Z_ERRNO otherwise.
+	*/
+	int ZIndex::build( std::FILE *const srcFile, const std::uint64_t span, OutputSink *const pOutput )
+	{
+
+		// Return code
+		int zRet( Z_OK );
+
+		// Compressed bytes consumed
+		std::uint64_t totalIn( 0 );
+
+		// Uncompressed bytes produced
+		std::uint64_t totalOut( 0 );
+
+		// Uncompressed offset of the last access-point
+		std::uint64_t lastPoint( 0 );
+
+		// Input-buffer
+		std::vector<unsigned char> inBuffer;
+
+		// Circular output-window
+		std::vector<unsigned char> window;
+
+		// gzip-header, done-flag tells if stream is gzip
+		gz_header gzipHeader = gz_header( );
+
+		// true, if inflate initialized
+		bool zInitialized( false );
+
+		// z_stream
+		z_stream zStream;
+
+		// Set z_stream state
+		zStream.zalloc = Z_NULL;
+		zStream.zfree = Z_NULL;
+		zStream.opaque = Z_NULL;
+		zStream.avail_in = 0;
+		zStream.next_in = Z_NULL;
+
+		// Read input into z_stream
+		auto readInput = [&]( )
+		{
+
+			zStream.avail_in = static_cast<uInt>( fread( inBuffer.data( ), sizeof( unsigned char ), inBuffer.size( ), srcFile ) );
+			zStream.next_in = inBuffer.data( );
+
+			if ( ferror( srcFile ) )
+				throw std::runtime_error( "io error, can't read input file !" );
+
+		};
+
+		// Guarded-Block
+		try
+		{
+
+			// Reset
+			mPoints.clear( );
+			mGzip = false;
+			mCompressedSize = 0;
+			mUncompressedSize = 0;
+
+			// Allocate buffers
+			inBuffer.resize( CHUNK_SIZE );
+			window.resize( WINDOW_SIZE );
+
+			// Initialize inflate, detecting zlib or gzip wrapper
+			if ( inflateInit2( &zStream, MAX_WBITS + 32 ) != Z_OK )
+				throw std::runtime_error( "failed to initialize decompression stream." );
+
+			// Inflate initialized
+			zInitialized = true;
+
+			// Request gzip-header
+			if ( inflateGetHeader( &zStream, &gzipHeader ) != Z_OK )
+				throw std::runtime_error( "failed to request gzip header." );
+
+			// Output-window is full, to start from the beginning
+			zStream.avail_out = 0;
+
+			// Decompress, stopping at the end of each deflate-block
+			do
+			{
+
+				// Read, if input consumed
+				if ( zStream.avail_in == 0 )
+				{
+
+					readInput( );
+
+					if ( zStream.avail_in == 0 )
+						throw std::runtime_error( "decompression (inflate) failed, unexpected end of file." );
+
+				}
+
+				// Decompress input
+				do
+				{
+
+					// Restart circular output-window
+					if ( zStream.avail_out == 0 )
+					{
+						zStream.avail_out = WINDOW_SIZE;
+						zStream.next_out = window.data( );
+					}
+
+					// State before inflate
+					const unsigned char *const outData( zStream.next_out );
+					const uInt inBefore( zStream.avail_in );
+					const uInt outBefore( zStream.avail_out );
+
+					// Decompress until end of block
+					zRet = inflate( &zStream, Z_BLOCK );
+
+					// Check inflate-status, Z_BUF_ERROR means more input required
+					switch ( zRet )
+					{
+
+					case Z_DATA_ERROR:
+						throw std::runtime_error( "decompression (inflate) failed, data corrupted." );
+
+					case Z_MEM_ERROR:
+						throw std::runtime_error( "decompression (inflate) failed, insufficent memory" );
+
+					case Z_NEED_DICT:
+						throw std::runtime_error( "decompression (inflate) failed, dictionary required." );
+
+					case Z_STREAM_ERROR:
+						throw std::runtime_error( "decompression (inflate) failed, stream structure inconsistent." );
+
+					}
+
+					// Count
+					totalIn += inBefore - zStream.avail_in;
+					totalOut += outBefore - zStream.avail_out;
+
+					// Pass output
+					if ( pOutput != nullptr && outBefore != zStream.avail_out )
+						pOutput->write( outData, outBefore - zStream.avail_out );
+
+					// Member end
+					if ( zRet == Z_STREAM_END )
+						break;
+
+					// Add access-point at block boundary (not after the last block)
+					if ( ( zStream.data_type & 128 ) != 0 && ( zStream.data_type & 64 ) == 0 && ( mPoints.empty( ) || totalOut - lastPoint >= span ) )
+					{
+						addPoint( window.data( ), zStream.avail_out, zStream.data_type & 7, totalIn, totalOut );
+						lastPoint = totalOut;
+					}
+
+				} while ( zStream.avail_in != 0 );
+
+				// gzip-member ended, next member can follow
+				if ( zRet == Z_STREAM_END && gzipHeader.done == 1 )
+				{
+
+					// gzip
+					mGzip = true;
+
+					// Read, if member ended at end of input
+					if ( zStream.avail_in == 0 )
+						readInput( );
+
+					// Start next member, reset clears requested header
+					if ( zStream.avail_in > 0 )
+					{
+
+						gzipHeader = gz_header( );
+						if ( inflateReset( &zStream ) != Z_OK || inflateGetHeader( &zStream, &gzipHeader ) != Z_OK )
+							throw std::runtime_error( "failed to reset inflate." );
+
+						zRet = Z_OK;
+
+					}
+
+				}
+
+			} while ( zRet != Z_STREAM_END );
+
+			// Complete pending writes
+			if ( pOutput != nullptr )
+				pOutput->finish( );
+
+			// Sizes
+			mCompressedSize = totalIn;
+			mUncompressedSize = totalOut;
+
+		}
+		catch ( const std::exception & pException )
+		{
+
+			// Print ERROR-message
+			std::cout << "ZIndex::build - error: " << pException.what( ) << std::endl;
+
+			// Release z_stream resources
+			if ( zInitialized )
+				inflateEnd( &zStream );
+
+			// Clear index
+			mPoints.clear( );
+
+			// Return ERROR
+			return( Z_ERRNO );
+
+		}
+
+		// Release z_stream resources
+		inflateEnd( &zStream );
+
+		// Return OK
+		return( Z_OK );
+
+	}
+
+	/*
+	 * Decompress range, starting from the closest access-point.
+	 *
+	 * @thread_safety - not thread-safe.
+	 * @param srcFile - indexed file.
+	 * @param offset - uncompressed offset of the range.
+	 * @param length - size of the range, cut at the end of data.
+	 * @param pOutput - receives decompressed range.
+	 * @return - Z_OK if range decompressed, Z_ERRNO otherwise.
+	*/
+	int ZIndex::extract( std::FILE *const srcFile, const std::uint64_t offset, const std::uint64_t length, OutputSink & pOutput ) const
+	{
+
+		// Return code
+		int zRet( Z_OK );
+
+		// Input-buffer
+		std::vector<unsigned char> inBuffer;
+
+		// Output-buffer
+		std::vector<unsigned char> outBuffer;
+
+		// true, if inflate initialized
+		bool zInitialized( false );
+
+		// z_stream
+		z_stream zStream;
+
+		// Set z_stream state
+		zStream.zalloc = Z_NULL;
+		zStream.zfree = Z_NULL;
+		zStream.opaque = Z_NULL;
+		zStream.avail_in = 0;
+		zStream.next_in = Z_NULL;
+
+		// Guarded-Block
+		try
+		{
+
+			// Check index
+			if ( mPoints.empty( ) )
+				throw std::runtime_error( "index is empty" );
+
+			if ( FileUtils::getSize( srcFile ) < mCompressedSize )
+				throw std::runtime_error( "index doesn't match the file" );
+
+			// Nothing to extract
+			if ( offset >= mUncompressedSize || length == 0 )
+			{
+				pOutput.finish( );
+				return( Z_OK );
+			}
+
+			// Closest access-point before offset
+			const AccessPoint & point( *( std::upper_bound( mPoints.begin( ), mPoints.end( ), offset, []( const std::uint64_t pOffset, const AccessPoint & pPoint ) { return( pOffset < pPoint.outOffset ); } ) - 1 ) );
+
+			// Uncompressed bytes to skip
+			std::uint64_t skipCount( offset - point.outOffset );
+
+			// Uncompressed bytes to write
+			std::uint64_t leftCount( std::min( length, mUncompressedSize - offset ) );
+
+			// Number of gzip-trailer bytes to skip after raw member end
+			std::size_t trailerLeft( 0 );
+
+			// true, while raw inflate is used (until the first member end)
+			bool rawMode( true );
+
+			// Allocate buffers
+			inBuffer.resize( CHUNK_SIZE );
+			outBuffer.resize( CHUNK_SIZE );
+
+			// Initialize raw inflate, access-point is inside deflate data
+			if ( inflateInit2( &zStream, -MAX_WBITS ) != Z_OK )
+				throw std::runtime_error( "failed to initialize decompression stream." );
+
+			// Inflate initialized
+			zInitialized = true;
+
+			// Seek to access-point, partial byte is read first
+			FileUtils::seek( srcFile, point.inOffset - ( point.bits > 0 ? 1 : 0 ) );
+
+			// Feed remaining bits of the partial byte
+			if ( point.bits > 0 )
+			{
+
+				const int partialByte( fgetc( srcFile ) );
+
+				if ( partialByte == EOF )
+					throw std::runtime_error( "decompression (inflate) failed, unexpected end of file." );
+
+				if ( inflatePrime( &zStream, point.bits, partialByte >> ( 8 - point.bits ) ) != Z_OK )
+					throw std::runtime_error( "failed to set access-point bits." );
+
+			}
+
+			// Set window
+			if ( !point.window.empty( ) && inflateSetDictionary( &zStream, point.window.data( ), static_cast<uInt>( point.window.size( ) ) ) != Z_OK )
+				throw std::runtime_error( "failed to set access-point window." );
+
+			// Decompress range
+			while ( leftCount > 0 )
+			{
+
+				// Read, if input consumed
+				if ( zStream.avail_in == 0 )
+				{
+
+					zStream.avail_in = static_cast<uInt>( fread( inBuffer.data( ), sizeof( unsigned char ), inBuffer.size( ), srcFile ) );
+					zStream.next_in = inBuffer.data( );
+
+					if ( ferror( srcFile ) )
+						throw std::runtime_error( "io error, can't read input file !" );
+
+					if ( zStream.avail_in == 0 )
+						throw std::runtime_error( "decompression (inflate) failed, unexpected end of file." );
+
+				}
+
+				// Skip gzip-trailer, then decompress next member with header
+				if ( trailerLeft > 0 )
+				{
+
+					// Skip
+					const uInt skipBytes( static_cast<uInt>( std::min<std::size_t>( trailerLeft, zStream.avail_in ) ) );
+					zStream.next_in += skipBytes;
+					zStream.avail_in -= skipBytes;
+					trailerLeft -= skipBytes;
+
+					// Next member
+					if ( trailerLeft == 0 && inflateReset2( &zStream, MAX_WBITS + 32 ) != Z_OK )
+						throw std::runtime_error( "failed to reset inflate." );
+
+					continue;
+
+				}
+
+				// Set output
+				zStream.next_out = outBuffer.data( );
+				zStream.avail_out = static_cast<uInt>( outBuffer.size( ) );
+
+				// Decompress
+				zRet = inflate( &zStream, Z_NO_FLUSH );
+
+				// Check inflate-status, Z_BUF_ERROR means more input required
+				switch ( zRet )
+				{
+
+				case Z_DATA_ERROR:
+					throw std::runtime_error( "decompression (inflate) failed, data corrupted." );
+
+				case Z_MEM_ERROR:
+					throw std::runtime_error( "decompression (inflate) failed, insufficent memory" );
+
+				case Z_NEED_DICT:
+					throw std::runtime_error( "decompression (inflate) failed, dictionary required." );
+
+				case Z_STREAM_ERROR:
+					throw std::runtime_error( "decompression (inflate) failed, stream structure inconsistent." );
+
+				}
+
+				// Output
+				const unsigned char * outData( outBuffer.data( ) );
+				std::uint64_t outCount( outBuffer.size( ) - zStream.avail_out );
+
+				// Skip output before offset
+				const std::uint64_t skipBytes( std::min( skipCount, outCount ) );
+				outData += skipBytes;
+				outCount -= skipBytes;
+				skipCount -= skipBytes;
+
+				// Write range
+				outCount = std::min( outCount, leftCount );
+				pOutput.write( outData, static_cast<std::size_t>( outCount ) );
+				leftCount -= outCount;
+
+				// Member end
+				if ( zRet == Z_STREAM_END && leftCount > 0 )
+				{
+
+					// zlib-stream has only one member
+					if ( !mGzip )
+						break;
+
+					// Raw inflate stops before gzip-trailer, next members are read with header & trailer
+					if ( rawMode )
+					{
+						trailerLeft = 8;
+						rawMode = false;
+					}
+					else if ( inflateReset( &zStream ) != Z_OK )
+						throw std::runtime_error( "failed to reset inflate." );
+
+				}
+
+			}
+
+			// Complete pending writes
+			pOutput.finish( );
+
+		}
+		catch ( const std::exception & pException )
+		{
+
+			// Print ERROR-message
+			std::cout << "ZIndex::extract - error: " << pException.what( ) << std::endl;
+
+			// Release z_stream resources
+			if ( zInitialized )
+				inflateEnd( &zStream );
+
+			// Return ERROR
+			return( Z_ERRNO );
+
+		}
+
+		// Release z_stream resources
+		inflateEnd( &zStream );
+
+		// Return OK
+		return( Z_OK );
+
+	}
+
+	/*
+	 * Write index to sidecar-file.
+	 *
+	 * @thread_safety - not thread-safe.
+	 * @param dstFile - output file.
+	 * @return - Z_OK if written, Z_ERRNO otherwise.
+	*/
+	int ZIndex::save( std::FILE *const dstFile ) const
+	{
+
+		// Guarded-Block
+		try
+		{
+
+			// Compressed window
+			std::vector<unsigned char> packedWindow( compressBound( WINDOW_SIZE ) );
+
+			// Header
+			if ( fwrite( FILE_MAGIC, sizeof( unsigned char ), 4, dstFile ) != 4 )
+				throw std::runtime_error( "failed to write index file" );
+
+			writeValue( dstFile, FILE_VERSION, 1 );
+			writeValue( dstFile, mGzip ? 1 : 0, 1 );
+			writeValue( dstFile, mCompressedSize, 8 );
+			writeValue( dstFile, mUncompressedSize, 8 );
+			writeValue( dstFile, mPoints.size( ), 4 );
+
+			// Access-points
+			for ( const AccessPoint & point : mPoints )
+			{
+
+				// Compress window
+				uLongf packedSize( static_cast<uLongf>( packedWindow.size( ) ) );
+				if ( compress2( packedWindow.data( ), &packedSize, point.window.data( ), static_cast<uLong>( point.window.size( ) ), Z_BEST_COMPRESSION ) != Z_OK )
+					throw std::runtime_error( "failed to compress window" );
+
+				// Write
+				writeValue( dstFile, point.outOffset, 8 );
+				writeValue( dstFile, point.inOffset, 8 );
+				writeValue( dstFile, static_cast<std::uint64_t>( point.bits ), 1 );
+				writeValue( dstFile, point.window.size( ), 4 );
+				writeValue( dstFile, packedSize, 4 );
+
+				if ( fwrite( packedWindow.data( ), sizeof( unsigned char ), packedSize, dstFile ) != packedSize )
+					throw std::runtime_error( "failed to write index file" );
+
+			}
+
+			// Flush
+			if ( fflush( dstFile ) != 0 || ferror( dstFile ) )
+				throw std::runtime_error( "failed to write index file" );
+
+		}
+		catch ( const std::exception & pException )
+		{
+
+			// Print ERROR-message
+			std::cout << "ZIndex::save - error: " << pException.what( ) << std::endl;
+
+			// Return ERROR
+			return( Z_ERRNO );
+
+		}
+
+		// Return OK
+		return( Z_OK );
+
+	}
+
+	/*
+	 * Read index from sidecar-file.
+	 *
+	 * @thread_safety - not thread-safe.
+	 * @param srcFile - input file.
+	 * @return - Z_OK if read, Z_ERRNO otherwise.
+	*/
+	int ZIndex::load( std::FILE *const srcFile )
+	{
+
+		// Guarded-Block
+		try
+		{
+
+			// Reset
+			mPoints.clear( );
+
+			// Compressed window
+			std::vector<unsigned char> packedWindow( compressBound( WINDOW_SIZE ) );
+
+			// Signature
+			unsigned char fileMagic[4];
+			if ( fread( fileMagic, sizeof( unsigned char ), 4, srcFile ) != 4 || std::memcmp( fileMagic, FILE_MAGIC, 4 ) != 0 )
+				throw std::runtime_error( "not an index file" );
+
+			if ( readValue( srcFile, 1 ) != FILE_VERSION )
+				throw std::runtime_error( "index file version is not supported" );
+
+			// Header
+			mGzip = readValue( srcFile, 1 ) != 0;
+			mCompressedSize = readValue( srcFile, 8 );
+			mUncompressedSize = readValue( srcFile, 8 );
+
+			const std::uint64_t pointsCount( readValue( srcFile, 4 ) );
+
+			// Access-points
+			for ( std::uint64_t i = 0; i < pointsCount; i++ )
+			{
+
+				// Access-point
+				AccessPoint point;
+				point.outOffset = readValue( srcFile, 8 );
+				point.inOffset = readValue( srcFile, 8 );
+				point.bits = static_cast<int>( readValue( srcFile, 1 ) );
+
+				const std::uint64_t windowSize( readValue( srcFile, 4 ) );
+				const std::uint64_t packedSize( readValue( srcFile, 4 ) );
+
+				// Check
+				if ( point.bits > 7 || windowSize > WINDOW_SIZE || packedSize > packedWindow.size( ) || ( !mPoints.empty( ) && point.outOffset < mPoints.back( ).outOffset ) || ( mPoints.empty( ) && point.outOffset != 0 ) )
+					throw std::runtime_error( "index file corrupted" );
+
+				// Read & decompress window
+				if ( fread( packedWindow.data( ), sizeof( unsigned char ), static_cast<std::size_t>( packedSize ), srcFile ) != packedSize )
+					throw std::runtime_error( "failed to read index file, unexpected end of file" );
+
+				point.window.resize( static_cast<std::size_t>( windowSize ) );
+				uLongf unpackedSize( static_cast<uLongf>( windowSize ) );
+
+				if ( uncompress( point.window.data( ), &unpackedSize, packedWindow.data( ), static_cast<uLong>( packedSize ) ) != Z_OK || unpackedSize != windowSize )
+					throw std::runtime_error( "index file corrupted" );
+
+				// Add
+				mPoints.push_back( std::move( point ) );
+
+			}
+
+		}
+		catch ( const std::exception & pException )
+		{
+
+			// Print ERROR-message
+			std::cout << "ZIndex::load - error: " << pException.what( ) << std::endl;
+
+			// Clear index
+			mPoints.clear( );
+
+			// Return ERROR
+			return( Z_ERRNO );
+
+		}
+
+		// Return OK
+		return( Z_OK );
+
+	}
+
+	// -------------------------------------------------------- \\
+
+}
\ No newline at end of file
@@ -0,0 +1,251 @@
+/*
+* Copyright  2018 Denis Zyamaev (code4un@yandex.ru) All rights reserved.
+* Authors: Denis Zyamaev (code4un@yandex.ru)
+* All rights reserved.
+* API: C++ 11
+* License: see LICENSE.txt
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+* 1. Redistributions of source code must retain the above copyright notice,
+* this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must display the names 'Denis Zyamaev' and
+* in the credits of the application, if such credits exist.
+* The authors of this work must be notified via email (code4un@yandex.ru) in
+* this case of redistribution.
+* 3. Neither the name of copyright holders nor the names of its contributors
+* may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS
+* IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+* PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+// Include 'pch_cxx'
+#include "../pch_cxx.hpp"
+
+// Include OutputSink
+#include "../io/OutputSink.hpp"
+
+namespace c0de4un
+{
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Types
+	// ===========================================================
+
+	/*
+	  * ZIndex - random-access index (zran-style) for zlib or gzip file.
+	  *
+	  * While decompressing, access-points are recorded at deflate-block
+	  * boundaries every span bytes of output: compressed bit-offset &
+	  * last 32 KB of output (window). To read a range, inflate starts at
+	  * the closest preceding access-point, instead of the stream start.
+	  * Index is stored in a sidecar-file, windows are compressed.
+	  *
+	  * @language C++ 17
+	  *
+	  * @authors Z. Denis (c0de4un@yandex.ru)
+	  * @version 1.0
+	 */
+	class ZIndex final
+	{
+
+	private:
+
+		// -------------------------------------------------------- \\
+
+		// ===========================================================
+		// Types
+		// ===========================================================
+
+		/* Position to start decompression from */
+		struct AccessPoint final
+		{
+
+			/* Offset in uncompressed data */
+			std::uint64_t outOffset;
+
+			/* Offset of the first full byte in compressed file */
+			std::uint64_t inOffset;
+
+			/* Number of bits (1-7) of the byte before inOffset, that belong to this point, or 0 */
+			int bits;
+
+			/* Uncompressed data before outOffset, up to WINDOW_SIZE bytes */
+			std::vector<unsigned char> window;
+
+		};
+
+		// ===========================================================
+		// Constants
+		// ===========================================================
+
+		/* Sidecar-file signature */
+		static constexpr unsigned char FILE_MAGIC[4] = { 'Z', 'I', 'D', 'X' };
+
+		/* Sidecar-file version */
+		static constexpr std::uint8_t FILE_VERSION = 1;
+
+		/* Size of input-buffer */
+		static constexpr std::size_t CHUNK_SIZE = 65536;
+
+		// ===========================================================
+		// Fields
+		// ===========================================================
+
+		/* Access-points, sorted by offsets */
+		std::vector<AccessPoint> mPoints;
+
+		/* true, if indexed file is gzip */
+		bool mGzip;
+
+		/* Size of indexed compressed file */
+		std::uint64_t mCompressedSize;
+
+		/* Size of uncompressed data */
+		std::uint64_t mUncompressedSize;
+
+		// ===========================================================
+		// Methods
+		// ===========================================================
+
+		/*
+		 * Add access-point.
+		 *
+		 * @param pWindow - circular output-window.
+		 * @param windowLeft - number of free bytes at the end of output-window.
+		 * @param bits - number of unused bits of the last consumed byte.
+		 * @param inOffset - compressed offset.
+		 * @param outOffset - uncompressed offset.
+		 * @throws - can throw exception (bad_alloc).
+		*/
+		void addPoint( const unsigned char *const pWindow, const std::size_t windowLeft, const int bits, const std::uint64_t inOffset, const std::uint64_t outOffset );
+
+		/*
+		 * Write little-endian value.
+		 *
+		 * @param pFile - output file.
+		 * @param pValue - value.
+		 * @param bytesCount - number of bytes to write.
+		 * @throws - can throw exception.
+		*/
+		static void writeValue( std::FILE *const pFile, const std::uint64_t pValue, const std::size_t bytesCount );
+
+		/*
+		 * Read little-endian value.
+		 *
+		 * @param pFile - input file.
+		 * @param bytesCount - number of bytes to read.
+		 * @return - value.
+		 * @throws - can throw exception, if end of file reached.
+		*/
+		static std::uint64_t readValue( std::FILE *const pFile, const std::size_t bytesCount );
+
+		// -------------------------------------------------------- \\
+
+	public:
+
+		// -------------------------------------------------------- \\
+
+		// ===========================================================
+		// Constants
+		// ===========================================================
+
+		/* Size of deflate window */
+		static constexpr std::size_t WINDOW_SIZE = 32768;
+
+		/* Default distance between access-points, in uncompressed bytes */
+		static constexpr std::uint64_t DEFAULT_SPAN = 1048576;
+
+		// ===========================================================
+		// Constructor & destructor
+		// ===========================================================
+
+		/* ZIndex constructor, index is empty */
+		explicit ZIndex( ) noexcept;
+
+		/* ZIndex destructor */
+		~ZIndex( ) = default;
+
+		// ===========================================================
+		// Getters
+		// ===========================================================
+
+		/* Returns number of access-points */
+		std::size_t getPointsCount( ) const noexcept;
+
+		/* Returns size of indexed compressed file */
+		std::uint64_t getCompressedSize( ) const noexcept;
+
+		/* Returns size of uncompressed data */
+		std::uint64_t getUncompressedSize( ) const noexcept;
+
+		// ===========================================================
+		// Methods
+		// ===========================================================
+
+		/*
+		 * Build index, decompressing whole file. Concatenated gzip-members
+		 * are supported.
+		 *
+		 * @thread_safety - not thread-safe.
+		 * @param srcFile - zlib or gzip file, position must be at the beginning.
+		 * @param span - min distance between access-points, in uncompressed bytes.
+		 * @param pOutput - receives decompressed data, so file is decompressed &
+		 * indexed in one pass. Can be null.
+		 * @return - Z_OK if index built, Z_ERRNO otherwise.
+		*/
+		int build( std::FILE *const srcFile, const std::uint64_t span = DEFAULT_SPAN, OutputSink *const pOutput = nullptr );
+
+		/*
+		 * Decompress range, starting from the closest access-point.
+		 *
+		 * @thread_safety - not thread-safe.
+		 * @param srcFile - indexed file.
+		 * @param offset - uncompressed offset of the range.
+		 * @param length - size of the range, cut at the end of data.
+		 * @param pOutput - receives decompressed range.
+		 * @return - Z_OK if range decompressed, Z_ERRNO otherwise.
+		*/
+		int extract( std::FILE *const srcFile, const std::uint64_t offset, const std::uint64_t length, OutputSink & pOutput ) const;
+
+		/*
+		 * Write index to sidecar-file.
+		 *
+		 * @thread_safety - not thread-safe.
+		 * @param dstFile - output file.
+		 * @return - Z_OK if written, Z_ERRNO otherwise.
+		*/
+		int save( std::FILE *const dstFile ) const;
+
+		/*
+		 * Read index from sidecar-file.
+		 *
+		 * @thread_safety - not thread-safe.
+		 * @param srcFile - input file.
+		 * @return - Z_OK if read, Z_ERRNO otherwise.
+		*/
+		int load( std::FILE *const srcFile );
+
+		// -------------------------------------------------------- \\
+
+	};
+
+	// -------------------------------------------------------- \\
+
+}
\ No newline at end of file
@@ -0,0 +1,534 @@
+/*
+* Copyright  2018 Denis Zyamaev (code4un@yandex.ru) All rights reserved.
+* Authors: Denis Zyamaev (code4un@yandex.ru)
+* All rights reserved.
+* API: C++ 11
+* License: see LICENSE.txt
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+* 1. Redistributions of source code must retain the above copyright notice,
+* this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must display the names 'Denis Zyamaev' and
+* in the credits of the application, if such credits exist.
+* The authors of this work must be notified via email (code4un@yandex.ru) in
+* this case of redistribution.
+* 3. Neither the name of copyright holders nor the names of its contributors
+* may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS
+* IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+* PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// HEADER
+#include "ZParallelDeflate.hpp"
+
+// Include ZArena
+#include "ZArena.hpp"
+
+namespace c0de4un
+{
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Methods
+	// ===========================================================
+
+	/*
+	 * Compress block into raw deflate.
+	 *
+	 * @thread_safety - thread-safe, if block not shared.
+	 * @param pBlock - block to compress.
+	 * @param compressionLevel - Compression-Level to use, must be in range 0-9.
+	 * @param format - stream format, selects check-value.
+	 * @throws - can throw exception.
+	*/
+	void ZParallelDeflate::deflateBlock( Block & pBlock, const int compressionLevel, const ZFormat format )
+	{
+
+		// Return code
+		int zRet( 0 );
+
+		// Number of compressed bytes
+		std::size_t zOutCount( 0 );
+
+		// z_stream
+		z_stream zStream;
+
+		// gzip header of frame
+		gz_header frameHeader = gz_header( );
+
+		// Allocate z_stream state from the thread's arena
+		ZArena::getThreadArena( ).attach( zStream );
+
+		// Initialize raw deflate (negative window-bits), wrapper is written by the caller. Frame is complete gzip-member.
+		if ( deflateInit2( &zStream, compressionLevel, Z_DEFLATED, pBlock.frameHeader != nullptr ? MAX_WBITS + 16 : -MAX_WBITS, 8, Z_DEFAULT_STRATEGY ) != Z_OK )
+			throw std::runtime_error( "ZParallelDeflate::deflateBlock - failed to initialize deflate." );
+
+		// Guarded-Block
+		try
+		{
+
+			// Set gzip header of frame
+			if ( pBlock.frameHeader != nullptr )
+			{
+
+				frameHeader.time = static_cast<uLong>( pBlock.frameHeader->mtime );
+				frameHeader.os = pBlock.frameHeader->os;
+				frameHeader.name = pBlock.frameHeader->name.empty( ) ? Z_NULL : reinterpret_cast<Bytef*>( const_cast<char*>( pBlock.frameHeader->name.c_str( ) ) );
+
+				if ( deflateSetHeader( &zStream, &frameHeader ) != Z_OK )
+					throw std::runtime_error( "ZParallelDeflate::deflateBlock - failed to set gzip header." );
+
+			}
+
+			// Set preset dictionary
+			if ( !pBlock.dictionary.empty( ) && deflateSetDictionary( &zStream, pBlock.dictionary.data( ), static_cast<uInt>( pBlock.dictionary.size( ) ) ) != Z_OK )
+				throw std::runtime_error( "ZParallelDeflate::deflateBlock - failed to set dictionary." );
+
+			// Allocate output, enough for most blocks
+			pBlock.output.resize( deflateBound( &zStream, static_cast<uLong>( pBlock.input.size( ) ) ) + 16 );
+
+			// Set input
+			zStream.next_in = pBlock.input.data( );
+			zStream.avail_in = static_cast<uInt>( pBlock.input.size( ) );
+
+			// Compress. Last block & frame finish the stream, others end byte-aligned with empty stored block.
+			do
+			{
+
+				// Grow output-buffer by +50%
+				if ( zOutCount == pBlock.output.size( ) )
+					pBlock.output.resize( pBlock.output.size( ) + pBlock.output.size( ) / 2 );
+
+				// Set output
+				zStream.next_out = pBlock.output.data( ) + zOutCount;
+				zStream.avail_out = static_cast<uInt>( pBlock.output.size( ) - zOutCount );
+
+				// Compress
+				zRet = deflate( &zStream, pBlock.last || pBlock.frameHeader != nullptr ? Z_FINISH : Z_SYNC_FLUSH );
+
+				// Check compression result-status.
+				if ( zRet == Z_STREAM_ERROR )
+					throw std::runtime_error( "ZParallelDeflate::deflateBlock - compression failed, stream error" );
+
+				// Count compressed bytes
+				zOutCount = pBlock.output.size( ) - zStream.avail_out;
+
+			} while ( zStream.avail_out == 0 );
+
+		}
+		catch ( ... )
+		{
+
+			// Release z_stream resources
+			deflateEnd( &zStream );
+
+			// Rethrow
+			throw;
+
+		}
+
+		// Release z_stream resources
+		deflateEnd( &zStream );
+
+		// Cut output
+		pBlock.output.resize( zOutCount );
+
+		// Compute check-value
+		if ( format == ZFormat::GZIP || pBlock.frameHeader != nullptr )
+			pBlock.check = crc32( crc32( 0L, Z_NULL, 0 ), pBlock.input.data( ), static_cast<uInt>( pBlock.input.size( ) ) );
+		else
+			pBlock.check = adler32( adler32( 0L, Z_NULL, 0 ), pBlock.input.data( ), static_cast<uInt>( pBlock.input.size( ) ) );
+
+	}
+
+	/*
+	 * Write zlib or gzip header for the given compression-level.
+	 *
+	 * @param dstFile - output file.
+	 * @param compressionLevel - Compression-Level, must be in range 0-9.
+	 * @param format - stream format.
+	 * @param gzipHeader - gzip header fields, used if format is gzip.
+	 * @throws - can throw exception.
+	*/
+	void ZParallelDeflate::writeHeader( std::FILE *const dstFile, const int compressionLevel, const ZFormat format, const ZGzipHeader & gzipHeader )
+	{
+
+		// gzip-header (RFC 1952)
+		if ( format == ZFormat::GZIP )
+		{
+
+			// Header bytes: magic, deflate, flags (FNAME), mtime (little-endian), extra-flags, OS
+			const unsigned char headerBytes[10] = { 0x1F, 0x8B, Z_DEFLATED, static_cast<unsigned char>( gzipHeader.name.empty( ) ? 0 : 0x08 ),
+				static_cast<unsigned char>( gzipHeader.mtime & 0xFF ), static_cast<unsigned char>( ( gzipHeader.mtime >> 8 ) & 0xFF ), static_cast<unsigned char>( ( gzipHeader.mtime >> 16 ) & 0xFF ), static_cast<unsigned char>( ( gzipHeader.mtime >> 24 ) & 0xFF ),
+				static_cast<unsigned char>( compressionLevel == Z_BEST_COMPRESSION ? 2 : compressionLevel == Z_BEST_SPEED ? 4 : 0 ), static_cast<unsigned char>( gzipHeader.os ) };
+
+			// Write header & zero-terminated name
+			if ( fwrite( headerBytes, sizeof( unsigned char ), 10, dstFile ) != 10
+				|| ( !gzipHeader.name.empty( ) && fwrite( gzipHeader.name.c_str( ), sizeof( char ), gzipHeader.name.size( ) + 1, dstFile ) != gzipHeader.name.size( ) + 1 )
+				|| ferror( dstFile ) )
+				throw std::runtime_error( "ZParallelDeflate::writeHeader - failed to write output file" );
+
+			// Stop
+			return;
+
+		}
+
+		// Level-flags, the same as deflate writes
+		const unsigned int levelFlags( compressionLevel == Z_DEFAULT_COMPRESSION ? 2 : compressionLevel < 2 ? 0 : compressionLevel < 6 ? 1 : compressionLevel == 6 ? 2 : 3 );
+
+		// CMF (deflate, 32 KB window) & FLG
+		unsigned int header( ( ( Z_DEFLATED + ( ( MAX_WBITS - 8 ) << 4 ) ) << 8 ) | ( levelFlags << 6 ) );
+
+		// FCHECK
+		header += 31 - ( header % 31 );
+
+		// Header bytes
+		const unsigned char headerBytes[2] = { static_cast<unsigned char>( header >> 8 ), static_cast<unsigned char>( header & 0xFF ) };
+
+		// Write
+		if ( fwrite( headerBytes, sizeof( unsigned char ), 2, dstFile ) != 2 || ferror( dstFile ) )
+			throw std::runtime_error( "ZParallelDeflate::writeHeader - failed to write output file" );
+
+	}
+
+	/*
+	 * Write zlib or gzip trailer.
+	 *
+	 * @param dstFile - output file.
+	 * @param format - stream format.
+	 * @param check - combined check-value.
+	 * @param inputSize - size of uncompressed data.
+	 * @throws - can throw exception.
+	*/
+	void ZParallelDeflate::writeTrailer( std::FILE *const dstFile, const ZFormat format, const uLong check, const std::uint64_t inputSize )
+	{
+
+		// Trailer bytes
+		unsigned char trailerBytes[8];
+
+		// Number of trailer bytes
+		std::size_t trailerSize( 0 );
+
+		if ( format == ZFormat::GZIP )
+		{
+
+			// CRC-32 & input size modulo 2^32, little-endian
+			for ( std::size_t i = 0; i < 4; i++ )
+			{
+				trailerBytes[i] = static_cast<unsigned char>( ( check >> ( i * 8 ) ) & 0xFF );
+				trailerBytes[4 + i] = static_cast<unsigned char>( ( inputSize >> ( i * 8 ) ) & 0xFF );
+			}
+
+			trailerSize = 8;
+
+		}
+		else
+		{
+
+			// Adler-32, big-endian
+			for ( std::size_t i = 0; i < 4; i++ )
+				trailerBytes[i] = static_cast<unsigned char>( ( check >> ( 24 - i * 8 ) ) & 0xFF );
+
+			trailerSize = 4;
+
+		}
+
+		// Write trailer
+		if ( fwrite( trailerBytes, sizeof( unsigned char ), trailerSize, dstFile ) != trailerSize || ferror( dstFile ) )
+			throw std::runtime_error( "ZParallelDeflate::writeTrailer - failed to write output file" );
+
+	}
+
+	/*
+	 * Compress the given file on multiple threads, as single stream or as frames.
+	 *
+	 * @thread_safety - not thread-safe.
+	 * @param srcFile - file to compress.
+	 * @param dstFile - output file.
+	 * @param compressionLevel - Compression-Level to use, must be in range 0-9.
+	 * @param threadsCount - number of worker-threads, 0 to use all hardware-threads.
+	 * @param blockSize - size of uncompressed block.
+	 * @param format - stream format, must be gzip for frames.
+	 * @param gzipHeader - gzip header fields, used if format is gzip.
+	 * @param seekable - true to write independent frames & frame table.
+	 * @throws - can throw exception.
+	*/
+	void ZParallelDeflate::deflateBlocks( std::FILE *const srcFile, std::FILE *const dstFile, const int compressionLevel, const std::uint32_t threadsCount, const std::uint32_t blockSize, const ZFormat format, const ZGzipHeader & gzipHeader, const bool seekable )
+	{
+
+		// Worker-threads
+		ThreadPool threadPool( threadsCount );
+
+		// Max number of blocks read & not written yet, limits memory usage
+		const std::size_t maxBlocksInFlight( threadPool.getThreadsCount( ) * 2 );
+
+		// Blocks in output order
+		std::deque<std::pair<std::shared_ptr<Block>, std::future<void>>> blocksInFlight;
+
+		// Combined check-value
+		uLong check( format == ZFormat::GZIP ? crc32( 0L, Z_NULL, 0 ) : adler32( 0L, Z_NULL, 0 ) );
+
+		// Size of uncompressed data
+		std::uint64_t inputSize( 0 );
+
+		// Number of bytes read
+		std::size_t readCount( 0 );
+
+		// Frames, written to frame table
+		std::vector<ZSeekable::Frame> frames;
+
+		// Offset of the next frame
+		std::uint64_t frameOffset( 0 );
+
+		// gzip header fields of frames after the first, without name
+		ZGzipHeader nextFrameHeader( gzipHeader );
+		nextFrameHeader.name.clear( );
+
+		// Write header, frames have own headers
+		if ( !seekable )
+			writeHeader( dstFile, compressionLevel, format, gzipHeader );
+
+		// Read first block
+		std::shared_ptr<Block> currentBlock( std::make_shared<Block>( ) );
+		currentBlock->input.resize( blockSize );
+		currentBlock->frameHeader = seekable ? &gzipHeader : nullptr;
+		readCount = fread( currentBlock->input.data( ), sizeof( unsigned char ), blockSize, srcFile );
+		currentBlock->input.resize( readCount );
+
+		// Check io errors
+		if ( ferror( srcFile ) )
+			throw std::runtime_error( "ZParallelDeflate::deflateFILE - io error, can't read input file !" );
+
+		// true, if input-file is fully read
+		bool inputEnd( readCount < blockSize );
+
+		// Compress blocks. Empty input produces single empty last block.
+		while ( currentBlock != nullptr )
+		{
+
+			// Next block
+			std::shared_ptr<Block> nextBlock( nullptr );
+
+			// Read next block, to know if current block is the last one
+			if ( !inputEnd )
+			{
+
+				// Read
+				nextBlock = std::make_shared<Block>( );
+				nextBlock->input.resize( blockSize );
+				nextBlock->frameHeader = seekable ? &nextFrameHeader : nullptr;
+				readCount = fread( nextBlock->input.data( ), sizeof( unsigned char ), blockSize, srcFile );
+				nextBlock->input.resize( readCount );
+
+				// Check io errors
+				if ( ferror( srcFile ) )
+					throw std::runtime_error( "ZParallelDeflate::deflateFILE - io error, can't read input file !" );
+
+				// Check end of input
+				inputEnd = readCount < blockSize;
+
+				// Set dictionary from the tail of the current block, frames are independent
+				if ( readCount == 0 )
+					nextBlock = nullptr;
+				else if ( !seekable )
+					nextBlock->dictionary.assign( currentBlock->input.end( ) - std::min<std::size_t>( currentBlock->input.size( ), DICTIONARY_SIZE ), currentBlock->input.end( ) );
+
+			}
+
+			// Last block finishes the stream
+			currentBlock->last = ( nextBlock == nullptr );
+
+			// Compress on worker-thread
+			blocksInFlight.emplace_back( currentBlock, threadPool.submit( [currentBlock, compressionLevel, format]( ) { deflateBlock( *currentBlock, compressionLevel, format ); } ) );
+
+			// Write compressed blocks in order
+			while ( !blocksInFlight.empty( ) && ( blocksInFlight.size( ) >= maxBlocksInFlight || nextBlock == nullptr ) )
+			{
+
+				// Oldest block
+				std::shared_ptr<Block> & writeBlock( blocksInFlight.front( ).first );
+
+				// Wait, rethrows worker exception
+				blocksInFlight.front( ).second.get( );
+
+				// Write compressed output
+				if ( fwrite( writeBlock->output.data( ), sizeof( unsigned char ), writeBlock->output.size( ), dstFile ) != writeBlock->output.size( ) || ferror( dstFile ) )
+					throw std::runtime_error( "ZParallelDeflate::deflateFILE - failed to write output file" );
+
+				// Record frame
+				if ( seekable )
+				{
+
+					// Frame
+					ZSeekable::Frame frame;
+					frame.inOffset = frameOffset;
+					frame.outOffset = inputSize;
+					frame.inSize = static_cast<std::uint32_t>( writeBlock->output.size( ) );
+					frame.outSize = static_cast<std::uint32_t>( writeBlock->input.size( ) );
+					frame.crc = static_cast<std::uint32_t>( writeBlock->check );
+
+					// Add
+					frames.push_back( frame );
+					frameOffset += writeBlock->output.size( );
+
+				}
+
+				// Combine check-value
+				if ( format == ZFormat::GZIP )
+					check = crc32_combine( check, writeBlock->check, static_cast<z_off_t>( writeBlock->input.size( ) ) );
+				else
+					check = adler32_combine( check, writeBlock->check, static_cast<z_off_t>( writeBlock->input.size( ) ) );
+
+				// Count input
+				inputSize += writeBlock->input.size( );
+
+				// Release block
+				blocksInFlight.pop_front( );
+
+			}
+
+			// Next
+			currentBlock = nextBlock;
+
+		}
+
+		// Write trailer or frame table
+		if ( seekable )
+			ZSeekable::writeTable( dstFile, frames );
+		else
+			writeTrailer( dstFile, format, check, inputSize );
+
+	}
+
+	/*
+	 * Compress the given file as zlib or gzip on multiple threads.
+	 *
+	 * @thread_safety - not thread-safe.
+	 * @param srcFile - file to compress.
+	 * @param dstFile - output file.
+	 * @param compressionLevel - Compression-Level to use, must be in range 0-9.
+	 * @param threadsCount - number of worker-threads, 0 to use all hardware-threads.
+	 * @param blockSize - size of uncompressed block, must be greater than DICTIONARY_SIZE.
+	 * @param format - stream format.
+	 * @param gzipHeader - gzip header fields, used if format is gzip.
+	 * @return - Z_OK if compression complete, Z_ERRNO otherwise.
+	*/
+	int ZParallelDeflate::deflateFILE( std::FILE *const srcFile, std::FILE *const dstFile, const int compressionLevel, const std::uint32_t threadsCount, const std::uint32_t blockSize, const ZFormat format, const ZGzipHeader & gzipHeader )
+	{
+
+		// Guarded-Block
+		try
+		{
+
+			// Check arguments
+			if ( compressionLevel < Z_DEFAULT_COMPRESSION || compressionLevel > Z_BEST_COMPRESSION )
+				throw std::runtime_error( "ZParallelDeflate::deflateFILE - wrong compression level" );
+
+			if ( blockSize <= DICTIONARY_SIZE )
+				throw std::runtime_error( "ZParallelDeflate::deflateFILE - block size must be greater than dictionary size" );
+
+			// Compress
+			deflateBlocks( srcFile, dstFile, compressionLevel, threadsCount, blockSize, format, gzipHeader, false );
+
+		}
+		catch ( const std::exception & pException )
+		{
+
+			// Print ERROR-message
+			std::cout << "ZParallelDeflate::deflateFILE - error: " << pException.what( ) << std::endl;
+
+			// Return ERROR
+			return( Z_ERRNO );
+
+		}
+		catch ( ... )
+		{
+
+			// Print ERROR-message
+			std::cout << "ZParallelDeflate::deflateFILE - unknown error" << std::endl;
+
+			// Return ERROR
+			return( Z_ERRNO );
+
+		}
+
+		// Return Z_OK
+		return( Z_OK );
+
+	}
+
+	/*
+	 * Compress the given file as seekable gzip on multiple threads:
+	 * independent frames of frameSize uncompressed bytes & frame table.
+	 * Output is readable by ZStream::inflateFILE & by ZSeekable.
+	 *
+	 * @thread_safety - not thread-safe.
+	 * @param srcFile - file to compress.
+	 * @param dstFile - output file.
+	 * @param compressionLevel - Compression-Level to use, must be in range 0-9.
+	 * @param threadsCount - number of worker-threads, 0 to use all hardware-threads.
+	 * @param frameSize - size of uncompressed frame, up to ZSeekable::MAX_FRAME_SIZE.
+	 * @param gzipHeader - gzip header fields, name is written to the first frame.
+	 * @return - Z_OK if compression complete, Z_ERRNO otherwise.
+	*/
+	int ZParallelDeflate::deflateSeekableFILE( std::FILE *const srcFile, std::FILE *const dstFile, const int compressionLevel, const std::uint32_t threadsCount, const std::uint32_t frameSize, const ZGzipHeader & gzipHeader )
+	{
+
+		// Guarded-Block
+		try
+		{
+
+			// Check arguments
+			if ( compressionLevel < Z_DEFAULT_COMPRESSION || compressionLevel > Z_BEST_COMPRESSION )
+				throw std::runtime_error( "ZParallelDeflate::deflateSeekableFILE - wrong compression level" );
+
+			if ( frameSize == 0 || frameSize > ZSeekable::MAX_FRAME_SIZE )
+				throw std::runtime_error( "ZParallelDeflate::deflateSeekableFILE - wrong frame size" );
+
+			// Compress
+			deflateBlocks( srcFile, dstFile, compressionLevel, threadsCount, frameSize, ZFormat::GZIP, gzipHeader, true );
+
+		}
+		catch ( const std::exception & pException )
+		{
+
+			// Print ERROR-message
+			std::cout << "ZParallelDeflate::deflateSeekableFILE - error: " << pException.what( ) << std::endl;
+
+			// Return ERROR
+			return( Z_ERRNO );
+
+		}
+		catch ( ... )
+		{
+
+			// Print ERROR-message
+			std::cout << "ZParallelDeflate::deflateSeekableFILE - unknown error" << std::endl;
+
+			// Return ERROR
+			return( Z_ERRNO );
+
+		}
+
+		// Return Z_OK
+		return( Z_OK );
+
+	}
+
+	// -------------------------------------------------------- \\
+
+}
\ No newline at end of file
@@ -0,0 +1,226 @@
+/*
+* Copyright  2018 Denis Zyamaev (code4un@yandex.ru) All rights reserved.
+* Authors: Denis Zyamaev (code4un@yandex.ru)
+* All rights reserved.
+* API: C++ 11
+* License: see LICENSE.txt
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+* 1. Redistributions of source code must retain the above copyright notice,
+* this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must display the names 'Denis Zyamaev' and
+* in the credits of the application, if such credits exist.
+* The authors of this work must be notified via email (code4un@yandex.ru) in
+* this case of redistribution.
+* 3. Neither the name of copyright holders nor the names of its contributors
+* may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS
+* IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+* PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+// Include 'pch_cxx'
+#include "../pch_cxx.hpp"
+
+// Include ThreadPool
+#include "../core/ThreadPool.hpp"
+
+// Include ZFormat
+#include "ZFormat.hpp"
+
+// Include ZSeekable
+#include "ZSeekable.hpp"
+
+namespace c0de4un
+{
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Types
+	// ===========================================================
+
+	/*
+	  * ZParallelDeflate - block-parallel (pigz-style) compression.
+	  *
+	  * Input is split into blocks, each block is compressed on a
+	  * worker-thread as raw deflate, using last 32 KB of the previous
+	  * block as preset dictionary. Blocks are joined with sync-flush
+	  * and check-value is combined, so output is a single standard
+	  * zlib or gzip stream, readable by ZStream::inflateFILE.
+	  *
+	  * Seekable mode compresses each block into independent gzip-member
+	  * (frame) without dictionary, & writes frame table (see ZSeekable).
+	  *
+	  * @language C++ 17
+	  *
+	  * @authors Z. Denis (c0de4un@yandex.ru)
+	  * @version 1.0
+	 */
+	class ZParallelDeflate final
+	{
+
+	private:
+
+		// -------------------------------------------------------- \\
+
+		// ===========================================================
+		// Types
+		// ===========================================================
+
+		/* Block of input & it's compressed output */
+		struct Block final
+		{
+
+			/* Uncompressed data */
+			std::vector<unsigned char> input;
+
+			/* Preset dictionary (tail of the previous block), can be empty */
+			std::vector<unsigned char> dictionary;
+
+			/* Compressed data */
+			std::vector<unsigned char> output;
+
+			/* Check-value of input, Adler-32 (zlib) or CRC-32 (gzip) */
+			uLong check;
+
+			/* true, if this is the last block of the stream */
+			bool last;
+
+			/* gzip header fields, if block is compressed as independent gzip-member (frame), null otherwise */
+			const ZGzipHeader * frameHeader;
+
+		};
+
+		// ===========================================================
+		// Methods
+		// ===========================================================
+
+		/*
+		 * Compress block into raw deflate.
+		 *
+		 * @thread_safety - thread-safe, if block not shared.
+		 * @param pBlock - block to compress.
+		 * @param compressionLevel - Compression-Level to use, must be in range 0-9.
+		 * @param format - stream format, selects check-value.
+		 * @throws - can throw exception.
+		*/
+		static void deflateBlock( Block & pBlock, const int compressionLevel, const ZFormat format );
+
+		/*
+		 * Compress the given file on multiple threads, as single stream or as frames.
+		 *
+		 * @thread_safety - not thread-safe.
+		 * @param srcFile - file to compress.
+		 * @param dstFile - output file.
+		 * @param compressionLevel - Compression-Level to use, must be in range 0-9.
+		 * @param threadsCount - number of worker-threads, 0 to use all hardware-threads.
+		 * @param blockSize - size of uncompressed block.
+		 * @param format - stream format, must be gzip for frames.
+		 * @param gzipHeader - gzip header fields, used if format is gzip.
+		 * @param seekable - true to write independent frames & frame table.
+		 * @throws - can throw exception.
+		*/
+		static void deflateBlocks( std::FILE *const srcFile, std::FILE *const dstFile, const int compressionLevel, const std::uint32_t threadsCount, const std::uint32_t blockSize, const ZFormat format, const ZGzipHeader & gzipHeader, const bool seekable );
+
+		// -------------------------------------------------------- \\
+
+	public:
+
+		// -------------------------------------------------------- \\
+
+		// ===========================================================
+		// Constants
+		// ===========================================================
+
+		/* Default size of uncompressed block */
+		static constexpr std::uint32_t DEFAULT_BLOCK_SIZE = 1048576;
+
+		/* Size of the deflate window (preset dictionary) */
+		static constexpr std::uint32_t DICTIONARY_SIZE = 32768;
+
+		// ===========================================================
+		// Constructor & destructor
+		// ===========================================================
+
+		/* @deleted ZParallelDeflate constructor, only static methods */
+		ZParallelDeflate( ) = delete;
+
+		// ===========================================================
+		// Methods
+		// ===========================================================
+
+		/*
+		 * Write zlib or gzip header for the given compression-level.
+		 *
+		 * @param dstFile - output file.
+		 * @param compressionLevel - Compression-Level, must be in range 0-9.
+		 * @param format - stream format.
+		 * @param gzipHeader - gzip header fields, used if format is gzip.
+		 * @throws - can throw exception.
+		*/
+		static void writeHeader( std::FILE *const dstFile, const int compressionLevel, const ZFormat format, const ZGzipHeader & gzipHeader );
+
+		/*
+		 * Write zlib or gzip trailer.
+		 *
+		 * @param dstFile - output file.
+		 * @param format - stream format.
+		 * @param check - combined check-value.
+		 * @param inputSize - size of uncompressed data.
+		 * @throws - can throw exception.
+		*/
+		static void writeTrailer( std::FILE *const dstFile, const ZFormat format, const uLong check, const std::uint64_t inputSize );
+
+		/*
+		 * Compress the given file as zlib or gzip on multiple threads.
+		 *
+		 * @thread_safety - not thread-safe.
+		 * @param srcFile - file to compress.
+		 * @param dstFile - output file.
+		 * @param compressionLevel - Compression-Level to use, must be in range 0-9.
+		 * @param threadsCount - number of worker-threads, 0 to use all hardware-threads.
+		 * @param blockSize - size of uncompressed block, must be greater than DICTIONARY_SIZE.
+		 * @param format - stream format.
+		 * @param gzipHeader - gzip header fields, used if format is gzip.
+		 * @return - Z_OK if compression complete, Z_ERRNO otherwise.
+		*/
+		static int deflateFILE( std::FILE *const srcFile, std::FILE *const dstFile, const int compressionLevel, const std::uint32_t threadsCount = 0, const std::uint32_t blockSize = DEFAULT_BLOCK_SIZE, const ZFormat format = ZFormat::ZLIB, const ZGzipHeader & gzipHeader = ZGzipHeader( ) );
+
+		/*
+		 * Compress the given file as seekable gzip on multiple threads:
+		 * independent frames of frameSize uncompressed bytes & frame table.
+		 * Output is readable by ZStream::inflateFILE & by ZSeekable.
+		 *
+		 * @thread_safety - not thread-safe.
+		 * @param srcFile - file to compress.
+		 * @param dstFile - output file.
+		 * @param compressionLevel - Compression-Level to use, must be in range 0-9.
+		 * @param threadsCount - number of worker-threads, 0 to use all hardware-threads.
+		 * @param frameSize - size of uncompressed frame, up to ZSeekable::MAX_FRAME_SIZE.
+		 * @param gzipHeader - gzip header fields, name is written to the first frame.
+		 * @return - Z_OK if compression complete, Z_ERRNO otherwise.
+		*/
+		static int deflateSeekableFILE( std::FILE *const srcFile, std::FILE *const dstFile, const int compressionLevel, const std::uint32_t threadsCount = 0, const std::uint32_t frameSize = ZSeekable::DEFAULT_FRAME_SIZE, const ZGzipHeader & gzipHeader = ZGzipHeader( ) );
+
+		// -------------------------------------------------------- \\
+
+	};
+
+	// -------------------------------------------------------- \\
+
+}
\ No newline at end of file
@@ -0,0 +1,526 @@
+/*
+* Copyright  2018 Denis Zyamaev (code4un@yandex.ru) All rights reserved.
+* Authors: Denis Zyamaev (code4un@yandex.ru)
+* All rights reserved.
+* API: C++ 11
+* License: see LICENSE.txt
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+* 1. Redistributions of source code must retain the above copyright notice,
+* this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must display the names 'Denis Zyamaev' and
+* in the credits of the application, if such credits exist.
+* The authors of this work must be notified via email (code4un@yandex.ru) in
+* this case of redistribution.
+* 3. Neither the name of copyright holders nor the names of its contributors
+* may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS
+* IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+* PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// HEADER
+#include "ZParallelInflate.hpp"
+
+// Include ZArena
+#include "ZArena.hpp"
+
+// Include ZSeekable
+#include "ZSeekable.hpp"
+
+// Include ZSpeculativeInflate
+#include "ZSpeculativeInflate.hpp"
+
+// Include ZStream
+#include "ZStream.hpp"
+
+// Include FileUtils
+#include "../io/FileUtils.hpp"
+
+namespace c0de4un
+{
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Methods
+	// ===========================================================
+
+	/*
+	 * Returns true, if gzip-header can start at data.
+	 *
+	 * @param pData - data, at least 4 bytes.
+	*/
+	bool ZParallelInflate::isMemberStart( const unsigned char *const pData ) noexcept
+	{
+		// Magic, deflate, reserved flags are 0
+		return( pData[0] == 0x1F && pData[1] == 0x8B && pData[2] == Z_DEFLATED && ( pData[3] & 0xE0 ) == 0 );
+	}
+
+	/*
+	 * Returns true, if data starts with zlib-header, requiring preset dictionary.
+	 *
+	 * @param pData - data, at least 2 bytes.
+	*/
+	bool ZParallelInflate::isDictionaryStream( const unsigned char *const pData ) noexcept
+	{
+		// Deflate, header check, FDICT flag
+		return( ( pData[0] & 0x0F ) == Z_DEFLATED && ( pData[0] * 256 + pData[1] ) % 31 == 0 && ( pData[1] & 0x20 ) != 0 );
+	}
+
+	/*
+	 * Inflate segment as complete gzip-member.
+	 *
+	 * @thread_safety - thread-safe, if segment not shared.
+	 * @param pSegment - segment, receives output & complete-flag.
+	 * @throws - can throw exception.
+	*/
+	void ZParallelInflate::inflateSegment( Segment & pSegment )
+	{
+
+		// Return code
+		int zRet( Z_OK );
+
+		// Number of decompressed bytes
+		std::size_t zOutCount( 0 );
+
+		// z_stream
+		z_stream zStream;
+
+		// Allocate z_stream state from the thread's arena
+		ZArena::getThreadArena( ).attach( zStream );
+		zStream.next_in = pSegment.input.data( );
+		zStream.avail_in = static_cast<uInt>( pSegment.input.size( ) );
+
+		// Initialize gzip inflate
+		if ( inflateInit2( &zStream, MAX_WBITS + 16 ) != Z_OK )
+			throw std::runtime_error( "ZParallelInflate::inflateSegment - failed to initialize inflate." );
+
+		// Guarded-Block
+		try
+		{
+
+			// Allocate output, guess from input size
+			pSegment.output.resize( std::min( pSegment.input.size( ) * 4 + 1024, MAX_OUTPUT_SIZE ) );
+
+			// Decompress, until member end or error
+			while ( true )
+			{
+
+				// Grow output-buffer by +50%, up to limit
+				if ( zOutCount == pSegment.output.size( ) )
+				{
+
+					if ( pSegment.output.size( ) >= MAX_OUTPUT_SIZE )
+						break;
+
+					pSegment.output.resize( std::min( pSegment.output.size( ) + pSegment.output.size( ) / 2, MAX_OUTPUT_SIZE ) );
+
+				}
+
+				// Set output
+				zStream.next_out = pSegment.output.data( ) + zOutCount;
+				zStream.avail_out = static_cast<uInt>( pSegment.output.size( ) - zOutCount );
+
+				// Decompress
+				zRet = inflate( &zStream, Z_NO_FLUSH );
+
+				// Count decompressed bytes
+				zOutCount = pSegment.output.size( ) - zStream.avail_out;
+
+				// Member must end exactly at segment end
+				if ( zRet == Z_STREAM_END )
+				{
+					pSegment.complete = ( zStream.avail_in == 0 );
+					break;
+				}
+
+				// Data error (signature inside compressed data) or segment ended before member end
+				if ( zRet != Z_OK || ( zStream.avail_in == 0 && zStream.avail_out > 0 ) )
+					break;
+
+			}
+
+		}
+		catch ( ... )
+		{
+
+			// Release z_stream resources
+			inflateEnd( &zStream );
+
+			// Rethrow
+			throw;
+
+		}
+
+		// Release z_stream resources
+		inflateEnd( &zStream );
+
+		// Keep output of complete member only
+		if ( pSegment.complete )
+			pSegment.output.resize( zOutCount );
+		else
+			std::vector<unsigned char>( ).swap( pSegment.output );
+
+	}
+
+	/*
+	 * Inflate segment as part of stream & write output.
+	 *
+	 * @thread_safety - not thread-safe.
+	 * @param pState - writer-thread stream.
+	 * @param pSegment - segment.
+	 * @param dstFile - output file.
+	 * @throws - can throw exception.
+	*/
+	void ZParallelInflate::streamSegment( StreamState & pState, const Segment & pSegment, std::FILE *const dstFile )
+	{
+
+		// Return code
+		int zRet( Z_OK );
+
+		// Offset of not inflated data
+		std::size_t inOffset( 0 );
+
+		// Previous member ended, so segment must start next member
+		if ( !pState.active && !pSegment.memberStart )
+			throw std::runtime_error( "decompression (inflate) failed, gzip member expected." );
+
+		// Inflate segment, members can start inside it
+		while ( inOffset < pSegment.input.size( ) )
+		{
+
+			// Start member
+			if ( !pState.active )
+			{
+
+				if ( !pState.initialized )
+				{
+
+					// Allocate z_stream state from the thread's arena
+					ZArena::getThreadArena( ).attach( pState.zStream );
+					pState.zStream.avail_in = 0;
+					pState.zStream.next_in = Z_NULL;
+
+					if ( inflateInit2( &pState.zStream, MAX_WBITS + 16 ) != Z_OK )
+						throw std::runtime_error( "failed to initialize decompression stream." );
+
+					pState.initialized = true;
+					pState.outBuffer.resize( CHUNK_SIZE );
+
+				}
+				else if ( inflateReset( &pState.zStream ) != Z_OK )
+					throw std::runtime_error( "failed to reset inflate." );
+
+				pState.active = true;
+
+			}
+
+			// Set input
+			pState.zStream.next_in = const_cast<Bytef*>( pSegment.input.data( ) + inOffset );
+			pState.zStream.avail_in = static_cast<uInt>( pSegment.input.size( ) - inOffset );
+
+			// Decompress input
+			do
+			{
+
+				// Set output
+				pState.zStream.next_out = pState.outBuffer.data( );
+				pState.zStream.avail_out = static_cast<uInt>( pState.outBuffer.size( ) );
+
+				// Decompress
+				zRet = inflate( &pState.zStream, Z_NO_FLUSH );
+
+				// Check inflate-status, Z_BUF_ERROR means more input required
+				switch ( zRet )
+				{
+
+				case Z_DATA_ERROR:
+					throw std::runtime_error( "decompression (inflate) failed, data corrupted." );
+
+				case Z_MEM_ERROR:
+					throw std::runtime_error( "decompression (inflate) failed, insufficent memory" );
+
+				case Z_NEED_DICT:
+					throw std::runtime_error( "decompression (inflate) failed, dictionary required." );
+
+				case Z_STREAM_ERROR:
+					throw std::runtime_error( "decompression (inflate) failed, stream structure inconsistent." );
+
+				}
+
+				// Write output
+				const std::size_t outCount( pState.outBuffer.size( ) - pState.zStream.avail_out );
+				if ( fwrite( pState.outBuffer.data( ), sizeof( unsigned char ), outCount, dstFile ) != outCount || ferror( dstFile ) )
+					throw std::runtime_error( "io error, can't write output file !" );
+
+			} while ( zRet != Z_STREAM_END && ( pState.zStream.avail_in > 0 || pState.zStream.avail_out == 0 ) );
+
+			// Consumed
+			inOffset = pSegment.input.size( ) - pState.zStream.avail_in;
+
+			// Member end
+			if ( zRet == Z_STREAM_END )
+				pState.active = false;
+
+		}
+
+	}
+
+	/*
+	 * Decompress the given zlib or gzip file on multiple threads.
+	 *
+	 * @thread_safety - not thread-safe.
+	 * @param srcFile - file to decompress, position must be at the beginning.
+	 * @param dstFile - output file, must be other then source.
+	 * @param threadsCount - number of worker-threads, 0 to use all hardware-threads.
+	 * @return - Z_OK if sucessfull, Z_ERRNO otherwise.
+	*/
+	int ZParallelInflate::inflateFILE( std::FILE *const srcFile, std::FILE *const dstFile, const std::uint32_t threadsCount, const ZDictionary *const pDictionaries )
+	{
+
+		// Writer-thread stream
+		StreamState streamState;
+		streamState.initialized = false;
+		streamState.active = false;
+
+		// Guarded-Block
+		try
+		{
+
+			// One worker can't inflate members in parallel, plain zlib loop is faster
+			if ( ( threadsCount > 0 ? threadsCount : ThreadPool::getHardwareThreadsCount( ) ) < 2 )
+				return( ZStream::inflateFILE( srcFile, dstFile, static_cast<std::uint32_t>( CHUNK_SIZE ), IOBackend::STDIO, nullptr, pDictionaries ) == Z_OK ? Z_OK : Z_ERRNO );
+
+			// Detect gzip
+			unsigned char headerBytes[4];
+			const std::size_t headerSize( fread( headerBytes, sizeof( unsigned char ), 4, srcFile ) );
+			FileUtils::seek( srcFile, 0 );
+
+			// Preset dictionary is set by ZStream from registry, speculative workers have no dictionary
+			if ( headerSize >= 2 && isDictionaryStream( headerBytes ) )
+				return( ZStream::inflateFILE( srcFile, dstFile, static_cast<std::uint32_t>( CHUNK_SIZE ), IOBackend::STDIO, nullptr, pDictionaries ) == Z_OK ? Z_OK : Z_ERRNO );
+
+			// zlib has one stream, split inside it
+			if ( headerSize < 4 || !isMemberStart( headerBytes ) )
+				return( ZSpeculativeInflate::inflateFILE( srcFile, dstFile, threadsCount ) );
+
+			// Frame table, if written by seekable compression
+			ZSeekable frameTable;
+			const bool framed( ZSeekable::hasTable( srcFile ) && frameTable.load( srcFile ) == Z_OK );
+			FileUtils::seek( srcFile, 0 );
+
+			// Worker-threads
+			ThreadPool threadPool( threadsCount );
+
+			// Max number of segments read & not written yet, limits memory usage
+			const std::size_t maxSegmentsInFlight( threadPool.getThreadsCount( ) * 2 );
+
+			// Segments in output order
+			std::deque<std::pair<std::shared_ptr<Segment>, std::future<void>>> segmentsInFlight;
+
+			// Data read & not cut into segment yet
+			std::vector<unsigned char> pendingData;
+
+			// Offset in pendingData to continue signature search from
+			std::size_t scanOffset( 1 );
+
+			// true, if pendingData starts with gzip-header
+			bool pendingMemberStart( true );
+
+			// Index of the next frame
+			std::size_t frameIndex( 0 );
+
+			// true, if input-file is fully read
+			bool inputEnd( false );
+
+			// true, if any segment added
+			bool segmentAdded( false );
+
+			// Add segment & inflate it on worker-thread, if it starts member
+			auto addSegment = [&]( std::vector<unsigned char> && pInput, const bool pMemberStart )
+			{
+
+				std::shared_ptr<Segment> segment( std::make_shared<Segment>( ) );
+				segment->input = std::move( pInput );
+				segment->memberStart = pMemberStart;
+				segment->complete = false;
+				segmentAdded = true;
+
+				segmentsInFlight.emplace_back( segment, pMemberStart ? threadPool.submit( [segment]( ) { inflateSegment( *segment ); } ) : std::future<void>( ) );
+
+			};
+
+			// Write the oldest segment
+			auto writeSegment = [&]( )
+			{
+
+				// Oldest segment
+				std::shared_ptr<Segment> segment( segmentsInFlight.front( ).first );
+
+				// Wait, rethrows worker exception
+				if ( segmentsInFlight.front( ).second.valid( ) )
+					segmentsInFlight.front( ).second.get( );
+
+				// Release
+				segmentsInFlight.pop_front( );
+
+				// Write worker output, if segment is complete member
+				if ( !streamState.active && segment->complete )
+				{
+
+					if ( fwrite( segment->output.data( ), sizeof( unsigned char ), segment->output.size( ), dstFile ) != segment->output.size( ) || ferror( dstFile ) )
+						throw std::runtime_error( "io error, can't write output file !" );
+
+					return;
+
+				}
+
+				// Inflate on this thread
+				streamSegment( streamState, *segment, dstFile );
+
+			};
+
+			// Read & cut input
+			while ( !inputEnd )
+			{
+
+				if ( framed )
+				{
+
+					// Frames are segments
+					if ( frameIndex == frameTable.getFramesCount( ) )
+					{
+						inputEnd = true;
+						break;
+					}
+
+					// Read frame
+					std::vector<unsigned char> frameData( frameTable.getFrame( frameIndex++ ).inSize );
+					if ( fread( frameData.data( ), sizeof( unsigned char ), frameData.size( ), srcFile ) != frameData.size( ) )
+						throw std::runtime_error( "decompression (inflate) failed, unexpected end of file." );
+
+					addSegment( std::move( frameData ), true );
+
+				}
+				else
+				{
+
+					// Read chunk
+					const std::size_t pendingSize( pendingData.size( ) );
+					pendingData.resize( pendingSize + CHUNK_SIZE );
+					const std::size_t readCount( fread( pendingData.data( ) + pendingSize, sizeof( unsigned char ), CHUNK_SIZE, srcFile ) );
+					pendingData.resize( pendingSize + readCount );
+
+					// Check io errors
+					if ( ferror( srcFile ) )
+						throw std::runtime_error( "io error, can't read input file !" );
+
+					inputEnd = ( readCount == 0 );
+
+					// Cut segments at gzip-header signatures
+					while ( pendingData.size( ) >= 4 && scanOffset <= pendingData.size( ) - 4 )
+					{
+
+						// Find signature
+						std::size_t memberOffset( scanOffset );
+						while ( memberOffset <= pendingData.size( ) - 4 && !isMemberStart( pendingData.data( ) + memberOffset ) )
+							memberOffset++;
+
+						// Not found
+						if ( memberOffset > pendingData.size( ) - 4 )
+						{
+							scanOffset = memberOffset;
+							break;
+						}
+
+						// Cut segment before signature
+						if ( memberOffset > 0 )
+						{
+							addSegment( std::vector<unsigned char>( pendingData.begin( ), pendingData.begin( ) + static_cast<std::ptrdiff_t>( memberOffset ) ), pendingMemberStart );
+							pendingData.erase( pendingData.begin( ), pendingData.begin( ) + static_cast<std::ptrdiff_t>( memberOffset ) );
+						}
+
+						// Continue after signature
+						pendingMemberStart = true;
+						scanOffset = 1;
+
+					}
+
+					// Cut large segment at searched part, next segment continues member
+					if ( scanOffset >= MAX_SEGMENT_SIZE )
+					{
+
+						// The first member is large, split inside it
+						if ( !segmentAdded )
+						{
+							FileUtils::seek( srcFile, 0 );
+							return( ZSpeculativeInflate::inflateFILE( srcFile, dstFile, threadsCount ) );
+						}
+
+						addSegment( std::vector<unsigned char>( pendingData.begin( ), pendingData.begin( ) + static_cast<std::ptrdiff_t>( scanOffset ) ), pendingMemberStart );
+						pendingData.erase( pendingData.begin( ), pendingData.begin( ) + static_cast<std::ptrdiff_t>( scanOffset ) );
+						pendingMemberStart = false;
+						scanOffset = 0;
+					}
+
+					// Last segment
+					if ( inputEnd && !pendingData.empty( ) )
+						addSegment( std::move( pendingData ), pendingMemberStart );
+
+				}
+
+				// Write segments in order
+				while ( segmentsInFlight.size( ) >= maxSegmentsInFlight )
+					writeSegment( );
+
+			}
+
+			// Write remaining segments
+			while ( !segmentsInFlight.empty( ) )
+				writeSegment( );
+
+			// Check, last member completed
+			if ( streamState.active )
+				throw std::runtime_error( "decompression (inflate) failed, unexpected end of file." );
+
+		}
+		catch ( const std::exception & pException )
+		{
+
+			// Print ERROR-message
+			std::cout << "ZParallelInflate::inflateFILE - error: " << pException.what( ) << std::endl;
+
+			// Release z_stream resources
+			if ( streamState.initialized )
+				inflateEnd( &streamState.zStream );
+
+			// Return ERROR
+			return( Z_ERRNO );
+
+		}
+
+		// Release z_stream resources
+		if ( streamState.initialized )
+			inflateEnd( &streamState.zStream );
+
+		// Return OK
+		return( Z_OK );
+
+	}
+
+	// -------------------------------------------------------- \\
+
+}
\ No newline at end of file
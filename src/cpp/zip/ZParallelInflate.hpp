@@ -0,0 +1,209 @@
+/*
+* Copyright  2018 Denis Zyamaev (code4un@yandex.ru) All rights reserved.
+* Authors: Denis Zyamaev (code4un@yandex.ru)
+* All rights reserved.
+* API: C++ 11
+* License: see LICENSE.txt
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+* 1. Redistributions of source code must retain the above copyright notice,
+* this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must display the names 'Denis Zyamaev' and
+* in the credits of the application, if such credits exist.
+* The authors of this work must be notified via email (code4un@yandex.ru) in
+* this case of redistribution.
+* 3. Neither the name of copyright holders nor the names of its contributors
+* may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS
+* IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+* PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+// Include 'pch_cxx'
+#include "../pch_cxx.hpp"
+
+// Include ThreadPool
+#include "../core/ThreadPool.hpp"
+
+// Include ZDictionary
+#include "ZDictionary.hpp"
+
+namespace c0de4un
+{
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Types
+	// ===========================================================
+
+	/*
+	  * ZParallelInflate - parallel decompression of multi-member gzip.
+	  *
+	  * Input is cut into segments at member boundaries: frame offsets,
+	  * if file has frame table (see ZSeekable), or offsets of gzip-header
+	  * signatures otherwise. Each segment is inflated as complete member
+	  * on a worker-thread, results are written in order.
+	  *
+	  * Signature can occur inside compressed data, so worker result is
+	  * used only if member ends exactly at segment end. Otherwise (and for
+	  * segments too large to hold in memory) segment is inflated on the
+	  * writer-thread as a stream, so output is always the same as
+	  * ZStream::inflateFILE. zlib & gzip, that starts with member too large
+	  * for one segment, are decompressed with ZSpeculativeInflate. With one
+	  * worker-thread, or for zlib with preset dictionary (FDICT), file is
+	  * decompressed with ZStream.
+	  *
+	  * @language C++ 17
+	  *
+	  * @authors Z. Denis (c0de4un@yandex.ru)
+	  * @version 1.0
+	 */
+	class ZParallelInflate final
+	{
+
+	private:
+
+		// -------------------------------------------------------- \\
+
+		// ===========================================================
+		// Types
+		// ===========================================================
+
+		/* Part of input between member boundaries */
+		struct Segment final
+		{
+
+			/* Compressed data */
+			std::vector<unsigned char> input;
+
+			/* Decompressed data, if segment is complete member */
+			std::vector<unsigned char> output;
+
+			/* true, if segment starts with gzip-header */
+			bool memberStart;
+
+			/* true, if segment inflated as complete member */
+			bool complete;
+
+		};
+
+		/* Stream inflate of writer-thread, for segments not inflated by workers */
+		struct StreamState final
+		{
+
+			/* z_stream */
+			z_stream zStream;
+
+			/* true, if inflate initialized */
+			bool initialized;
+
+			/* true, if member is being inflated */
+			bool active;
+
+			/* Output-buffer */
+			std::vector<unsigned char> outBuffer;
+
+		};
+
+		// ===========================================================
+		// Constants
+		// ===========================================================
+
+		/* Size of read chunk */
+		static constexpr std::size_t CHUNK_SIZE = 1048576;
+
+		/* Max size of segment, larger members are inflated as stream */
+		static constexpr std::size_t MAX_SEGMENT_SIZE = 8388608;
+
+		/* Max size of segment output on worker-thread, larger members are inflated as stream */
+		static constexpr std::size_t MAX_OUTPUT_SIZE = 33554432;
+
+		// ===========================================================
+		// Methods
+		// ===========================================================
+
+		/*
+		 * Returns true, if gzip-header can start at data.
+		 *
+		 * @param pData - data, at least 4 bytes.
+		*/
+		static bool isMemberStart( const unsigned char *const pData ) noexcept;
+
+		/*
+		 * Returns true, if data starts with zlib-header, requiring preset dictionary.
+		 *
+		 * @param pData - data, at least 2 bytes.
+		*/
+		static bool isDictionaryStream( const unsigned char *const pData ) noexcept;
+
+		/*
+		 * Inflate segment as complete gzip-member.
+		 *
+		 * @thread_safety - thread-safe, if segment not shared.
+		 * @param pSegment - segment, receives output & complete-flag.
+		 * @throws - can throw exception.
+		*/
+		static void inflateSegment( Segment & pSegment );
+
+		/*
+		 * Inflate segment as part of stream & write output.
+		 *
+		 * @thread_safety - not thread-safe.
+		 * @param pState - writer-thread stream.
+		 * @param pSegment - segment.
+		 * @param dstFile - output file.
+		 * @throws - can throw exception.
+		*/
+		static void streamSegment( StreamState & pState, const Segment & pSegment, std::FILE *const dstFile );
+
+		// -------------------------------------------------------- \\
+
+	public:
+
+		// -------------------------------------------------------- \\
+
+		// ===========================================================
+		// Constructor & destructor
+		// ===========================================================
+
+		/* @deleted ZParallelInflate constructor, only static methods */
+		ZParallelInflate( ) = delete;
+
+		// ===========================================================
+		// Methods
+		// ===========================================================
+
+		/*
+		 * Decompress the given zlib or gzip file on multiple threads.
+		 *
+		 * @thread_safety - not thread-safe.
+		 * @param srcFile - file to decompress, position must be at the beginning.
+		 * @param dstFile - output file, must be other then source.
+		 * @param threadsCount - number of worker-threads, 0 to use all hardware-threads.
+		 * @param pDictionaries - registry of preset dictionaries, nullptr if not used.
+		 * @return - Z_OK if sucessfull, Z_ERRNO otherwise.
+		*/
+		static int inflateFILE( std::FILE *const srcFile, std::FILE *const dstFile, const std::uint32_t threadsCount = 0, const ZDictionary *const pDictionaries = nullptr );
+
+		// -------------------------------------------------------- \\
+
+	};
+
+	// -------------------------------------------------------- \\
+
+}
\ No newline at end of file
@@ -0,0 +1,651 @@
+/*
+* Copyright  2018 Denis Zyamaev (code4un@yandex.ru) All rights reserved.
+* Authors: Denis Zyamaev (code4un@yandex.ru)
+* All rights reserved.
+* API: C++ 11
+* License: see LICENSE.txt
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+* 1. Redistributions of source code must retain the above copyright notice,
+* this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must display the names 'Denis Zyamaev' and
+* in the credits of the application, if such credits exist.
+* The authors of this work must be notified via email (code4un@yandex.ru) in
+* this case of redistribution.
+* 3. Neither the name of copyright holders nor the names of its contributors
+* may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS
+* IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+* PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// HEADER
+#include "ZPipeline.hpp"
+
+// Include ZArena
+#include "ZArena.hpp"
+
+namespace c0de4un
+{
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Context
+	// ===========================================================
+
+	/*
+	 * Context constructor.
+	 *
+	 * @param pSrcFile - input file.
+	 * @param pDstFile - output file.
+	 * @param pChunkSize - size of chunk.
+	 * @param pChunksCount - number of chunks per queue.
+	 * @throws - can throw exception (bad_alloc).
+	*/
+	ZPipeline::Context::Context( std::FILE *const pSrcFile, std::FILE *const pDstFile, const std::size_t pChunkSize, const std::size_t pChunksCount )
+		: srcFile( pSrcFile ),
+		dstFile( pDstFile ),
+		chunkSize( pChunkSize ),
+		inputChunks( pChunksCount ),
+		outputChunks( pChunksCount ),
+		freeInput( pChunksCount ),
+		filledInput( pChunksCount ),
+		freeOutput( pChunksCount ),
+		filledOutput( pChunksCount ),
+		errorMutex( ),
+		error( nullptr )
+	{
+
+		// Allocate chunks, all free
+		for ( std::size_t i = 0; i < pChunksCount; i++ )
+		{
+
+			inputChunks[i].data.resize( pChunkSize );
+			inputChunks[i].size = 0;
+			inputChunks[i].last = false;
+			freeInput.push( &inputChunks[i] );
+
+			outputChunks[i].data.resize( pChunkSize );
+			outputChunks[i].size = 0;
+			outputChunks[i].last = false;
+			freeOutput.push( &outputChunks[i] );
+
+		}
+
+	}
+
+	/*
+	 * Stores error (if first) & closes all queues to stop other stages.
+	 *
+	 * @thread_safety - thread-safe.
+	 * @param pError - error.
+	*/
+	void ZPipeline::Context::fail( std::exception_ptr pError )
+	{
+
+		// Store first error
+		{
+			std::lock_guard<std::mutex> errorLock( errorMutex );
+			if ( error == nullptr )
+				error = pError;
+		}
+
+		// Stop all stages
+		close( );
+
+	}
+
+	/*
+	 * Closes all queues.
+	 *
+	 * @thread_safety - thread-safe.
+	*/
+	void ZPipeline::Context::close( )
+	{
+
+		freeInput.close( );
+		filledInput.close( );
+		freeOutput.close( );
+		filledOutput.close( );
+
+	}
+
+	// ===========================================================
+	// Methods
+	// ===========================================================
+
+	/*
+	 * Reader-stage loop.
+	 *
+	 * @param pContext - pipeline state.
+	*/
+	void ZPipeline::readLoop( Context & pContext ) noexcept
+	{
+
+		// Guarded-Block
+		try
+		{
+
+			// Chunk to fill
+			Chunk * chunk( nullptr );
+
+			// Read until end of file or pipeline stop
+			while ( pContext.freeInput.pop( chunk ) )
+			{
+
+				// Read
+				chunk->size = fread( chunk->data.data( ), sizeof( unsigned char ), pContext.chunkSize, pContext.srcFile );
+
+				// Check io errors
+				if ( ferror( pContext.srcFile ) )
+					throw std::runtime_error( "ZPipeline::readLoop - io error, can't read input file !" );
+
+				// fread returns less than requested only at end of file
+				chunk->last = chunk->size < pContext.chunkSize;
+
+				// Pass to codec
+				if ( !pContext.filledInput.push( chunk ) || chunk->last )
+					return;
+
+			}
+
+		}
+		catch ( ... )
+		{
+
+			// Stop pipeline
+			pContext.fail( std::current_exception( ) );
+
+		}
+
+	}
+
+	/*
+	 * Writer-stage loop.
+	 *
+	 * @param pContext - pipeline state.
+	*/
+	void ZPipeline::writeLoop( Context & pContext ) noexcept
+	{
+
+		// Guarded-Block
+		try
+		{
+
+			// Chunk to write
+			Chunk * chunk( nullptr );
+
+			// Write until last chunk or pipeline stop
+			while ( pContext.filledOutput.pop( chunk ) )
+			{
+
+				// Write
+				if ( fwrite( chunk->data.data( ), sizeof( unsigned char ), chunk->size, pContext.dstFile ) != chunk->size || ferror( pContext.dstFile ) )
+					throw std::runtime_error( "ZPipeline::writeLoop - failed to write output file" );
+
+				// Return chunk to codec
+				if ( chunk->last || !pContext.freeOutput.push( chunk ) )
+					return;
+
+			}
+
+		}
+		catch ( ... )
+		{
+
+			// Stop pipeline
+			pContext.fail( std::current_exception( ) );
+
+		}
+
+	}
+
+	/*
+	 * Compress input chunks into output chunks.
+	 *
+	 * @param pContext - pipeline state.
+	 * @param compressionLevel - Compression-Level to use, must be in range 0-9.
+	 * @throws - can throw exception.
+	*/
+	void ZPipeline::deflateLoop( Context & pContext, const int compressionLevel )
+	{
+
+		// Return code
+		int zRet( 0 );
+
+		// Flush code
+		int zFlush( Z_NO_FLUSH );
+
+		// Input chunk
+		Chunk * inChunk( nullptr );
+
+		// Output chunk
+		Chunk * outChunk( nullptr );
+
+		// z_stream
+		z_stream zStream;
+
+		// Allocate z_stream state from the thread's arena
+		ZArena::getThreadArena( ).attach( zStream );
+
+		// Initialze deflate
+		if ( deflateInit( &zStream, compressionLevel ) != Z_OK )
+			throw std::runtime_error( "ZPipeline::deflateLoop - failed to initialize deflate." );
+
+		// Guarded-Block
+		try
+		{
+
+			// Take first output chunk
+			if ( !pContext.freeOutput.pop( outChunk ) )
+				throw std::runtime_error( "ZPipeline::deflateLoop - pipeline stopped" );
+
+			// Set output
+			zStream.next_out = outChunk->data.data( );
+			zStream.avail_out = static_cast<uInt>( pContext.chunkSize );
+
+			// Compress all input chunks
+			while ( zFlush != Z_FINISH )
+			{
+
+				// Take input chunk
+				if ( !pContext.filledInput.pop( inChunk ) )
+					throw std::runtime_error( "ZPipeline::deflateLoop - pipeline stopped" );
+
+				// Set input
+				zStream.next_in = inChunk->data.data( );
+				zStream.avail_in = static_cast<uInt>( inChunk->size );
+
+				// Set flush value
+				zFlush = inChunk->last ? Z_FINISH : Z_NO_FLUSH;
+
+				// Compress until output-chunk is not full
+				do
+				{
+
+					// Pass full output chunk to writer & take free one
+					if ( zStream.avail_out == 0 )
+					{
+
+						outChunk->size = pContext.chunkSize;
+						outChunk->last = false;
+
+						if ( !pContext.filledOutput.push( outChunk ) || !pContext.freeOutput.pop( outChunk ) )
+							throw std::runtime_error( "ZPipeline::deflateLoop - pipeline stopped" );
+
+						zStream.next_out = outChunk->data.data( );
+						zStream.avail_out = static_cast<uInt>( pContext.chunkSize );
+
+					}
+
+					// Compress
+					zRet = deflate( &zStream, zFlush );
+
+					// Check compression result-status.
+					if ( zRet == Z_STREAM_ERROR )
+						throw std::runtime_error( "ZPipeline::deflateLoop - compression failed, stream error" );
+
+				} while ( zStream.avail_out == 0 );
+
+				// Return input chunk to reader
+				if ( !pContext.freeInput.push( inChunk ) && zFlush != Z_FINISH )
+					throw std::runtime_error( "ZPipeline::deflateLoop - pipeline stopped" );
+
+			}
+
+			// Pass last output chunk to writer
+			outChunk->size = pContext.chunkSize - zStream.avail_out;
+			outChunk->last = true;
+
+			if ( !pContext.filledOutput.push( outChunk ) )
+				throw std::runtime_error( "ZPipeline::deflateLoop - pipeline stopped" );
+
+		}
+		catch ( ... )
+		{
+
+			// Release z_stream resources
+			deflateEnd( &zStream );
+
+			// Rethrow
+			throw;
+
+		}
+
+		// Release z_stream resources
+		deflateEnd( &zStream );
+
+	}
+
+	/*
+	 * Decompress input chunks into output chunks.
+	 *
+	 * @param pContext - pipeline state.
+	 * @throws - can throw exception.
+	*/
+	void ZPipeline::inflateLoop( Context & pContext )
+	{
+
+		// Return code
+		int zRet( Z_OK );
+
+		// Input chunk
+		Chunk * inChunk( nullptr );
+
+		// Output chunk
+		Chunk * outChunk( nullptr );
+
+		// Number of decompressed gzip-members
+		std::size_t membersCount( 0 );
+
+		// gzip-header, done-flag tells if stream is gzip
+		gz_header gzipHeader = gz_header( );
+
+		// z_stream
+		z_stream zStream;
+
+		// Allocate z_stream state from the thread's arena
+		ZArena::getThreadArena( ).attach( zStream );
+		zStream.avail_in = 0;
+		zStream.next_in = Z_NULL;
+
+		// Initialize inflate, detecting zlib or gzip wrapper
+		if ( inflateInit2( &zStream, MAX_WBITS + 32 ) != Z_OK )
+			throw std::runtime_error( "ZPipeline::inflateLoop - failed to initialize decompression stream." );
+
+		// Guarded-Block
+		try
+		{
+
+			// Request gzip-header
+			if ( inflateGetHeader( &zStream, &gzipHeader ) != Z_OK )
+				throw std::runtime_error( "ZPipeline::inflateLoop - failed to request gzip header." );
+
+			// Take first output chunk
+			if ( !pContext.freeOutput.pop( outChunk ) )
+				throw std::runtime_error( "ZPipeline::inflateLoop - pipeline stopped" );
+
+			// Set output
+			zStream.next_out = outChunk->data.data( );
+			zStream.avail_out = static_cast<uInt>( pContext.chunkSize );
+
+			// Decompress until end of stream
+			while ( zRet != Z_STREAM_END )
+			{
+
+				// Take input chunk
+				if ( !pContext.filledInput.pop( inChunk ) )
+					throw std::runtime_error( "ZPipeline::inflateLoop - pipeline stopped" );
+
+				// Set input
+				zStream.next_in = inChunk->data.data( );
+				zStream.avail_in = static_cast<uInt>( inChunk->size );
+
+				// Decompress until output-chunk is not full
+				do
+				{
+
+					// Pass full output chunk to writer & take free one
+					if ( zStream.avail_out == 0 )
+					{
+
+						outChunk->size = pContext.chunkSize;
+						outChunk->last = false;
+
+						if ( !pContext.filledOutput.push( outChunk ) || !pContext.freeOutput.pop( outChunk ) )
+							throw std::runtime_error( "ZPipeline::inflateLoop - pipeline stopped" );
+
+						zStream.next_out = outChunk->data.data( );
+						zStream.avail_out = static_cast<uInt>( pContext.chunkSize );
+
+					}
+
+					// Decompress
+					zRet = inflate( &zStream, Z_NO_FLUSH );
+
+					// Check inflate-status, Z_BUF_ERROR means more input required
+					switch ( zRet )
+					{
+
+					case Z_DATA_ERROR:
+						throw std::runtime_error( "ZPipeline::inflateLoop - decompression (inflate) failed, data corrupted." );
+
+					case Z_MEM_ERROR:
+						throw std::runtime_error( "ZPipeline::inflateLoop - decompression (inflate) failed, insufficent memory" );
+
+					case Z_NEED_DICT:
+						throw std::runtime_error( "ZPipeline::inflateLoop - decompression (inflate) failed, dictionary required." );
+
+					case Z_STREAM_ERROR:
+						throw std::runtime_error( "ZPipeline::inflateLoop - decompression (inflate) failed, stream structure inconsistent." );
+
+					}
+
+					// gzip-member ended, next member can follow (concatenated .gz files)
+					if ( zRet == Z_STREAM_END && gzipHeader.done == 1 && ( zStream.avail_in > 0 || !inChunk->last ) )
+					{
+
+						// Start next member, reset clears requested header & total_in
+						membersCount++;
+						gzipHeader = gz_header( );
+						if ( inflateReset( &zStream ) != Z_OK || inflateGetHeader( &zStream, &gzipHeader ) != Z_OK )
+							throw std::runtime_error( "ZPipeline::inflateLoop - failed to reset inflate." );
+
+						zRet = Z_OK;
+
+					}
+
+				} while ( zRet != Z_STREAM_END && ( zStream.avail_out == 0 || zStream.avail_in > 0 ) );
+
+				// Check end of input
+				if ( inChunk->last && zRet != Z_STREAM_END )
+				{
+
+					// Input ended right after gzip-member
+					if ( membersCount > 0 && zStream.total_in == 0 )
+						zRet = Z_STREAM_END;
+					else
+						throw std::runtime_error( "ZPipeline::inflateLoop - decompression (inflate) failed, unexpected end of file." );
+
+				}
+
+				// Return input chunk to reader
+				if ( !pContext.freeInput.push( inChunk ) && zRet != Z_STREAM_END )
+					throw std::runtime_error( "ZPipeline::inflateLoop - pipeline stopped" );
+
+			}
+
+			// Pass last output chunk to writer
+			outChunk->size = pContext.chunkSize - zStream.avail_out;
+			outChunk->last = true;
+
+			if ( !pContext.filledOutput.push( outChunk ) )
+				throw std::runtime_error( "ZPipeline::inflateLoop - pipeline stopped" );
+
+		}
+		catch ( ... )
+		{
+
+			// Release z_stream resources
+			inflateEnd( &zStream );
+
+			// Rethrow
+			throw;
+
+		}
+
+		// Release z_stream resources
+		inflateEnd( &zStream );
+
+	}
+
+	/*
+	 * Run reader & writer threads, and codec on the calling thread.
+	 *
+	 * @param srcFile - input file.
+	 * @param dstFile - output file.
+	 * @param chunkSize - size of chunk.
+	 * @param chunksCount - number of chunks per stage.
+	 * @param pCodec - codec stage.
+	 * @throws - can throw exception.
+	*/
+	void ZPipeline::run( std::FILE *const srcFile, std::FILE *const dstFile, const std::uint32_t chunkSize, const std::uint32_t chunksCount, const Codec & pCodec )
+	{
+
+		// Check arguments
+		if ( chunkSize == 0 || chunksCount == 0 )
+			throw std::runtime_error( "ZPipeline::run - chunk size & count must be greater than 0" );
+
+		// Pipeline state
+		Context context( srcFile, dstFile, chunkSize, chunksCount );
+
+		// Start reader
+		std::thread readerThread( &ZPipeline::readLoop, std::ref( context ) );
+
+		// Writer-thread
+		std::thread writerThread;
+
+		// Start writer & run codec
+		try
+		{
+
+			writerThread = std::thread( &ZPipeline::writeLoop, std::ref( context ) );
+
+			pCodec( context );
+
+		}
+		catch ( ... )
+		{
+
+			// Stop pipeline
+			context.fail( std::current_exception( ) );
+
+		}
+
+		// Stop reader, if stream ended before end of file. Writer stops at last chunk.
+		context.freeInput.close( );
+		context.filledInput.close( );
+
+		// Join
+		readerThread.join( );
+
+		if ( writerThread.joinable( ) )
+			writerThread.join( );
+
+		// Rethrow first error
+		if ( context.error != nullptr )
+			std::rethrow_exception( context.error );
+
+	}
+
+	/*
+	 * Compress the given file using zlib (not gzip) with pipelined io.
+	 *
+	 * @thread_safety - not thread-safe.
+	 * @param srcFile - file to compress.
+	 * @param dstFile - output file.
+	 * @param compressionLevel - Compression-Level to use, must be in range 0-9.
+	 * @param chunkSize - size of io chunk.
+	 * @param chunksCount - number of chunks per stage.
+	 * @return - Z_OK if compression complete, Z_ERRNO otherwise.
+	*/
+	int ZPipeline::deflateFILE( std::FILE *const srcFile, std::FILE *const dstFile, const int compressionLevel, const std::uint32_t chunkSize, const std::uint32_t chunksCount )
+	{
+
+		// Guarded-Block
+		try
+		{
+
+			// Run
+			run( srcFile, dstFile, chunkSize, chunksCount, [compressionLevel]( Context & pContext ) { deflateLoop( pContext, compressionLevel ); } );
+
+		}
+		catch ( const std::exception & pException )
+		{
+
+			// Print ERROR-message
+			std::cout << "ZPipeline::deflateFILE - error: " << pException.what( ) << std::endl;
+
+			// Return ERROR
+			return( Z_ERRNO );
+
+		}
+		catch ( ... )
+		{
+
+			// Print ERROR-message
+			std::cout << "ZPipeline::deflateFILE - unknown error" << std::endl;
+
+			// Return ERROR
+			return( Z_ERRNO );
+
+		}
+
+		// Return Z_OK
+		return( Z_OK );
+
+	}
+
+	/*
+	 * Decompress given zlib or gzip file with pipelined io.
+	 *
+	 * @thread_safety - not thread-safe.
+	 * @param srcFile - file to decompress (inflate).
+	 * @param dstFile - output file, must be other then source.
+	 * @param chunkSize - size of io chunk.
+	 * @param chunksCount - number of chunks per stage.
+	 * @return - Z_OK if sucessfull, Z_ERRNO otherwise.
+	*/
+	int ZPipeline::inflateFILE( std::FILE *const srcFile, std::FILE *const dstFile, const std::uint32_t chunkSize, const std::uint32_t chunksCount )
+	{
+
+		// Guarded-Block
+		try
+		{
+
+			// Run
+			run( srcFile, dstFile, chunkSize, chunksCount, &ZPipeline::inflateLoop );
+
+		}
+		catch ( const std::exception & pException )
+		{
+
+			// Print ERROR-message
+			std::cout << "ZPipeline::inflateFILE - error: " << pException.what( ) << std::endl;
+
+			// Return ERROR
+			return( Z_ERRNO );
+
+		}
+		catch ( ... )
+		{
+
+			// Print ERROR-message
+			std::cout << "ZPipeline::inflateFILE - unknown error" << std::endl;
+
+			// Return ERROR
+			return( Z_ERRNO );
+
+		}
+
+		// Return Z_OK
+		return( Z_OK );
+
+	}
+
+	// -------------------------------------------------------- \\
+
+}
\ No newline at end of file
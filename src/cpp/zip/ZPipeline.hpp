@@ -0,0 +1,266 @@
+/*
+* Copyright  2018 Denis Zyamaev (code4un@yandex.ru) All rights reserved.
+* Authors: Denis Zyamaev (code4un@yandex.ru)
+* All rights reserved.
+* API: C++ 11
+* License: see LICENSE.txt
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+* 1. Redistributions of source code must retain the above copyright notice,
+* this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must display the names 'Denis Zyamaev' and
+* in the credits of the application, if such credits exist.
+* The authors of this work must be notified via email (code4un@yandex.ru) in
+* this case of redistribution.
+* 3. Neither the name of copyright holders nor the names of its contributors
+* may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS
+* IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+* PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+// Include 'pch_cxx'
+#include "../pch_cxx.hpp"
+
+// Include BoundedQueue
+#include "../core/BoundedQueue.hpp"
+
+namespace c0de4un
+{
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Types
+	// ===========================================================
+
+	/*
+	  * ZPipeline - three-stage compression/decompression.
+	  *
+	  * Reader-thread fills input chunks, calling thread runs
+	  * deflate/inflate, writer-thread writes output chunks. Stages are
+	  * connected by bounded queues of reusable chunks, so disk-waits
+	  * overlap with compression.
+	  *
+	  * @language C++ 17
+	  *
+	  * @authors Z. Denis (c0de4un@yandex.ru)
+	  * @version 1.0
+	 */
+	class ZPipeline final
+	{
+
+	private:
+
+		// -------------------------------------------------------- \\
+
+		// ===========================================================
+		// Types
+		// ===========================================================
+
+		/* Reusable chunk of data */
+		struct Chunk final
+		{
+
+			/* Storage, chunk-size bytes */
+			std::vector<unsigned char> data;
+
+			/* Number of used bytes */
+			std::size_t size;
+
+			/* true, if this is the last chunk of the file */
+			bool last;
+
+		};
+
+		/* Queue of chunks */
+		using ChunkQueue = BoundedQueue<Chunk*>;
+
+		/* Pipeline state, shared by all stages */
+		struct Context final
+		{
+
+			/* Input file */
+			std::FILE * srcFile;
+
+			/* Output file */
+			std::FILE * dstFile;
+
+			/* Size of chunk */
+			std::size_t chunkSize;
+
+			/* Input chunks storage */
+			std::vector<Chunk> inputChunks;
+
+			/* Output chunks storage */
+			std::vector<Chunk> outputChunks;
+
+			/* Input chunks, ready to be filled by reader */
+			ChunkQueue freeInput;
+
+			/* Input chunks, filled by reader */
+			ChunkQueue filledInput;
+
+			/* Output chunks, ready to be filled by codec */
+			ChunkQueue freeOutput;
+
+			/* Output chunks, filled by codec */
+			ChunkQueue filledOutput;
+
+			/* Error mutex */
+			std::mutex errorMutex;
+
+			/* First error of any stage */
+			std::exception_ptr error;
+
+			/*
+			 * Context constructor.
+			 *
+			 * @param pSrcFile - input file.
+			 * @param pDstFile - output file.
+			 * @param pChunkSize - size of chunk.
+			 * @param pChunksCount - number of chunks per queue.
+			 * @throws - can throw exception (bad_alloc).
+			*/
+			explicit Context( std::FILE *const pSrcFile, std::FILE *const pDstFile, const std::size_t pChunkSize, const std::size_t pChunksCount );
+
+			/*
+			 * Stores error (if first) & closes all queues to stop other stages.
+			 *
+			 * @thread_safety - thread-safe.
+			 * @param pError - error.
+			*/
+			void fail( std::exception_ptr pError );
+
+			/*
+			 * Closes all queues.
+			 *
+			 * @thread_safety - thread-safe.
+			*/
+			void close( );
+
+		};
+
+		/* Codec stage */
+		using Codec = std::function<void( Context & )>;
+
+		// ===========================================================
+		// Methods
+		// ===========================================================
+
+		/*
+		 * Reader-stage loop.
+		 *
+		 * @param pContext - pipeline state.
+		*/
+		static void readLoop( Context & pContext ) noexcept;
+
+		/*
+		 * Writer-stage loop.
+		 *
+		 * @param pContext - pipeline state.
+		*/
+		static void writeLoop( Context & pContext ) noexcept;
+
+		/*
+		 * Compress input chunks into output chunks.
+		 *
+		 * @param pContext - pipeline state.
+		 * @param compressionLevel - Compression-Level to use, must be in range 0-9.
+		 * @throws - can throw exception.
+		*/
+		static void deflateLoop( Context & pContext, const int compressionLevel );
+
+		/*
+		 * Decompress input chunks into output chunks.
+		 *
+		 * @param pContext - pipeline state.
+		 * @throws - can throw exception.
+		*/
+		static void inflateLoop( Context & pContext );
+
+		/*
+		 * Run reader & writer threads, and codec on the calling thread.
+		 *
+		 * @param srcFile - input file.
+		 * @param dstFile - output file.
+		 * @param chunkSize - size of chunk.
+		 * @param chunksCount - number of chunks per stage.
+		 * @param pCodec - codec stage.
+		 * @throws - can throw exception.
+		*/
+		static void run( std::FILE *const srcFile, std::FILE *const dstFile, const std::uint32_t chunkSize, const std::uint32_t chunksCount, const Codec & pCodec );
+
+		// -------------------------------------------------------- \\
+
+	public:
+
+		// -------------------------------------------------------- \\
+
+		// ===========================================================
+		// Constants
+		// ===========================================================
+
+		/* Default size of chunk */
+		static constexpr std::uint32_t DEFAULT_CHUNK_SIZE = 262144;
+
+		/* Default number of chunks per stage */
+		static constexpr std::uint32_t DEFAULT_CHUNKS_COUNT = 4;
+
+		// ===========================================================
+		// Constructor & destructor
+		// ===========================================================
+
+		/* @deleted ZPipeline constructor, only static methods */
+		ZPipeline( ) = delete;
+
+		// ===========================================================
+		// Methods
+		// ===========================================================
+
+		/*
+		 * Compress the given file using zlib (not gzip) with pipelined io.
+		 *
+		 * @thread_safety - not thread-safe.
+		 * @param srcFile - file to compress.
+		 * @param dstFile - output file.
+		 * @param compressionLevel - Compression-Level to use, must be in range 0-9.
+		 * @param chunkSize - size of io chunk.
+		 * @param chunksCount - number of chunks per stage.
+		 * @return - Z_OK if compression complete, Z_ERRNO otherwise.
+		*/
+		static int deflateFILE( std::FILE *const srcFile, std::FILE *const dstFile, const int compressionLevel, const std::uint32_t chunkSize = DEFAULT_CHUNK_SIZE, const std::uint32_t chunksCount = DEFAULT_CHUNKS_COUNT );
+
+		/*
+		 * Decompress given zlib or gzip file with pipelined io.
+		 *
+		 * @thread_safety - not thread-safe.
+		 * @param srcFile - file to decompress (inflate).
+		 * @param dstFile - output file, must be other then source.
+		 * @param chunkSize - size of io chunk.
+		 * @param chunksCount - number of chunks per stage.
+		 * @return - Z_OK if sucessfull, Z_ERRNO otherwise.
+		*/
+		static int inflateFILE( std::FILE *const srcFile, std::FILE *const dstFile, const std::uint32_t chunkSize = DEFAULT_CHUNK_SIZE, const std::uint32_t chunksCount = DEFAULT_CHUNKS_COUNT );
+
+		// -------------------------------------------------------- \\
+
+	};
+
+	// -------------------------------------------------------- \\
+
+}
\ No newline at end of file
@@ -0,0 +1,535 @@
+/*
+* Copyright  2018 Denis Zyamaev (code4un@yandex.ru) All rights reserved.
+* Authors: Denis Zyamaev (code4un@yandex.ru)
+* All rights reserved.
+* API: C++ 11
+* License: see LICENSE.txt
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+* 1. Redistributions of source code must retain the above copyright notice,
+* this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must display the names 'Denis Zyamaev' and
+* in the credits of the application, if such credits exist.
+* The authors of this work must be notified via email (code4un@yandex.ru) in
+* this case of redistribution.
+* 3. Neither the name of copyright holders nor the names of its contributors
+* may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS
+* IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+* PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// HEADER
+#include "ZSeekable.hpp"
+
+// Include FileUtils
+#include "../io/FileUtils.hpp"
+
+namespace c0de4un
+{
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Constructor & destructor
+	// ===========================================================
+
+	/* ZSeekable constructor, table is empty */
+	ZSeekable::ZSeekable( ) noexcept
+		: mFrames( ),
+		mUncompressedSize( 0 )
+	{
+	}
+
+	// ===========================================================
+	// Getters
+	// ===========================================================
+
+	/* Returns number of frames */
+	std::size_t ZSeekable::getFramesCount( ) const noexcept
+	{ return( mFrames.size( ) ); }
+
+	/*
+	 * Returns frame.
+	 *
+	 * @param pIndex - frame index, must be less than frames count.
+	*/
+	const ZSeekable::Frame & ZSeekable::getFrame( const std::size_t pIndex ) const noexcept
+	{ return( mFrames[pIndex] ); }
+
+	/* Returns size of uncompressed data */
+	std::uint64_t ZSeekable::getUncompressedSize( ) const noexcept
+	{ return( mUncompressedSize ); }
+
+	/*
+	 * Returns index of frame, that contains uncompressed offset.
+	 *
+	 * @param pOffset - uncompressed offset, must be less than uncompressed size.
+	*/
+	std::size_t ZSeekable::findFrame( const std::uint64_t pOffset ) const noexcept
+	{
+
+		// First frame after offset
+		const auto nextFrame( std::upper_bound( mFrames.begin( ), mFrames.end( ), pOffset, []( const std::uint64_t pValue, const Frame & pFrame ) { return( pValue < pFrame.outOffset ); } ) );
+
+		// Return
+		return( static_cast<std::size_t>( nextFrame - mFrames.begin( ) ) - 1 );
+
+	}
+
+	// ===========================================================
+	// Methods
+	// ===========================================================
+
+	/*
+	 * Append little-endian value.
+	 *
+	 * @param pBuffer - output.
+	 * @param pValue - value.
+	 * @param bytesCount - number of bytes to write.
+	 * @throws - can throw exception (bad_alloc).
+	*/
+	void ZSeekable::putValue( std::vector<unsigned char> & pBuffer, const std::uint64_t pValue, const std::size_t bytesCount )
+	{
+
+		for ( std::size_t i = 0; i < bytesCount; i++ )
+			pBuffer.push_back( static_cast<unsigned char>( ( pValue >> ( i * 8 ) ) & 0xFF ) );
+
+	}
+
+	/*
+	 * Returns little-endian value.
+	 *
+	 * @param pData - input.
+	 * @param bytesCount - number of bytes to read.
+	*/
+	std::uint64_t ZSeekable::getValue( const unsigned char *const pData, const std::size_t bytesCount ) noexcept
+	{
+
+		// Value
+		std::uint64_t value( 0 );
+		for ( std::size_t i = 0; i < bytesCount; i++ )
+			value |= static_cast<std::uint64_t>( pData[i] ) << ( i * 8 );
+
+		// Return
+		return( value );
+
+	}
+
+	/*
+	 * Write frame table as gzip-members.
+	 *
+	 * @thread_safety - not thread-safe.
+	 * @param dstFile - output file, position must be after the last frame.
+	 * @param pFrames - frames, in file order.
+	 * @throws - can throw exception.
+	*/
+	void ZSeekable::writeTable( std::FILE *const dstFile, const std::vector<Frame> & pFrames )
+	{
+
+		// Table-member
+		std::vector<unsigned char> tableMember;
+
+		// Index of the first frame of table-member
+		std::size_t firstFrame( 0 );
+
+		// Write table-members, empty file has one empty table
+		do
+		{
+
+			// Number of frames in table-member
+			const std::size_t framesCount( std::min( pFrames.size( ) - firstFrame, MAX_TABLE_FRAMES ) );
+
+			// Size of subfield-data
+			const std::size_t subfieldSize( framesCount * ENTRY_SIZE + FOOTER_SIZE );
+
+			// Size of table-member
+			const std::size_t memberSize( HEADER_SIZE + SUBFIELD_HEADER_SIZE + subfieldSize + TRAILER_SIZE );
+
+			// gzip-header: magic, deflate, flags (FEXTRA), mtime, extra-flags, OS (unknown)
+			const unsigned char headerBytes[10] = { 0x1F, 0x8B, Z_DEFLATED, 0x04, 0, 0, 0, 0, 0, 255 };
+			tableMember.assign( headerBytes, headerBytes + 10 );
+
+			// Extra-field length & subfield-header
+			putValue( tableMember, SUBFIELD_HEADER_SIZE + subfieldSize, 2 );
+			tableMember.push_back( SUBFIELD_ID[0] );
+			tableMember.push_back( SUBFIELD_ID[1] );
+			putValue( tableMember, subfieldSize, 2 );
+
+			// Entries
+			for ( std::size_t i = firstFrame; i < firstFrame + framesCount; i++ )
+			{
+				putValue( tableMember, pFrames[i].inSize, 4 );
+				putValue( tableMember, pFrames[i].outSize, 4 );
+				putValue( tableMember, pFrames[i].crc, 4 );
+			}
+
+			// Footer
+			putValue( tableMember, firstFrame, 4 );
+			putValue( tableMember, framesCount, 4 );
+			putValue( tableMember, memberSize, 4 );
+			tableMember.insert( tableMember.end( ), FOOTER_MAGIC, FOOTER_MAGIC + 4 );
+
+			// Empty deflate-data (final fixed block with end-of-block only), CRC-32 & size are 0
+			tableMember.push_back( 0x03 );
+			tableMember.insert( tableMember.end( ), TRAILER_SIZE - 1, 0 );
+
+			// Write
+			if ( fwrite( tableMember.data( ), sizeof( unsigned char ), tableMember.size( ), dstFile ) != tableMember.size( ) || ferror( dstFile ) )
+				throw std::runtime_error( "ZSeekable::writeTable - failed to write output file" );
+
+			// Next
+			firstFrame += framesCount;
+
+		} while ( firstFrame < pFrames.size( ) );
+
+	}
+
+	/*
+	 * Returns true, if file ends with frame table. Position is not changed.
+	 *
+	 * @thread_safety - not thread-safe.
+	 * @param srcFile - file, must be seekable.
+	 * @throws - can throw exception, if file can't be positioned.
+	*/
+	bool ZSeekable::hasTable( std::FILE *const srcFile )
+	{
+
+		// Position
+		const std::uint64_t position( FileUtils::tell( srcFile ) );
+
+		// Size
+		const std::uint64_t fileSize( FileUtils::getSize( srcFile ) );
+
+		if ( fileSize < HEADER_SIZE + SUBFIELD_HEADER_SIZE + FOOTER_SIZE + TRAILER_SIZE )
+			return( false );
+
+		// Footer & trailer
+		unsigned char footerBytes[FOOTER_SIZE + TRAILER_SIZE];
+
+		FileUtils::seek( srcFile, fileSize - FOOTER_SIZE - TRAILER_SIZE );
+		const bool footerRead( fread( footerBytes, sizeof( unsigned char ), sizeof( footerBytes ), srcFile ) == sizeof( footerBytes ) );
+
+		// Restore position
+		FileUtils::seek( srcFile, position );
+
+		// Return
+		return( footerRead && std::memcmp( footerBytes + 12, FOOTER_MAGIC, 4 ) == 0 && footerBytes[FOOTER_SIZE] == 0x03 );
+
+	}
+
+	/*
+	 * Read frame table from the end of file.
+	 *
+	 * @thread_safety - not thread-safe.
+	 * @param srcFile - seekable gzip file.
+	 * @return - Z_OK if read, Z_ERRNO otherwise (not a seekable file).
+	*/
+	int ZSeekable::load( std::FILE *const srcFile )
+	{
+
+		// Guarded-Block
+		try
+		{
+
+			// Reset
+			mFrames.clear( );
+			mUncompressedSize = 0;
+
+			// Table-members, from the end of file
+			std::vector<std::vector<Frame>> tables;
+
+			// Table-member
+			std::vector<unsigned char> tableMember;
+
+			// End of the table-member
+			std::uint64_t tableEnd( FileUtils::getSize( srcFile ) );
+
+			// Index of the frame after table-member
+			std::uint64_t nextFrame( 0 );
+
+			// Read table-members, until the first one
+			while ( true )
+			{
+
+				// Footer & trailer
+				unsigned char footerBytes[FOOTER_SIZE + TRAILER_SIZE];
+
+				if ( tableEnd < HEADER_SIZE + SUBFIELD_HEADER_SIZE + FOOTER_SIZE + TRAILER_SIZE )
+					throw std::runtime_error( "frame table not found" );
+
+				FileUtils::seek( srcFile, tableEnd - FOOTER_SIZE - TRAILER_SIZE );
+				if ( fread( footerBytes, sizeof( unsigned char ), sizeof( footerBytes ), srcFile ) != sizeof( footerBytes ) )
+					throw std::runtime_error( "failed to read input file" );
+
+				// Check signature & empty member trailer
+				if ( std::memcmp( footerBytes + 12, FOOTER_MAGIC, 4 ) != 0 || footerBytes[FOOTER_SIZE] != 0x03 || std::any_of( footerBytes + FOOTER_SIZE + 1, footerBytes + sizeof( footerBytes ), []( const unsigned char pByte ) { return( pByte != 0 ); } ) )
+					throw std::runtime_error( "frame table not found" );
+
+				// Footer
+				const std::uint64_t firstFrame( getValue( footerBytes, 4 ) );
+				const std::uint64_t framesCount( getValue( footerBytes + 4, 4 ) );
+				const std::uint64_t memberSize( getValue( footerBytes + 8, 4 ) );
+
+				// Check, the last table-member ends frames
+				if ( tables.empty( ) )
+					nextFrame = firstFrame + framesCount;
+
+				if ( framesCount > MAX_TABLE_FRAMES || firstFrame + framesCount != nextFrame || memberSize > tableEnd
+					|| memberSize != HEADER_SIZE + SUBFIELD_HEADER_SIZE + framesCount * ENTRY_SIZE + FOOTER_SIZE + TRAILER_SIZE )
+					throw std::runtime_error( "frame table corrupted" );
+
+				// Read table-member
+				tableMember.resize( static_cast<std::size_t>( memberSize ) );
+				FileUtils::seek( srcFile, tableEnd - memberSize );
+				if ( fread( tableMember.data( ), sizeof( unsigned char ), tableMember.size( ), srcFile ) != tableMember.size( ) )
+					throw std::runtime_error( "failed to read input file" );
+
+				// Check gzip-header & subfield
+				if ( tableMember[0] != 0x1F || tableMember[1] != 0x8B || tableMember[2] != Z_DEFLATED || tableMember[3] != 0x04
+					|| getValue( tableMember.data( ) + 10, 2 ) != memberSize - HEADER_SIZE - TRAILER_SIZE
+					|| tableMember[12] != SUBFIELD_ID[0] || tableMember[13] != SUBFIELD_ID[1] )
+					throw std::runtime_error( "frame table corrupted" );
+
+				// Entries
+				tables.emplace_back( );
+				tables.back( ).resize( static_cast<std::size_t>( framesCount ) );
+				for ( std::size_t i = 0; i < tables.back( ).size( ); i++ )
+				{
+					const unsigned char *const entryBytes( tableMember.data( ) + HEADER_SIZE + SUBFIELD_HEADER_SIZE + i * ENTRY_SIZE );
+					Frame & frame( tables.back( )[i] );
+					frame.inSize = static_cast<std::uint32_t>( getValue( entryBytes, 4 ) );
+					frame.outSize = static_cast<std::uint32_t>( getValue( entryBytes + 4, 4 ) );
+					frame.crc = static_cast<std::uint32_t>( getValue( entryBytes + 8, 4 ) );
+				}
+
+				// Previous table-member
+				tableEnd -= memberSize;
+				nextFrame = firstFrame;
+
+				if ( firstFrame == 0 )
+					break;
+
+			}
+
+			// Join tables in file order & compute offsets
+			std::uint64_t inOffset( 0 );
+			for ( auto tablesIter = tables.rbegin( ); tablesIter != tables.rend( ); tablesIter++ )
+			{
+
+				for ( Frame & frame : *tablesIter )
+				{
+
+					frame.inOffset = inOffset;
+					frame.outOffset = mUncompressedSize;
+
+					inOffset += frame.inSize;
+					mUncompressedSize += frame.outSize;
+
+					mFrames.push_back( frame );
+
+				}
+
+			}
+
+			// Check, frames end where table starts
+			if ( inOffset != tableEnd )
+				throw std::runtime_error( "frame table doesn't match the file" );
+
+		}
+		catch ( const std::exception & pException )
+		{
+
+			// Print ERROR-message
+			std::cout << "ZSeekable::load - error: " << pException.what( ) << std::endl;
+
+			// Clear table
+			mFrames.clear( );
+			mUncompressedSize = 0;
+
+			// Return ERROR
+			return( Z_ERRNO );
+
+		}
+
+		// Return OK
+		return( Z_OK );
+
+	}
+
+	/*
+	 * Decompress range, starting from the frame that contains offset.
+	 *
+	 * @thread_safety - not thread-safe.
+	 * @param srcFile - seekable gzip file.
+	 * @param offset - uncompressed offset of the range.
+	 * @param length - size of the range, cut at the end of data.
+	 * @param pOutput - receives decompressed range.
+	 * @return - Z_OK if range decompressed, Z_ERRNO otherwise.
+	*/
+	int ZSeekable::extract( std::FILE *const srcFile, const std::uint64_t offset, const std::uint64_t length, OutputSink & pOutput ) const
+	{
+
+		// Return code
+		int zRet( Z_OK );
+
+		// Input-buffer
+		std::vector<unsigned char> inBuffer;
+
+		// Output-buffer
+		std::vector<unsigned char> outBuffer;
+
+		// true, if inflate initialized
+		bool zInitialized( false );
+
+		// z_stream
+		z_stream zStream;
+
+		// Set z_stream state
+		zStream.zalloc = Z_NULL;
+		zStream.zfree = Z_NULL;
+		zStream.opaque = Z_NULL;
+		zStream.avail_in = 0;
+		zStream.next_in = Z_NULL;
+
+		// Guarded-Block
+		try
+		{
+
+			// Nothing to extract
+			if ( offset >= mUncompressedSize || length == 0 )
+			{
+				pOutput.finish( );
+				return( Z_OK );
+			}
+
+			// Frame with offset
+			const Frame & frame( mFrames[findFrame( offset )] );
+
+			// Uncompressed bytes to skip
+			std::uint64_t skipCount( offset - frame.outOffset );
+
+			// Uncompressed bytes to write
+			std::uint64_t leftCount( std::min( length, mUncompressedSize - offset ) );
+
+			// Allocate buffers
+			inBuffer.resize( CHUNK_SIZE );
+			outBuffer.resize( CHUNK_SIZE );
+
+			// Initialize gzip inflate, frame is a complete member
+			if ( inflateInit2( &zStream, MAX_WBITS + 16 ) != Z_OK )
+				throw std::runtime_error( "failed to initialize decompression stream." );
+
+			// Inflate initialized
+			zInitialized = true;
+
+			// Seek to frame
+			FileUtils::seek( srcFile, frame.inOffset );
+
+			// Decompress frames, until range written
+			while ( leftCount > 0 )
+			{
+
+				// Read, if input consumed
+				if ( zStream.avail_in == 0 )
+				{
+
+					zStream.avail_in = static_cast<uInt>( fread( inBuffer.data( ), sizeof( unsigned char ), inBuffer.size( ), srcFile ) );
+					zStream.next_in = inBuffer.data( );
+
+					if ( ferror( srcFile ) )
+						throw std::runtime_error( "io error, can't read input file !" );
+
+					if ( zStream.avail_in == 0 )
+						throw std::runtime_error( "decompression (inflate) failed, unexpected end of file." );
+
+				}
+
+				// Set output
+				zStream.next_out = outBuffer.data( );
+				zStream.avail_out = static_cast<uInt>( outBuffer.size( ) );
+
+				// Decompress, member CRC-32 is checked by inflate
+				zRet = inflate( &zStream, Z_NO_FLUSH );
+
+				// Check inflate-status, Z_BUF_ERROR means more input required
+				switch ( zRet )
+				{
+
+				case Z_DATA_ERROR:
+					throw std::runtime_error( "decompression (inflate) failed, data corrupted." );
+
+				case Z_MEM_ERROR:
+					throw std::runtime_error( "decompression (inflate) failed, insufficent memory" );
+
+				case Z_NEED_DICT:
+					throw std::runtime_error( "decompression (inflate) failed, dictionary required." );
+
+				case Z_STREAM_ERROR:
+					throw std::runtime_error( "decompression (inflate) failed, stream structure inconsistent." );
+
+				}
+
+				// Output
+				const unsigned char * outData( outBuffer.data( ) );
+				std::uint64_t outCount( outBuffer.size( ) - zStream.avail_out );
+
+				// Skip output before offset
+				const std::uint64_t skipBytes( std::min( skipCount, outCount ) );
+				outData += skipBytes;
+				outCount -= skipBytes;
+				skipCount -= skipBytes;
+
+				// Write range
+				outCount = std::min( outCount, leftCount );
+				pOutput.write( outData, static_cast<std::size_t>( outCount ) );
+				leftCount -= outCount;
+
+				// Next frame
+				if ( zRet == Z_STREAM_END && leftCount > 0 && inflateReset( &zStream ) != Z_OK )
+					throw std::runtime_error( "failed to reset inflate." );
+
+			}
+
+			// Complete pending writes
+			pOutput.finish( );
+
+		}
+		catch ( const std::exception & pException )
+		{
+
+			// Print ERROR-message
+			std::cout << "ZSeekable::extract - error: " << pException.what( ) << std::endl;
+
+			// Release z_stream resources
+			if ( zInitialized )
+				inflateEnd( &zStream );
+
+			// Return ERROR
+			return( Z_ERRNO );
+
+		}
+
+		// Release z_stream resources
+		inflateEnd( &zStream );
+
+		// Return OK
+		return( Z_OK );
+
+	}
+
+	// -------------------------------------------------------- \\
+
+}
\ No newline at end of file
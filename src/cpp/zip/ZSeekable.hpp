@@ -0,0 +1,270 @@
+/*
+* Copyright  2018 Denis Zyamaev (code4un@yandex.ru) All rights reserved.
+* Authors: Denis Zyamaev (code4un@yandex.ru)
+* All rights reserved.
+* API: C++ 11
+* License: see LICENSE.txt
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+* 1. Redistributions of source code must retain the above copyright notice,
+* this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must display the names 'Denis Zyamaev' and
+* in the credits of the application, if such credits exist.
+* The authors of this work must be notified via email (code4un@yandex.ru) in
+* this case of redistribution.
+* 3. Neither the name of copyright holders nor the names of its contributors
+* may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS
+* IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+* PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+// Include 'pch_cxx'
+#include "../pch_cxx.hpp"
+
+// Include OutputSink
+#include "../io/OutputSink.hpp"
+
+namespace c0de4un
+{
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Types
+	// ===========================================================
+
+	/*
+	  * ZSeekable - frame table of seekable gzip file.
+	  *
+	  * Seekable file is a sequence of independent gzip-members (frames),
+	  * each holds fixed amount of uncompressed data. Frame table is
+	  * stored in the extra-field (FEXTRA, subfield 'Z','F') of empty
+	  * gzip-members at the end of the file, so the file is still a valid
+	  * gzip, readable by ZStream::inflateFILE & gzip -d.
+	  *
+	  * Table-member ends with footer, so table is found from the end
+	  * of the file: first frame index, frames count, member size, magic.
+	  * Large tables are split into several table-members.
+	  *
+	  * @language C++ 17
+	  *
+	  * @authors Z. Denis (c0de4un@yandex.ru)
+	  * @version 1.0
+	 */
+	class ZSeekable final
+	{
+
+	public:
+
+		// -------------------------------------------------------- \\
+
+		// ===========================================================
+		// Types
+		// ===========================================================
+
+		/* Independent gzip-member */
+		struct Frame final
+		{
+
+			/* Offset of the member in compressed file */
+			std::uint64_t inOffset;
+
+			/* Offset in uncompressed data */
+			std::uint64_t outOffset;
+
+			/* Size of the member */
+			std::uint32_t inSize;
+
+			/* Size of uncompressed data */
+			std::uint32_t outSize;
+
+			/* CRC-32 of uncompressed data */
+			std::uint32_t crc;
+
+		};
+
+		// ===========================================================
+		// Constants
+		// ===========================================================
+
+		/* Default size of uncompressed frame */
+		static constexpr std::uint32_t DEFAULT_FRAME_SIZE = 1048576;
+
+		/* Max size of uncompressed frame, keeps compressed size in 32 bits */
+		static constexpr std::uint32_t MAX_FRAME_SIZE = 1073741824;
+
+		/* Max number of frames in one table-member, limited by 64 KB extra-field */
+		static constexpr std::size_t MAX_TABLE_FRAMES = 5000;
+
+		// -------------------------------------------------------- \\
+
+	private:
+
+		// -------------------------------------------------------- \\
+
+		// ===========================================================
+		// Constants
+		// ===========================================================
+
+		/* Extra-field subfield ID */
+		static constexpr unsigned char SUBFIELD_ID[2] = { 'Z', 'F' };
+
+		/* Footer signature */
+		static constexpr unsigned char FOOTER_MAGIC[4] = { 'Z', 'F', 'T', '1' };
+
+		/* Size of frame entry: inSize, outSize, crc */
+		static constexpr std::size_t ENTRY_SIZE = 12;
+
+		/* Size of footer: first frame, frames count, member size, magic */
+		static constexpr std::size_t FOOTER_SIZE = 16;
+
+		/* Size of gzip-header with extra-field length */
+		static constexpr std::size_t HEADER_SIZE = 12;
+
+		/* Size of subfield-header: ID & length */
+		static constexpr std::size_t SUBFIELD_HEADER_SIZE = 4;
+
+		/* Size of empty deflate-data & gzip-trailer */
+		static constexpr std::size_t TRAILER_SIZE = 10;
+
+		/* Size of input & output buffers */
+		static constexpr std::size_t CHUNK_SIZE = 65536;
+
+		// ===========================================================
+		// Fields
+		// ===========================================================
+
+		/* Frames, in file order */
+		std::vector<Frame> mFrames;
+
+		/* Size of uncompressed data */
+		std::uint64_t mUncompressedSize;
+
+		// ===========================================================
+		// Methods
+		// ===========================================================
+
+		/*
+		 * Append little-endian value.
+		 *
+		 * @param pBuffer - output.
+		 * @param pValue - value.
+		 * @param bytesCount - number of bytes to write.
+		 * @throws - can throw exception (bad_alloc).
+		*/
+		static void putValue( std::vector<unsigned char> & pBuffer, const std::uint64_t pValue, const std::size_t bytesCount );
+
+		/*
+		 * Returns little-endian value.
+		 *
+		 * @param pData - input.
+		 * @param bytesCount - number of bytes to read.
+		*/
+		static std::uint64_t getValue( const unsigned char *const pData, const std::size_t bytesCount ) noexcept;
+
+		// -------------------------------------------------------- \\
+
+	public:
+
+		// -------------------------------------------------------- \\
+
+		// ===========================================================
+		// Constructor & destructor
+		// ===========================================================
+
+		/* ZSeekable constructor, table is empty */
+		explicit ZSeekable( ) noexcept;
+
+		/* ZSeekable destructor */
+		~ZSeekable( ) = default;
+
+		// ===========================================================
+		// Getters
+		// ===========================================================
+
+		/* Returns number of frames */
+		std::size_t getFramesCount( ) const noexcept;
+
+		/*
+		 * Returns frame.
+		 *
+		 * @param pIndex - frame index, must be less than frames count.
+		*/
+		const Frame & getFrame( const std::size_t pIndex ) const noexcept;
+
+		/* Returns size of uncompressed data */
+		std::uint64_t getUncompressedSize( ) const noexcept;
+
+		/*
+		 * Returns index of frame, that contains uncompressed offset.
+		 *
+		 * @param pOffset - uncompressed offset, must be less than uncompressed size.
+		*/
+		std::size_t findFrame( const std::uint64_t pOffset ) const noexcept;
+
+		// ===========================================================
+		// Methods
+		// ===========================================================
+
+		/*
+		 * Write frame table as gzip-members.
+		 *
+		 * @thread_safety - not thread-safe.
+		 * @param dstFile - output file, position must be after the last frame.
+		 * @param pFrames - frames, in file order.
+		 * @throws - can throw exception.
+		*/
+		static void writeTable( std::FILE *const dstFile, const std::vector<Frame> & pFrames );
+
+		/*
+		 * Returns true, if file ends with frame table. Position is not changed.
+		 *
+		 * @thread_safety - not thread-safe.
+		 * @param srcFile - file, must be seekable.
+		 * @throws - can throw exception, if file can't be positioned.
+		*/
+		static bool hasTable( std::FILE *const srcFile );
+
+		/*
+		 * Read frame table from the end of file.
+		 *
+		 * @thread_safety - not thread-safe.
+		 * @param srcFile - seekable gzip file.
+		 * @return - Z_OK if read, Z_ERRNO otherwise (not a seekable file).
+		*/
+		int load( std::FILE *const srcFile );
+
+		/*
+		 * Decompress range, starting from the frame that contains offset.
+		 *
+		 * @thread_safety - not thread-safe.
+		 * @param srcFile - seekable gzip file.
+		 * @param offset - uncompressed offset of the range.
+		 * @param length - size of the range, cut at the end of data.
+		 * @param pOutput - receives decompressed range.
+		 * @return - Z_OK if range decompressed, Z_ERRNO otherwise.
+		*/
+		int extract( std::FILE *const srcFile, const std::uint64_t offset, const std::uint64_t length, OutputSink & pOutput ) const;
+
+		// -------------------------------------------------------- \\
+
+	};
+
+	// -------------------------------------------------------- \\
+
+}
\ No newline at end of file
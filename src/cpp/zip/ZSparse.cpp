@@ -0,0 +1,870 @@
+/*
+* Copyright  2018 Denis Zyamaev (code4un@yandex.ru) All rights reserved.
+* Authors: Denis Zyamaev (code4un@yandex.ru)
+* All rights reserved.
+* API: C++ 11
+* License: see LICENSE.txt
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+* 1. Redistributions of source code must retain the above copyright notice,
+* this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must display the names 'Denis Zyamaev' and
+* in the credits of the application, if such credits exist.
+* The authors of this work must be notified via email (code4un@yandex.ru) in
+* this case of redistribution.
+* 3. Neither the name of copyright holders nor the names of its contributors
+* may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS
+* IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+* PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// HEADER
+#include "ZSparse.hpp"
+
+// Include ZStream
+#include "ZStream.hpp"
+
+// Include FileUtils
+#include "../io/FileUtils.hpp"
+
+// Include FileOutputSink
+#include "../io/FileOutputSink.hpp"
+
+// Include SparseOutputSink
+#include "../io/SparseOutputSink.hpp"
+
+// Include POSIX file API
+#if !defined( _WIN32 )
+#  include <cerrno>
+#  include <unistd.h>
+#endif
+
+namespace c0de4un
+{
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// ExtentSource
+	// ===========================================================
+
+	/*
+	 * ExtentSource constructor, positions file at extent.
+	 *
+	 * @param pFile - file to read.
+	 * @param pExtent - extent.
+	 * @param pBuffer - read-buffer, must outlive this source.
+	 * @throws - can throw exception, if file can't be positioned.
+	*/
+	ZSparse::ExtentSource::ExtentSource( std::FILE *const pFile, const Extent & pExtent, std::vector<unsigned char> & pBuffer )
+		: mFile( pFile ),
+		mLeftCount( pExtent.length ),
+		mBuffer( pBuffer )
+	{ FileUtils::seek( pFile, pExtent.offset ); }
+
+	/*
+	 * Reads next piece of extent.
+	 *
+	 * @param pData - receives pointer to buffer.
+	 * @return - number of bytes, 0 at end of extent.
+	 * @throws - can throw exception.
+	*/
+	std::size_t ZSparse::ExtentSource::read( const unsigned char *& pData )
+	{
+
+		// Read
+		const std::size_t readCount( fread( mBuffer.data( ), sizeof( unsigned char ), static_cast<std::size_t>( std::min<std::uint64_t>( mLeftCount, mBuffer.size( ) ) ), mFile ) );
+
+		// Check io errors, file must not shrink
+		if ( ferror( mFile ) || ( readCount == 0 && mLeftCount > 0 ) )
+			throw std::runtime_error( "ZSparse::ExtentSource::read - io error, can't read input file !" );
+
+		mLeftCount -= readCount;
+
+		// Return
+		pData = mBuffer.data( );
+		return( readCount );
+
+	}
+
+	// ===========================================================
+	// Methods
+	// ===========================================================
+
+	/*
+	 * Append little-endian value.
+	 *
+	 * @param pBuffer - output.
+	 * @param pValue - value.
+	 * @param bytesCount - number of bytes to write.
+	 * @throws - can throw exception (bad_alloc).
+	*/
+	void ZSparse::putValue( std::vector<unsigned char> & pBuffer, const std::uint64_t pValue, const std::size_t bytesCount )
+	{
+
+		for ( std::size_t i = 0; i < bytesCount; i++ )
+			pBuffer.push_back( static_cast<unsigned char>( ( pValue >> ( i * 8 ) ) & 0xFF ) );
+
+	}
+
+	/*
+	 * Returns little-endian value.
+	 *
+	 * @param pData - input.
+	 * @param bytesCount - number of bytes to read.
+	*/
+	std::uint64_t ZSparse::getValue( const unsigned char *const pData, const std::size_t bytesCount ) noexcept
+	{
+
+		// Value
+		std::uint64_t value( 0 );
+		for ( std::size_t i = 0; i < bytesCount; i++ )
+			value |= static_cast<std::uint64_t>( pData[i] ) << ( i * 8 );
+
+		// Return
+		return( value );
+
+	}
+
+	/*
+	 * Enumerate data extents from the current position to the end of file.
+	 * Holes smaller then MIN_HOLE_SIZE are included in data.
+	 * Without SEEK_DATA support the whole file is one extent.
+	 *
+	 * @param srcFile - file to read, must be seekable.
+	 * @param fileSize - size of file.
+	 * @return - data extents, in file order.
+	 * @throws - can throw exception.
+	*/
+	std::vector<ZSparse::Extent> ZSparse::getDataExtents( std::FILE *const srcFile, const std::uint64_t fileSize )
+	{
+
+		// Extents
+		std::vector<Extent> dataExtents;
+
+		// Start
+		const std::uint64_t startOffset( FileUtils::tell( srcFile ) );
+
+#if !defined( _WIN32 ) && defined( SEEK_DATA ) && defined( SEEK_HOLE )
+
+		// File-descriptor
+		const int fileDescriptor( fileno( srcFile ) );
+
+		// true, if file system reports data extents
+		bool extentsSupported( fileDescriptor >= 0 );
+
+		// Enumerate extents
+		for ( std::uint64_t offset = startOffset; extentsSupported && offset < fileSize; )
+		{
+
+			// Next data, no data till the end of file
+			const off_t dataStart( lseek( fileDescriptor, static_cast<off_t>( offset ), SEEK_DATA ) );
+			if ( dataStart < 0 )
+			{
+				extentsSupported = errno == ENXIO;
+				break;
+			}
+
+			// Hole after data, end of file is a hole
+			const off_t holeStart( lseek( fileDescriptor, dataStart, SEEK_HOLE ) );
+			const std::uint64_t dataEnd( holeStart < 0 ? fileSize : std::min<std::uint64_t>( static_cast<std::uint64_t>( holeStart ), fileSize ) );
+
+			// Small hole is included in previous extent
+			const std::uint64_t dataOffset( static_cast<std::uint64_t>( dataStart ) );
+			const std::uint64_t previousEnd( dataExtents.empty( ) ? startOffset : dataExtents.back( ).offset + dataExtents.back( ).length );
+
+			if ( dataOffset - previousEnd < MIN_HOLE_SIZE )
+			{
+
+				if ( dataExtents.empty( ) )
+					dataExtents.push_back( Extent{ startOffset, dataEnd - startOffset } );
+				else
+					dataExtents.back( ).length = dataEnd - dataExtents.back( ).offset;
+
+			}
+			else
+				dataExtents.push_back( Extent{ dataOffset, dataEnd - dataOffset } );
+
+			offset = dataEnd;
+
+		}
+
+		// Restore position, stdio is synchronized with descriptor
+		FileUtils::seek( srcFile, startOffset );
+
+		// Small hole at the end is included in the last extent
+		if ( extentsSupported )
+		{
+
+			const std::uint64_t lastEnd( dataExtents.empty( ) ? startOffset : dataExtents.back( ).offset + dataExtents.back( ).length );
+
+			if ( lastEnd < fileSize && fileSize - lastEnd < MIN_HOLE_SIZE )
+			{
+
+				if ( dataExtents.empty( ) )
+					dataExtents.push_back( Extent{ startOffset, fileSize - startOffset } );
+				else
+					dataExtents.back( ).length = fileSize - dataExtents.back( ).offset;
+
+			}
+
+			return( dataExtents );
+
+		}
+
+		dataExtents.clear( );
+
+#endif
+
+		// Whole file
+		if ( fileSize > startOffset )
+			dataExtents.push_back( Extent{ startOffset, fileSize - startOffset } );
+
+		return( dataExtents );
+
+	}
+
+	/*
+	 * Write gzip-members of zeros.
+	 *
+	 * @param dstFile - output file.
+	 * @param pLength - number of zeros.
+	 * @param zeroMembers - cache of members, by power of 2.
+	 * @throws - can throw exception.
+	*/
+	void ZSparse::writeZeros( std::FILE *const dstFile, std::uint64_t pLength, std::vector<std::vector<unsigned char>> & zeroMembers )
+	{
+
+		// Members, from the largest
+		while ( pLength > 0 )
+		{
+
+			// The largest power of 2, not greater then length
+			std::size_t sizeIndex( ZERO_SIZES_COUNT - 1 );
+			while ( ( static_cast<std::uint64_t>( 1 ) << sizeIndex ) > pLength )
+				sizeIndex--;
+
+			const std::uint64_t memberLength( static_cast<std::uint64_t>( 1 ) << sizeIndex );
+			std::vector<unsigned char> & zeroMember( zeroMembers[sizeIndex] );
+
+			// Compress zeros once
+			if ( zeroMember.empty( ) )
+			{
+
+				z_stream zStream;
+				zStream.zalloc = Z_NULL;
+				zStream.zfree = Z_NULL;
+				zStream.opaque = Z_NULL;
+
+				if ( deflateInit2( &zStream, Z_BEST_COMPRESSION, Z_DEFLATED, ZStream::GZIP_WINDOW_BITS, 9, Z_DEFAULT_STRATEGY ) != Z_OK )
+					throw std::runtime_error( "ZSparse::writeZeros - failed to initialize deflate." );
+
+				const std::vector<unsigned char> zeroBuffer( static_cast<std::size_t>( std::min<std::uint64_t>( memberLength, CHUNK_SIZE ) ), 0 );
+				zeroMember.resize( deflateBound( &zStream, static_cast<uLong>( memberLength ) ) );
+				zStream.next_out = zeroMember.data( );
+				zStream.avail_out = static_cast<uInt>( zeroMember.size( ) );
+
+				int zRet( Z_OK );
+				for ( std::uint64_t leftCount = memberLength; zRet != Z_STREAM_END; )
+				{
+
+					const std::size_t inCount( static_cast<std::size_t>( std::min<std::uint64_t>( leftCount, zeroBuffer.size( ) ) ) );
+					zStream.next_in = const_cast<Bytef*>( zeroBuffer.data( ) );
+					zStream.avail_in = static_cast<uInt>( inCount );
+					leftCount -= inCount;
+
+					zRet = deflate( &zStream, leftCount == 0 ? Z_FINISH : Z_NO_FLUSH );
+
+					if ( zRet == Z_STREAM_ERROR || ( zRet != Z_STREAM_END && zStream.avail_out == 0 ) )
+					{
+						deflateEnd( &zStream );
+						throw std::runtime_error( "ZSparse::writeZeros - compression failed." );
+					}
+
+				}
+
+				zeroMember.resize( zeroMember.size( ) - zStream.avail_out );
+				deflateEnd( &zStream );
+
+			}
+
+			// Write
+			if ( fwrite( zeroMember.data( ), sizeof( unsigned char ), zeroMember.size( ), dstFile ) != zeroMember.size( ) || ferror( dstFile ) )
+				throw std::runtime_error( "ZSparse::writeZeros - failed to write output file" );
+
+			pLength -= memberLength;
+
+		}
+
+	}
+
+	/*
+	 * Write hole map as gzip-members.
+	 *
+	 * @param dstFile - output file, position must be after the last member.
+	 * @param pHoles - holes, in file order.
+	 * @param uncompressedSize - size of uncompressed data.
+	 * @throws - can throw exception.
+	*/
+	void ZSparse::writeTable( std::FILE *const dstFile, const std::vector<Hole> & pHoles, const std::uint64_t uncompressedSize )
+	{
+
+		// Map-member
+		std::vector<unsigned char> tableMember;
+
+		// Index of the first hole of map-member
+		std::size_t firstHole( 0 );
+
+		// Write map-members, file without holes has one empty map
+		do
+		{
+
+			// Number of holes in map-member
+			const std::size_t holesCount( std::min( pHoles.size( ) - firstHole, MAX_TABLE_HOLES ) );
+
+			// Size of subfield-data
+			const std::size_t subfieldSize( holesCount * ENTRY_SIZE + FOOTER_SIZE );
+
+			// Size of map-member
+			const std::size_t memberSize( HEADER_SIZE + SUBFIELD_HEADER_SIZE + subfieldSize + TRAILER_SIZE );
+
+			// gzip-header: magic, deflate, flags (FEXTRA), mtime, extra-flags, OS (unknown)
+			const unsigned char headerBytes[10] = { 0x1F, 0x8B, Z_DEFLATED, 0x04, 0, 0, 0, 0, 0, 255 };
+			tableMember.assign( headerBytes, headerBytes + 10 );
+
+			// Extra-field length & subfield-header
+			putValue( tableMember, SUBFIELD_HEADER_SIZE + subfieldSize, 2 );
+			tableMember.push_back( SUBFIELD_ID[0] );
+			tableMember.push_back( SUBFIELD_ID[1] );
+			putValue( tableMember, subfieldSize, 2 );
+
+			// Entries
+			for ( std::size_t i = firstHole; i < firstHole + holesCount; i++ )
+			{
+				putValue( tableMember, pHoles[i].outOffset, 8 );
+				putValue( tableMember, pHoles[i].length, 8 );
+				putValue( tableMember, pHoles[i].inOffset, 8 );
+				putValue( tableMember, pHoles[i].inSize, 8 );
+			}
+
+			// Footer
+			putValue( tableMember, uncompressedSize, 8 );
+			putValue( tableMember, firstHole, 4 );
+			putValue( tableMember, holesCount, 4 );
+			putValue( tableMember, memberSize, 4 );
+			tableMember.insert( tableMember.end( ), FOOTER_MAGIC, FOOTER_MAGIC + 4 );
+
+			// Empty deflate-data (final fixed block with end-of-block only), CRC-32 & size are 0
+			tableMember.push_back( 0x03 );
+			tableMember.insert( tableMember.end( ), TRAILER_SIZE - 1, 0 );
+
+			// Write
+			if ( fwrite( tableMember.data( ), sizeof( unsigned char ), tableMember.size( ), dstFile ) != tableMember.size( ) || ferror( dstFile ) )
+				throw std::runtime_error( "ZSparse::writeTable - failed to write output file" );
+
+			// Next
+			firstHole += holesCount;
+
+		} while ( firstHole < pHoles.size( ) );
+
+	}
+
+	/*
+	 * Read hole map from the end of file.
+	 *
+	 * @param srcFile - sparse gzip file.
+	 * @param pHoles - receives holes, in file order.
+	 * @param uncompressedSize - receives size of uncompressed data.
+	 * @return - offset of the first map-member.
+	 * @throws - can throw exception, if map not found or corrupted.
+	*/
+	std::uint64_t ZSparse::readTable( std::FILE *const srcFile, std::vector<Hole> & pHoles, std::uint64_t & uncompressedSize )
+	{
+
+		// Map-members, from the end of file
+		std::vector<std::vector<Hole>> tables;
+
+		// Map-member
+		std::vector<unsigned char> tableMember;
+
+		// End of the map-member
+		std::uint64_t tableEnd( FileUtils::getSize( srcFile ) );
+
+		// Index of the hole after map-member
+		std::uint64_t nextHole( 0 );
+
+		// Read map-members, until the first one
+		while ( true )
+		{
+
+			// Footer & trailer
+			unsigned char footerBytes[FOOTER_SIZE + TRAILER_SIZE];
+
+			if ( tableEnd < HEADER_SIZE + SUBFIELD_HEADER_SIZE + FOOTER_SIZE + TRAILER_SIZE )
+				throw std::runtime_error( "hole map not found" );
+
+			FileUtils::seek( srcFile, tableEnd - FOOTER_SIZE - TRAILER_SIZE );
+			if ( fread( footerBytes, sizeof( unsigned char ), sizeof( footerBytes ), srcFile ) != sizeof( footerBytes ) )
+				throw std::runtime_error( "failed to read input file" );
+
+			// Check signature & empty member trailer
+			if ( std::memcmp( footerBytes + 20, FOOTER_MAGIC, 4 ) != 0 || footerBytes[FOOTER_SIZE] != 0x03 || std::any_of( footerBytes + FOOTER_SIZE + 1, footerBytes + sizeof( footerBytes ), []( const unsigned char pByte ) { return( pByte != 0 ); } ) )
+				throw std::runtime_error( "hole map not found" );
+
+			// Footer
+			const std::uint64_t dataSize( getValue( footerBytes, 8 ) );
+			const std::uint64_t firstHole( getValue( footerBytes + 8, 4 ) );
+			const std::uint64_t holesCount( getValue( footerBytes + 12, 4 ) );
+			const std::uint64_t memberSize( getValue( footerBytes + 16, 4 ) );
+
+			// Check, the last map-member ends holes
+			if ( tables.empty( ) )
+			{
+				nextHole = firstHole + holesCount;
+				uncompressedSize = dataSize;
+			}
+
+			if ( holesCount > MAX_TABLE_HOLES || firstHole + holesCount != nextHole || memberSize > tableEnd || dataSize != uncompressedSize
+				|| memberSize != HEADER_SIZE + SUBFIELD_HEADER_SIZE + holesCount * ENTRY_SIZE + FOOTER_SIZE + TRAILER_SIZE )
+				throw std::runtime_error( "hole map corrupted" );
+
+			// Read map-member
+			tableMember.resize( static_cast<std::size_t>( memberSize ) );
+			FileUtils::seek( srcFile, tableEnd - memberSize );
+			if ( fread( tableMember.data( ), sizeof( unsigned char ), tableMember.size( ), srcFile ) != tableMember.size( ) )
+				throw std::runtime_error( "failed to read input file" );
+
+			// Check gzip-header & subfield
+			if ( tableMember[0] != 0x1F || tableMember[1] != 0x8B || tableMember[2] != Z_DEFLATED || tableMember[3] != 0x04
+				|| getValue( tableMember.data( ) + 10, 2 ) != memberSize - HEADER_SIZE - TRAILER_SIZE
+				|| tableMember[12] != SUBFIELD_ID[0] || tableMember[13] != SUBFIELD_ID[1] )
+				throw std::runtime_error( "hole map corrupted" );
+
+			// Entries
+			tables.emplace_back( );
+			tables.back( ).resize( static_cast<std::size_t>( holesCount ) );
+			for ( std::size_t i = 0; i < tables.back( ).size( ); i++ )
+			{
+				const unsigned char *const entryBytes( tableMember.data( ) + HEADER_SIZE + SUBFIELD_HEADER_SIZE + i * ENTRY_SIZE );
+				Hole & hole( tables.back( )[i] );
+				hole.outOffset = getValue( entryBytes, 8 );
+				hole.length = getValue( entryBytes + 8, 8 );
+				hole.inOffset = getValue( entryBytes + 16, 8 );
+				hole.inSize = getValue( entryBytes + 24, 8 );
+			}
+
+			// Previous map-member
+			tableEnd -= memberSize;
+			nextHole = firstHole;
+
+			if ( firstHole == 0 )
+				break;
+
+		}
+
+		// Join tables in file order
+		pHoles.clear( );
+		for ( auto tablesIter = tables.rbegin( ); tablesIter != tables.rend( ); tablesIter++ )
+			pHoles.insert( pHoles.end( ), tablesIter->begin( ), tablesIter->end( ) );
+
+		// Check order: holes & their members don't overlap, members end before the map
+		std::uint64_t inEnd( 0 );
+		std::uint64_t outEnd( 0 );
+		for ( const Hole & hole : pHoles )
+		{
+
+			if ( hole.inOffset < inEnd || hole.outOffset < outEnd || hole.inOffset + hole.inSize > tableEnd || hole.outOffset + hole.length > uncompressedSize )
+				throw std::runtime_error( "hole map doesn't match the file" );
+
+			inEnd = hole.inOffset + hole.inSize;
+			outEnd = hole.outOffset + hole.length;
+
+		}
+
+		// Return
+		return( tableEnd );
+
+	}
+
+	/*
+	 * Decompress gzip-members in range of compressed file.
+	 *
+	 * @param srcFile - compressed file.
+	 * @param inBegin - offset of the first member.
+	 * @param inEnd - end of the last member.
+	 * @param zStream - initialized inflate.
+	 * @param pBuffers - input & output buffers.
+	 * @param pOutput - output.
+	 * @return - number of decompressed bytes.
+	 * @throws - can throw exception.
+	*/
+	std::uint64_t ZSparse::inflateRange( std::FILE *const srcFile, const std::uint64_t inBegin, const std::uint64_t inEnd, z_stream & zStream, std::vector<unsigned char> & pBuffers, OutputSink & pOutput )
+	{
+
+		// Empty range
+		if ( inBegin >= inEnd )
+			return( 0 );
+
+		// Buffers
+		unsigned char *const inBuffer( pBuffers.data( ) );
+		unsigned char *const outBuffer( pBuffers.data( ) + CHUNK_SIZE );
+
+		// Number of decompressed bytes
+		std::uint64_t outCount( 0 );
+
+		// Compressed bytes left to read
+		std::uint64_t leftCount( inEnd - inBegin );
+
+		// Return code
+		int zRet( Z_OK );
+
+		// Start
+		FileUtils::seek( srcFile, inBegin );
+
+		if ( inflateReset( &zStream ) != Z_OK )
+			throw std::runtime_error( "failed to reset inflate." );
+
+		zStream.avail_in = 0;
+
+		// Decompress members
+		while ( true )
+		{
+
+			// Read
+			if ( zStream.avail_in == 0 )
+			{
+
+				if ( leftCount == 0 )
+					break;
+
+				const std::size_t readCount( fread( inBuffer, sizeof( unsigned char ), static_cast<std::size_t>( std::min<std::uint64_t>( leftCount, CHUNK_SIZE ) ), srcFile ) );
+
+				if ( readCount == 0 || ferror( srcFile ) )
+					throw std::runtime_error( "io error, can't read input file !" );
+
+				leftCount -= readCount;
+				zStream.next_in = inBuffer;
+				zStream.avail_in = static_cast<uInt>( readCount );
+
+			}
+
+			// Decompress input
+			do
+			{
+
+				zStream.next_out = outBuffer;
+				zStream.avail_out = static_cast<uInt>( CHUNK_SIZE );
+
+				zRet = inflate( &zStream, Z_NO_FLUSH );
+
+				// Z_BUF_ERROR means more input required
+				if ( zRet == Z_DATA_ERROR || zRet == Z_NEED_DICT || zRet == Z_MEM_ERROR || zRet == Z_STREAM_ERROR )
+					throw std::runtime_error( "decompression (inflate) failed, data corrupted." );
+
+				const std::size_t inflatedCount( CHUNK_SIZE - zStream.avail_out );
+				pOutput.write( outBuffer, inflatedCount );
+				outCount += inflatedCount;
+
+			} while ( zStream.avail_out == 0 && zRet != Z_STREAM_END );
+
+			// Member end, next member follows in range
+			if ( zRet == Z_STREAM_END && ( zStream.avail_in > 0 || leftCount > 0 ) )
+			{
+
+				if ( inflateReset( &zStream ) != Z_OK )
+					throw std::runtime_error( "failed to reset inflate." );
+
+				zRet = Z_OK;
+
+			}
+
+		}
+
+		// The last member must be complete
+		if ( zRet != Z_STREAM_END )
+			throw std::runtime_error( "decompression (inflate) failed, unexpected end of member." );
+
+		// Return
+		return( outCount );
+
+	}
+
+	/*
+	 * Returns true, if file ends with hole map. Position is not changed.
+	 *
+	 * @thread_safety - not thread-safe.
+	 * @param srcFile - file, must be seekable.
+	 * @throws - can throw exception, if file can't be positioned.
+	*/
+	bool ZSparse::hasTable( std::FILE *const srcFile )
+	{
+
+		// Position
+		const std::uint64_t position( FileUtils::tell( srcFile ) );
+
+		// Size
+		const std::uint64_t fileSize( FileUtils::getSize( srcFile ) );
+
+		if ( fileSize < HEADER_SIZE + SUBFIELD_HEADER_SIZE + FOOTER_SIZE + TRAILER_SIZE )
+			return( false );
+
+		// Footer & trailer
+		unsigned char footerBytes[FOOTER_SIZE + TRAILER_SIZE];
+
+		FileUtils::seek( srcFile, fileSize - FOOTER_SIZE - TRAILER_SIZE );
+		const bool footerRead( fread( footerBytes, sizeof( unsigned char ), sizeof( footerBytes ), srcFile ) == sizeof( footerBytes ) );
+
+		// Restore position
+		FileUtils::seek( srcFile, position );
+
+		// Return
+		return( footerRead && std::memcmp( footerBytes + 20, FOOTER_MAGIC, 4 ) == 0 && footerBytes[FOOTER_SIZE] == 0x03 );
+
+	}
+
+	/*
+	 * Compress sparse file as gzip with hole map.
+	 *
+	 * @thread_safety - thread-safe.
+	 * @param srcFile - file to compress, must be seekable, from the current position.
+	 * @param dstFile - output file.
+	 * @param compressionLevel - Compression-Level to use, must be in range 0-9.
+	 * @return - Z_OK if compression complete, Z_ERRNO otherwise.
+	*/
+	int ZSparse::deflateFILE( std::FILE *const srcFile, std::FILE *const dstFile, const int compressionLevel )
+	{
+
+		// Guarded-Block
+		try
+		{
+
+			// Data extents
+			const std::uint64_t startOffset( FileUtils::tell( srcFile ) );
+			const std::uint64_t fileSize( FileUtils::getSize( srcFile ) );
+			const std::vector<Extent> dataExtents( getDataExtents( srcFile, fileSize ) );
+
+			// Engine, extents are compressed as separate members
+			ZStream zEngine( static_cast<std::uint32_t>( CHUNK_SIZE ), &ZArena::getThreadArena( ) );
+			std::vector<unsigned char> readBuffer( CHUNK_SIZE );
+			FileOutputSink fileSink( dstFile );
+
+			// Cache of zero-members
+			std::vector<std::vector<unsigned char>> zeroMembers( ZERO_SIZES_COUNT );
+
+			// Holes
+			std::vector<Hole> holes;
+
+			// Uncompressed offset
+			std::uint64_t outOffset( 0 );
+
+			// Write hole as zero-members
+			auto addHole = [&]( const std::uint64_t pLength )
+			{
+
+				Hole hole;
+				hole.outOffset = outOffset;
+				hole.length = pLength;
+				hole.inOffset = FileUtils::tell( dstFile );
+
+				writeZeros( dstFile, pLength, zeroMembers );
+
+				hole.inSize = FileUtils::tell( dstFile ) - hole.inOffset;
+				holes.push_back( hole );
+
+				outOffset += pLength;
+
+			};
+
+			// Extents & holes before them
+			for ( const Extent & dataExtent : dataExtents )
+			{
+
+				if ( dataExtent.offset > startOffset + outOffset )
+					addHole( dataExtent.offset - startOffset - outOffset );
+
+				ExtentSource extentSource( srcFile, dataExtent, readBuffer );
+				if ( zEngine.compress( extentSource, fileSink, compressionLevel, ZFormat::GZIP ) != Z_OK )
+					throw std::runtime_error( "failed to compress data extent" );
+
+				outOffset += dataExtent.length;
+
+			}
+
+			// Hole at the end
+			if ( startOffset + outOffset < fileSize )
+				addHole( fileSize - startOffset - outOffset );
+
+			// Hole map
+			writeTable( dstFile, holes, outOffset );
+
+		}
+		catch ( const std::exception & pException )
+		{
+
+			// Print ERROR-message
+			std::cout << "ZSparse::deflateFILE - error: " << pException.what( ) << std::endl;
+
+			// Return ERROR
+			return( Z_ERRNO );
+
+		}
+
+		// Return OK
+		return( Z_OK );
+
+	}
+
+	/*
+	 * Decompress gzip file, recreating holes. File with hole map is
+	 * inflated without zero-members, other files are inflated whole
+	 * with zero blocks skipped.
+	 *
+	 * @thread_safety - thread-safe.
+	 * @param srcFile - file to decompress, from the beginning.
+	 * @param dstFile - output file, should be regular file.
+	 * @return - Z_OK if sucessfull, Z_ERRNO otherwise.
+	*/
+	int ZSparse::inflateFILE( std::FILE *const srcFile, std::FILE *const dstFile )
+	{
+
+		// Inflate z_stream
+		z_stream zStream;
+		zStream.zalloc = Z_NULL;
+		zStream.zfree = Z_NULL;
+		zStream.opaque = Z_NULL;
+		zStream.avail_in = 0;
+		zStream.next_in = Z_NULL;
+
+		// true, if inflate initialized
+		bool zInitialized( false );
+
+		// Guarded-Block
+		try
+		{
+
+			// Without hole map (other gzip, zlib, pipe), zero blocks of output are skipped
+			bool mapped( false );
+			try
+			{
+				mapped = hasTable( srcFile );
+			}
+			catch ( const std::runtime_error & )
+			{
+				// Not seekable
+			}
+
+			if ( !mapped )
+				return( ZStream::inflateFILE( srcFile, dstFile, static_cast<std::uint32_t>( CHUNK_SIZE ), IOBackend::SPARSE ) == Z_OK ? Z_OK : Z_ERRNO );
+
+			// Hole map
+			std::vector<Hole> holes;
+			std::uint64_t uncompressedSize( 0 );
+			const std::uint64_t tableOffset( readTable( srcFile, holes, uncompressedSize ) );
+
+			// Output, zeros are written, if not a regular file
+			std::unique_ptr<OutputSink> fileSink;
+			SparseOutputSink * sparseSink( nullptr );
+
+			try
+			{
+				std::unique_ptr<SparseOutputSink> newSink( std::make_unique<SparseOutputSink>( dstFile ) );
+				sparseSink = newSink.get( );
+				fileSink = std::move( newSink );
+			}
+			catch ( const std::runtime_error & )
+			{
+				fileSink = std::make_unique<FileOutputSink>( dstFile );
+			}
+
+			// Initialize inflate, gzip only
+			if ( inflateInit2( &zStream, MAX_WBITS + 16 ) != Z_OK )
+				throw std::runtime_error( "failed to initialize inflate." );
+
+			zInitialized = true;
+
+			// Buffers
+			std::vector<unsigned char> zBuffers( CHUNK_SIZE * 2 );
+
+			// Offsets
+			std::uint64_t inOffset( 0 );
+			std::uint64_t outOffset( 0 );
+
+			// Data members before each hole, then hole
+			for ( const Hole & hole : holes )
+			{
+
+				outOffset += inflateRange( srcFile, inOffset, hole.inOffset, zStream, zBuffers, *fileSink );
+
+				if ( outOffset != hole.outOffset )
+					throw std::runtime_error( "hole map doesn't match data" );
+
+				if ( sparseSink != nullptr )
+					sparseSink->skip( hole.length );
+				else
+				{
+
+					const std::vector<unsigned char> zeroBuffer( CHUNK_SIZE, 0 );
+					for ( std::uint64_t leftCount = hole.length; leftCount > 0; )
+					{
+						const std::size_t zeroCount( static_cast<std::size_t>( std::min<std::uint64_t>( leftCount, CHUNK_SIZE ) ) );
+						fileSink->write( zeroBuffer.data( ), zeroCount );
+						leftCount -= zeroCount;
+					}
+
+				}
+
+				outOffset += hole.length;
+				inOffset = hole.inOffset + hole.inSize;
+
+			}
+
+			// Data members after the last hole
+			outOffset += inflateRange( srcFile, inOffset, tableOffset, zStream, zBuffers, *fileSink );
+
+			if ( outOffset != uncompressedSize )
+				throw std::runtime_error( "hole map doesn't match data" );
+
+			// Complete output
+			fileSink->finish( );
+
+		}
+		catch ( const std::exception & pException )
+		{
+
+			// Print ERROR-message
+			std::cout << "ZSparse::inflateFILE - error: " << pException.what( ) << std::endl;
+
+			// Release inflate
+			if ( zInitialized )
+				inflateEnd( &zStream );
+
+			// Return ERROR
+			return( Z_ERRNO );
+
+		}
+
+		// Release inflate
+		if ( zInitialized )
+			inflateEnd( &zStream );
+
+		// Return OK
+		return( Z_OK );
+
+	}
+
+	// -------------------------------------------------------- \\
+
+}
\ No newline at end of file
@@ -0,0 +1,337 @@
+/*
+* Copyright  2018 Denis Zyamaev (code4un@yandex.ru) All rights reserved.
+* Authors: Denis Zyamaev (code4un@yandex.ru)
+* All rights reserved.
+* API: C++ 11
+* License: see LICENSE.txt
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+* 1. Redistributions of source code must retain the above copyright notice,
+* this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must display the names 'Denis Zyamaev' and
+* in the credits of the application, if such credits exist.
+* The authors of this work must be notified via email (code4un@yandex.ru) in
+* this case of redistribution.
+* 3. Neither the name of copyright holders nor the names of its contributors
+* may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS
+* IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+* PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+// Include 'pch_cxx'
+#include "../pch_cxx.hpp"
+
+// Include InputSource
+#include "../io/InputSource.hpp"
+
+// Include OutputSink
+#include "../io/OutputSink.hpp"
+
+namespace c0de4un
+{
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Types
+	// ===========================================================
+
+	/*
+	  * ZSparse - compression of sparse files (disk images), that reads
+	  * only data extents.
+	  *
+	  * Data extents are enumerated with SEEK_DATA/SEEK_HOLE & each one is
+	  * compressed as gzip-member. Each hole is written as cached gzip-members
+	  * of zeros (about 1 KB per MB of hole), so the file is still a valid
+	  * gzip, readable by ZStream::inflateFILE & gzip -d.
+	  *
+	  * Hole map is stored like ZSeekable frame table: in the extra-field
+	  * (FEXTRA, subfield 'Z','H') of empty gzip-members at the end of the
+	  * file. inflateFILE uses it to skip zero-members & leave holes in the
+	  * output, so both directions take time proportional to stored data.
+	  *
+	  * @language C++ 17
+	  *
+	  * @authors Z. Denis (c0de4un@yandex.ru)
+	  * @version 1.0
+	 */
+	class ZSparse final
+	{
+
+	public:
+
+		// -------------------------------------------------------- \\
+
+		// ===========================================================
+		// Types
+		// ===========================================================
+
+		/* Hole & it's zero-members */
+		struct Hole final
+		{
+
+			/* Offset of the hole in uncompressed data */
+			std::uint64_t outOffset;
+
+			/* Size of the hole */
+			std::uint64_t length;
+
+			/* Offset of zero-members in compressed file */
+			std::uint64_t inOffset;
+
+			/* Size of zero-members */
+			std::uint64_t inSize;
+
+		};
+
+		// ===========================================================
+		// Constants
+		// ===========================================================
+
+		/* Min size of hole, smaller holes are compressed as data */
+		static constexpr std::uint64_t MIN_HOLE_SIZE = 65536;
+
+		/* Max number of holes in one map-member, limited by 64 KB extra-field */
+		static constexpr std::size_t MAX_TABLE_HOLES = 2000;
+
+		// -------------------------------------------------------- \\
+
+	private:
+
+		// -------------------------------------------------------- \\
+
+		// ===========================================================
+		// Types
+		// ===========================================================
+
+		/* Data extent of source file */
+		struct Extent final
+		{
+
+			/* File offset */
+			std::uint64_t offset;
+
+			/* Size */
+			std::uint64_t length;
+
+		};
+
+		/* Reads extent of file */
+		class ExtentSource final : public InputSource
+		{
+
+		private:
+
+			/* Input file */
+			std::FILE * mFile;
+
+			/* Bytes left to read */
+			std::uint64_t mLeftCount;
+
+			/* Read-buffer */
+			std::vector<unsigned char> & mBuffer;
+
+		public:
+
+			/*
+			 * ExtentSource constructor, positions file at extent.
+			 *
+			 * @param pFile - file to read.
+			 * @param pExtent - extent.
+			 * @param pBuffer - read-buffer, must outlive this source.
+			 * @throws - can throw exception, if file can't be positioned.
+			*/
+			explicit ExtentSource( std::FILE *const pFile, const Extent & pExtent, std::vector<unsigned char> & pBuffer );
+
+			/*
+			 * Reads next piece of extent.
+			 *
+			 * @param pData - receives pointer to buffer.
+			 * @return - number of bytes, 0 at end of extent.
+			 * @throws - can throw exception.
+			*/
+			std::size_t read( const unsigned char *& pData ) override;
+
+		};
+
+		// ===========================================================
+		// Constants
+		// ===========================================================
+
+		/* Extra-field subfield ID */
+		static constexpr unsigned char SUBFIELD_ID[2] = { 'Z', 'H' };
+
+		/* Footer signature */
+		static constexpr unsigned char FOOTER_MAGIC[4] = { 'Z', 'H', 'M', '1' };
+
+		/* Size of hole entry: outOffset, length, inOffset, inSize */
+		static constexpr std::size_t ENTRY_SIZE = 32;
+
+		/* Size of footer: uncompressed size, first hole, holes count, member size, magic */
+		static constexpr std::size_t FOOTER_SIZE = 24;
+
+		/* Size of gzip-header with extra-field length */
+		static constexpr std::size_t HEADER_SIZE = 12;
+
+		/* Size of subfield-header: ID & length */
+		static constexpr std::size_t SUBFIELD_HEADER_SIZE = 4;
+
+		/* Size of empty deflate-data & gzip-trailer */
+		static constexpr std::size_t TRAILER_SIZE = 10;
+
+		/* Number of zero-member sizes (powers of 2), the largest is 64 MB */
+		static constexpr std::size_t ZERO_SIZES_COUNT = 27;
+
+		/* Size of input & output buffers */
+		static constexpr std::size_t CHUNK_SIZE = 262144;
+
+		// ===========================================================
+		// Methods
+		// ===========================================================
+
+		/*
+		 * Append little-endian value.
+		 *
+		 * @param pBuffer - output.
+		 * @param pValue - value.
+		 * @param bytesCount - number of bytes to write.
+		 * @throws - can throw exception (bad_alloc).
+		*/
+		static void putValue( std::vector<unsigned char> & pBuffer, const std::uint64_t pValue, const std::size_t bytesCount );
+
+		/*
+		 * Returns little-endian value.
+		 *
+		 * @param pData - input.
+		 * @param bytesCount - number of bytes to read.
+		*/
+		static std::uint64_t getValue( const unsigned char *const pData, const std::size_t bytesCount ) noexcept;
+
+		/*
+		 * Enumerate data extents from the current position to the end of file.
+		 * Holes smaller then MIN_HOLE_SIZE are included in data.
+		 * Without SEEK_DATA support the whole file is one extent.
+		 *
+		 * @param srcFile - file to read, must be seekable.
+		 * @param fileSize - size of file.
+		 * @return - data extents, in file order.
+		 * @throws - can throw exception.
+		*/
+		static std::vector<Extent> getDataExtents( std::FILE *const srcFile, const std::uint64_t fileSize );
+
+		/*
+		 * Write gzip-members of zeros.
+		 *
+		 * @param dstFile - output file.
+		 * @param pLength - number of zeros.
+		 * @param zeroMembers - cache of members, by power of 2.
+		 * @throws - can throw exception.
+		*/
+		static void writeZeros( std::FILE *const dstFile, std::uint64_t pLength, std::vector<std::vector<unsigned char>> & zeroMembers );
+
+		/*
+		 * Write hole map as gzip-members.
+		 *
+		 * @param dstFile - output file, position must be after the last member.
+		 * @param pHoles - holes, in file order.
+		 * @param uncompressedSize - size of uncompressed data.
+		 * @throws - can throw exception.
+		*/
+		static void writeTable( std::FILE *const dstFile, const std::vector<Hole> & pHoles, const std::uint64_t uncompressedSize );
+
+		/*
+		 * Read hole map from the end of file.
+		 *
+		 * @param srcFile - sparse gzip file.
+		 * @param pHoles - receives holes, in file order.
+		 * @param uncompressedSize - receives size of uncompressed data.
+		 * @return - offset of the first map-member.
+		 * @throws - can throw exception, if map not found or corrupted.
+		*/
+		static std::uint64_t readTable( std::FILE *const srcFile, std::vector<Hole> & pHoles, std::uint64_t & uncompressedSize );
+
+		/*
+		 * Decompress gzip-members in range of compressed file.
+		 *
+		 * @param srcFile - compressed file.
+		 * @param inBegin - offset of the first member.
+		 * @param inEnd - end of the last member.
+		 * @param zStream - initialized inflate.
+		 * @param pBuffers - input & output buffers.
+		 * @param pOutput - output.
+		 * @return - number of decompressed bytes.
+		 * @throws - can throw exception.
+		*/
+		static std::uint64_t inflateRange( std::FILE *const srcFile, const std::uint64_t inBegin, const std::uint64_t inEnd, z_stream & zStream, std::vector<unsigned char> & pBuffers, OutputSink & pOutput );
+
+		// -------------------------------------------------------- \\
+
+	public:
+
+		// -------------------------------------------------------- \\
+
+		// ===========================================================
+		// Constructor & destructor
+		// ===========================================================
+
+		/* @deleted ZSparse constructor, only static methods */
+		ZSparse( ) = delete;
+
+		// ===========================================================
+		// Methods
+		// ===========================================================
+
+		/*
+		 * Returns true, if file ends with hole map. Position is not changed.
+		 *
+		 * @thread_safety - not thread-safe.
+		 * @param srcFile - file, must be seekable.
+		 * @throws - can throw exception, if file can't be positioned.
+		*/
+		static bool hasTable( std::FILE *const srcFile );
+
+		/*
+		 * Compress sparse file as gzip with hole map.
+		 *
+		 * @thread_safety - thread-safe.
+		 * @param srcFile - file to compress, must be seekable, from the current position.
+		 * @param dstFile - output file.
+		 * @param compressionLevel - Compression-Level to use, must be in range 0-9.
+		 * @return - Z_OK if compression complete, Z_ERRNO otherwise.
+		*/
+		static int deflateFILE( std::FILE *const srcFile, std::FILE *const dstFile, const int compressionLevel );
+
+		/*
+		 * Decompress gzip file, recreating holes. File with hole map is
+		 * inflated without zero-members, other files are inflated whole
+		 * with zero blocks skipped.
+		 *
+		 * @thread_safety - thread-safe.
+		 * @param srcFile - file to decompress, from the beginning.
+		 * @param dstFile - output file, should be regular file.
+		 * @return - Z_OK if sucessfull, Z_ERRNO otherwise.
+		*/
+		static int inflateFILE( std::FILE *const srcFile, std::FILE *const dstFile );
+
+		// -------------------------------------------------------- \\
+
+	};
+
+	// -------------------------------------------------------- \\
+
+}
\ No newline at end of file
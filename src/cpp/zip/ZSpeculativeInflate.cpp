@@ -0,0 +1,611 @@
+/*
+* Copyright  2018 Denis Zyamaev (code4un@yandex.ru) All rights reserved.
+* Authors: Denis Zyamaev (code4un@yandex.ru)
+* All rights reserved.
+* API: C++ 11
+* License: see LICENSE.txt
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+* 1. Redistributions of source code must retain the above copyright notice,
+* this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must display the names 'Denis Zyamaev' and
+* in the credits of the application, if such credits exist.
+* The authors of this work must be notified via email (code4un@yandex.ru) in
+* this case of redistribution.
+* 3. Neither the name of copyright holders nor the names of its contributors
+* may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS
+* IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+* PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// HEADER
+#include "ZSpeculativeInflate.hpp"
+
+// Include ZArena
+#include "ZArena.hpp"
+
+// Include ZPipeline
+#include "ZPipeline.hpp"
+
+// Include ZStream
+#include "ZStream.hpp"
+
+// Include FileUtils
+#include "../io/FileUtils.hpp"
+
+namespace c0de4un
+{
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Methods
+	// ===========================================================
+
+	/*
+	 * Parse zlib or gzip header.
+	 *
+	 * @param pData - file start.
+	 * @param pSize - size of data.
+	 * @param isGzip - receives true, if gzip.
+	 * @return - size of header, 0 if not supported (preset dictionary, reserved flags, too long).
+	*/
+	std::size_t ZSpeculativeInflate::parseHeader( const unsigned char *const pData, const std::size_t pSize, bool & isGzip ) noexcept
+	{
+
+		if ( pSize < 10 )
+			return( 0 );
+
+		// zlib: deflate, window up to 32 KB, check bits, no preset dictionary
+		isGzip = ( pData[0] == 0x1F && pData[1] == 0x8B );
+		if ( !isGzip )
+			return( ( pData[0] & 0x0F ) == Z_DEFLATED && ( pData[0] >> 4 ) <= 7 && ( pData[0] * 256 + pData[1] ) % 31 == 0 && ( pData[1] & 0x20 ) == 0 ? 2 : 0 );
+
+		// gzip: deflate, reserved flags are 0
+		const unsigned char headerFlags( pData[3] );
+		if ( pData[2] != Z_DEFLATED || ( headerFlags & 0xE0 ) != 0 )
+			return( 0 );
+
+		// Fixed part
+		std::size_t headerSize( 10 );
+
+		// FEXTRA
+		if ( ( headerFlags & 0x04 ) != 0 )
+		{
+
+			if ( headerSize + 2 > pSize )
+				return( 0 );
+
+			headerSize += 2 + ( pData[headerSize] | ( pData[headerSize + 1] << 8 ) );
+
+		}
+
+		// FNAME & FCOMMENT, zero-terminated
+		for ( const unsigned char stringFlag : { 0x08, 0x10 } )
+		{
+
+			if ( ( headerFlags & stringFlag ) == 0 )
+				continue;
+
+			while ( headerSize < pSize && pData[headerSize] != 0 )
+				headerSize++;
+
+			headerSize++;
+
+		}
+
+		// FHCRC
+		if ( ( headerFlags & 0x02 ) != 0 )
+			headerSize += 2;
+
+		return( headerSize < pSize ? headerSize : 0 );
+
+	}
+
+	/*
+	 * Decode chunk on worker-thread.
+	 *
+	 * @thread_safety - thread-safe, if chunk not shared.
+	 * @param pChunk - chunk, receives result.
+	 * @throws - can throw exception (bad_alloc).
+	*/
+	void ZSpeculativeInflate::decodeChunk( Chunk & pChunk )
+	{
+
+		// Decoder
+		ZDeflateDecoder zDecoder;
+
+		// Bit offset of chunk end
+		const std::uint64_t chunkEndBit( static_cast<std::uint64_t>( pChunk.chunkSize ) * 8 );
+
+		// The first chunk starts at stream start, others search for block start
+		if ( pChunk.streamStart )
+			pChunk.decoded = ( zDecoder.decode( pChunk.input.data( ), pChunk.input.size( ), 0, chunkEndBit, false, MAX_OUTPUT_SYMBOLS, pChunk.result ) == ZDeflateDecoder::Status::OK );
+		else
+			pChunk.decoded = zDecoder.findAndDecode( pChunk.input.data( ), pChunk.input.size( ), 0, chunkEndBit, chunkEndBit, MAX_OUTPUT_SYMBOLS, pChunk.result );
+
+		// Release result memory, if not used
+		if ( !pChunk.decoded )
+			std::vector<std::uint16_t>( ).swap( pChunk.result.symbols );
+
+	}
+
+	/*
+	 * Write output, update checksum & history.
+	 *
+	 * @thread_safety - not thread-safe.
+	 * @param pState - writer-thread state.
+	 * @param pData - output bytes.
+	 * @param pSize - number of bytes.
+	 * @throws - can throw exception.
+	*/
+	void ZSpeculativeInflate::writeOutput( WriterState & pState, const unsigned char *const pData, const std::size_t pSize )
+	{
+
+		if ( pSize == 0 )
+			return;
+
+		// Write
+		if ( fwrite( pData, sizeof( unsigned char ), pSize, pState.dstFile ) != pSize || ferror( pState.dstFile ) )
+			throw std::runtime_error( "io error, can't write output file !" );
+
+		// Checksum
+		pState.checksum = pState.gzip ? crc32( pState.checksum, pData, static_cast<uInt>( pSize ) ) : adler32( pState.checksum, pData, static_cast<uInt>( pSize ) );
+		pState.outCount += pSize;
+
+		// Keep the last WINDOW_SIZE bytes
+		if ( pSize >= ZDeflateDecoder::WINDOW_SIZE )
+		{
+			pState.history.assign( pData + pSize - ZDeflateDecoder::WINDOW_SIZE, pData + pSize );
+			return;
+		}
+
+		pState.history.insert( pState.history.end( ), pData, pData + pSize );
+		if ( pState.history.size( ) > ZDeflateDecoder::WINDOW_SIZE )
+			pState.history.erase( pState.history.begin( ), pState.history.end( ) - static_cast<std::ptrdiff_t>( ZDeflateDecoder::WINDOW_SIZE ) );
+
+	}
+
+	/*
+	 * Write chunk: decoded result, if starts at the next bit, inflate on writer-thread otherwise.
+	 *
+	 * @thread_safety - not thread-safe.
+	 * @param pState - writer-thread state.
+	 * @param pChunk - chunk.
+	 * @param pNextChunk - the next chunk, nullptr if last.
+	 * @throws - can throw exception.
+	*/
+	void ZSpeculativeInflate::writeChunk( WriterState & pState, const Chunk & pChunk, const Chunk *const pNextChunk )
+	{
+
+		if ( pState.streamEnd )
+			return;
+
+		// Use decoded result, if it starts where output ended
+		const std::uint64_t chunkBit( pChunk.fileOffset * 8 );
+		if ( !pState.streaming && pChunk.decoded && pState.nextBit >= chunkBit + pChunk.result.startBitMin && pState.nextBit <= chunkBit + pChunk.result.startBitMax )
+		{
+
+			const std::vector<std::uint16_t> & symbols( pChunk.result.symbols );
+			const std::size_t bytesCount( symbols.size( ) - ZDeflateDecoder::WINDOW_SIZE );
+
+			// Window bytes known from history
+			const std::size_t historyStart( ZDeflateDecoder::WINDOW_SIZE - pState.history.size( ) );
+
+			// Replace markers with window bytes
+			pState.outBuffer.resize( bytesCount );
+			for ( std::size_t byteIndex = 0; byteIndex < bytesCount; byteIndex++ )
+			{
+
+				const std::uint16_t symbolValue( symbols[ZDeflateDecoder::WINDOW_SIZE + byteIndex] );
+
+				if ( symbolValue < ZDeflateDecoder::MARKER_BASE )
+				{
+					pState.outBuffer[byteIndex] = static_cast<unsigned char>( symbolValue );
+					continue;
+				}
+
+				if ( symbolValue - ZDeflateDecoder::MARKER_BASE < static_cast<int>( historyStart ) )
+					throw std::runtime_error( "decompression (inflate) failed, data corrupted." );
+
+				pState.outBuffer[byteIndex] = pState.history[symbolValue - ZDeflateDecoder::MARKER_BASE - historyStart];
+
+			}
+
+			writeOutput( pState, pState.outBuffer.data( ), bytesCount );
+
+			pState.nextBit = chunkBit + pChunk.result.endBit;
+			pState.streamEnd = pChunk.result.streamEnd;
+
+			return;
+
+		}
+
+		// Inflate on this thread
+		if ( !pState.streaming )
+		{
+			pState.streaming = true;
+			pState.streamActive = false;
+		}
+
+		streamChunk( pState, pChunk, pNextChunk );
+
+	}
+
+	/*
+	 * Inflate chunk on writer-thread, until block boundary at the next chunk start.
+	 *
+	 * @thread_safety - not thread-safe.
+	 * @param pState - writer-thread state.
+	 * @param pChunk - chunk.
+	 * @param pNextChunk - the next chunk, nullptr if last.
+	 * @throws - can throw exception.
+	*/
+	void ZSpeculativeInflate::streamChunk( WriterState & pState, const Chunk & pChunk, const Chunk *const pNextChunk )
+	{
+
+		// Return code
+		int zRet( Z_OK );
+
+		// File offsets of chunk data
+		const std::uint64_t inputEnd( pChunk.fileOffset + pChunk.input.size( ) );
+		const std::uint64_t chunkEndBit( ( pChunk.fileOffset + pChunk.chunkSize ) * 8 );
+
+		// Start inflate at the next bit, with history as window
+		if ( !pState.streamActive )
+		{
+
+			const std::uint64_t startOffset( pState.nextBit / 8 );
+			const int startBits( static_cast<int>( pState.nextBit % 8 ) );
+
+			// Starts in later chunk
+			if ( startOffset >= inputEnd )
+				return;
+
+			if ( startOffset < pChunk.fileOffset )
+				throw std::runtime_error( "decompression (inflate) failed, stream offset out of chunk." );
+
+			if ( !pState.initialized )
+			{
+
+				// Allocate z_stream state from the thread's arena
+				ZArena::getThreadArena( ).attach( pState.zStream );
+				pState.zStream.avail_in = 0;
+				pState.zStream.next_in = Z_NULL;
+
+				if ( inflateInit2( &pState.zStream, -MAX_WBITS ) != Z_OK )
+					throw std::runtime_error( "failed to initialize decompression stream." );
+
+				pState.initialized = true;
+
+			}
+			else if ( inflateReset( &pState.zStream ) != Z_OK )
+				throw std::runtime_error( "failed to reset inflate." );
+
+			if ( !pState.history.empty( ) && inflateSetDictionary( &pState.zStream, pState.history.data( ), static_cast<uInt>( pState.history.size( ) ) ) != Z_OK )
+				throw std::runtime_error( "failed to set inflate window." );
+
+			// Bits of the first byte after the next bit
+			if ( startBits != 0 && inflatePrime( &pState.zStream, 8 - startBits, pChunk.input[static_cast<std::size_t>( startOffset - pChunk.fileOffset )] >> startBits ) != Z_OK )
+				throw std::runtime_error( "failed to set inflate bit offset." );
+
+			pState.streamInOffset = startOffset + ( startBits != 0 ? 1 : 0 );
+			pState.streamActive = true;
+
+		}
+
+		// Input consumed in previous chunks
+		if ( pState.streamInOffset >= inputEnd )
+			return;
+
+		// Set input
+		pState.zStream.next_in = const_cast<Bytef*>( pChunk.input.data( ) + ( pState.streamInOffset - pChunk.fileOffset ) );
+		pState.zStream.avail_in = static_cast<uInt>( inputEnd - pState.streamInOffset );
+
+		pState.outBuffer.resize( CHUNK_SIZE );
+
+		// Inflate, until block boundary after chunk end
+		while ( true )
+		{
+
+			// Set output
+			pState.zStream.next_out = pState.outBuffer.data( );
+			pState.zStream.avail_out = static_cast<uInt>( pState.outBuffer.size( ) );
+
+			// Decompress, stop at block boundary
+			zRet = inflate( &pState.zStream, Z_BLOCK );
+
+			// Check inflate-status, Z_BUF_ERROR means more input required
+			switch ( zRet )
+			{
+
+			case Z_DATA_ERROR:
+				throw std::runtime_error( "decompression (inflate) failed, data corrupted." );
+
+			case Z_MEM_ERROR:
+				throw std::runtime_error( "decompression (inflate) failed, insufficent memory" );
+
+			case Z_NEED_DICT:
+				throw std::runtime_error( "decompression (inflate) failed, dictionary required." );
+
+			case Z_STREAM_ERROR:
+				throw std::runtime_error( "decompression (inflate) failed, stream structure inconsistent." );
+
+			}
+
+			// Write output
+			writeOutput( pState, pState.outBuffer.data( ), pState.outBuffer.size( ) - pState.zStream.avail_out );
+
+			// Consumed
+			pState.streamInOffset = inputEnd - pState.zStream.avail_in;
+
+			// Bit offset after consumed data, unused bits of the last byte are not consumed
+			const std::uint64_t streamBit( pState.streamInOffset * 8 - static_cast<std::uint64_t>( pState.zStream.data_type & 7 ) );
+
+			// Stream end
+			if ( zRet == Z_STREAM_END )
+			{
+				pState.nextBit = streamBit;
+				pState.streamEnd = true;
+				pState.streaming = false;
+				return;
+			}
+
+			// Block boundary in the next chunk: switch to decoded result, if it starts here
+			if ( ( pState.zStream.data_type & 128 ) != 0 && streamBit >= chunkEndBit )
+			{
+
+				const std::uint64_t nextChunkBit( pChunk.fileOffset * 8 + pChunk.chunkSize * 8 );
+				if ( pNextChunk != nullptr && pNextChunk->decoded && streamBit >= nextChunkBit + pNextChunk->result.startBitMin && streamBit <= nextChunkBit + pNextChunk->result.startBitMax )
+				{
+					pState.nextBit = streamBit;
+					pState.streaming = false;
+				}
+
+				return;
+
+			}
+
+			// Input consumed
+			if ( pState.zStream.avail_in == 0 && pState.zStream.avail_out != 0 )
+				return;
+
+		}
+
+	}
+
+	/*
+	 * Read & verify trailer of stream.
+	 *
+	 * @thread_safety - not thread-safe.
+	 * @param pState - writer-thread state.
+	 * @param srcFile - compressed file.
+	 * @throws - can throw exception.
+	*/
+	void ZSpeculativeInflate::checkTrailer( const WriterState & pState, std::FILE *const srcFile )
+	{
+
+		// Trailer starts at byte boundary after stream
+		FileUtils::seek( srcFile, ( pState.nextBit + 7 ) / 8 );
+
+		unsigned char trailerBytes[8];
+		const std::size_t trailerSize( pState.gzip ? 8 : 4 );
+
+		if ( fread( trailerBytes, sizeof( unsigned char ), trailerSize, srcFile ) != trailerSize )
+			throw std::runtime_error( "decompression (inflate) failed, unexpected end of file." );
+
+		// gzip: CRC-32 & size modulo 2^32, little-endian
+		if ( pState.gzip )
+		{
+
+			const uLong storedCRC( static_cast<uLong>( trailerBytes[0] ) | ( static_cast<uLong>( trailerBytes[1] ) << 8 ) | ( static_cast<uLong>( trailerBytes[2] ) << 16 ) | ( static_cast<uLong>( trailerBytes[3] ) << 24 ) );
+			const std::uint32_t storedSize( static_cast<std::uint32_t>( trailerBytes[4] ) | ( static_cast<std::uint32_t>( trailerBytes[5] ) << 8 ) | ( static_cast<std::uint32_t>( trailerBytes[6] ) << 16 ) | ( static_cast<std::uint32_t>( trailerBytes[7] ) << 24 ) );
+
+			if ( storedCRC != pState.checksum || storedSize != static_cast<std::uint32_t>( pState.outCount ) )
+				throw std::runtime_error( "decompression (inflate) failed, incorrect data check." );
+
+			return;
+
+		}
+
+		// zlib: Adler-32, big-endian
+		const uLong storedAdler( ( static_cast<uLong>( trailerBytes[0] ) << 24 ) | ( static_cast<uLong>( trailerBytes[1] ) << 16 ) | ( static_cast<uLong>( trailerBytes[2] ) << 8 ) | static_cast<uLong>( trailerBytes[3] ) );
+
+		if ( storedAdler != pState.checksum )
+			throw std::runtime_error( "decompression (inflate) failed, incorrect data check." );
+
+	}
+
+	/*
+	 * Decompress the given zlib or gzip file on multiple threads.
+	 * With one worker-thread ZStream is used.
+	 *
+	 * @thread_safety - not thread-safe.
+	 * @param srcFile - file to decompress, position must be at the beginning.
+	 * @param dstFile - output file, must be other then source.
+	 * @param threadsCount - number of worker-threads, 0 to use all hardware-threads.
+	 * @return - Z_OK if sucessfull, Z_ERRNO otherwise.
+	*/
+	int ZSpeculativeInflate::inflateFILE( std::FILE *const srcFile, std::FILE *const dstFile, const std::uint32_t threadsCount )
+	{
+
+		// Writer-thread state
+		WriterState writerState;
+		writerState.dstFile = dstFile;
+		writerState.gzip = false;
+		writerState.nextBit = 0;
+		writerState.streamEnd = false;
+		writerState.outCount = 0;
+		writerState.initialized = false;
+		writerState.streaming = false;
+		writerState.streamActive = false;
+		writerState.streamInOffset = 0;
+
+		// Guarded-Block
+		try
+		{
+
+			// One worker can't decode ahead, plain zlib loop is faster
+			if ( ( threadsCount > 0 ? threadsCount : ThreadPool::getHardwareThreadsCount( ) ) < 2 )
+			{
+				FileUtils::seek( srcFile, 0 );
+				return( ZStream::inflateFILE( srcFile, dstFile, STREAM_BUFFER_SIZE ) == Z_OK ? Z_OK : Z_ERRNO );
+			}
+
+			// Size of file
+			const std::uint64_t fileSize( FileUtils::getSize( srcFile ) );
+
+			// Parse header
+			std::vector<unsigned char> chunkData( static_cast<std::size_t>( std::min<std::uint64_t>( fileSize, CHUNK_SIZE ) ) );
+			FileUtils::seek( srcFile, 0 );
+			chunkData.resize( fread( chunkData.data( ), sizeof( unsigned char ), chunkData.size( ), srcFile ) );
+
+			const std::size_t headerSize( parseHeader( chunkData.data( ), chunkData.size( ), writerState.gzip ) );
+
+			// Small file or not supported header
+			if ( fileSize < MIN_FILE_SIZE || headerSize == 0 )
+			{
+				FileUtils::seek( srcFile, 0 );
+				return( ZPipeline::inflateFILE( srcFile, dstFile ) );
+			}
+
+			writerState.checksum = writerState.gzip ? crc32( 0, Z_NULL, 0 ) : adler32( 0, Z_NULL, 0 );
+			writerState.nextBit = static_cast<std::uint64_t>( headerSize ) * 8;
+
+			// Worker-threads
+			ThreadPool threadPool( threadsCount );
+
+			// Max number of chunks read & not written yet, limits memory usage
+			const std::size_t maxChunksInFlight( threadPool.getThreadsCount( ) * 2 + 1 );
+
+			// Chunks in output order
+			std::deque<std::pair<std::shared_ptr<Chunk>, std::future<void>>> chunksInFlight;
+
+			// Read chunk of compressed stream
+			std::uint64_t fileOffset( headerSize );
+
+			auto readChunk = [&]( )
+			{
+
+				std::vector<unsigned char> readData( CHUNK_SIZE );
+				readData.resize( fread( readData.data( ), sizeof( unsigned char ), CHUNK_SIZE, srcFile ) );
+
+				// Check io errors
+				if ( ferror( srcFile ) )
+					throw std::runtime_error( "io error, can't read input file !" );
+
+				return( readData );
+
+			};
+
+			// Write the oldest chunk, the next chunk must be decoded to switch to it
+			auto writeFront = [&]( )
+			{
+
+				// Wait, rethrows worker exception
+				for ( std::size_t chunkIndex = 0; chunkIndex < 2 && chunkIndex < chunksInFlight.size( ); chunkIndex++ )
+					if ( chunksInFlight[chunkIndex].second.valid( ) )
+						chunksInFlight[chunkIndex].second.get( );
+
+				writeChunk( writerState, *chunksInFlight.front( ).first, chunksInFlight.size( ) > 1 ? chunksInFlight[1].first.get( ) : nullptr );
+
+				// Release
+				chunksInFlight.pop_front( );
+
+			};
+
+			// Chunk 0 starts after header
+			FileUtils::seek( srcFile, headerSize );
+			chunkData = readChunk( );
+
+			// Read chunks & decode
+			while ( !chunkData.empty( ) && !writerState.streamEnd )
+			{
+
+				std::vector<unsigned char> nextData( readChunk( ) );
+
+				// Chunk with the next one, for blocks after chunk end
+				std::shared_ptr<Chunk> chunk( std::make_shared<Chunk>( ) );
+				chunk->chunkSize = chunkData.size( );
+				chunk->input.reserve( chunkData.size( ) + nextData.size( ) );
+				chunk->input.insert( chunk->input.end( ), chunkData.begin( ), chunkData.end( ) );
+				chunk->input.insert( chunk->input.end( ), nextData.begin( ), nextData.end( ) );
+				chunk->fileOffset = fileOffset;
+				chunk->streamStart = ( fileOffset == headerSize );
+				chunk->decoded = false;
+
+				chunksInFlight.emplace_back( chunk, threadPool.submit( [chunk]( ) { decodeChunk( *chunk ); } ) );
+
+				fileOffset += chunkData.size( );
+				chunkData = std::move( nextData );
+
+				// Write chunks in order
+				while ( chunksInFlight.size( ) > maxChunksInFlight && !writerState.streamEnd )
+					writeFront( );
+
+			}
+
+			// Write remaining chunks
+			while ( !chunksInFlight.empty( ) && !writerState.streamEnd )
+				writeFront( );
+
+			// Wait chunks after stream end, results not used
+			for ( std::pair<std::shared_ptr<Chunk>, std::future<void>> & chunkInFlight : chunksInFlight )
+				if ( chunkInFlight.second.valid( ) )
+					chunkInFlight.second.wait( );
+
+			// Check stream end
+			if ( !writerState.streamEnd )
+				throw std::runtime_error( "decompression (inflate) failed, unexpected end of file." );
+
+			// Verify trailer
+			checkTrailer( writerState, srcFile );
+
+			// Release z_stream resources
+			if ( writerState.initialized )
+			{
+				inflateEnd( &writerState.zStream );
+				writerState.initialized = false;
+			}
+
+			// gzip members after the first
+			if ( writerState.gzip && FileUtils::tell( srcFile ) < fileSize && ZStream::inflateFILE( srcFile, dstFile, STREAM_BUFFER_SIZE ) != Z_OK )
+				return( Z_ERRNO );
+
+		}
+		catch ( const std::exception & pException )
+		{
+
+			// Print ERROR-message
+			std::cout << "ZSpeculativeInflate::inflateFILE - error: " << pException.what( ) << std::endl;
+
+			// Release z_stream resources
+			if ( writerState.initialized )
+				inflateEnd( &writerState.zStream );
+
+			// Return ERROR
+			return( Z_ERRNO );
+
+		}
+
+		// Return OK
+		return( Z_OK );
+
+	}
+
+	// -------------------------------------------------------- \\
+
+}
\ No newline at end of file
@@ -0,0 +1,274 @@
+/*
+* Copyright  2018 Denis Zyamaev (code4un@yandex.ru) All rights reserved.
+* Authors: Denis Zyamaev (code4un@yandex.ru)
+* All rights reserved.
+* API: C++ 11
+* License: see LICENSE.txt
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+* 1. Redistributions of source code must retain the above copyright notice,
+* this list of conditions and the following disclaimer.
+* 2. Redistributions in binary form must display the names 'Denis Zyamaev' and
+* in the credits of the application, if such credits exist.
+* The authors of this work must be notified via email (code4un@yandex.ru) in
+* this case of redistribution.
+* 3. Neither the name of copyright holders nor the names of its contributors
+* may be used to endorse or promote products derived from this software
+* without specific prior written permission.
+*
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS
+* IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+* THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+* PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL COPYRIGHT HOLDERS OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+// Include 'pch_cxx'
+#include "../pch_cxx.hpp"
+
+// Include ThreadPool
+#include "../core/ThreadPool.hpp"
+
+// Include ZDeflateDecoder
+#include "ZDeflateDecoder.hpp"
+
+namespace c0de4un
+{
+
+	// -------------------------------------------------------- \\
+
+	// ===========================================================
+	// Types
+	// ===========================================================
+
+	/*
+	  * ZSpeculativeInflate - parallel decompression of single deflate stream
+	  * (zlib, or the first gzip member).
+	  *
+	  * Compressed stream is cut into chunks of fixed size. Worker-thread
+	  * finds the first block start in its chunk (see ZDeflateDecoder) &
+	  * decodes until the first block boundary after chunk end, with
+	  * markers in place of the unknown window.
+	  *
+	  * Writer-thread uses chunk result only, if it starts exactly where
+	  * previous chunk ended, replaces markers with the last 32 KB of output
+	  * & writes it. Otherwise (false block start, fixed-code block, output
+	  * limit) writer inflates from the known offset with zlib, until block
+	  * boundary matches start of a later chunk. So output & checksum
+	  * verification are always the same as for sequential inflate.
+	  *
+	  * Members after the first are decompressed sequentially.
+	  *
+	  * @language C++ 17
+	  *
+	  * @authors Z. Denis (c0de4un@yandex.ru)
+	  * @version 1.0
+	 */
+	class ZSpeculativeInflate final
+	{
+
+	private:
+
+		// -------------------------------------------------------- \\
+
+		// ===========================================================
+		// Types
+		// ===========================================================
+
+		/* Chunk of compressed stream, decoded on worker-thread */
+		struct Chunk final
+		{
+
+			/* Compressed data: this chunk & the next one, for blocks after chunk end */
+			std::vector<unsigned char> input;
+
+			/* File offset of chunk */
+			std::uint64_t fileOffset;
+
+			/* Size of this chunk in input */
+			std::size_t chunkSize;
+
+			/* true, if chunk starts with the first block of stream */
+			bool streamStart;
+
+			/* true, if result decoded */
+			bool decoded;
+
+			/* Decoded data */
+			ZDeflateDecoder::Result result;
+
+		};
+
+		/* Writer-thread state */
+		struct WriterState final
+		{
+
+			/* Output file */
+			std::FILE * dstFile;
+
+			/* true, if gzip, zlib otherwise */
+			bool gzip;
+
+			/* Bit offset in file, where the next not written block starts */
+			std::uint64_t nextBit;
+
+			/* true, if stream end reached */
+			bool streamEnd;
+
+			/* CRC-32 (gzip) or Adler-32 (zlib) of output */
+			uLong checksum;
+
+			/* Number of output bytes */
+			std::uint64_t outCount;
+
+			/* The last WINDOW_SIZE output bytes, or less at stream start */
+			std::vector<unsigned char> history;
+
+			/* Output bytes of chunk */
+			std::vector<unsigned char> outBuffer;
+
+			/* z_stream, when inflated on writer-thread */
+			z_stream zStream;
+
+			/* true, if inflate initialized */
+			bool initialized;
+
+			/* true, if stream is inflated on writer-thread */
+			bool streaming;
+
+			/* true, if inflate is started at the next bit */
+			bool streamActive;
+
+			/* File offset of the next byte to feed to inflate */
+			std::uint64_t streamInOffset;
+
+		};
+
+		// ===========================================================
+		// Constants
+		// ===========================================================
+
+		/* Size of compressed chunk */
+		static constexpr std::size_t CHUNK_SIZE = 1048576;
+
+		/* Max number of symbols, decoded by worker from one chunk */
+		static constexpr std::size_t MAX_OUTPUT_SYMBOLS = 16777216;
+
+		/* Min size of file, smaller files are decompressed with ZPipeline */
+		static constexpr std::uint64_t MIN_FILE_SIZE = CHUNK_SIZE * 2;
+
+		/* Size of buffer for members after the first */
+		static constexpr std::uint32_t STREAM_BUFFER_SIZE = 262144;
+
+		// ===========================================================
+		// Methods
+		// ===========================================================
+
+		/*
+		 * Parse zlib or gzip header.
+		 *
+		 * @param pData - file start.
+		 * @param pSize - size of data.
+		 * @param isGzip - receives true, if gzip.
+		 * @return - size of header, 0 if not supported (preset dictionary, reserved flags, too long).
+		*/
+		static std::size_t parseHeader( const unsigned char *const pData, const std::size_t pSize, bool & isGzip ) noexcept;
+
+		/*
+		 * Decode chunk on worker-thread.
+		 *
+		 * @thread_safety - thread-safe, if chunk not shared.
+		 * @param pChunk - chunk, receives result.
+		 * @throws - can throw exception (bad_alloc).
+		*/
+		static void decodeChunk( Chunk & pChunk );
+
+		/*
+		 * Write output, update checksum & history.
+		 *
+		 * @thread_safety - not thread-safe.
+		 * @param pState - writer-thread state.
+		 * @param pData - output bytes.
+		 * @param pSize - number of bytes.
+		 * @throws - can throw exception.
+		*/
+		static void writeOutput( WriterState & pState, const unsigned char *const pData, const std::size_t pSize );
+
+		/*
+		 * Write chunk: decoded result, if starts at the next bit, inflate on writer-thread otherwise.
+		 *
+		 * @thread_safety - not thread-safe.
+		 * @param pState - writer-thread state.
+		 * @param pChunk - chunk.
+		 * @param pNextChunk - the next chunk, nullptr if last.
+		 * @throws - can throw exception.
+		*/
+		static void writeChunk( WriterState & pState, const Chunk & pChunk, const Chunk *const pNextChunk );
+
+		/*
+		 * Inflate chunk on writer-thread, until block boundary at the next chunk start.
+		 *
+		 * @thread_safety - not thread-safe.
+		 * @param pState - writer-thread state.
+		 * @param pChunk - chunk.
+		 * @param pNextChunk - the next chunk, nullptr if last.
+		 * @throws - can throw exception.
+		*/
+		static void streamChunk( WriterState & pState, const Chunk & pChunk, const Chunk *const pNextChunk );
+
+		/*
+		 * Read & verify trailer of stream.
+		 *
+		 * @thread_safety - not thread-safe.
+		 * @param pState - writer-thread state.
+		 * @param srcFile - compressed file.
+		 * @throws - can throw exception.
+		*/
+		static void checkTrailer( const WriterState & pState, std::FILE *const srcFile );
+
+		// -------------------------------------------------------- \\
+
+	public:
+
+		// -------------------------------------------------------- \\
+
+		// ===========================================================
+		// Constructor & destructor
+		// ===========================================================
+
+		/* @deleted ZSpeculativeInflate constructor, only static methods */
+		ZSpeculativeInflate( ) = delete;
+
+		// ===========================================================
+		// Methods
+		// ===========================================================
+
+		/*
+		 * Decompress the given zlib or gzip file on multiple threads.
+		 * With one worker-thread ZStream is used.
+		 *
+		 * @thread_safety - not thread-safe.
+		 * @param srcFile - file to decompress, position must be at the beginning.
+		 * @param dstFile - output file, must be other then source.
+		 * @param threadsCount - number of worker-threads, 0 to use all hardware-threads.
+		 * @return - Z_OK if sucessfull, Z_ERRNO otherwise.
+		*/
+		static int inflateFILE( std::FILE *const srcFile, std::FILE *const dstFile, const std::uint32_t threadsCount = 0 );
+
+		// -------------------------------------------------------- \\
+
+	};
+
+	// -------------------------------------------------------- \\
+
+}
\ No newline at end of file
@@ -34,6 +34,21 @@
 // HEADER
 #include "ZStream.hpp"
 
+// Include IOFactory
+#include "../io/IOFactory.hpp"
+
+// Include FileInputSource
+#include "../io/FileInputSource.hpp"
+
+// Include FileUtils
+#include "../io/FileUtils.hpp"
+
+// Include ZSeekable
+#include "ZSeekable.hpp"
+
+// Include ZBgzf
+#include "ZBgzf.hpp"
+
 namespace c0de4un
 {
 
@@ -46,119 +61,498 @@ namespace c0de4un
 	/*
 	 * ZStream constructor.
 	 *
-	 * @param bufferSize - initial buffer size. Increased, if required,
-	 * by +50% each time.
+	 * @param bufferSize - initial size of input & output buffers.
+	 * @param pArena - allocator for z_stream state, must outlive this instance.
+	 * If null, zlib default allocator (malloc) is used.
+	 * @param maxBufferSize - max size of input & output buffers, so both
+	 * use up to 2 * maxBufferSize. Buffers don't grow, if not greater then bufferSize.
 	 * @throws - can throw exception (bad_alloc).
 	*/
-	ZStream::ZStream( const std::uint32_t bufferSize )
+	ZStream::ZStream( const std::uint32_t bufferSize, ZArena *const pArena, const std::uint32_t maxBufferSize )
+		: mBufferSize( std::max<std::uint32_t>( bufferSize, 1 ) ),
+		mMaxBufferSize( std::max<std::uint32_t>( maxBufferSize, mBufferSize ) ),
+		mGrowCount( 0 ),
+		mReadCount( 0 ),
+		mInBuffer( mBufferSize ),
+		mOutBuffer( mBufferSize ),
+		mDeflateStream( ),
+		mDeflateInitialized( false ),
+		mDeflateLevel( 0 ),
+		mDeflateFormat( ZFormat::ZLIB ),
+		mWindowBits( MAX_WBITS ),
+		mMemLevel( 8 ),
+		mGzipFields( ),
+		mDeflateHeader( ),
+		mInflateStream( ),
+		mInflateInitialized( false ),
+		mInflateHeader( ),
+		mDictionary( ),
+		mDictionaries( nullptr )
 	{
+
+		// Set z_stream's allocators
+		mDeflateStream.zalloc = Z_NULL;
+		mDeflateStream.zfree = Z_NULL;
+		mDeflateStream.opaque = Z_NULL;
+		mInflateStream.zalloc = Z_NULL;
+		mInflateStream.zfree = Z_NULL;
+		mInflateStream.opaque = Z_NULL;
+
+		// Set arena allocator
+		if ( pArena != nullptr )
+		{
+			pArena->attach( mDeflateStream );
+			pArena->attach( mInflateStream );
+		}
+
 	}
 
 	/* ZStream destructor */
 	ZStream::~ZStream( )
 	{
+
+		// Release deflate resources
+		if ( mDeflateInitialized )
+			deflateEnd( &mDeflateStream );
+
+		// Release inflate resources
+		if ( mInflateInitialized )
+			inflateEnd( &mInflateStream );
+
 	}
 
 	// ===========================================================
-	// Methods
+	// Getters
+	// ===========================================================
+
+	/* Returns current size of input & output buffers */
+	std::uint32_t ZStream::getBufferSize( ) const noexcept
+	{ return( mBufferSize ); }
+
+	/* Returns buffer statistics, since construction */
+	ZStream::Stats ZStream::getStats( ) const noexcept
+	{ return( Stats{ mBufferSize, mGrowCount, mReadCount } ); }
+
+	// ===========================================================
+	// Setters
 	// ===========================================================
 
 	/*
-	 * Compress file.
+	 * Set gzip header fields for the next compressions.
 	 *
 	 * @thread_safety - not thread-safe.
-	 * @param srcFile - file to compress.
-	 * @param dstFile - output file.
-	 * @param bufferSize - initial buffer size. Increased, if required,
-	 * by +50% each time.
+	 * @param pHeader - gzip header fields.
+	 * @throws - can throw exception (bad_alloc).
+	*/
+	void ZStream::setGzipHeader( const ZGzipHeader & pHeader )
+	{ mGzipFields = pHeader; }
+
+	/*
+	 * Set deflate memory for the next compressions (see MemoryBudget::plan).
+	 * Deflate uses (4 << windowBits) + (1 << (memLevel + 9)) bytes.
+	 *
+	 * @thread_safety - not thread-safe.
+	 * @param windowBits - window-bits, in range 9-15.
+	 * @param memLevel - mem-level, in range 1-9.
+	*/
+	void ZStream::setDeflateMemory( const int windowBits, const int memLevel ) noexcept
+	{
+
+		// Deflate is re-initialized by the next compression
+		if ( mDeflateInitialized && ( windowBits != mWindowBits || memLevel != mMemLevel ) )
+		{
+			deflateEnd( &mDeflateStream );
+			mDeflateInitialized = false;
+		}
+
+		mWindowBits = std::min( std::max( windowBits, 9 ), MAX_WBITS );
+		mMemLevel = std::min( std::max( memLevel, 1 ), MAX_MEM_LEVEL );
+
+	}
+
+	/*
+	 * Set preset dictionary for the next compressions, zlib format only.
+	 *
+	 * @thread_safety - not thread-safe.
+	 * @param pDictionary - dictionary, empty to compress without it.
+	 * @throws - can throw exception (bad_alloc).
+	*/
+	void ZStream::setDictionary( const std::vector<unsigned char> & pDictionary )
+	{ mDictionary = pDictionary; }
+
+	/*
+	 * Set dictionaries for the next decompressions, stream requiring
+	 * dictionary gets it by id.
+	 *
+	 * @thread_safety - not thread-safe.
+	 * @param pDictionaries - registry, must outlive decompressions. Null to not use.
+	*/
+	void ZStream::setDictionaries( const ZDictionary *const pDictionaries ) noexcept
+	{ mDictionaries = pDictionaries; }
+
+	// ===========================================================
+	// Methods
+	// ===========================================================
+
+	/*
+	 * Grow input & output buffers by +50%, up to the max buffer size.
+	 * Must be called when output-buffer & source data are not in use.
+	 *
+	 * @param pSource - current source, receives the new read size.
+	 * @throws - can throw exception (bad_alloc).
+	*/
+	void ZStream::growBuffers( InputSource & pSource )
+	{
+
+		// Max size reached
+		if ( mBufferSize >= mMaxBufferSize )
+			return;
+
+		// +50%
+		mBufferSize = static_cast<std::uint32_t>( std::min<std::uint64_t>( mBufferSize + mBufferSize / 2 + 1, mMaxBufferSize ) );
+		mOutBuffer.resize( mBufferSize );
+
+		// Stdio-source resizes input-buffer
+		pSource.setReadSize( mBufferSize );
+
+		mGrowCount++;
+
+	}
+
+	/*
+	 * Initialize deflate on first use, reset it otherwise.
+	 * Deflate is re-initialized only if Compression-Level or format changed.
+	 *
 	 * @param compressionLevel - Compression-Level to use, must be in range 0-9.
-	 * @return - Z_OK if compression complete.
+	 * @param format - stream format.
 	 * @throws - can throw exception.
 	*/
-	const int & ZStream::deflateFILE( std::FILE *const srcFile, std::FILE *const dstFile, const std::uint32_t & bufferSize, const int & compressionLevel )
+	void ZStream::prepareDeflate( const int compressionLevel, const ZFormat format )
 	{
 
-		// Set in & out binary mode on MSVC to prevent 'end-of-line' char adding
-		SET_BINARY_MODE( stdin );
-		SET_BINARY_MODE( stdout );
+		// Reset, if initialized with the same level & format
+		if ( mDeflateInitialized && mDeflateLevel == compressionLevel && mDeflateFormat == format )
+		{
 
-		// Return cde
-		int zRet( 0 );
+			// Reset
+			if ( deflateReset( &mDeflateStream ) != Z_OK )
+				throw std::runtime_error( "ZStream::prepareDeflate - failed to reset deflate." );
 
-		// Flush code
-		int zFlush( 0 );
+		}
+		else
+		{
 
-		// Elements count to write
-		std::uint32_t zOutCount( 0 );
+			// Release previous state
+			if ( mDeflateInitialized )
+			{
+				deflateEnd( &mDeflateStream );
+				mDeflateInitialized = false;
+			}
+
+			// Initialze deflate
+			initDeflate( compressionLevel, format );
 
-		// Input-buffer for z_stream
-		unsigned char * inBuffer;
+		}
+
+		// Set gzip header, after each init or reset
+		if ( format == ZFormat::GZIP )
+		{
 
-		// Output-buffer for z_stream
-		unsigned char * outBuffer;
+			// Fields
+			mDeflateHeader = gz_header( );
+			mDeflateHeader.time = static_cast<uLong>( mGzipFields.mtime );
+			mDeflateHeader.os = mGzipFields.os;
+			mDeflateHeader.name = mGzipFields.name.empty( ) ? Z_NULL : reinterpret_cast<Bytef*>( &mGzipFields.name[0] );
 
-		// z_stream
-		z_stream zStream;
+			// Set
+			if ( deflateSetHeader( &mDeflateStream, &mDeflateHeader ) != Z_OK )
+				throw std::runtime_error( "ZStream::prepareDeflate - failed to set gzip header." );
+
+		}
+
+		// Set preset dictionary, after each init or reset. gzip has no dictionary id.
+		if ( !mDictionary.empty( ) )
+		{
+
+			if ( format != ZFormat::ZLIB )
+				throw std::runtime_error( "ZStream::prepareDeflate - preset dictionary requires zlib format." );
+
+			if ( deflateSetDictionary( &mDeflateStream, mDictionary.data( ), static_cast<uInt>( mDictionary.size( ) ) ) != Z_OK )
+				throw std::runtime_error( "ZStream::prepareDeflate - failed to set dictionary." );
+
+		}
+
+	}
+
+	/*
+	 * Initialize deflate.
+	 *
+	 * @param compressionLevel - Compression-Level to use, must be in range 0-9.
+	 * @param format - stream format.
+	 * @throws - can throw exception.
+	*/
+	void ZStream::initDeflate( const int compressionLevel, const ZFormat format )
+	{
+
+		// Initialze deflate, gzip-wrapper is selected by window-bits
+		const int zRet( deflateInit2( &mDeflateStream, compressionLevel, Z_DEFLATED, format == ZFormat::GZIP ? mWindowBits + 16 : mWindowBits, mMemLevel, Z_DEFAULT_STRATEGY ) );
+
+		// Check z_stream
+		if ( zRet != Z_OK )
+		{
+
+			switch ( zRet )
+			{
+				case Z_VERSION_ERROR:
+					throw std::runtime_error( "ZStream::initDeflate - failed to initialize deflate, zlib verion conflict." );
+					break;
+				case Z_STREAM_ERROR:
+					throw std::runtime_error( "ZStream::initDeflate - failed to initialize deflate, wrong compression level" );
+					break;
+				case Z_MEM_ERROR:
+					throw std::runtime_error( "ZStream::initDeflate - failed to initialize deflate, don't have enough memory." );
+					break;
+				default:
+					throw std::runtime_error( "ZStream::initDeflate - failed to initialize deflate, unknown reason." );
+			}
+
+		}
 
-		// Set z_stream & deflate state
-		zStream.zalloc = Z_NULL;
-		zStream.zfree = Z_NULL;
-		zStream.opaque = Z_NULL;
+		// Deflate initialized
+		mDeflateInitialized = true;
+		mDeflateLevel = compressionLevel;
+		mDeflateFormat = format;
+
+	}
+
+	/*
+	 * Initialize inflate on first use, reset it otherwise.
+	 * Input-data of z_stream is not changed.
+	 *
+	 * @throws - can throw exception.
+	*/
+	void ZStream::prepareInflate( )
+	{
+
+		// Reset, if initialized
+		if ( mInflateInitialized )
+		{
+
+			// Reset
+			if ( inflateReset( &mInflateStream ) != Z_OK )
+				throw std::runtime_error( "ZStream::prepareInflate - failed to reset inflate." );
+
+		}
+		else
+			initInflate( );
+
+		// Request gzip-header, reset clears it. Done-flag tells, if stream is gzip.
+		mInflateHeader = gz_header( );
+		if ( inflateGetHeader( &mInflateStream, &mInflateHeader ) != Z_OK )
+			throw std::runtime_error( "ZStream::prepareInflate - failed to request gzip header." );
+
+	}
+
+	/*
+	 * Initialize inflate.
+	 *
+	 * @throws - can throw exception.
+	*/
+	void ZStream::initInflate( )
+	{
+
+		// Set z_stream input
+		mInflateStream.avail_in = 0;
+		mInflateStream.next_in = Z_NULL;
+
+		// Initialize inflate, detecting zlib or gzip wrapper
+		const int zRet( inflateInit2( &mInflateStream, AUTO_WINDOW_BITS ) );
+
+		// Check initialization state
+		if ( zRet != Z_OK )
+		{
+
+			// Handle code
+			switch ( zRet )
+			{
+
+			case Z_MEM_ERROR:
+				throw std::runtime_error( "ZStream::initInflate - failed to initialize decompression stream, not enough memory." );
+				break;
+
+			case Z_VERSION_ERROR:
+				throw std::runtime_error( "ZStream::initInflate - failed to initialize decompression stream, zlib version conflict." );
+				break;
+
+			case Z_STREAM_ERROR:
+				throw std::runtime_error( "ZStream::initInflate - failed to initialize decompression stream, arguments are invalid." );
+				break;
+
+			default:
+				throw std::runtime_error( "ZStream::initInflate - failed to initialize decompression stream, unknown reason." );
+
+			}
+
+		}
+
+		// Inflate initialized
+		mInflateInitialized = true;
+
+	}
+
+	/*
+	 * Open file-source. Stdio-source uses own input-buffer.
+	 *
+	 * @param srcFile - file to read.
+	 * @param ioBackend - file io backend, stdio is used if backend can't be used for the file.
+	 * @throws - can throw exception (bad_alloc).
+	*/
+	std::unique_ptr<InputSource> ZStream::openSource( std::FILE *const srcFile, const IOBackend ioBackend )
+	{
+
+		// Stdio, read into own buffer
+		if ( ioBackend == IOBackend::STDIO )
+		{
+			mInBuffer.resize( mBufferSize );
+			return( std::make_unique<FileInputSource>( srcFile, mInBuffer ) );
+		}
+
+		// Other backends use own buffers
+		return( IOFactory::openSource( srcFile, mBufferSize, ioBackend ) );
+
+	}
+
+	/*
+	 * Returns expected size of output, to preallocate output file.
+	 * Compression uses deflate bound of the remaining input,
+	 * decompression uses ISIZE of gzip trailer.
+	 *
+	 * @param srcFile - input file, position is not changed.
+	 * @param forInflate - true for decompression, compression otherwise.
+	 * @return - expected size, 0 if unknown (not seekable, zlib input).
+	*/
+	std::uint64_t ZStream::getExpectedSize( std::FILE *const srcFile, const bool forInflate ) const noexcept
+	{
 
 		// Guarded-Block
 		try
 		{
 
-			// Allocate input-buffer
-			inBuffer = new unsigned char[bufferSize];
+			// Remaining input, throws if not seekable (pipe)
+			const std::uint64_t position( FileUtils::tell( srcFile ) );
+			const std::uint64_t fileSize( FileUtils::getSize( srcFile ) );
+			const std::uint64_t inputSize( fileSize > position ? fileSize - position : 0 );
 
-			// Allocate output-buffer
-			outBuffer = new unsigned char[bufferSize];
+			// compressBound, with 64-bit size & gzip wrapper (header, name, trailer)
+			if ( !forInflate )
+				return( inputSize + ( inputSize >> 12 ) + ( inputSize >> 14 ) + ( inputSize >> 25 ) + 13 + 18 + mGzipFields.name.size( ) );
 
-			// Check buffers
-			if ( inBuffer == nullptr || outBuffer == nullptr )
-				throw std::exception( "ZStream::deflateFILE - failed to allocate input output buffer" );
+			// Smallest gzip
+			if ( inputSize < 20 )
+				return( 0 );
 
-			// Initialze deflate
-			zRet = deflateInit( &zStream, compressionLevel );
+			// gzip magic & ISIZE (size mod 2^32 of the last member)
+			unsigned char headBytes[2];
+			unsigned char sizeBytes[4];
+			const bool headRead( fread( headBytes, 1, 2, srcFile ) == 2 );
+			FileUtils::seek( srcFile, fileSize - 4 );
+			const bool sizeRead( fread( sizeBytes, 1, 4, srcFile ) == 4 );
+			FileUtils::seek( srcFile, position );
+
+			if ( !headRead || !sizeRead || headBytes[0] != 0x1f || headBytes[1] != 0x8b )
+				return( 0 );
 
-			// Check z_stream
-			if ( zRet != Z_OK )
+			// Seekable gzip, frame table holds size of all members
+			if ( ZSeekable::hasTable( srcFile ) )
 			{
 
-				switch ( zRet )
-				{
-					case Z_VERSION_ERROR:
-						throw std::exception( "ZStream::deflateFILE - failed to initialize deflate, zlib verion conflict." );
-						break;
-					case Z_STREAM_ERROR:
-						throw std::exception( "ZStream::deflateFILE - failed to initialize deflate, wrong compression level" );
-						break;
-					case Z_MEM_ERROR:
-						throw std::exception( "ZStream::deflateFILE - failed to initialize deflate, don't have enough memory." );
-						break;
-					default:
-						throw std::exception( "ZStream::deflateFILE - failed to initialize deflate, unknown reason." );
-				}
+				ZSeekable frameTable;
+				const bool tableRead( frameTable.load( srcFile ) == Z_OK );
+				FileUtils::seek( srcFile, position );
+
+				return( tableRead ? frameTable.getUncompressedSize( ) : 0 );
 
 			}
 
-			// Read all data from file
+			// BGZF, sum of member sizes
+			const std::uint64_t bgzfSize( ZBgzf::getUncompressedSize( srcFile ) );
+			if ( bgzfSize > 0 )
+				return( bgzfSize );
+
+			// Other gzip: ISIZE is used, only if input fits deflate bound of it, as single member does.
+			// Larger input has several members (or more than 4 GB of data), size is unknown.
+			const std::uint64_t lastSize( static_cast<std::uint64_t>( sizeBytes[0] ) | ( static_cast<std::uint64_t>( sizeBytes[1] ) << 8 ) | ( static_cast<std::uint64_t>( sizeBytes[2] ) << 16 ) | ( static_cast<std::uint64_t>( sizeBytes[3] ) << 24 ) );
+			const std::uint64_t singleBound( lastSize + ( lastSize >> 12 ) + ( lastSize >> 14 ) + ( lastSize >> 25 ) + 13 + MAX_HEADER_SIZE );
+
+			return( inputSize <= singleBound ? lastSize : 0 );
+
+		}
+		catch ( const std::exception & )
+		{
+			// Unknown, output grows by writes
+		}
+
+		return( 0 );
+
+	}
+
+	/*
+	 * Compress data from source into sink as zlib or gzip,
+	 * reusing z_stream & buffers of this instance.
+	 *
+	 * @thread_safety - not thread-safe, use one instance per thread.
+	 * @param pSource - data to compress.
+	 * @param pSink - output.
+	 * @param compressionLevel - Compression-Level to use, must be in range 0-9.
+	 * @param format - stream format, gzip uses header set by setGzipHeader.
+	 * @return - Z_OK if compression complete, Z_ERRNO otherwise.
+	*/
+	int ZStream::compress( InputSource & pSource, OutputSink & pSink, const int compressionLevel, const ZFormat format )
+	{
+
+		// Return cde
+		int zRet( 0 );
+
+		// Flush code
+		int zFlush( 0 );
+
+		// Elements count to write
+		std::uint32_t zOutCount( 0 );
+
+		// Input data
+		const unsigned char * inData( nullptr );
+
+		// Number of passes in a row, where io took longer than deflate
+		std::uint32_t ioBoundPasses( 0 );
+
+		// z_stream
+		z_stream & zStream( mDeflateStream );
+
+		// Guarded-Block
+		try
+		{
+
+			// Initialize or reset deflate
+			prepareDeflate( compressionLevel, format );
+
+			// Read all data from source
 			while ( zFlush != Z_FINISH )
 			{
 
-				// Read input-file
-				zStream.avail_in = fread( inBuffer, sizeof( unsigned char ), bufferSize, srcFile );
+				// Read input, source returns 0 at end of data
+				std::chrono::steady_clock::time_point timePoint( std::chrono::steady_clock::now( ) );
+				zStream.avail_in = static_cast<uInt>( pSource.read( inData ) );
+				mReadCount++;
 
-				// Check io errors
-				if ( ferror( srcFile ) )
-					throw std::exception( "ZStream::deflateFILE - io error, can't read input file !" );
+				// Time of pass: read & write, deflate
+				std::chrono::steady_clock::duration ioTime( std::chrono::steady_clock::now( ) - timePoint );
+				std::chrono::steady_clock::duration codecTime( 0 );
 
 				// Set z_stream flush value
-				zFlush = feof( srcFile ) ? Z_FINISH : Z_NO_FLUSH;
+				zFlush = zStream.avail_in == 0 ? Z_FINISH : Z_NO_FLUSH;
 
 				// Update z_stream input-buffer.
-				zStream.next_in = inBuffer;
+				zStream.next_in = const_cast<Bytef*>( inData );
 
 				// Update z_stream avail_out to avoid bugs.
 				zStream.avail_out = 0;
@@ -168,67 +562,55 @@ namespace c0de4un
 				{
 
 					// Set z_stream number of elements to output
-					zStream.avail_out = bufferSize;
+					zStream.avail_out = mBufferSize;
 
 					// Set z_stream output-buffer
-					zStream.next_out = outBuffer;
+					zStream.next_out = mOutBuffer.data( );
 
 					// Compress & get result.
+					timePoint = std::chrono::steady_clock::now( );
 					zRet = deflate( &zStream, zFlush );
+					const std::chrono::steady_clock::time_point deflatedPoint( std::chrono::steady_clock::now( ) );
+					codecTime += deflatedPoint - timePoint;
 
 					// Check compression result-status.
 					if ( zRet == Z_STREAM_ERROR )
-						throw std::exception( "ZStream::deflateFILE - compression failed, stream error" );
+						throw std::runtime_error( "ZStream::compress - compression failed, stream error" );
 
 					// Count elements to write in the output-file.
-					zOutCount = bufferSize - zStream.avail_out;
-
-					// Write output-file
-					if ( fwrite( outBuffer, sizeof( unsigned char ), zOutCount, dstFile ) != zOutCount || ferror( dstFile ) )
-						throw std::exception( "ZStream::deflateFILE - failed to write output file" );
+					zOutCount = mBufferSize - zStream.avail_out;
 
+					// Write output
+					pSink.write( mOutBuffer.data( ), zOutCount );
+					ioTime += std::chrono::steady_clock::now( ) - deflatedPoint;
 
 				}// while ( zStream.avail_out == 0 )
 
 				// Check if all data are compressed
 				if ( zStream.avail_in != 0 )
-					throw std::exception( "ZStream::deflateFILE - not all input data compressed !" );
+					throw std::runtime_error( "ZStream::compress - not all input data compressed !" );
+
+				// Grow buffers, while io stays slower than deflate
+				ioBoundPasses = ioTime > codecTime ? ioBoundPasses + 1 : 0;
+				if ( ioBoundPasses >= GROW_AFTER_PASSES )
+				{
+					growBuffers( pSource );
+					ioBoundPasses = 0;
+				}
 
 			}// while ( zFlush != Z_FINISH )
 
-			// Check flus-code
-			//if ( zFlush != Z_STREAM_END ) // May cause bug, when Z_STREAM_END not set event if deflate called last time.
-				//throw std::exception( "ZStream::deflateFILE - z_stream not properly closed (finished) !" );
+			// Complete pending writes
+			pSink.finish( );
 
 		}
 		catch ( const std::exception & pException )
 		{
 
 			// Print ERROR-message
-			std::cout << "ZStream::deflateFILE - error: " << pException.what( ) << std::endl;
-
-			// Release z_stream resources
-			deflateEnd( &zStream );
-
-			// Release input-buffer
-			if ( inBuffer != nullptr )
-			{
-
-				delete[] inBuffer;
-				inBuffer = nullptr;
-
-			}
-
-			//Release output-buffer
-			if ( outBuffer != nullptr )
-			{
-
-				delete[] outBuffer;
-				outBuffer = nullptr;
+			std::cout << "ZStream::compress - error: " << pException.what( ) << std::endl;
 
-			}
-
-			// Return ERROR
+			// Return ERROR, z_stream is reset by the next call
 			return( Z_ERRNO );
 
 		}
@@ -236,155 +618,128 @@ namespace c0de4un
 		{
 
 			// Print ERROR-message
-			std::cout << "ZStream::deflateFILE - unknown error" << std::endl;
+			std::cout << "ZStream::compress - unknown error" << std::endl;
 
-			// Release z_stream resources
-			deflateEnd( &zStream );
+			// Return ERROR
+			return( Z_ERRNO );
 
-			// Release input-buffer
-			if ( inBuffer != nullptr )
-			{
+		}
 
-				delete[] inBuffer;
-				inBuffer = nullptr;
+		// Return Z_OK
+		return( Z_OK );
 
-			}
+	}
 
-			//Release output-buffer
-			if ( outBuffer != nullptr )
-			{
+	/*
+	 * Compress the given file as zlib or gzip,
+	 * reusing z_stream & buffers of this instance.
+	 *
+	 * @thread_safety - not thread-safe, use one instance per thread.
+	 * @param srcFile - file to compress.
+	 * @param dstFile - output file.
+	 * @param compressionLevel - Compression-Level to use, must be in range 0-9.
+	 * @param ioBackend - file io backend, stdio is used if backend can't be used for the file.
+	 * @param format - stream format, gzip uses header set by setGzipHeader.
+	 * @return - Z_OK if compression complete, Z_ERRNO otherwise.
+	*/
+	int ZStream::compressFILE( std::FILE *const srcFile, std::FILE *const dstFile, const int compressionLevel, const IOBackend ioBackend, const ZFormat format )
+	{
 
-				delete[] outBuffer;
-				outBuffer = nullptr;
+		// Set in & out binary mode on MSVC to prevent 'end-of-line' char adding
+		SET_BINARY_MODE( stdin );
+		SET_BINARY_MODE( stdout );
 
-			}
+		// Guarded-Block
+		try
+		{
 
-			// Return ERROR
-			return( Z_ERRNO );
+			// Output, preallocated for deflate bound of input
+			std::unique_ptr<OutputSink> fileSink( IOFactory::openSink( dstFile, ioBackend, getExpectedSize( srcFile, false ) ) );
 
-		}
+			// Input
+			std::unique_ptr<InputSource> fileSource( openSource( srcFile, ioBackend ) );
 
-		// Release z_stream resources
-		deflateEnd( &zStream );
+			// Compress
+			return( compress( *fileSource, *fileSink, compressionLevel, format ) );
 
-		// Release input-buffer
-		delete[] inBuffer;
-		inBuffer = nullptr;
+		}
+		catch ( const std::exception & pException )
+		{
 
-		//Release output-buffer
-		delete[] outBuffer;
-		outBuffer = nullptr;
+			// Print ERROR-message
+			std::cout << "ZStream::compressFILE - error: " << pException.what( ) << std::endl;
 
-		// Return Z_OK
-		return( Z_OK );
+			// Return ERROR
+			return( Z_ERRNO );
+
+		}
 
 	}
 
 	/*
-	 * Decompress given file using zlib (not gzip).
+	 * Decompress zlib or gzip data from source into sink,
+	 * reusing z_stream & buffers of this instance.
 	 *
-	 * @thread_safety - not thread-safe.
-	 * @param srcFile - file to decompress (inflate). Must be compressed by the same zlib version and method.
-	 * @param dstFile - output file path, must be other then source.
-	 * @param bufferSize - initial buffer size. Increased, if required,
-	 * by +50% each time.
+	 * @thread_safety - not thread-safe, use one instance per thread.
+	 * @param pSource - data to decompress (inflate).
+	 * @param pSink - output.
 	 * @return - Z_OK if sucessfull, error-code otherwise.
-	 * @throws - can throw exception.
 	*/
-	const int ZStream::inflateFILE( std::FILE *const srcFile, std::FILE *const dstFile, const std::uint32_t & bufferSize )
+	int ZStream::decompress( InputSource & pSource, OutputSink & pSink )
 	{
 
-		// Set in & out binary mode on MSVC to prevent 'end-of-line' char adding
-		SET_BINARY_MODE( stdin );
-		SET_BINARY_MODE( stdout );
-
 		// Return cde
 		int zRet( 0 );
 
-		// Flush code
-		int zFlush( 0 );
-
 		// Elements count to write
 		std::uint32_t zOutCount( 0 );
 
-		// Input-buffer for z_stream
-		unsigned char * inBuffer;
+		// Input data
+		const unsigned char * inData( nullptr );
 
-		// Output-buffer for z_stream
-		unsigned char * outBuffer;
+		// Number of passes in a row, where io took longer than inflate
+		std::uint32_t ioBoundPasses( 0 );
 
-		// z_stream
-		z_stream zStream;
+		// Time of pass: read & write, inflate
+		std::chrono::steady_clock::duration ioTime( 0 );
+		std::chrono::steady_clock::duration codecTime( 0 );
 
-		// Set z_stream state
-		zStream.zalloc = Z_NULL;
-		zStream.zfree = Z_NULL;
-		zStream.opaque = Z_NULL;
-		zStream.avail_in = 0;
-		zStream.next_in = Z_NULL;
+		// z_stream
+		z_stream & zStream( mInflateStream );
 
 		// Guarded-Block
 		try
 		{
 
-			// Allocate input-buffer
-			inBuffer = new unsigned char[bufferSize];
-
-			// Allocate output-buffer
-			outBuffer = new unsigned char[bufferSize];
+			// No input
+			zStream.avail_in = 0;
 
-			// Check buffers
-			if ( inBuffer == nullptr || outBuffer == nullptr )
-				throw std::exception( "ZStream::deflateFILE - failed to allocate input output buffer" );
+			// Initialize or reset inflate
+			prepareInflate( );
 
-			// Initialize inflate
-			zRet = inflateInit( &zStream );
-
-			// Check initialization state
-			if ( zRet != Z_OK )
+			// Read input
+			do
 			{
 
-				// Handle code
-				switch ( zRet )
+				// Read, if input consumed
+				if ( zStream.avail_in == 0 )
 				{
 
-				case Z_MEM_ERROR:
-					throw std::exception( "ZStream::deflateFILE - failed to initialize decompression stream, not enough memory." );
-					break;
+					// Read & update z_stream input elements counter
+					const std::chrono::steady_clock::time_point readPoint( std::chrono::steady_clock::now( ) );
+					zStream.avail_in = static_cast<uInt>( pSource.read( inData ) );
+					mReadCount++;
+					ioTime += std::chrono::steady_clock::now( ) - readPoint;
 
-				case Z_VERSION_ERROR:
-					throw std::exception( "ZStream::deflateFILE - failed to initialize decompression stream, zlib version conflict." );
-					break;
-
-				case Z_STREAM_ERROR:
-					throw std::exception( "ZStream::deflateFILE - failed to initialize decompression stream, arguments are invalid." );
-					break;
+					// Stop if no data
+					if ( zStream.avail_in == 0 )
+						break;
 
-				default:
-					throw std::exception( "ZStream::deflateFILE - failed to initialize decompression stream, unknown reason." );
+					//Update z_stream input buffer
+					zStream.next_in = const_cast<Bytef*>( inData );
 
 				}
 
-			}
-
-			// Read input-file
-			do
-			{
-
-				// Read & update z_stream input elements counter
-				zStream.avail_in = fread( inBuffer, sizeof( unsigned char ), bufferSize, srcFile );
-
-				// Check read-status
-				if ( ferror( srcFile ) )
-					throw std::exception( "ZStream::deflateFILE - can't read source-file !" );
-
-				// Stop if no data
-				if ( zStream.avail_in == 0 )
-					break;
-
-				//Update z_stream input buffer
-				zStream.next_in = inBuffer;
-
 				// Reset z_stream.avail_out to avoid bug
 				zStream.avail_out = 0;
 
@@ -393,131 +748,356 @@ namespace c0de4un
 				{
 
 					// Update z_stream avail_out
-					zStream.avail_out = bufferSize;
+					zStream.avail_out = mBufferSize;
 
 					// Update z_stream output-buffer
-					zStream.next_out = outBuffer;
+					zStream.next_out = mOutBuffer.data( );
 
 					// Decompress data (Z_NO_FLUSH means all possinle data, using full buffer size)
+					const std::chrono::steady_clock::time_point inflatePoint( std::chrono::steady_clock::now( ) );
 					zRet = inflate( &zStream, Z_NO_FLUSH );
+					const std::chrono::steady_clock::time_point inflatedPoint( std::chrono::steady_clock::now( ) );
+					codecTime += inflatedPoint - inflatePoint;
 
 					// Check inflate-status
 					switch ( zRet )
 					{
 
 					case Z_DATA_ERROR:
-						throw std::exception( "ZStream::deflateFILE - decompression (inflate) failed, data corrupted." );
+						throw std::runtime_error( "ZStream::decompress - decompression (inflate) failed, data corrupted." );
 						break;
 
 					case Z_MEM_ERROR:
-						throw std::exception( "ZStream::deflateFILE - decompression (inflate) failed, insufficent memory" );
+						throw std::runtime_error( "ZStream::decompress - decompression (inflate) failed, insufficent memory" );
 						break;
 
 					case Z_BUF_ERROR:
-						throw std::exception( "ZStream::deflateFILE - decompression (inflate) failed, data can't fit output-buffer." );
+						// No progress possible (output-buffer was filled exactly by the previous call), read more input.
 						break;
 
 					case Z_NEED_DICT:
-						throw std::exception( "ZStream::deflateFILE - decompression (inflate) failed, dictionary required." );
+					{
+
+						// Dictionary by id (Adler-32 of dictionary), stream continues with it
+						const std::vector<unsigned char> *const presetDictionary( mDictionaries != nullptr ? mDictionaries->find( static_cast<std::uint32_t>( zStream.adler ) ) : nullptr );
+
+						if ( presetDictionary == nullptr )
+							throw std::runtime_error( "ZStream::decompress - decompression (inflate) failed, dictionary #" + std::to_string( zStream.adler ) + " required." );
+
+						if ( inflateSetDictionary( &zStream, presetDictionary->data( ), static_cast<uInt>( presetDictionary->size( ) ) ) != Z_OK )
+							throw std::runtime_error( "ZStream::decompress - decompression (inflate) failed, dictionary rejected." );
+
+						zRet = Z_OK;
 						break;
 
+					}
+
 					case Z_STREAM_ERROR:
-						throw std::exception( "ZStream::deflateFILE - decompression (inflate) failed, stream structure inconsistent (some params are not set)." );
+						throw std::runtime_error( "ZStream::decompress - decompression (inflate) failed, stream structure inconsistent (some params are not set)." );
 						break;
 
 					}
 
 					// Count output elements
-					zOutCount = bufferSize - zStream.avail_out;
+					zOutCount = mBufferSize - zStream.avail_out;
 
 					// Write uncompressed output
-					if ( fwrite( outBuffer, sizeof( unsigned char ), zOutCount, dstFile ) != zOutCount || ferror( dstFile ) )
-						throw std::exception( "failed to write decompressed output" );
+					pSink.write( mOutBuffer.data( ), zOutCount );
+					ioTime += std::chrono::steady_clock::now( ) - inflatedPoint;
 
 				} while ( zStream.avail_out == 0 );
 
+				// Grow buffers, while io stays slower than inflate. Pass ends, when input is consumed, source data is reallocated.
+				if ( zStream.avail_in == 0 )
+				{
+
+					ioBoundPasses = ioTime > codecTime ? ioBoundPasses + 1 : 0;
+					ioTime = std::chrono::steady_clock::duration( 0 );
+					codecTime = std::chrono::steady_clock::duration( 0 );
+
+					if ( ioBoundPasses >= GROW_AFTER_PASSES )
+					{
+						growBuffers( pSource );
+						ioBoundPasses = 0;
+					}
+
+				}
+
+				// gzip-member ended, next member can follow (concatenated .gz files)
+				if ( zRet == Z_STREAM_END && mInflateHeader.done == 1 )
+				{
+
+					// Read, if member ended at end of input
+					if ( zStream.avail_in == 0 )
+					{
+						zStream.avail_in = static_cast<uInt>( pSource.read( inData ) );
+						zStream.next_in = const_cast<Bytef*>( inData );
+						mReadCount++;
+					}
+
+					// Start next member
+					if ( zStream.avail_in > 0 )
+					{
+						prepareInflate( );
+						zRet = Z_OK;
+					}
+
+				}
+
 			} while ( zRet != Z_STREAM_END );
 
-			// Release z_stream resources
-			inflateEnd( &zStream );
+			// Complete pending writes
+			pSink.finish( );
+
+		}
+		catch ( const std::exception & pException )
+		{
+
+			// Print ERROR-message
+			std::cout << "ZStream::decompress - error: " << pException.what( ) << std::endl;
+
+			// Return ERROR, z_stream is reset by the next call
+			return( Z_ERRNO );
+
+		}
+		catch ( ... )
+		{
+
+			// Print ERROR-message
+			std::cout << "ZStream::decompress - unknown error" << std::endl;
+
+			// Return ERROR
+			return( Z_ERRNO );
+
+		}
+
+		// Return
+		return( zRet == Z_STREAM_END ? Z_OK : Z_DATA_ERROR );
+
+	}
+
+	/*
+	 * Decompress given zlib or gzip file,
+	 * reusing z_stream & buffers of this instance.
+	 *
+	 * @thread_safety - not thread-safe, use one instance per thread.
+	 * @param srcFile - file to decompress (inflate).
+	 * @param dstFile - output file, must be other then source.
+	 * @param ioBackend - file io backend, stdio is used if backend can't be used for the file.
+	 * @return - Z_OK if sucessfull, error-code otherwise.
+	*/
+	int ZStream::decompressFILE( std::FILE *const srcFile, std::FILE *const dstFile, const IOBackend ioBackend )
+	{
+
+		// Set in & out binary mode on MSVC to prevent 'end-of-line' char adding
+		SET_BINARY_MODE( stdin );
+		SET_BINARY_MODE( stdout );
+
+		// Guarded-Block
+		try
+		{
 
-			// Release input-buffer
-			delete[] inBuffer;
-			inBuffer = nullptr;
+			// Output, preallocated for gzip ISIZE
+			std::unique_ptr<OutputSink> fileSink( IOFactory::openSink( dstFile, ioBackend, getExpectedSize( srcFile, true ) ) );
 
-			//Release output-buffer
-			delete[] outBuffer;
-			outBuffer = nullptr;
+			// Input
+			std::unique_ptr<InputSource> fileSource( openSource( srcFile, ioBackend ) );
 
-			// Return
-			return( zRet == Z_STREAM_END ? Z_OK : Z_DATA_ERROR );
+			// Decompress
+			return( decompress( *fileSource, *fileSink ) );
 
 		}
 		catch ( const std::exception & pException )
 		{
 
 			// Print ERROR-message
-			std::cout << "ZStream::inflateFILE - error: " << pException.what( ) << std::endl;
+			std::cout << "ZStream::decompressFILE - error: " << pException.what( ) << std::endl;
 
-			// Release z_stream resources
-			inflateEnd( &zStream );
+			// Return ERROR
+			return( Z_ERRNO );
 
-			// Release input-buffer
-			if ( inBuffer != nullptr )
-			{
+		}
 
-				delete[] inBuffer;
-				inBuffer = nullptr;
+	}
 
-			}
+	/*
+	 * Compress the given file as zlib or gzip.
+	 *
+	 * @thread_safety - thread-safe, temporary ZStream is used.
+	 * @param srcFile - file to compress.
+	 * @param dstFile - output file.
+	 * @param bufferSize - initial size of input & output buffers.
+	 * @param compressionLevel - Compression-Level to use, must be in range 0-9.
+	 * @param ioBackend - file io backend, stdio is used if backend can't be used for the file.
+	 * @param format - stream format.
+	 * @param gzipHeader - gzip header fields, used if format is gzip.
+	 * @param pStats - receives buffer statistics, can be null.
+	 * @param pDictionary - preset dictionary, zlib format only. Can be null.
+	 * @return - Z_OK if compression complete, Z_ERRNO otherwise.
+	*/
+	int ZStream::deflateFILE( std::FILE *const srcFile, std::FILE *const dstFile, const std::uint32_t & bufferSize, const int & compressionLevel, const IOBackend ioBackend, const ZFormat format, const ZGzipHeader & gzipHeader, Stats *const pStats, const std::vector<unsigned char> *const pDictionary )
+	{
 
-			//Release output-buffer
-			if ( outBuffer != nullptr )
-			{
+		// Guarded-Block
+		try
+		{
 
-				delete[] outBuffer;
-				outBuffer = nullptr;
+			// Temporary engine, zlib state is allocated from thread's arena
+			ZStream zEngine( bufferSize, &ZArena::getThreadArena( ) );
 
-			}
+			// Set gzip header
+			zEngine.setGzipHeader( gzipHeader );
+
+			// Set preset dictionary
+			if ( pDictionary != nullptr )
+				zEngine.setDictionary( *pDictionary );
+
+			// Compress
+			const int zRet( zEngine.compressFILE( srcFile, dstFile, compressionLevel, ioBackend, format ) );
+
+			// Statistics
+			if ( pStats != nullptr )
+				*pStats = zEngine.getStats( );
+
+			return( zRet );
+
+		}
+		catch ( const std::exception & pException )
+		{
+
+			// Print ERROR-message
+			std::cout << "ZStream::deflateFILE - error: " << pException.what( ) << std::endl;
 
 			// Return ERROR
 			return( Z_ERRNO );
 
 		}
-		catch ( ... )
+
+	}
+
+	/*
+	 * Compress data from source into sink as zlib or gzip.
+	 *
+	 * @thread_safety - thread-safe, temporary ZStream is used.
+	 * @param pSource - data to compress.
+	 * @param pSink - output.
+	 * @param bufferSize - output buffer size.
+	 * @param compressionLevel - Compression-Level to use, must be in range 0-9.
+	 * @param format - stream format.
+	 * @param gzipHeader - gzip header fields, used if format is gzip.
+	 * @return - Z_OK if compression complete, Z_ERRNO otherwise.
+	*/
+	int ZStream::deflateSource( InputSource & pSource, OutputSink & pSink, const std::uint32_t & bufferSize, const int & compressionLevel, const ZFormat format, const ZGzipHeader & gzipHeader )
+	{
+
+		// Guarded-Block
+		try
+		{
+
+			// Temporary engine, zlib state is allocated from thread's arena
+			ZStream zEngine( bufferSize, &ZArena::getThreadArena( ) );
+
+			// Set gzip header
+			zEngine.setGzipHeader( gzipHeader );
+
+			// Compress
+			return( zEngine.compress( pSource, pSink, compressionLevel, format ) );
+
+		}
+		catch ( const std::exception & pException )
 		{
 
 			// Print ERROR-message
-			std::cout << "ZStream::inflateFILE - unknown error" << std::endl;
+			std::cout << "ZStream::deflateSource - error: " << pException.what( ) << std::endl;
 
-			// Release z_stream resources
-			inflateEnd( &zStream );
+			// Return ERROR
+			return( Z_ERRNO );
 
-			// Release input-buffer
-			if ( inBuffer != nullptr )
-			{
+		}
 
-				delete[] inBuffer;
-				inBuffer = nullptr;
+	}
 
-			}
+	/*
+	 * Decompress given zlib or gzip file.
+	 *
+	 * @thread_safety - thread-safe, temporary ZStream is used.
+	 * @param srcFile - file to decompress (inflate).
+	 * @param dstFile - output file path, must be other then source.
+	 * @param bufferSize - initial size of input & output buffers.
+	 * @param ioBackend - file io backend, stdio is used if backend can't be used for the file.
+	 * @param pStats - receives buffer statistics, can be null.
+	 * @param pDictionaries - dictionaries for streams, which require one. Can be null.
+	 * @return - Z_OK if sucessfull, error-code otherwise.
+	*/
+	int ZStream::inflateFILE( std::FILE *const srcFile, std::FILE *const dstFile, const std::uint32_t & bufferSize, const IOBackend ioBackend, Stats *const pStats, const ZDictionary *const pDictionaries )
+	{
 
-			//Release output-buffer
-			if ( outBuffer != nullptr )
-			{
+		// Guarded-Block
+		try
+		{
 
-				delete[] outBuffer;
-				outBuffer = nullptr;
+			// Temporary engine, zlib state is allocated from thread's arena
+			ZStream zEngine( bufferSize, &ZArena::getThreadArena( ) );
 
-			}
+			// Set dictionaries
+			zEngine.setDictionaries( pDictionaries );
+
+			// Decompress
+			const int zRet( zEngine.decompressFILE( srcFile, dstFile, ioBackend ) );
+
+			// Statistics
+			if ( pStats != nullptr )
+				*pStats = zEngine.getStats( );
+
+			return( zRet );
+
+		}
+		catch ( const std::exception & pException )
+		{
+
+			// Print ERROR-message
+			std::cout << "ZStream::inflateFILE - error: " << pException.what( ) << std::endl;
 
 			// Return ERROR
 			return( Z_ERRNO );
 
 		}
 
-		// Return OK
-		return( Z_OK ); // Unreachable code, but required by MSVC
+	}
+
+	/*
+	 * Decompress zlib or gzip data from source into sink.
+	 *
+	 * @thread_safety - thread-safe, temporary ZStream is used.
+	 * @param pSource - data to decompress (inflate).
+	 * @param pSink - output.
+	 * @param bufferSize - output buffer size.
+	 * @return - Z_OK if sucessfull, error-code otherwise.
+	*/
+	int ZStream::inflateSource( InputSource & pSource, OutputSink & pSink, const std::uint32_t & bufferSize )
+	{
+
+		// Guarded-Block
+		try
+		{
+
+			// Temporary engine, zlib state is allocated from thread's arena
+			ZStream zEngine( bufferSize, &ZArena::getThreadArena( ) );
+
+			// Decompress
+			return( zEngine.decompress( pSource, pSink ) );
+
+		}
+		catch ( const std::exception & pException )
+		{
+
+			// Print ERROR-message
+			std::cout << "ZStream::inflateSource - error: " << pException.what( ) << std::endl;
+
+			// Return ERROR
+			return( Z_ERRNO );
+
+		}
 
 	}
 
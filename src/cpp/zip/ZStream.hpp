@@ -36,6 +36,27 @@
 // Include 'pch_cxx'
 #include "../pch_cxx.hpp"
 
+// Include IOBackend
+#include "../io/IOBackend.hpp"
+
+// Include InputSource
+#include "../io/InputSource.hpp"
+
+// Include OutputSink
+#include "../io/OutputSink.hpp"
+
+// Include ZArena
+#include "ZArena.hpp"
+
+// Include ZFormat
+#include "ZFormat.hpp"
+
+// Include ZDictionary
+#include "ZDictionary.hpp"
+
+// Include C++ chrono
+#include <chrono> // std::chrono::steady_clock
+
 // Hack for Windows to avoid binary data corruption & casting end-of-line characters
 #if defined(MSDOS) || defined(OS2) || defined(WIN32) || defined(__CYGWIN__)
 #  include <fcntl.h>
@@ -57,6 +78,13 @@ namespace c0de4un
 	/*
 	  * ZStream - utility-class to simpify work with compressing/decompressing
 	  * data (directly files or stream).
+	  * Writes zlib or gzip, reads both (detected by header), including
+	  * concatenated gzip-members. zlib streams can use preset dictionary,
+	  * decompression finds it by id in ZDictionary registry.
+	  * Buffers start from the configured size & grow by +50%, while io
+	  * (source reads & sink writes) takes longer than the codec several
+	  * passes in a row, up to the max buffer size. Full reads are not
+	  * counted: regular file fills any buffer, without io being slow.
 	  * 
 	  * @language C++ 11
 	  * 
@@ -74,12 +102,179 @@ namespace c0de4un
 		// Fields
 		// ===========================================================
 
+		/* Size of input & output buffers */
+		std::uint32_t mBufferSize;
+
+		/* Max size of input & output buffers, growth limit */
+		std::uint32_t mMaxBufferSize;
+
+		/* Number of times buffers grew */
+		std::uint32_t mGrowCount;
+
+		/* Number of reads from sources */
+		std::uint64_t mReadCount;
+
+		/* Input-buffer, used by stdio file-source */
+		std::vector<unsigned char> mInBuffer;
+
+		/* Output-buffer for z_stream */
+		std::vector<unsigned char> mOutBuffer;
+
+		/* Deflate z_stream */
+		z_stream mDeflateStream;
+
+		/* true, if deflate initialized */
+		bool mDeflateInitialized;
+
+		/* Compression-Level of initialized deflate */
+		int mDeflateLevel;
+
+		/* Format of initialized deflate */
+		ZFormat mDeflateFormat;
+
+		/* deflateInit2 window-bits, without wrapper offset */
+		int mWindowBits;
+
+		/* deflateInit2 mem-level */
+		int mMemLevel;
+
+		/* gzip header fields, used by compression */
+		ZGzipHeader mGzipFields;
+
+		/* zlib gzip header, points to mGzipFields */
+		gz_header mDeflateHeader;
+
+		/* Inflate z_stream */
+		z_stream mInflateStream;
+
+		/* true, if inflate initialized */
+		bool mInflateInitialized;
+
+		/* Header of decompressed stream, done is 1 if gzip-header read */
+		gz_header mInflateHeader;
+
+		/* Preset dictionary of compression, empty if not used */
+		std::vector<unsigned char> mDictionary;
+
+		/* Dictionaries for decompression, null if not used */
+		const ZDictionary * mDictionaries;
+
+		// ===========================================================
+		// Constants
+		// ===========================================================
+
+		/* Number of io-bound passes in a row, after which buffers grow */
+		static constexpr std::uint32_t GROW_AFTER_PASSES = 4;
+
+		/* Max size of gzip-header & trailer, assumed for single-member check (name, comment, extra-field) */
+		static constexpr std::uint64_t MAX_HEADER_SIZE = 65536;
+
+		// ===========================================================
+		// Methods
+		// ===========================================================
+
+		/*
+		 * Grow input & output buffers by +50%, up to the max buffer size.
+		 * Must be called when output-buffer & source data are not in use.
+		 *
+		 * @param pSource - current source, receives the new read size.
+		 * @throws - can throw exception (bad_alloc).
+		*/
+		void growBuffers( InputSource & pSource );
+
+		/*
+		 * Initialize deflate on first use, reset it otherwise.
+		 * Deflate is re-initialized only if Compression-Level or format changed.
+		 *
+		 * @param compressionLevel - Compression-Level to use, must be in range 0-9.
+		 * @param format - stream format.
+		 * @throws - can throw exception.
+		*/
+		void prepareDeflate( const int compressionLevel, const ZFormat format );
+
+		/*
+		 * Initialize deflate.
+		 *
+		 * @param compressionLevel - Compression-Level to use, must be in range 0-9.
+		 * @param format - stream format.
+		 * @throws - can throw exception.
+		*/
+		void initDeflate( const int compressionLevel, const ZFormat format );
+
+		/*
+		 * Initialize inflate on first use, reset it otherwise.
+		 * Input-data of z_stream is not changed.
+		 *
+		 * @throws - can throw exception.
+		*/
+		void prepareInflate( );
+
+		/*
+		 * Initialize inflate.
+		 *
+		 * @throws - can throw exception.
+		*/
+		void initInflate( );
+
+		/*
+		 * Open file-source. Stdio-source uses own input-buffer.
+		 *
+		 * @param srcFile - file to read.
+		 * @param ioBackend - file io backend, stdio is used if backend can't be used for the file.
+		 * @throws - can throw exception (bad_alloc).
+		*/
+		std::unique_ptr<InputSource> openSource( std::FILE *const srcFile, const IOBackend ioBackend );
+
+		/*
+		 * Returns expected size of output, to preallocate output file.
+		 * Compression uses deflate bound of the remaining input.
+		 * Decompression uses frame table of seekable gzip, sum of BGZF
+		 * member sizes, or ISIZE of gzip trailer, if input can be one member.
+		 *
+		 * @param srcFile - input file, position is not changed.
+		 * @param forInflate - true for decompression, compression otherwise.
+		 * @return - expected size, 0 if unknown (not seekable, zlib input).
+		*/
+		std::uint64_t getExpectedSize( std::FILE *const srcFile, const bool forInflate ) const noexcept;
+
 		// -------------------------------------------------------- \\
 
 	public:
 
 		// -------------------------------------------------------- \\
 
+		// ===========================================================
+		// Types
+		// ===========================================================
+
+		/* Buffer statistics */
+		struct Stats final
+		{
+
+			/* Current (chosen) size of input & output buffers */
+			std::uint32_t bufferSize;
+
+			/* Number of times buffers grew */
+			std::uint32_t growCount;
+
+			/* Number of reads from sources */
+			std::uint64_t readCount;
+
+		};
+
+		// ===========================================================
+		// Constants
+		// ===========================================================
+
+		/* Default max size of input & output buffers */
+		static constexpr std::uint32_t DEFAULT_MAX_BUFFER_SIZE = 4194304;
+
+		/* deflateInit2 window-bits to write gzip-wrapper */
+		static constexpr int GZIP_WINDOW_BITS = MAX_WBITS + 16;
+
+		/* inflateInit2 window-bits to detect zlib or gzip wrapper */
+		static constexpr int AUTO_WINDOW_BITS = MAX_WBITS + 32;
+
 		// ===========================================================
 		// Constructor & destructor
 		// ===========================================================
@@ -87,45 +282,188 @@ namespace c0de4un
 		/*
 		 * ZStream constructor.
 		 * 
-		 * @param bufferSize - initial buffer size. Increased, if required,
-		 * by +50% each time.
+		 * Buffers are allocated once, z_stream's are initialized on first use
+		 * and reset between calls, so one instance can process many files
+		 * without repeating the setup.
+		 *
+		 * @param bufferSize - initial size of input & output buffers.
+		 * @param pArena - allocator for z_stream state, must outlive this instance.
+		 * If null, zlib default allocator (malloc) is used.
+		 * @param maxBufferSize - max size of input & output buffers, so both
+		 * use up to 2 * maxBufferSize. Buffers don't grow, if not greater then bufferSize.
 		 * @throws - can throw exception (bad_alloc).
 		*/
-		explicit ZStream( const std::uint32_t bufferSize = 65536 );
+		explicit ZStream( const std::uint32_t bufferSize = 65536, ZArena *const pArena = nullptr, const std::uint32_t maxBufferSize = DEFAULT_MAX_BUFFER_SIZE );
 
 		/* ZStream destructor */
 		~ZStream( );
 
+		/* @deleted ZStream copy-constructor, z_stream state can't be copied */
+		ZStream( const ZStream & ) = delete;
+
+		/* @deleted ZStream copy-assignment */
+		ZStream & operator=( const ZStream & ) = delete;
+
 		// ===========================================================
-		// Methods
+		// Getters
+		// ===========================================================
+
+		/* Returns current size of input & output buffers */
+		std::uint32_t getBufferSize( ) const noexcept;
+
+		/* Returns buffer statistics, since construction */
+		Stats getStats( ) const noexcept;
+
+		// ===========================================================
+		// Setters
 		// ===========================================================
 
 		/*
-		 * Compress the given file using zlib (not gzip).
+		 * Set gzip header fields for the next compressions.
 		 *
 		 * @thread_safety - not thread-safe.
+		 * @param pHeader - gzip header fields.
+		 * @throws - can throw exception (bad_alloc).
+		*/
+		void setGzipHeader( const ZGzipHeader & pHeader );
+
+		/*
+		 * Set deflate memory for the next compressions (see MemoryBudget::plan).
+		 * Deflate uses (4 << windowBits) + (1 << (memLevel + 9)) bytes.
+		 *
+		 * @thread_safety - not thread-safe.
+		 * @param windowBits - window-bits, in range 9-15.
+		 * @param memLevel - mem-level, in range 1-9.
+		*/
+		void setDeflateMemory( const int windowBits, const int memLevel ) noexcept;
+
+		/*
+		 * Set preset dictionary for the next compressions, zlib format only.
+		 *
+		 * @thread_safety - not thread-safe.
+		 * @param pDictionary - dictionary, empty to compress without it.
+		 * @throws - can throw exception (bad_alloc).
+		*/
+		void setDictionary( const std::vector<unsigned char> & pDictionary );
+
+		/*
+		 * Set dictionaries for the next decompressions, stream requiring
+		 * dictionary gets it by id.
+		 *
+		 * @thread_safety - not thread-safe.
+		 * @param pDictionaries - registry, must outlive decompressions. Null to not use.
+		*/
+		void setDictionaries( const ZDictionary *const pDictionaries ) noexcept;
+
+		// ===========================================================
+		// Methods
+		// ===========================================================
+
+		/*
+		 * Compress data from source into sink as zlib or gzip,
+		 * reusing z_stream & buffers of this instance.
+		 *
+		 * @thread_safety - not thread-safe, use one instance per thread.
+		 * @param pSource - data to compress.
+		 * @param pSink - output.
+		 * @param compressionLevel - Compression-Level to use, must be in range 0-9.
+		 * @param format - stream format, gzip uses header set by setGzipHeader.
+		 * @return - Z_OK if compression complete, Z_ERRNO otherwise.
+		*/
+		int compress( InputSource & pSource, OutputSink & pSink, const int compressionLevel, const ZFormat format = ZFormat::ZLIB );
+
+		/*
+		 * Compress the given file as zlib or gzip,
+		 * reusing z_stream & buffers of this instance.
+		 *
+		 * @thread_safety - not thread-safe, use one instance per thread.
 		 * @param srcFile - file to compress.
 		 * @param dstFile - output file.
-		 * @param bufferSize - initial buffer size. Increased, if required,
-		 * by +50% each time.
 		 * @param compressionLevel - Compression-Level to use, must be in range 0-9.
-		 * @return - Z_OK if compression complete.
-		 * @throws - can throw exception.
+		 * @param ioBackend - file io backend, stdio is used if backend can't be used for the file.
+		 * @param format - stream format, gzip uses header set by setGzipHeader.
+		 * @return - Z_OK if compression complete, Z_ERRNO otherwise.
+		*/
+		int compressFILE( std::FILE *const srcFile, std::FILE *const dstFile, const int compressionLevel, const IOBackend ioBackend = IOBackend::STDIO, const ZFormat format = ZFormat::ZLIB );
+
+		/*
+		 * Decompress zlib or gzip data from source into sink,
+		 * reusing z_stream & buffers of this instance.
+		 *
+		 * @thread_safety - not thread-safe, use one instance per thread.
+		 * @param pSource - data to decompress (inflate).
+		 * @param pSink - output.
+		 * @return - Z_OK if sucessfull, error-code otherwise.
+		*/
+		int decompress( InputSource & pSource, OutputSink & pSink );
+
+		/*
+		 * Decompress given zlib or gzip file,
+		 * reusing z_stream & buffers of this instance.
+		 *
+		 * @thread_safety - not thread-safe, use one instance per thread.
+		 * @param srcFile - file to decompress (inflate).
+		 * @param dstFile - output file, must be other then source.
+		 * @param ioBackend - file io backend, stdio is used if backend can't be used for the file.
+		 * @return - Z_OK if sucessfull, error-code otherwise.
 		*/
-		static const int & deflateFILE( std::FILE *const srcFile, std::FILE *const dstFile, const std::uint32_t & bufferSize, const int & compressionLevel );
+		int decompressFILE( std::FILE *const srcFile, std::FILE *const dstFile, const IOBackend ioBackend = IOBackend::STDIO );
 
 		/*
-		 * Decompress given file using zlib (not gzip).
+		 * Compress the given file as zlib or gzip.
+		 *
+		 * @thread_safety - thread-safe, temporary ZStream is used.
+		 * @param srcFile - file to compress.
+		 * @param dstFile - output file.
+		 * @param bufferSize - initial size of input & output buffers.
+		 * @param compressionLevel - Compression-Level to use, must be in range 0-9.
+		 * @param ioBackend - file io backend, stdio is used if backend can't be used for the file.
+		 * @param format - stream format.
+		 * @param gzipHeader - gzip header fields, used if format is gzip.
+		 * @param pStats - receives buffer statistics, can be null.
+		 * @param pDictionary - preset dictionary, zlib format only. Can be null.
+		 * @return - Z_OK if compression complete, Z_ERRNO otherwise.
+		*/
+		static int deflateFILE( std::FILE *const srcFile, std::FILE *const dstFile, const std::uint32_t & bufferSize, const int & compressionLevel, const IOBackend ioBackend = IOBackend::STDIO, const ZFormat format = ZFormat::ZLIB, const ZGzipHeader & gzipHeader = ZGzipHeader( ), Stats *const pStats = nullptr, const std::vector<unsigned char> *const pDictionary = nullptr );
+
+		/*
+		 * Compress data from source into sink as zlib or gzip.
+		 *
+		 * @thread_safety - thread-safe, temporary ZStream is used.
+		 * @param pSource - data to compress.
+		 * @param pSink - output.
+		 * @param bufferSize - output buffer size.
+		 * @param compressionLevel - Compression-Level to use, must be in range 0-9.
+		 * @param format - stream format.
+		 * @param gzipHeader - gzip header fields, used if format is gzip.
+		 * @return - Z_OK if compression complete, Z_ERRNO otherwise.
+		*/
+		static int deflateSource( InputSource & pSource, OutputSink & pSink, const std::uint32_t & bufferSize, const int & compressionLevel, const ZFormat format = ZFormat::ZLIB, const ZGzipHeader & gzipHeader = ZGzipHeader( ) );
+
+		/*
+		 * Decompress given zlib or gzip file.
 		 * 
-		 * @thread_safety - not thread-safe.
-		 * @param srcFile - file to decompress (inflate). Must be compressed by the same zlib version and method.
+		 * @thread_safety - thread-safe, temporary ZStream is used.
+		 * @param srcFile - file to decompress (inflate).
 		 * @param dstFile - output file path, must be other then source.
-		 * @param bufferSize - initial buffer size. Increased, if required,
-		 * by +50% each time.
+		 * @param bufferSize - initial size of input & output buffers.
+		 * @param ioBackend - file io backend, stdio is used if backend can't be used for the file.
+		 * @param pStats - receives buffer statistics, can be null.
+		 * @param pDictionaries - dictionaries for streams, which require one. Can be null.
+		 * @return - Z_OK if sucessfull, error-code otherwise.
+		*/
+		static int inflateFILE( std::FILE *const srcFile, std::FILE *const dstFile, const std::uint32_t & bufferSize, const IOBackend ioBackend = IOBackend::STDIO, Stats *const pStats = nullptr, const ZDictionary *const pDictionaries = nullptr );
+
+		/*
+		 * Decompress zlib or gzip data from source into sink.
+		 *
+		 * @thread_safety - thread-safe, temporary ZStream is used.
+		 * @param pSource - data to decompress (inflate).
+		 * @param pSink - output.
+		 * @param bufferSize - output buffer size.
 		 * @return - Z_OK if sucessfull, error-code otherwise.
-		 * @throws - can throw exception.
 		*/
-		static const int inflateFILE( std::FILE *const srcFile, std::FILE *const dstFile, const std::uint32_t & bufferSize );
+		static int inflateSource( InputSource & pSource, OutputSink & pSink, const std::uint32_t & bufferSize );
 
 		// -------------------------------------------------------- \\
 